@@ -0,0 +1,64 @@
+#version 450
+
+// one invocation per draw command (VULKAN_CULL_GROUP_SIZE)
+layout(local_size_x = 64) in;
+
+// culling uniforms
+layout(set = 0, binding = 0) uniform buffer0{
+	vec4 frustumPlanes[8 * 6]; // per view (VULKAN_SCENE_MAX_VIEWS)
+	vec4 viewPositions[8];     // per view (VULKAN_SCENE_MAX_VIEWS)
+	uint viewsCount;
+	uint instancesCount;
+	uint commandsCount;
+	uint compact;
+	uint occlusion;
+} uCull;
+
+// indirect commands (5 words per command, VULKAN_DRAW_INDIRECT_STRIDE - instance count is second word for both command types)
+layout(std430, set = 0, binding = 3) readonly buffer buffer3{
+	uint commands[];
+} uCommands;
+layout(std430, set = 0, binding = 4) writeonly buffer buffer4{
+	uint commands[];
+} uCulledCommands;
+
+// culled draw counts (one per batch)
+layout(std430, set = 0, binding = 5) buffer buffer5{
+	uint counts[];
+} uCulledCounts;
+
+// command cull data (batch of command)
+struct CommandCullData {
+	uint batchIndex;
+	uint batchFirst;
+};
+layout(std430, set = 0, binding = 8) readonly buffer buffer8{
+	CommandCullData commandCullData[];
+} uCommandCullData;
+
+// culled instance counts (one per command, written by instance culling)
+layout(std430, set = 0, binding = 9) readonly buffer buffer9{
+	uint counts[];
+} uCulledInstanceCounts;
+
+// main
+void main()
+{
+	// command index
+	uint commandIndex = gl_GlobalInvocationID.x;
+	if (commandIndex >= uCull.commandsCount)
+		return;
+
+	// compacted output appends commands with visible instances to batch range, in place output keeps empty commands
+	uint instanceCount = uCulledInstanceCounts.counts[commandIndex];
+	uint culledIndex = commandIndex;
+	if (uCull.compact != 0) {
+		if (instanceCount == 0)
+			return;
+		CommandCullData commandCullData = uCommandCullData.commandCullData[commandIndex];
+		culledIndex = commandCullData.batchFirst + atomicAdd(uCulledCounts.counts[commandCullData.batchIndex], 1);
+	}
+	for (uint i = 0; i < 5; i++)
+		uCulledCommands.commands[culledIndex * 5 + i] = uCommands.commands[commandIndex * 5 + i];
+	uCulledCommands.commands[culledIndex * 5 + 1] = instanceCount;
+}
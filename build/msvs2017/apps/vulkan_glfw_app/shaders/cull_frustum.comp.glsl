@@ -0,0 +1,98 @@
+#version 450
+
+// one invocation per instance (VULKAN_CULL_GROUP_SIZE)
+layout(local_size_x = 64) in;
+
+// culling uniforms
+layout(set = 0, binding = 0) uniform buffer0{
+	vec4 frustumPlanes[8 * 6]; // per view (VULKAN_SCENE_MAX_VIEWS)
+	vec4 viewPositions[8];     // per view (VULKAN_SCENE_MAX_VIEWS)
+	uint viewsCount;
+	uint instancesCount;
+	uint commandsCount;
+	uint compact;
+	uint occlusion;
+} uCull;
+
+// draw data (same buffer as vertex shaders)
+struct DrawData {
+	mat4 model;
+	uint materialId;
+};
+layout(std430, set = 0, binding = 1) readonly buffer buffer1{
+	DrawData drawData[];
+} uDrawData;
+
+// cull data (model space bounding sphere and box extent, draw command of instance, backface cone of meshlet)
+struct CullData {
+	vec4 boundingSphere;
+	vec4 boundingBoxExtent;
+	uint commandIndex;
+	uint commandFirst;
+	uint visibilityIndex;
+	uint padding;
+	vec4 cone;
+};
+layout(std430, set = 0, binding = 2) readonly buffer buffer2{
+	CullData cullData[];
+} uCullData;
+
+// visibility of instances after occlusion phase of previous frame with same index
+layout(std430, set = 0, binding = 6) readonly buffer buffer6{
+	uint visibility[];
+} uVisibility;
+
+// culled instance counts (one per command)
+layout(std430, set = 0, binding = 9) buffer buffer9{
+	uint counts[];
+} uCulledInstanceCounts;
+
+// culled draw data (visible instances are appended to instance range of command)
+layout(std430, set = 0, binding = 10) writeonly buffer buffer10{
+	DrawData drawData[];
+} uCulledDrawData;
+
+// main
+void main()
+{
+	// instance index
+	uint instanceIndex = gl_GlobalInvocationID.x;
+	if (instanceIndex >= uCull.instancesCount)
+		return;
+
+	// world space bounding sphere (radius scaled by largest axis scale)
+	mat4 model = uDrawData.drawData[instanceIndex].model;
+	CullData cullData = uCullData.cullData[instanceIndex];
+	vec3 center = (model * vec4(cullData.boundingSphere.xyz, 1.0f)).xyz;
+	float radius = cullData.boundingSphere.w * max(length(model[0].xyz), max(length(model[1].xyz), length(model[2].xyz)));
+
+	// visible if inside all planes of any view
+	bool visible = false;
+	for (uint viewIndex = 0; viewIndex < uCull.viewsCount && !visible; viewIndex++) {
+		bool inside = true;
+		for (uint planeIndex = 0; planeIndex < 6; planeIndex++) {
+			vec4 plane = uCull.frustumPlanes[viewIndex * 6 + planeIndex];
+			inside = inside && (dot(plane.xyz, center) + plane.w >= -radius);
+		}
+		visible = visible || inside;
+	}
+
+	// meshlet is culled when its triangles face away from all views (zero cone axis is never culled)
+	vec3 coneAxis = normalize(mat3(model) * cullData.cone.xyz);
+	bool frontFacing = cullData.cone.xyz == vec3(0.0f);
+	for (uint viewIndex = 0; viewIndex < uCull.viewsCount && !frontFacing; viewIndex++) {
+		vec3 direction = center - uCull.viewPositions[viewIndex].xyz;
+		frontFacing = dot(direction, coneAxis) < cullData.cone.w * length(direction) + radius;
+	}
+	visible = visible && frontFacing;
+
+	// two phase occlusion culling draws only previously visible instances first
+	if (uCull.occlusion != 0 && visible)
+		visible = uVisibility.visibility[cullData.visibilityIndex] != 0;
+
+	// visible instances are compacted within their command (commands are written by second dispatch)
+	if (!visible)
+		return;
+	uint culledIndex = cullData.commandFirst + atomicAdd(uCulledInstanceCounts.counts[cullData.commandIndex], 1);
+	uCulledDrawData.drawData[culledIndex] = uDrawData.drawData[instanceIndex];
+}
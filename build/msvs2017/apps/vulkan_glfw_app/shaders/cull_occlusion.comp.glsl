@@ -0,0 +1,151 @@
+#version 450
+
+// one invocation per instance (VULKAN_CULL_GROUP_SIZE)
+layout(local_size_x = 64) in;
+
+// culling uniforms
+layout(set = 0, binding = 0) uniform buffer0{
+	vec4 frustumPlanes[8 * 6]; // per view (VULKAN_SCENE_MAX_VIEWS)
+	vec4 viewPositions[8];     // per view (VULKAN_SCENE_MAX_VIEWS)
+	uint viewsCount;
+	uint instancesCount;
+	uint commandsCount;
+	uint compact;
+	uint occlusion;
+	mat4 viewProjection; // first view
+	vec2 depthSize;
+	uint pyramidLevels;
+} uCull;
+
+// draw data (same buffer as vertex shaders)
+struct DrawData {
+	mat4 model;
+	uint materialId;
+};
+layout(std430, set = 0, binding = 1) readonly buffer buffer1{
+	DrawData drawData[];
+} uDrawData;
+
+// cull data (model space bounding sphere and box extent, draw command of instance, backface cone of meshlet)
+struct CullData {
+	vec4 boundingSphere;
+	vec4 boundingBoxExtent;
+	uint commandIndex;
+	uint commandFirst;
+	uint visibilityIndex;
+	uint padding;
+	vec4 cone;
+};
+layout(std430, set = 0, binding = 2) readonly buffer buffer2{
+	CullData cullData[];
+} uCullData;
+
+// visibility of instances (read by first phase of next frame with same index)
+layout(std430, set = 0, binding = 6) buffer buffer6{
+	uint visibility[];
+} uVisibility;
+
+// farthest depth pyramid (level 0 is half of depth attachment)
+layout(set = 0, binding = 7) uniform sampler2D uDepthPyramid;
+
+// culled instance counts (one per command)
+layout(std430, set = 0, binding = 9) buffer buffer9{
+	uint counts[];
+} uCulledInstanceCounts;
+
+// culled draw data (newly visible instances are appended to instance range of command)
+layout(std430, set = 0, binding = 10) writeonly buffer buffer10{
+	DrawData drawData[];
+} uCulledDrawData;
+
+// occluded (bounding box is behind farthest depth of pyramid texels it covers)
+bool occluded(mat4 model, vec3 center, vec3 extent)
+{
+	// screen rectangle and nearest depth of box corners
+	mat4 matrix = uCull.viewProjection * model;
+	vec2 uvMin = vec2(1.0f);
+	vec2 uvMax = vec2(0.0f);
+	float depthMin = 1.0f;
+	for (uint i = 0u; i < 8u; i++) {
+		vec3 corner = center + extent * vec3(
+			(i & 1u) != 0u ? 1.0f : -1.0f,
+			(i & 2u) != 0u ? 1.0f : -1.0f,
+			(i & 4u) != 0u ? 1.0f : -1.0f);
+		vec4 clip = matrix * vec4(corner, 1.0f);
+		// box crossing camera plane is kept
+		if (clip.w <= 0.0f)
+			return false;
+		vec3 ndc = clip.xyz / clip.w;
+		// viewport is flipped (first row is top of screen)
+		vec2 uv = vec2(ndc.x * 0.5f + 0.5f, 0.5f - ndc.y * 0.5f);
+		uvMin = min(uvMin, uv);
+		uvMax = max(uvMax, uv);
+		depthMin = min(depthMin, ndc.z);
+	}
+	uvMin = clamp(uvMin, vec2(0.0f), vec2(1.0f));
+	uvMax = clamp(uvMax, vec2(0.0f), vec2(1.0f));
+
+	// level where rectangle covers at most 2x2 texels (level texel covers 2^(level + 1) depth pixels)
+	ivec2 pixelMin = min(ivec2(uvMin * uCull.depthSize), ivec2(uCull.depthSize) - ivec2(1));
+	ivec2 pixelMax = min(ivec2(uvMax * uCull.depthSize), ivec2(uCull.depthSize) - ivec2(1));
+	ivec2 pixelSize = pixelMax - pixelMin + ivec2(1);
+	int level = max(int(ceil(log2(float(max(pixelSize.x, pixelSize.y))))) - 1, 0);
+	level = min(level, int(uCull.pyramidLevels) - 1);
+
+	// farthest depth of covered texels
+	ivec2 levelSize = textureSize(uDepthPyramid, level);
+	ivec2 texelMin = min(pixelMin >> (level + 1), levelSize - ivec2(1));
+	ivec2 texelMax = min(pixelMax >> (level + 1), levelSize - ivec2(1));
+	float depthMax = max(
+		max(texelFetch(uDepthPyramid, texelMin, level).r, texelFetch(uDepthPyramid, ivec2(texelMax.x, texelMin.y), level).r),
+		max(texelFetch(uDepthPyramid, ivec2(texelMin.x, texelMax.y), level).r, texelFetch(uDepthPyramid, texelMax, level).r));
+	return depthMin > depthMax;
+}
+
+// main
+void main()
+{
+	// instance index
+	uint instanceIndex = gl_GlobalInvocationID.x;
+	if (instanceIndex >= uCull.instancesCount)
+		return;
+
+	// world space bounding sphere (radius scaled by largest axis scale)
+	mat4 model = uDrawData.drawData[instanceIndex].model;
+	CullData cullData = uCullData.cullData[instanceIndex];
+	vec3 center = (model * vec4(cullData.boundingSphere.xyz, 1.0f)).xyz;
+	float radius = cullData.boundingSphere.w * max(length(model[0].xyz), max(length(model[1].xyz), length(model[2].xyz)));
+
+	// visible if inside all planes of any view
+	bool visible = false;
+	for (uint viewIndex = 0; viewIndex < uCull.viewsCount && !visible; viewIndex++) {
+		bool inside = true;
+		for (uint planeIndex = 0; planeIndex < 6; planeIndex++) {
+			vec4 plane = uCull.frustumPlanes[viewIndex * 6 + planeIndex];
+			inside = inside && (dot(plane.xyz, center) + plane.w >= -radius);
+		}
+		visible = visible || inside;
+	}
+
+	// meshlet is culled when its triangles face away from all views (zero cone axis is never culled)
+	vec3 coneAxis = normalize(mat3(model) * cullData.cone.xyz);
+	bool frontFacing = cullData.cone.xyz == vec3(0.0f);
+	for (uint viewIndex = 0; viewIndex < uCull.viewsCount && !frontFacing; viewIndex++) {
+		vec3 direction = center - uCull.viewPositions[viewIndex].xyz;
+		frontFacing = dot(direction, coneAxis) < cullData.cone.w * length(direction) + radius;
+	}
+	visible = visible && frontFacing;
+
+	// first phase has drawn frustum visible instances which were visible in previous frame
+	bool drawnFirst = visible && uVisibility.visibility[cullData.visibilityIndex] != 0;
+
+	// test against depth of first phase and keep visibility for next frame
+	visible = visible && !occluded(model, cullData.boundingSphere.xyz, cullData.boundingBoxExtent.xyz);
+	uVisibility.visibility[cullData.visibilityIndex] = visible ? 1u : 0u;
+
+	// second phase draws newly visible instances only (commands are written by second dispatch)
+	if (!visible || drawnFirst)
+		return;
+	uint culledIndex = cullData.commandFirst + atomicAdd(uCulledInstanceCounts.counts[cullData.commandIndex], 1);
+	uCulledDrawData.drawData[culledIndex] = uDrawData.drawData[instanceIndex];
+}
@@ -0,0 +1,84 @@
+#version 450
+
+// max meshes per dispatch (VULKAN_DEBUG_GEOMETRY_MAX_JOBS)
+#define MAX_JOBS 64
+
+// one invocation per source vertex, one work group row per mesh (VULKAN_DEBUG_GEOMETRY_GROUP_SIZE)
+#define GROUP_SIZE 64
+layout(local_size_x = GROUP_SIZE) in;
+
+// debug geometry data (jobs: source first vertex, debug first vertex, source vertex count, triangle list flag)
+layout(set = 0, binding = 0) uniform buffer0{
+	vec4  params; // line length
+	uvec4 jobs[MAX_JOBS];
+} uDebugGeometry;
+
+// geometry pool vertex buffers (positions, texture coordinates and normals are tightly packed)
+layout(std430, set = 0, binding = 1) buffer buffer1{
+	vec4 pos[];
+} uPos;
+layout(std430, set = 0, binding = 2) buffer buffer2{
+	float tex[];
+} uTex;
+layout(std430, set = 0, binding = 3) buffer buffer3{
+	float nrm[];
+} uNrm;
+
+// read vertex attributes
+vec2 readTex(uint vertex)
+{
+	return vec2(uTex.tex[vertex * 2 + 0], uTex.tex[vertex * 2 + 1]);
+}
+vec3 readNrm(uint vertex)
+{
+	return vec3(uNrm.nrm[vertex * 3 + 0], uNrm.nrm[vertex * 3 + 1], uNrm.nrm[vertex * 3 + 2]);
+}
+
+// write line from position along direction (color in normal stream, no texture coordinates)
+void writeLine(uint vertex, vec4 position, vec3 direction, vec3 color)
+{
+	uPos.pos[vertex + 0] = position;
+	uPos.pos[vertex + 1] = vec4(position.xyz + direction * uDebugGeometry.params.x, 1.0f);
+	for (uint i = 0; i < 2; i++) {
+		uTex.tex[(vertex + i) * 2 + 0] = 0.0f;
+		uTex.tex[(vertex + i) * 2 + 1] = 0.0f;
+		uNrm.nrm[(vertex + i) * 3 + 0] = color.r;
+		uNrm.nrm[(vertex + i) * 3 + 1] = color.g;
+		uNrm.nrm[(vertex + i) * 3 + 2] = color.b;
+	}
+}
+
+// main
+void main()
+{
+	// source vertex of job
+	uvec4 job = uDebugGeometry.jobs[gl_WorkGroupID.y];
+	uint index = gl_GlobalInvocationID.x;
+	if (index >= job.z)
+		return;
+	uint vertex = job.x + index;
+	uint debugVertex = job.y + index * 6;
+	vec4 position = uPos.pos[vertex];
+	vec3 normal = readNrm(vertex);
+
+	// tangent and bi-normal from triangle of vertex (triangle lists only, degenerate texture coordinates give none)
+	vec3 tangent = vec3(0.0f);
+	vec3 binormal = vec3(0.0f);
+	if (job.w != 0) {
+		uint first = job.x + index / 3 * 3;
+		vec3 edge1 = uPos.pos[first + 1].xyz - uPos.pos[first].xyz;
+		vec3 edge2 = uPos.pos[first + 2].xyz - uPos.pos[first].xyz;
+		vec2 delta1 = readTex(first + 1) - readTex(first);
+		vec2 delta2 = readTex(first + 2) - readTex(first);
+		float det = delta1.x * delta2.y - delta2.x * delta1.y;
+		if (abs(det) > 1e-12f) {
+			tangent = normalize((edge1 * delta2.y - edge2 * delta1.y) / det);
+			binormal = normalize((edge2 * delta1.x - edge1 * delta2.x) / det);
+		}
+	}
+
+	// normal, tangent and bi-normal lines (red, green, blue)
+	writeLine(debugVertex + 0, position, normal, vec3(1.0f, 0.0f, 0.0f));
+	writeLine(debugVertex + 2, position, tangent, vec3(0.0f, 1.0f, 0.0f));
+	writeLine(debugVertex + 4, position, binormal, vec3(0.0f, 0.0f, 1.0f));
+}
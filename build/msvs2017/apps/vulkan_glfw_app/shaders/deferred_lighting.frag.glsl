@@ -0,0 +1,110 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+// G-buffer of geometry subpass (albedo, normal and lit flag, depth)
+layout(input_attachment_index = 0, set = 3, binding = 0) uniform subpassInput gAlbedo;
+layout(input_attachment_index = 1, set = 3, binding = 1) uniform subpassInput gNormal;
+layout(input_attachment_index = 2, set = 3, binding = 2) uniform subpassInput gDepth;
+
+// deferred data (first view)
+layout(set = 3, binding = 3) uniform buffer3{
+	mat4 viewProjectionInverse;
+	mat4 view;
+	vec4 viewport; // inverse width and height of render area
+} uDeferredData;
+
+// shadow data (VULKAN_SHADOW_MAX_CASCADES cascades of directional light)
+layout(set = 2, binding = 2) uniform buffer2{
+	mat4 shadowMatrices[4];
+	vec4 cascadeSplits;
+	vec4 lightDirection;
+	uint cascadesCount;
+} uShadowData;
+
+// shadow maps (one layer per cascade, compared depth)
+layout(set = 2, binding = 3) uniform sampler2DArrayShadow shadowMaps;
+
+// light sources (world position and radius, color and intensity)
+struct Light {
+	vec4 positionRadius;
+	vec4 colorIntensity;
+};
+layout(std430, set = 2, binding = 1) readonly buffer buffer1{
+	Light lights[];
+} uLights;
+
+// light clusters (VULKAN_LIGHT_CLUSTERS_X/Y/Z grid, VULKAN_LIGHT_CLUSTER_MAX_LIGHTS light indices per cluster)
+layout(std430, set = 2, binding = 4) readonly buffer buffer4{
+	uint counts[16 * 9 * 24];
+	uint indices[];
+} uClusters;
+
+// light clusters data (clusters of first view)
+layout(set = 2, binding = 5) uniform buffer5{
+	mat4 view;
+	mat4 viewProjection;
+	mat4 projectionInverse;
+	vec4 depthParams; // near, far, slice scale, slice bias
+	uint lightsCount;
+} uLightClusters;
+
+// outputs
+layout(location = 0) out vec4 fragColor;
+
+// shadow factor of world position in cascade of view depth (filtered comparison, lit beyond last cascade)
+float shadowFactor(vec4 shadowPosition)
+{
+	uint cascade = 0;
+	while (cascade < uShadowData.cascadesCount && shadowPosition.w > uShadowData.cascadeSplits[cascade])
+		cascade++;
+	if (cascade >= uShadowData.cascadesCount)
+		return 1.0f;
+	vec4 position = uShadowData.shadowMatrices[cascade] * vec4(shadowPosition.xyz, 1.0f);
+	return texture(shadowMaps, vec4(position.xy, float(cascade), position.z));
+}
+
+// diffuse lighting of point lights in cluster of fragment (first view only)
+vec3 pointLighting(vec4 shadowPosition, vec3 normal)
+{
+	if (uLightClusters.lightsCount == 0)
+		return vec3(0.0f);
+
+	// cluster of fragment (tile of first view, exponential slice of view depth)
+	vec4 clip = uLightClusters.viewProjection * vec4(shadowPosition.xyz, 1.0f);
+	vec2 tile = clamp((clip.xy / clip.w * 0.5f + 0.5f) * vec2(16.0f, 9.0f), vec2(0.0f), vec2(15.0f, 8.0f));
+	float slice = clamp(log(shadowPosition.w) * uLightClusters.depthParams.z + uLightClusters.depthParams.w, 0.0f, 23.0f);
+	uint cluster = (uint(slice) * 9 + uint(tile.y)) * 16 + uint(tile.x);
+	uint first = cluster * 128;
+	uint count = uClusters.counts[cluster];
+
+	// smooth falloff to zero at light radius
+	vec3 lighting = vec3(0.0f);
+	for (uint i = 0; i < count; i++) {
+		Light light = uLights.lights[uClusters.indices[first + i]];
+		vec3 direction = light.positionRadius.xyz - shadowPosition.xyz;
+		float distance2 = dot(direction, direction);
+		float falloff = clamp(1.0f - distance2 / (light.positionRadius.w * light.positionRadius.w), 0.0f, 1.0f);
+		lighting += light.colorIntensity.rgb * light.colorIntensity.a * falloff * falloff * max(dot(normal, direction * inversesqrt(max(distance2, 1e-8f))), 0.0f);
+	}
+	return lighting;
+}
+
+// main
+void main()
+{
+	// unlit fragments and background keep albedo
+	vec4 albedo = subpassLoad(gAlbedo);
+	vec4 normal = subpassLoad(gNormal);
+	fragColor = albedo;
+	if (normal.w < 0.5f)
+		return;
+
+	// world position from depth (viewport is flipped, normalized device y points up)
+	vec2 uv = gl_FragCoord.xy * uDeferredData.viewport.xy;
+	vec4 position = uDeferredData.viewProjectionInverse * vec4(uv.x * 2.0f - 1.0f, 1.0f - uv.y * 2.0f, subpassLoad(gDepth).r, 1.0f);
+	position.xyz /= position.w;
+	vec4 shadowPosition = vec4(position.xyz, -(uDeferredData.view * vec4(position.xyz, 1.0f)).z);
+
+	// same shading as lit forward shaders
+	fragColor.rgb *= mix(0.5f, 1.0f, shadowFactor(shadowPosition)) + pointLighting(shadowPosition, normalize(normal.xyz * 2.0f - 1.0f));
+}
@@ -0,0 +1,33 @@
+#version 450
+
+// one invocation per reduced texel (VULKAN_DEPTH_PYRAMID_GROUP_SIZE)
+layout(local_size_x = 8, local_size_y = 8) in;
+
+// source depth (depth attachment or previous level) and reduced level
+layout(set = 0, binding = 0) uniform sampler2D uSource;
+layout(set = 0, binding = 1, r32f) uniform writeonly image2D uLevel;
+
+// main
+void main()
+{
+	// reduced texel
+	ivec2 levelSize = imageSize(uLevel);
+	ivec2 texel = ivec2(gl_GlobalInvocationID.xy);
+	if (any(greaterThanEqual(texel, levelSize)))
+		return;
+
+	// source footprint (last column and row also cover odd source edge)
+	ivec2 sourceSize = textureSize(uSource, 0);
+	ivec2 first = texel * 2;
+	ivec2 last = first + ivec2(1);
+	if (texel.x == levelSize.x - 1) last.x = sourceSize.x - 1;
+	if (texel.y == levelSize.y - 1) last.y = sourceSize.y - 1;
+	last = min(last, sourceSize - ivec2(1));
+
+	// farthest depth of footprint
+	float depth = 0.0f;
+	for (int y = first.y; y <= last.y; y++)
+		for (int x = first.x; x <= last.x; x++)
+			depth = max(depth, texelFetch(uSource, ivec2(x, y), 0).r);
+	imageStore(uLevel, texel, vec4(depth));
+}
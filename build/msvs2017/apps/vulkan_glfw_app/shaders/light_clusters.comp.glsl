@@ -0,0 +1,97 @@
+#version 450
+
+// cluster grid and binned lights limit (VULKAN_LIGHT_CLUSTERS_X/Y/Z, VULKAN_LIGHT_CLUSTER_MAX_LIGHTS)
+#define CLUSTERS_X 16
+#define CLUSTERS_Y 9
+#define CLUSTERS_Z 24
+#define CLUSTERS_COUNT (CLUSTERS_X * CLUSTERS_Y * CLUSTERS_Z)
+#define CLUSTER_MAX_LIGHTS 128
+
+// one invocation per cluster (VULKAN_LIGHT_CLUSTERS_GROUP_SIZE)
+#define GROUP_SIZE 64
+layout(local_size_x = GROUP_SIZE) in;
+
+// light clusters data (first view)
+layout(set = 0, binding = 0) uniform buffer0{
+	mat4 view;
+	mat4 viewProjection;
+	mat4 projectionInverse;
+	vec4 depthParams; // near, far, slice scale, slice bias
+	uint lightsCount;
+} uLightClusters;
+
+// light sources (world position and radius, color and intensity)
+struct Light {
+	vec4 positionRadius;
+	vec4 colorIntensity;
+};
+layout(std430, set = 0, binding = 1) readonly buffer buffer1{
+	Light lights[];
+} uLights;
+
+// light clusters (light count per cluster, then CLUSTER_MAX_LIGHTS light indices per cluster)
+layout(std430, set = 0, binding = 2) writeonly buffer buffer2{
+	uint counts[CLUSTERS_COUNT];
+	uint indices[];
+} uClusters;
+
+// view space lights of work group batch (light list is read once per work group)
+shared vec4 sharedLights[GROUP_SIZE];
+
+// view space point on ray of normalized device coordinates at view depth
+vec3 viewPoint(vec2 ndc, float depth)
+{
+	vec4 point = uLightClusters.projectionInverse * vec4(ndc, -1.0f, 1.0f);
+	point.xyz /= point.w;
+	return point.xyz * (depth / -point.z);
+}
+
+// main
+void main()
+{
+	// cluster of invocation (invocations past last cluster load lights only)
+	uint cluster = gl_GlobalInvocationID.x;
+	bool valid = cluster < CLUSTERS_COUNT;
+	uint x = cluster % CLUSTERS_X;
+	uint y = (cluster / CLUSTERS_X) % CLUSTERS_Y;
+	uint z = cluster / (CLUSTERS_X * CLUSTERS_Y);
+
+	// view space bounding box of cluster (tile corners between exponential slice depths)
+	vec2 ndcMin = vec2(x, y) / vec2(CLUSTERS_X, CLUSTERS_Y) * 2.0f - 1.0f;
+	vec2 ndcMax = vec2(x + 1, y + 1) / vec2(CLUSTERS_X, CLUSTERS_Y) * 2.0f - 1.0f;
+	float depthRatio = uLightClusters.depthParams.y / uLightClusters.depthParams.x;
+	float depthNear = uLightClusters.depthParams.x * pow(depthRatio, float(z) / CLUSTERS_Z);
+	float depthFar = uLightClusters.depthParams.x * pow(depthRatio, float(z + 1) / CLUSTERS_Z);
+	vec3 boxMin = vec3(1e30f);
+	vec3 boxMax = vec3(-1e30f);
+	for (uint corner = 0; corner < 8; corner++) {
+		vec2 ndc = vec2((corner & 1) != 0 ? ndcMax.x : ndcMin.x, (corner & 2) != 0 ? ndcMax.y : ndcMin.y);
+		vec3 point = viewPoint(ndc, (corner & 4) != 0 ? depthFar : depthNear);
+		boxMin = min(boxMin, point);
+		boxMax = max(boxMax, point);
+	}
+
+	// test light spheres against box (batches of work group size)
+	uint count = 0;
+	for (uint first = 0; first < uLightClusters.lightsCount; first += GROUP_SIZE) {
+		uint index = first + gl_LocalInvocationIndex;
+		if (index < uLightClusters.lightsCount) {
+			vec4 positionRadius = uLights.lights[index].positionRadius;
+			sharedLights[gl_LocalInvocationIndex] = vec4((uLightClusters.view * vec4(positionRadius.xyz, 1.0f)).xyz, positionRadius.w);
+		}
+		barrier();
+
+		uint batchCount = min(GROUP_SIZE, uLightClusters.lightsCount - first);
+		for (uint light = 0; valid && light < batchCount && count < CLUSTER_MAX_LIGHTS; light++) {
+			vec4 sphere = sharedLights[light];
+			vec3 delta = clamp(sphere.xyz, boxMin, boxMax) - sphere.xyz;
+			if (dot(delta, delta) <= sphere.w * sphere.w)
+				uClusters.indices[cluster * CLUSTER_MAX_LIGHTS + count++] = first + light;
+		}
+		barrier();
+	}
+
+	// light count of cluster (lights past CLUSTER_MAX_LIGHTS are dropped)
+	if (valid)
+		uClusters.counts[cluster] = count;
+}
@@ -0,0 +1,28 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+// inputs
+layout(location = 0) in vec3 vPosition;
+layout(location = 1) in vec2 vTexCoords;
+layout(location = 2) in vec3 vNormal;
+
+// material colors
+layout(set = 0, binding = 1) uniform materialColors{
+	vec4 diffuseColor;
+	vec4 ambientColor;
+	vec4 emissionColor;
+	vec4 specularColor;
+	float specularFactor;
+} uMaterialColors;
+
+// outputs (G-buffer albedo, normal and lit flag)
+layout(location = 0) out vec4 gAlbedo;
+layout(location = 1) out vec4 gNormal;
+
+// main
+void main()
+{
+	// unlit (resolve subpass writes albedo)
+	gAlbedo = uMaterialColors.diffuseColor;
+	gNormal = vec4(0.0f);
+}
@@ -1,10 +1,13 @@
 #version 450
 #extension GL_ARB_separate_shader_objects : enable
+#extension GL_EXT_multiview : enable
 
 // inputs
 layout(location = 0) in vec3 vPosition;
 layout(location = 1) in vec2 vTexCoords;
 layout(location = 2) in vec3 vNormal;
+layout(location = 3) in vec4 vShadowPosition;
+layout(location = 4) in vec3 vWorldNormal;
 
 // diffuse texture
 layout(set = 0, binding = 0) uniform sampler2D diffuseTexture;
@@ -18,9 +21,87 @@ vec4 specularColor;
 float specularFactor;
 } uMaterialColors;
 
+// shadow data (VULKAN_SHADOW_MAX_CASCADES cascades of directional light)
+layout(set = 2, binding = 2) uniform buffer2{
+	mat4 shadowMatrices[4];
+	vec4 cascadeSplits;
+	vec4 lightDirection;
+	uint cascadesCount;
+} uShadowData;
+
+// shadow maps (one layer per cascade, compared depth)
+layout(set = 2, binding = 3) uniform sampler2DArrayShadow shadowMaps;
+
+// light sources (world position and radius, color and intensity)
+struct Light {
+	vec4 positionRadius;
+	vec4 colorIntensity;
+};
+layout(std430, set = 2, binding = 1) readonly buffer buffer1{
+	Light lights[];
+} uLights;
+
+// light clusters (VULKAN_LIGHT_CLUSTERS_X/Y/Z grid, VULKAN_LIGHT_CLUSTER_MAX_LIGHTS light indices per cluster)
+layout(std430, set = 2, binding = 4) readonly buffer buffer4{
+	uint counts[16 * 9 * 24];
+	uint indices[];
+} uClusters;
+
+// light clusters data (clusters of first view)
+layout(set = 2, binding = 5) uniform buffer5{
+	mat4 view;
+	mat4 viewProjection;
+	mat4 projectionInverse;
+	vec4 depthParams; // near, far, slice scale, slice bias
+	uint lightsCount;
+} uLightClusters;
+
 // outputs
 layout(location = 0) out vec4 fragColor;
 
+// shadow factor of world position in cascade of view depth (filtered comparison, lit beyond last cascade)
+float shadowFactor(vec4 shadowPosition)
+{
+	uint cascade = 0;
+	while (cascade < uShadowData.cascadesCount && shadowPosition.w > uShadowData.cascadeSplits[cascade])
+		cascade++;
+	if (cascade >= uShadowData.cascadesCount)
+		return 1.0f;
+	vec4 position = uShadowData.shadowMatrices[cascade] * vec4(shadowPosition.xyz, 1.0f);
+	return texture(shadowMaps, vec4(position.xy, float(cascade), position.z));
+}
+
+// diffuse lighting of point lights in cluster of fragment (other views than first iterate all lights)
+vec3 pointLighting(vec4 shadowPosition, vec3 normal)
+{
+	if (uLightClusters.lightsCount == 0)
+		return vec3(0.0f);
+
+	// cluster of fragment (tile of first view, exponential slice of view depth)
+	uint first = 0;
+	uint count = uLightClusters.lightsCount;
+	bool clustered = gl_ViewIndex == 0;
+	if (clustered) {
+		vec4 clip = uLightClusters.viewProjection * vec4(shadowPosition.xyz, 1.0f);
+		vec2 tile = clamp((clip.xy / clip.w * 0.5f + 0.5f) * vec2(16.0f, 9.0f), vec2(0.0f), vec2(15.0f, 8.0f));
+		float slice = clamp(log(shadowPosition.w) * uLightClusters.depthParams.z + uLightClusters.depthParams.w, 0.0f, 23.0f);
+		uint cluster = (uint(slice) * 9 + uint(tile.y)) * 16 + uint(tile.x);
+		first = cluster * 128;
+		count = uClusters.counts[cluster];
+	}
+
+	// smooth falloff to zero at light radius
+	vec3 lighting = vec3(0.0f);
+	for (uint i = 0; i < count; i++) {
+		Light light = uLights.lights[clustered ? uClusters.indices[first + i] : i];
+		vec3 direction = light.positionRadius.xyz - shadowPosition.xyz;
+		float distance2 = dot(direction, direction);
+		float falloff = clamp(1.0f - distance2 / (light.positionRadius.w * light.positionRadius.w), 0.0f, 1.0f);
+		lighting += light.colorIntensity.rgb * light.colorIntensity.a * falloff * falloff * max(dot(normal, direction * inversesqrt(max(distance2, 1e-8f))), 0.0f);
+	}
+	return lighting;
+}
+
 // main
 void main()
 {
@@ -28,4 +109,5 @@ void main()
 	//fragColor = vec4(vPosition, 1.0f);
 	//fragColor = vec4(vTexCoords, 0.0f, 1.0f);
 	fragColor = vec4(vNormal, 1.0f);
+	fragColor.rgb *= mix(0.5f, 1.0f, shadowFactor(vShadowPosition)) + pointLighting(vShadowPosition, normalize(vWorldNormal));
 }
@@ -0,0 +1,34 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_EXT_multiview : enable
+
+// attributes (position stream only)
+layout(location = 0) in vec3 aPosition;
+
+// outputs
+invariant gl_Position; // same depth as color pass (equal depth test)
+
+// draw data (one per instance, instance index includes first instance of draw command)
+struct DrawData {
+	mat4 model;
+	uint materialId;
+};
+layout(std430, set = 3, binding = 0) readonly buffer buffer0{
+	DrawData drawData[];
+} uDrawData;
+
+// scene uniforms
+layout(set = 2, binding = 0) uniform buffer1{
+	mat4 view[8]; // per view (VULKAN_SCENE_MAX_VIEWS)
+	mat4 proj[8];
+} uSceneMatrices;
+
+// main
+void main()
+{
+	// find position (same expression as mesh object shaders)
+	gl_Position =
+		uSceneMatrices.proj[gl_ViewIndex] *
+		uSceneMatrices.view[gl_ViewIndex] *
+		uDrawData.drawData[gl_InstanceIndex].model * vec4(aPosition, 1.0f);
+}
@@ -1,5 +1,6 @@
 #version 450
 #extension GL_ARB_separate_shader_objects : enable
+#extension GL_EXT_multiview : enable
 
 // attributes
 layout(location = 0) in vec3 aPosition;
@@ -15,15 +16,19 @@ layout(location = 0) out vec3 vPosition;
 layout(location = 1) out vec2 vTexCoords;
 layout(location = 2) out vec3 vNormal;
 
-// model uniforms
-layout(set = 1, binding = 0) uniform buffer0{
+// draw data (one per instance, instance index includes first instance of draw command)
+struct DrawData {
 	mat4 model;
-} uModelMatrices;
+	uint materialId;
+};
+layout(std430, set = 3, binding = 0) readonly buffer buffer0{
+	DrawData drawData[];
+} uDrawData;
 
 // scene uniforms
 layout(set = 2, binding = 0) uniform buffer1{
-	mat4 view;
-	mat4 proj;
+	mat4 view[8]; // per view (VULKAN_SCENE_MAX_VIEWS)
+	mat4 proj[8];
 } uSceneMatrices;
 
 // main
@@ -37,7 +42,7 @@ void main()
 	// find position
 	//gl_Position = aPosition;
 	gl_Position =
-		uSceneMatrices.proj *
-		uSceneMatrices.view *
-		uModelMatrices.model * vec4(aPosition, 1.0f);
+		uSceneMatrices.proj[gl_ViewIndex] *
+		uSceneMatrices.view[gl_ViewIndex] *
+		uDrawData.drawData[gl_InstanceIndex].model * vec4(aPosition, 1.0f);
 }
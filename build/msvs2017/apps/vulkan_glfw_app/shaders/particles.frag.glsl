@@ -0,0 +1,17 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+// inputs
+layout(location = 0) in vec4 vColor;
+layout(location = 1) in vec2 vCorner;
+
+// outputs
+layout(location = 0) out vec4 fragColor;
+
+// main
+void main()
+{
+	// round particle fading to its edge (added to color attachment)
+	float falloff = max(1.0f - dot(vCorner, vCorner), 0.0f);
+	fragColor = vec4(vColor.rgb * vColor.a * falloff, 0.0f);
+}
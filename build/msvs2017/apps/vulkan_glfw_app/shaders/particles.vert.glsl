@@ -0,0 +1,40 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_EXT_multiview : enable
+
+// outputs
+layout(location = 0) out vec4 vColor;
+layout(location = 1) out vec2 vCorner;
+
+// drawn instances (position and size, packed color)
+layout(std430, set = 3, binding = 0) readonly buffer buffer0{
+	vec4 positionSize[];
+} uInstances;
+layout(std430, set = 3, binding = 1) readonly buffer buffer1{
+	uint colors[];
+} uColors;
+
+// scene uniforms
+layout(set = 2, binding = 0) uniform buffer2{
+	mat4 view[8]; // per view (VULKAN_SCENE_MAX_VIEWS)
+	mat4 proj[8];
+} uSceneMatrices;
+
+// quad corners (two triangles)
+const vec2 corners[6] = vec2[](
+	vec2(-1.0f, -1.0f), vec2(1.0f, -1.0f), vec2(1.0f, 1.0f),
+	vec2(-1.0f, -1.0f), vec2(1.0f, 1.0f), vec2(-1.0f, 1.0f));
+
+// main
+void main()
+{
+	// particle of instance
+	vec4 positionSize = uInstances.positionSize[gl_InstanceIndex];
+	vColor = unpackUnorm4x8(uColors.colors[gl_InstanceIndex]);
+	vCorner = corners[gl_VertexIndex];
+
+	// camera facing quad in view space
+	vec4 position = uSceneMatrices.view[gl_ViewIndex] * vec4(positionSize.xyz, 1.0f);
+	position.xy += vCorner * positionSize.w;
+	gl_Position = uSceneMatrices.proj[gl_ViewIndex] * position;
+}
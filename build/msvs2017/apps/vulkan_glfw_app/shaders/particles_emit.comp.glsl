@@ -0,0 +1,124 @@
+#version 450
+
+// particles of pool and max emitters (VULKAN_PARTICLES_CAPACITY, VULKAN_PARTICLES_MAX_EMITTERS)
+#define CAPACITY (1 << 20)
+#define MAX_EMITTERS 16
+
+// one invocation per emitted particle (VULKAN_PARTICLES_GROUP_SIZE)
+#define GROUP_SIZE 64
+layout(local_size_x = GROUP_SIZE) in;
+
+// particles data (gravity and time step, emitters)
+struct Emitter {
+	vec4  positionRadius;
+	vec4  velocitySpread;
+	vec4  colorBegin;
+	vec4  colorEnd;
+	vec4  params; // life, begin size, end size, drag
+	uvec4 range;  // first emit invocation, emitted count
+};
+layout(set = 0, binding = 0) uniform buffer0{
+	vec4    gravityTimeStep;
+	uint    emitCount;
+	uint    emittersCount;
+	uint    aliveList;
+	uint    seed;
+	Emitter emitters[MAX_EMITTERS];
+} uParticles;
+
+// particle state (position and age, velocity and emitter)
+struct Particle {
+	vec4 positionAge;
+	vec3 velocity;
+	uint emitter;
+};
+layout(std430, set = 0, binding = 1) writeonly buffer buffer1{
+	Particle particles[];
+} uState;
+
+// dead list (indices of free particles, popped from end)
+layout(std430, set = 0, binding = 2) readonly buffer buffer2{
+	uint indices[];
+} uDead;
+
+// alive lists (emitted particles are appended to list of next frame)
+layout(std430, set = 0, binding = 3) writeonly buffer buffer3{
+	uint indices[];
+} uAlive;
+
+// counters (simulation dispatch, alive counts of lists, dead count, emitted count)
+layout(std430, set = 0, binding = 4) buffer buffer4{
+	uint simulateDispatch[3];
+	uint aliveCount;
+	uint aliveNextCount;
+	uint deadCount;
+	uint emitted;
+} uCounters;
+
+// drawn instances of frame (position and size, packed color)
+layout(std430, set = 0, binding = 5) writeonly buffer buffer5{
+	vec4 positionSize[];
+} uInstances;
+layout(std430, set = 0, binding = 6) writeonly buffer buffer6{
+	uint colors[];
+} uColors;
+
+// integer hash
+uint hash(uint x)
+{
+	x ^= x >> 16;
+	x *= 0x7feb352du;
+	x ^= x >> 15;
+	x *= 0x846ca68bu;
+	x ^= x >> 16;
+	return x;
+}
+
+// random number in [0, 1)
+float random(inout uint state)
+{
+	state = hash(state);
+	return float(state >> 8) * (1.0f / 16777216.0f);
+}
+
+// random point in unit sphere
+vec3 randomInSphere(inout uint state)
+{
+	float z = random(state) * 2.0f - 1.0f;
+	float phi = random(state) * 6.28318531f;
+	float radius = pow(random(state), 1.0f / 3.0f);
+	return vec3(sqrt(1.0f - z * z) * vec2(cos(phi), sin(phi)), z) * radius;
+}
+
+// main
+void main()
+{
+	// emitter of invocation (emitters own consecutive invocation ranges)
+	uint invocation = gl_GlobalInvocationID.x;
+	if (invocation >= uParticles.emitCount)
+		return;
+	uint emitterIndex = 0;
+	while (emitterIndex + 1 < uParticles.emittersCount && invocation >= uParticles.emitters[emitterIndex].range.x + uParticles.emitters[emitterIndex].range.y)
+		emitterIndex++;
+	Emitter emitter = uParticles.emitters[emitterIndex];
+
+	// pop free particle (emission beyond dead particles is dropped, dead count is lowered after emission)
+	uint popped = atomicAdd(uCounters.emitted, 1);
+	if (popped >= uCounters.deadCount)
+		return;
+	uint index = uDead.indices[uCounters.deadCount - 1 - popped];
+
+	// random position in emission sphere and random velocity
+	uint state = hash(invocation ^ hash(uParticles.seed));
+	vec3 position = emitter.positionRadius.xyz + randomInSphere(state) * emitter.positionRadius.w;
+	vec3 velocity = emitter.velocitySpread.xyz + randomInSphere(state) * emitter.velocitySpread.w;
+	uState.particles[index].positionAge = vec4(position, 0.0f);
+	uState.particles[index].velocity = velocity;
+	uState.particles[index].emitter = emitterIndex;
+
+	// emitted particle is appended to alive list of next frame and drawn
+	uint slot = atomicAdd(uCounters.aliveNextCount, 1);
+	uAlive.indices[(uParticles.aliveList ^ 1) * CAPACITY + slot] = index;
+	uInstances.positionSize[slot] = vec4(position, emitter.params.y);
+	uColors.colors[slot] = packUnorm4x8(emitter.colorBegin);
+}
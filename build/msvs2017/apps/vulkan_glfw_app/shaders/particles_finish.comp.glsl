@@ -0,0 +1,46 @@
+#version 450
+
+// alive particles per simulation work group (VULKAN_PARTICLES_GROUP_SIZE)
+#define GROUP_SIZE 64
+
+// one invocation
+layout(local_size_x = 1) in;
+
+// counters (simulation dispatch, alive counts of lists, dead count, emitted count)
+layout(std430, set = 0, binding = 4) buffer buffer4{
+	uint simulateDispatch[3];
+	uint aliveCount;
+	uint aliveNextCount;
+	uint deadCount;
+	uint emitted;
+} uCounters;
+
+// indirect draw of frame
+layout(std430, set = 0, binding = 7) writeonly buffer buffer7{
+	uint vertexCount;
+	uint instanceCount;
+	uint firstVertex;
+	uint firstInstance;
+} uDraw;
+
+// main
+void main()
+{
+	// emitted particles left dead list
+	uCounters.deadCount -= min(uCounters.emitted, uCounters.deadCount);
+	uCounters.emitted = 0;
+
+	// survivors and emitted particles are simulated by next frame
+	uint aliveCount = uCounters.aliveNextCount;
+	uCounters.aliveCount = aliveCount;
+	uCounters.aliveNextCount = 0;
+	uCounters.simulateDispatch[0] = (aliveCount + GROUP_SIZE - 1) / GROUP_SIZE;
+	uCounters.simulateDispatch[1] = 1;
+	uCounters.simulateDispatch[2] = 1;
+
+	// camera facing quad per alive particle
+	uDraw.vertexCount = 6;
+	uDraw.instanceCount = aliveCount;
+	uDraw.firstVertex = 0;
+	uDraw.firstInstance = 0;
+}
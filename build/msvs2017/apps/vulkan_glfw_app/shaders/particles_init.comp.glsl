@@ -0,0 +1,41 @@
+#version 450
+
+// particles of pool (VULKAN_PARTICLES_CAPACITY)
+#define CAPACITY (1 << 20)
+
+// one invocation per particle (VULKAN_PARTICLES_GROUP_SIZE)
+#define GROUP_SIZE 64
+layout(local_size_x = GROUP_SIZE) in;
+
+// dead list (indices of free particles, popped from end)
+layout(std430, set = 0, binding = 2) writeonly buffer buffer2{
+	uint indices[];
+} uDead;
+
+// counters (simulation dispatch, alive counts of lists, dead count, emitted count)
+layout(std430, set = 0, binding = 4) writeonly buffer buffer4{
+	uint simulateDispatch[3];
+	uint aliveCount;
+	uint aliveNextCount;
+	uint deadCount;
+	uint emitted;
+} uCounters;
+
+// main
+void main()
+{
+	// every particle is dead
+	uint index = gl_GlobalInvocationID.x;
+	uDead.indices[index] = CAPACITY - 1 - index;
+
+	// nothing alive and nothing to simulate
+	if (index == 0) {
+		uCounters.simulateDispatch[0] = 0;
+		uCounters.simulateDispatch[1] = 1;
+		uCounters.simulateDispatch[2] = 1;
+		uCounters.aliveCount = 0;
+		uCounters.aliveNextCount = 0;
+		uCounters.deadCount = CAPACITY;
+		uCounters.emitted = 0;
+	}
+}
@@ -0,0 +1,97 @@
+#version 450
+
+// particles of pool and max emitters (VULKAN_PARTICLES_CAPACITY, VULKAN_PARTICLES_MAX_EMITTERS)
+#define CAPACITY (1 << 20)
+#define MAX_EMITTERS 16
+
+// one invocation per alive particle (VULKAN_PARTICLES_GROUP_SIZE)
+#define GROUP_SIZE 64
+layout(local_size_x = GROUP_SIZE) in;
+
+// particles data (gravity and time step, emitters)
+struct Emitter {
+	vec4  positionRadius;
+	vec4  velocitySpread;
+	vec4  colorBegin;
+	vec4  colorEnd;
+	vec4  params; // life, begin size, end size, drag
+	uvec4 range;  // first emit invocation, emitted count
+};
+layout(set = 0, binding = 0) uniform buffer0{
+	vec4    gravityTimeStep;
+	uint    emitCount;
+	uint    emittersCount;
+	uint    aliveList;
+	uint    seed;
+	Emitter emitters[MAX_EMITTERS];
+} uParticles;
+
+// particle state (position and age, velocity and emitter)
+struct Particle {
+	vec4 positionAge;
+	vec3 velocity;
+	uint emitter;
+};
+layout(std430, set = 0, binding = 1) buffer buffer1{
+	Particle particles[];
+} uState;
+
+// dead list (indices of free particles)
+layout(std430, set = 0, binding = 2) writeonly buffer buffer2{
+	uint indices[];
+} uDead;
+
+// alive lists (simulated list of frame, survivors appended to other list)
+layout(std430, set = 0, binding = 3) buffer buffer3{
+	uint indices[];
+} uAlive;
+
+// counters (simulation dispatch, alive counts of lists, dead count, emitted count)
+layout(std430, set = 0, binding = 4) buffer buffer4{
+	uint simulateDispatch[3];
+	uint aliveCount;
+	uint aliveNextCount;
+	uint deadCount;
+	uint emitted;
+} uCounters;
+
+// drawn instances of frame (position and size, packed color)
+layout(std430, set = 0, binding = 5) writeonly buffer buffer5{
+	vec4 positionSize[];
+} uInstances;
+layout(std430, set = 0, binding = 6) writeonly buffer buffer6{
+	uint colors[];
+} uColors;
+
+// main
+void main()
+{
+	// alive particle of invocation
+	uint alive = gl_GlobalInvocationID.x;
+	if (alive >= uCounters.aliveCount)
+		return;
+	uint index = uAlive.indices[uParticles.aliveList * CAPACITY + alive];
+	Particle particle = uState.particles[index];
+
+	// particles past life or of removed emitters are pushed to dead list
+	float timeStep = uParticles.gravityTimeStep.w;
+	float age = particle.positionAge.w + timeStep;
+	if (particle.emitter >= uParticles.emittersCount || age >= uParticles.emitters[particle.emitter].params.x) {
+		uDead.indices[atomicAdd(uCounters.deadCount, 1)] = index;
+		return;
+	}
+
+	// integrate velocity (gravity and drag) and position
+	Emitter emitter = uParticles.emitters[particle.emitter];
+	vec3 velocity = (particle.velocity + uParticles.gravityTimeStep.xyz * timeStep) * max(1.0f - emitter.params.w * timeStep, 0.0f);
+	vec3 position = particle.positionAge.xyz + velocity * timeStep;
+	uState.particles[index].positionAge = vec4(position, age);
+	uState.particles[index].velocity = velocity;
+
+	// survivor is appended to other alive list and drawn with size and color of its age
+	uint slot = atomicAdd(uCounters.aliveNextCount, 1);
+	float t = age / emitter.params.x;
+	uAlive.indices[(uParticles.aliveList ^ 1) * CAPACITY + slot] = index;
+	uInstances.positionSize[slot] = vec4(position, mix(emitter.params.y, emitter.params.z, t));
+	uColors.colors[slot] = packUnorm4x8(mix(emitter.colorBegin, emitter.colorEnd, t));
+}
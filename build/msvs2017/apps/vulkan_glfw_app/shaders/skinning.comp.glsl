@@ -0,0 +1,61 @@
+#version 450
+
+// one invocation per vertex, one work group per job of up to group size vertices (VULKAN_SKINNING_GROUP_SIZE)
+#define GROUP_SIZE 64
+layout(local_size_x = GROUP_SIZE) in;
+
+// skinning jobs (first skin vertex, first pool vertex, vertex count, first joint matrix of palette)
+layout(std430, set = 0, binding = 0) readonly buffer buffer0{
+	uvec4 jobs[];
+} uJobs;
+
+// joint matrices of all skinned meshes
+layout(std430, set = 0, binding = 1) readonly buffer buffer1{
+	mat4 palette[];
+} uPalette;
+
+// skin vertices (bind pose, joint weights and indices)
+struct SkinVertex {
+	vec4  position;
+	vec4  normal;
+	vec4  weights;
+	uvec4 joints;
+};
+layout(std430, set = 0, binding = 2) readonly buffer buffer2{
+	SkinVertex vertices[];
+} uSkin;
+
+// geometry pool vertex buffers (positions and tightly packed normals)
+layout(std430, set = 0, binding = 3) writeonly buffer buffer3{
+	vec4 pos[];
+} uPos;
+layout(std430, set = 0, binding = 4) writeonly buffer buffer4{
+	float nrm[];
+} uNrm;
+
+// main
+void main()
+{
+	// vertex of job
+	uvec4 job = uJobs.jobs[gl_WorkGroupID.x];
+	uint index = gl_LocalInvocationIndex;
+	if (index >= job.z)
+		return;
+	SkinVertex vertex = uSkin.vertices[job.x + index];
+
+	// blend joint matrices (normals assume no non-uniform joint scale)
+	mat4 skin =
+		uPalette.palette[job.w + vertex.joints.x] * vertex.weights.x +
+		uPalette.palette[job.w + vertex.joints.y] * vertex.weights.y +
+		uPalette.palette[job.w + vertex.joints.z] * vertex.weights.z +
+		uPalette.palette[job.w + vertex.joints.w] * vertex.weights.w;
+	vec4 position = skin * vec4(vertex.position.xyz, 1.0f);
+	vec3 normal = normalize(mat3(skin) * vertex.normal.xyz);
+
+	// write skinned vertex
+	uint poolVertex = job.y + index;
+	uPos.pos[poolVertex] = vec4(position.xyz, 1.0f);
+	uNrm.nrm[poolVertex * 3 + 0] = normal.x;
+	uNrm.nrm[poolVertex * 3 + 1] = normal.y;
+	uNrm.nrm[poolVertex * 3 + 2] = normal.z;
+}
@@ -0,0 +1,75 @@
+#include "thread_pool.hpp"
+#include <cassert>
+
+// ThreadPool::ThreadPool
+ThreadPool::ThreadPool(uint32_t threadsCount)
+{
+	// check threads count
+	assert(threadsCount);
+	// start worker threads
+	for (uint32_t i = 0; i < threadsCount; i++)
+		threads.emplace_back(&ThreadPool::workerFunc, this);
+}
+
+// ThreadPool::~ThreadPool
+ThreadPool::~ThreadPool()
+{
+	// finish pending tasks and stop workers
+	{
+		std::unique_lock<std::mutex> lock(tasksMutex);
+		stopping = true;
+	}
+	tasksCondition.notify_all();
+	for (auto& thread : threads)
+		thread.join();
+	threads.clear();
+}
+
+// ThreadPool::workerFunc
+void ThreadPool::workerFunc()
+{
+	for (;;) {
+		// get next task
+		std::function<void()> task;
+		{
+			std::unique_lock<std::mutex> lock(tasksMutex);
+			tasksCondition.wait(lock, [this] { return stopping || !tasks.empty(); });
+			if (tasks.empty()) return;
+			task = std::move(tasks.front());
+			tasks.pop_front();
+			busyCount++;
+		}
+		// execute task
+		task();
+		// notify waiters when idle
+		{
+			std::unique_lock<std::mutex> lock(tasksMutex);
+			busyCount--;
+			if (tasks.empty() && busyCount == 0)
+				idleCondition.notify_all();
+		}
+	}
+}
+
+// ThreadPool::push
+void ThreadPool::push(std::function<void()> task)
+{
+	{
+		std::unique_lock<std::mutex> lock(tasksMutex);
+		tasks.push_back(std::move(task));
+	}
+	tasksCondition.notify_one();
+}
+
+// ThreadPool::wait
+void ThreadPool::wait()
+{
+	std::unique_lock<std::mutex> lock(tasksMutex);
+	idleCondition.wait(lock, [this] { return tasks.empty() && busyCount == 0; });
+}
+
+// ThreadPool::getThreadsCount
+uint32_t ThreadPool::getThreadsCount()
+{
+	return (uint32_t)threads.size();
+}
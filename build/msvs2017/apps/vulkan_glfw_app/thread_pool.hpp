@@ -0,0 +1,38 @@
+#pragma once
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <deque>
+#include <vector>
+
+// ThreadPool
+class ThreadPool {
+protected:
+	// worker threads
+	std::vector<std::thread> threads{};
+protected:
+	// task queue
+	std::deque<std::function<void()>> tasks{};
+	std::mutex                        tasksMutex{};
+	std::condition_variable           tasksCondition{};
+	std::condition_variable           idleCondition{};
+	uint32_t                          busyCount{};
+	bool                              stopping{};
+protected:
+	// worker thread function
+	void workerFunc();
+public:
+	// constructor and destructor
+	ThreadPool(uint32_t threadsCount);
+	~ThreadPool();
+
+	// push task (executed on any worker thread)
+	void push(std::function<void()> task);
+
+	// wait until all pushed tasks are complete
+	void wait();
+
+	// getters
+	uint32_t getThreadsCount();
+};
@@ -5,7 +5,7 @@
 void timeStampTick(TimeStamp& timeStamp) 
 {
 	timeStamp.prevTimePoint = timeStamp.nextTimePoint;
-	timeStamp.nextTimePoint = std::chrono::high_resolution_clock::now();
+	timeStamp.nextTimePoint = std::chrono::steady_clock::now();
 	timeStamp.deltaTime = std::chrono::duration_cast<std::chrono::duration<float>>(timeStamp.nextTimePoint - timeStamp.prevTimePoint).count();
 	timeStamp.printTime = timeStamp.printTime + timeStamp.deltaTime;
 	timeStamp.accumTime = timeStamp.accumTime + timeStamp.deltaTime;
@@ -15,8 +15,8 @@ void timeStampTick(TimeStamp& timeStamp)
 // timeStampReset
 void timeStampReset(TimeStamp& timeStamp)
 {
-	timeStamp.prevTimePoint = std::chrono::high_resolution_clock::now();
-	timeStamp.nextTimePoint = std::chrono::high_resolution_clock::now();
+	timeStamp.prevTimePoint = std::chrono::steady_clock::now();
+	timeStamp.nextTimePoint = std::chrono::steady_clock::now();
 	timeStamp.deltaTime = 0.0f;
 	timeStamp.printTime = 0.0f;
 	timeStamp.accumTime = 0.0f;
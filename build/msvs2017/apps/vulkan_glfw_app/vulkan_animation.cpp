@@ -0,0 +1,338 @@
+#include "vulkan_animation.hpp"
+#include <glm/common.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cassert>
+
+// SIMD lanes (AVX when compiled with /arch:AVX, otherwise SSE)
+#if defined(__AVX__)
+#include <immintrin.h>
+#define VULKAN_ANIMATION_LANES 8
+typedef __m256 VulkanAnimationFloats;
+#define vulkanAnimationLoad(p)      _mm256_loadu_ps(p)
+#define vulkanAnimationStore(p, a)  _mm256_storeu_ps(p, a)
+#define vulkanAnimationSet1(f)      _mm256_set1_ps(f)
+#define vulkanAnimationAdd(a, b)    _mm256_add_ps(a, b)
+#define vulkanAnimationSub(a, b)    _mm256_sub_ps(a, b)
+#define vulkanAnimationMul(a, b)    _mm256_mul_ps(a, b)
+#define vulkanAnimationDiv(a, b)    _mm256_div_ps(a, b)
+#define vulkanAnimationSqrt(a)      _mm256_sqrt_ps(a)
+#define vulkanAnimationLt(a, b)     _mm256_cmp_ps(a, b, _CMP_LT_OQ)
+#define vulkanAnimationAnd(a, b)    _mm256_and_ps(a, b)
+#define vulkanAnimationXor(a, b)    _mm256_xor_ps(a, b)
+#define vulkanAnimationZero()       _mm256_setzero_ps()
+#else
+#include <emmintrin.h>
+#define VULKAN_ANIMATION_LANES 4
+typedef __m128 VulkanAnimationFloats;
+#define vulkanAnimationLoad(p)      _mm_loadu_ps(p)
+#define vulkanAnimationStore(p, a)  _mm_storeu_ps(p, a)
+#define vulkanAnimationSet1(f)      _mm_set1_ps(f)
+#define vulkanAnimationAdd(a, b)    _mm_add_ps(a, b)
+#define vulkanAnimationSub(a, b)    _mm_sub_ps(a, b)
+#define vulkanAnimationMul(a, b)    _mm_mul_ps(a, b)
+#define vulkanAnimationDiv(a, b)    _mm_div_ps(a, b)
+#define vulkanAnimationSqrt(a)      _mm_sqrt_ps(a)
+#define vulkanAnimationLt(a, b)     _mm_cmplt_ps(a, b)
+#define vulkanAnimationAnd(a, b)    _mm_and_ps(a, b)
+#define vulkanAnimationXor(a, b)    _mm_xor_ps(a, b)
+#define vulkanAnimationZero()       _mm_setzero_ps()
+#endif
+
+// channels of pose and clips
+enum VulkanAnimationChannel {
+	VULKAN_ANIMATION_CHANNEL_TX, VULKAN_ANIMATION_CHANNEL_TY, VULKAN_ANIMATION_CHANNEL_TZ,
+	VULKAN_ANIMATION_CHANNEL_RX, VULKAN_ANIMATION_CHANNEL_RY, VULKAN_ANIMATION_CHANNEL_RZ, VULKAN_ANIMATION_CHANNEL_RW,
+	VULKAN_ANIMATION_CHANNEL_SX, VULKAN_ANIMATION_CHANNEL_SY, VULKAN_ANIMATION_CHANNEL_SZ,
+};
+
+// vulkanAnimationPadded (joints count padded to whole SIMD batches)
+static uint32_t vulkanAnimationPadded(uint32_t jointsCount)
+{
+	return (jointsCount + VULKAN_ANIMATION_JOINTS_ALIGN - 1) / VULKAN_ANIMATION_JOINTS_ALIGN * VULKAN_ANIMATION_JOINTS_ALIGN;
+}
+
+// vulkanAnimationSetIdentity (identity transforms of all joints of channels)
+static void vulkanAnimationSetIdentity(float* channels, uint32_t jointsPadded)
+{
+	for (uint32_t channel = 0; channel < VULKAN_ANIMATION_CHANNELS; channel++) {
+		float value = channel == VULKAN_ANIMATION_CHANNEL_RW || channel >= VULKAN_ANIMATION_CHANNEL_SX ? 1.0f : 0.0f;
+		std::fill(channels + channel * jointsPadded, channels + (channel + 1) * jointsPadded, value);
+	}
+}
+
+// VulkanAnimationClip::VulkanAnimationClip
+VulkanAnimationClip::VulkanAnimationClip(uint32_t jointsCount, uint32_t framesCount, float sampleRate) :
+	jointsCount(jointsCount),
+	jointsPadded(vulkanAnimationPadded(jointsCount)),
+	framesCount(std::max(framesCount, 1u)),
+	sampleRate(sampleRate)
+{
+	// identity keyframes
+	assert(sampleRate > 0.0f);
+	channels.resize((size_t)this->framesCount * VULKAN_ANIMATION_CHANNELS * jointsPadded);
+	for (uint32_t frame = 0; frame < this->framesCount; frame++)
+		vulkanAnimationSetIdentity(&channels[(size_t)frame * VULKAN_ANIMATION_CHANNELS * jointsPadded], jointsPadded);
+}
+
+// VulkanAnimationClip::setJoint
+void VulkanAnimationClip::setJoint(uint32_t frame, uint32_t joint, const glm::vec3& translation, const glm::quat& rotation, const glm::vec3& scale)
+{
+	assert(frame < framesCount && joint < jointsCount);
+	float* frameChannels = &channels[(size_t)frame * VULKAN_ANIMATION_CHANNELS * jointsPadded];
+	const float values[VULKAN_ANIMATION_CHANNELS] = {
+		translation.x, translation.y, translation.z,
+		rotation.x, rotation.y, rotation.z, rotation.w,
+		scale.x, scale.y, scale.z };
+	for (uint32_t channel = 0; channel < VULKAN_ANIMATION_CHANNELS; channel++)
+		frameChannels[channel * jointsPadded + joint] = values[channel];
+}
+
+// VulkanAnimator::VulkanAnimator
+VulkanAnimator::VulkanAnimator(const VulkanSkeleton& skeleton) :
+	skeleton(skeleton),
+	jointsCount((uint32_t)skeleton.parents.size()),
+	jointsPadded(vulkanAnimationPadded((uint32_t)skeleton.parents.size()))
+{
+	assert(skeleton.inverseBindMatrices.size() == skeleton.parents.size());
+	pose.resize((size_t)VULKAN_ANIMATION_CHANNELS * jointsPadded);
+	locals.resize((size_t)12 * jointsPadded);
+	models.resize(jointsCount);
+}
+
+// VulkanAnimator::advance
+void VulkanAnimator::advance(float deltaTime)
+{
+	// loop times by clip durations
+	for (uint32_t layerIndex = 0; layerIndex < layersCount; layerIndex++) {
+		VulkanAnimationLayer& layer = layers[layerIndex];
+		if (!layer.clip) continue;
+		float duration = layer.clip->getDuration();
+		layer.time += deltaTime * layer.speed;
+		if (duration > 0.0f) {
+			layer.time = std::fmod(layer.time, duration);
+			if (layer.time < 0.0f)
+				layer.time += duration;
+		}
+		else layer.time = 0.0f;
+	}
+}
+
+// VulkanAnimator::evaluate
+void VulkanAnimator::evaluate(glm::mat4* palette)
+{
+	// total weight of layers playing clips of skeleton
+	float weightSum = 0.0f;
+	for (uint32_t layerIndex = 0; layerIndex < layersCount; layerIndex++) {
+		const VulkanAnimationLayer& layer = layers[layerIndex];
+		if (layer.clip && layer.weight > 0.0f && layer.clip->getJointsCount() == jointsCount)
+			weightSum += layer.weight;
+	}
+	if (weightSum <= 0.0f) {
+		// bind pose
+		for (uint32_t joint = 0; joint < jointsCount; joint++)
+			palette[joint] = glm::mat4(1.0f);
+		return;
+	}
+
+	// sample keyframes and accumulate weighted layers (rotations in hemisphere of accumulated rotation)
+	VulkanAnimationFloats signMask = vulkanAnimationSet1(-0.0f);
+	bool accumulated = false;
+	for (uint32_t layerIndex = 0; layerIndex < layersCount; layerIndex++) {
+		const VulkanAnimationLayer& layer = layers[layerIndex];
+		if (!layer.clip || layer.weight <= 0.0f || layer.clip->getJointsCount() != jointsCount) continue;
+		float frame = glm::clamp(layer.time * layer.clip->getSampleRate(), 0.0f, (float)(layer.clip->getFramesCount() - 1));
+		uint32_t frame0 = (uint32_t)frame;
+		uint32_t frame1 = std::min(frame0 + 1, layer.clip->getFramesCount() - 1);
+		const float* channels0 = layer.clip->getFrame(frame0);
+		const float* channels1 = layer.clip->getFrame(frame1);
+		VulkanAnimationFloats alpha = vulkanAnimationSet1(frame - (float)frame0);
+		VulkanAnimationFloats weight = vulkanAnimationSet1(layer.weight / weightSum);
+
+		for (uint32_t first = 0; first < jointsPadded; first += VULKAN_ANIMATION_LANES) {
+			// interpolated channels of keyframes (second rotation in hemisphere of first)
+			VulkanAnimationFloats samples[VULKAN_ANIMATION_CHANNELS];
+			VulkanAnimationFloats dot = vulkanAnimationZero();
+			for (uint32_t channel = VULKAN_ANIMATION_CHANNEL_RX; channel <= VULKAN_ANIMATION_CHANNEL_RW; channel++)
+				dot = vulkanAnimationAdd(dot, vulkanAnimationMul(
+					vulkanAnimationLoad(channels0 + channel * jointsPadded + first),
+					vulkanAnimationLoad(channels1 + channel * jointsPadded + first)));
+			VulkanAnimationFloats flip = vulkanAnimationAnd(vulkanAnimationLt(dot, vulkanAnimationZero()), signMask);
+			for (uint32_t channel = 0; channel < VULKAN_ANIMATION_CHANNELS; channel++) {
+				VulkanAnimationFloats value0 = vulkanAnimationLoad(channels0 + channel * jointsPadded + first);
+				VulkanAnimationFloats value1 = vulkanAnimationLoad(channels1 + channel * jointsPadded + first);
+				if (channel >= VULKAN_ANIMATION_CHANNEL_RX && channel <= VULKAN_ANIMATION_CHANNEL_RW)
+					value1 = vulkanAnimationXor(value1, flip);
+				samples[channel] = vulkanAnimationAdd(value0, vulkanAnimationMul(vulkanAnimationSub(value1, value0), alpha));
+			}
+
+			// weighted sum into pose (rotation in hemisphere of accumulated rotation)
+			if (accumulated) {
+				dot = vulkanAnimationZero();
+				for (uint32_t channel = VULKAN_ANIMATION_CHANNEL_RX; channel <= VULKAN_ANIMATION_CHANNEL_RW; channel++)
+					dot = vulkanAnimationAdd(dot, vulkanAnimationMul(vulkanAnimationLoad(&pose[channel * jointsPadded + first]), samples[channel]));
+				flip = vulkanAnimationAnd(vulkanAnimationLt(dot, vulkanAnimationZero()), signMask);
+				for (uint32_t channel = VULKAN_ANIMATION_CHANNEL_RX; channel <= VULKAN_ANIMATION_CHANNEL_RW; channel++)
+					samples[channel] = vulkanAnimationXor(samples[channel], flip);
+			}
+			for (uint32_t channel = 0; channel < VULKAN_ANIMATION_CHANNELS; channel++) {
+				float* target = &pose[channel * jointsPadded + first];
+				VulkanAnimationFloats value = vulkanAnimationMul(samples[channel], weight);
+				vulkanAnimationStore(target, accumulated ? vulkanAnimationAdd(vulkanAnimationLoad(target), value) : value);
+			}
+		}
+		accumulated = true;
+	}
+
+	// local 3x4 matrices of blended pose (normalized rotation, translation * rotation * scale)
+	auto channel = [this](uint32_t channelIndex, uint32_t first) { return vulkanAnimationLoad(&pose[channelIndex * jointsPadded + first]); };
+	auto store = [this](uint32_t element, uint32_t first, VulkanAnimationFloats value) { vulkanAnimationStore(&locals[element * jointsPadded + first], value); };
+	VulkanAnimationFloats one = vulkanAnimationSet1(1.0f);
+	for (uint32_t first = 0; first < jointsPadded; first += VULKAN_ANIMATION_LANES) {
+		VulkanAnimationFloats qx = channel(VULKAN_ANIMATION_CHANNEL_RX, first);
+		VulkanAnimationFloats qy = channel(VULKAN_ANIMATION_CHANNEL_RY, first);
+		VulkanAnimationFloats qz = channel(VULKAN_ANIMATION_CHANNEL_RZ, first);
+		VulkanAnimationFloats qw = channel(VULKAN_ANIMATION_CHANNEL_RW, first);
+		VulkanAnimationFloats length = vulkanAnimationSqrt(vulkanAnimationAdd(
+			vulkanAnimationAdd(vulkanAnimationMul(qx, qx), vulkanAnimationMul(qy, qy)),
+			vulkanAnimationAdd(vulkanAnimationMul(qz, qz), vulkanAnimationMul(qw, qw))));
+		VulkanAnimationFloats scale2 = vulkanAnimationDiv(vulkanAnimationSet1(2.0f), vulkanAnimationMul(length, length));
+		VulkanAnimationFloats xx = vulkanAnimationMul(vulkanAnimationMul(qx, qx), scale2);
+		VulkanAnimationFloats yy = vulkanAnimationMul(vulkanAnimationMul(qy, qy), scale2);
+		VulkanAnimationFloats zz = vulkanAnimationMul(vulkanAnimationMul(qz, qz), scale2);
+		VulkanAnimationFloats xy = vulkanAnimationMul(vulkanAnimationMul(qx, qy), scale2);
+		VulkanAnimationFloats xz = vulkanAnimationMul(vulkanAnimationMul(qx, qz), scale2);
+		VulkanAnimationFloats yz = vulkanAnimationMul(vulkanAnimationMul(qy, qz), scale2);
+		VulkanAnimationFloats wx = vulkanAnimationMul(vulkanAnimationMul(qw, qx), scale2);
+		VulkanAnimationFloats wy = vulkanAnimationMul(vulkanAnimationMul(qw, qy), scale2);
+		VulkanAnimationFloats wz = vulkanAnimationMul(vulkanAnimationMul(qw, qz), scale2);
+		VulkanAnimationFloats sx = channel(VULKAN_ANIMATION_CHANNEL_SX, first);
+		VulkanAnimationFloats sy = channel(VULKAN_ANIMATION_CHANNEL_SY, first);
+		VulkanAnimationFloats sz = channel(VULKAN_ANIMATION_CHANNEL_SZ, first);
+		// rows of rotation with scaled columns, translation in last column
+		store(0, first, vulkanAnimationMul(vulkanAnimationSub(one, vulkanAnimationAdd(yy, zz)), sx));
+		store(1, first, vulkanAnimationMul(vulkanAnimationSub(xy, wz), sy));
+		store(2, first, vulkanAnimationMul(vulkanAnimationAdd(xz, wy), sz));
+		store(3, first, channel(VULKAN_ANIMATION_CHANNEL_TX, first));
+		store(4, first, vulkanAnimationMul(vulkanAnimationAdd(xy, wz), sx));
+		store(5, first, vulkanAnimationMul(vulkanAnimationSub(one, vulkanAnimationAdd(xx, zz)), sy));
+		store(6, first, vulkanAnimationMul(vulkanAnimationSub(yz, wx), sz));
+		store(7, first, channel(VULKAN_ANIMATION_CHANNEL_TY, first));
+		store(8, first, vulkanAnimationMul(vulkanAnimationSub(xz, wy), sx));
+		store(9, first, vulkanAnimationMul(vulkanAnimationAdd(yz, wx), sy));
+		store(10, first, vulkanAnimationMul(vulkanAnimationSub(one, vulkanAnimationAdd(xx, yy)), sz));
+		store(11, first, channel(VULKAN_ANIMATION_CHANNEL_TZ, first));
+	}
+
+	// model space transforms down hierarchy and palette (joint transform times inverse bind matrix)
+	for (uint32_t joint = 0; joint < jointsCount; joint++) {
+		glm::mat4 local(1.0f);
+		for (uint32_t row = 0; row < 3; row++)
+			for (uint32_t column = 0; column < 4; column++)
+				local[column][row] = locals[(row * 4 + column) * jointsPadded + joint];
+		int32_t parent = skeleton.parents[joint];
+		assert(parent < (int32_t)joint);
+		models[joint] = parent >= 0 ? models[parent] * local : local;
+		palette[joint] = models[joint] * skeleton.inverseBindMatrices[joint];
+	}
+}
+
+// VulkanAnimator::evaluateReference
+void VulkanAnimator::evaluateReference(glm::mat4* palette) const
+{
+	// total weight of layers playing clips of skeleton
+	float weightSum = 0.0f;
+	for (uint32_t layerIndex = 0; layerIndex < layersCount; layerIndex++) {
+		const VulkanAnimationLayer& layer = layers[layerIndex];
+		if (layer.clip && layer.weight > 0.0f && layer.clip->getJointsCount() == jointsCount)
+			weightSum += layer.weight;
+	}
+	if (weightSum <= 0.0f) {
+		// bind pose
+		for (uint32_t joint = 0; joint < jointsCount; joint++)
+			palette[joint] = glm::mat4(1.0f);
+		return;
+	}
+
+	// per joint pose (same keyframe interpolation and hemisphere rules as SIMD evaluate)
+	std::vector<glm::mat4> jointModels(jointsCount);
+	for (uint32_t joint = 0; joint < jointsCount; joint++) {
+		glm::vec3 translation(0.0f), scale(0.0f);
+		glm::quat rotation(0.0f, 0.0f, 0.0f, 0.0f);
+		bool accumulated = false;
+		for (uint32_t layerIndex = 0; layerIndex < layersCount; layerIndex++) {
+			const VulkanAnimationLayer& layer = layers[layerIndex];
+			if (!layer.clip || layer.weight <= 0.0f || layer.clip->getJointsCount() != jointsCount) continue;
+			float frame = glm::clamp(layer.time * layer.clip->getSampleRate(), 0.0f, (float)(layer.clip->getFramesCount() - 1));
+			uint32_t frame0 = (uint32_t)frame;
+			uint32_t frame1 = std::min(frame0 + 1, layer.clip->getFramesCount() - 1);
+			float alpha = frame - (float)frame0;
+			float values[2][VULKAN_ANIMATION_CHANNELS];
+			for (uint32_t channel = 0; channel < VULKAN_ANIMATION_CHANNELS; channel++) {
+				values[0][channel] = layer.clip->getFrame(frame0)[channel * jointsPadded + joint];
+				values[1][channel] = layer.clip->getFrame(frame1)[channel * jointsPadded + joint];
+			}
+			glm::vec3 t0(values[0][0], values[0][1], values[0][2]), t1(values[1][0], values[1][1], values[1][2]);
+			glm::quat r0(values[0][6], values[0][3], values[0][4], values[0][5]), r1(values[1][6], values[1][3], values[1][4], values[1][5]);
+			glm::vec3 s0(values[0][7], values[0][8], values[0][9]), s1(values[1][7], values[1][8], values[1][9]);
+			if (glm::dot(r0, r1) < 0.0f)
+				r1 = -r1;
+			glm::quat sampleRotation = r0 + (r1 - r0) * alpha;
+			if (accumulated && glm::dot(rotation, sampleRotation) < 0.0f)
+				sampleRotation = -sampleRotation;
+			float weight = layer.weight / weightSum;
+			translation += (t0 + (t1 - t0) * alpha) * weight;
+			rotation = rotation + sampleRotation * weight;
+			scale += (s0 + (s1 - s0) * alpha) * weight;
+			accumulated = true;
+		}
+		// local transform (translation * rotation * scale) down hierarchy
+		glm::mat4 local = glm::scale(glm::translate(glm::mat4(1.0f), translation) * glm::mat4_cast(glm::normalize(rotation)), scale);
+		int32_t parent = skeleton.parents[joint];
+		jointModels[joint] = parent >= 0 ? jointModels[parent] * local : local;
+		palette[joint] = jointModels[joint] * skeleton.inverseBindMatrices[joint];
+	}
+}
+
+// VulkanAnimator::validate
+bool VulkanAnimator::validate(float epsilon)
+{
+	// SIMD palette against reference palette
+	std::vector<glm::mat4> palette(jointsCount), paletteReference(jointsCount);
+	evaluate(palette.data());
+	evaluateReference(paletteReference.data());
+	for (uint32_t joint = 0; joint < jointsCount; joint++)
+		for (uint32_t column = 0; column < 4; column++)
+			for (uint32_t row = 0; row < 4; row++) {
+				float reference = paletteReference[joint][column][row];
+				if (std::abs(palette[joint][column][row] - reference) > epsilon * std::max(1.0f, std::abs(reference)))
+					return false;
+			}
+	return true;
+}
+
+// VulkanAnimation::evaluate
+void VulkanAnimation::evaluate(const std::vector<VulkanAnimationTask>& tasks, ThreadPool* threadPool)
+{
+	// few animators are evaluated on calling thread
+	size_t threadsCount = threadPool ? threadPool->getThreadsCount() : 1;
+	size_t tasksThreadsCount = std::min(threadsCount, tasks.size() / threadAnimatorsMin);
+	if (tasksThreadsCount <= 1) {
+		for (auto& task : tasks)
+			task.animator->evaluate(task.palette);
+		return;
+	}
+
+	// contiguous ranges of animators per worker thread (animators and palettes are disjoint)
+	size_t first = 0;
+	for (size_t threadIndex = 0; threadIndex < tasksThreadsCount; threadIndex++) {
+		size_t count = (tasks.size() - first) / (tasksThreadsCount - threadIndex);
+		threadPool->push([&tasks, first, count]() {
+			for (size_t i = first; i < first + count; i++)
+				tasks[i].animator->evaluate(tasks[i].palette);
+		});
+		first += count;
+	}
+	threadPool->wait();
+}
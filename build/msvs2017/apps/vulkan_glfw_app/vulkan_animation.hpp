@@ -0,0 +1,108 @@
+#pragma once
+
+#include "thread_pool.hpp"
+#include <glm/vec3.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <vector>
+
+// max blended clips per animator
+#define VULKAN_ANIMATION_MAX_LAYERS 4
+
+// channels per joint (translation xyz, rotation xyzw, scale xyz)
+#define VULKAN_ANIMATION_CHANNELS 10
+
+// joint arrays are padded to whole SIMD batches (SSE and AVX)
+#define VULKAN_ANIMATION_JOINTS_ALIGN 8
+
+// VulkanSkeleton (joint hierarchy and bind pose)
+struct VulkanSkeleton {
+	std::vector<int32_t>   parents{};             // parent joint (-1 for roots, parents precede children)
+	std::vector<glm::mat4> inverseBindMatrices{}; // model space to joint space of bind pose
+};
+
+// VulkanAnimationClip (local joint transforms sampled at fixed rate, structure of arrays per keyframe)
+class VulkanAnimationClip {
+protected:
+	// joints and keyframes
+	uint32_t jointsCount{};
+	uint32_t jointsPadded{};
+	uint32_t framesCount{};
+	float    sampleRate{};
+	// channels [(frame * VULKAN_ANIMATION_CHANNELS + channel) * jointsPadded + joint] (padding joints are identity)
+	std::vector<float> channels{};
+public:
+	// constructor (all keyframes are identity)
+	VulkanAnimationClip(uint32_t jointsCount, uint32_t framesCount, float sampleRate);
+
+	// set local transform of joint at keyframe
+	void setJoint(uint32_t frame, uint32_t joint, const glm::vec3& translation, const glm::quat& rotation, const glm::vec3& scale);
+
+	// getters
+	const float* getFrame(uint32_t frame) const { return &channels[(size_t)frame * VULKAN_ANIMATION_CHANNELS * jointsPadded]; }
+	uint32_t getJointsCount() const { return jointsCount; }
+	uint32_t getFramesCount() const { return framesCount; }
+	float getSampleRate() const { return sampleRate; }
+	float getDuration() const { return (float)(framesCount - 1) / sampleRate; }
+};
+
+// VulkanAnimationLayer (clip played by animator)
+struct VulkanAnimationLayer {
+	const VulkanAnimationClip* clip;
+	float                      time;   // seconds (looped by clip duration)
+	float                      speed;  // time scale of advance
+	float                      weight; // blend weight (normalized over layers)
+};
+
+// VulkanAnimator (animation state of one skinned character, evaluated by one thread at a time)
+class VulkanAnimator {
+protected:
+	// skeleton
+	const VulkanSkeleton& skeleton;
+	uint32_t              jointsCount{};
+	uint32_t              jointsPadded{};
+protected:
+	// blended local pose and local 3x4 matrices (structure of arrays, channels and matrix elements by rows)
+	std::vector<float> pose{};
+	std::vector<float> locals{};
+	// model space joint transforms
+	std::vector<glm::mat4> models{};
+public:
+	// played clips
+	VulkanAnimationLayer layers[VULKAN_ANIMATION_MAX_LAYERS]{};
+	uint32_t             layersCount{};
+public:
+	// constructor
+	VulkanAnimator(const VulkanSkeleton& skeleton);
+
+	// advance times of layers
+	void advance(float deltaTime);
+
+	// sample and blend layers into joint matrices palette (joints count matrices, bind pose without weighted layers)
+	void evaluate(glm::mat4* palette);
+
+	// sample and blend layers with scalar math (reference of SIMD evaluate, scratch of animator is not used)
+	void evaluateReference(glm::mat4* palette) const;
+
+	// compare palettes of evaluate and reference evaluate of current layers (tolerance relative to element magnitude)
+	bool validate(float epsilon);
+
+	// getters
+	uint32_t getJointsCount() const { return jointsCount; }
+};
+
+// VulkanAnimationTask (animator evaluated into palette)
+struct VulkanAnimationTask {
+	VulkanAnimator* animator;
+	glm::mat4*      palette;
+};
+
+// VulkanAnimation (animators evaluated in parallel on worker threads of caller)
+class VulkanAnimation {
+protected:
+	// animators per worker thread
+	uint32_t threadAnimatorsMin = 4;
+public:
+	// evaluate tasks of distinct animators on idle thread pool (calling thread without pool, returns when all palettes are written)
+	void evaluate(const std::vector<VulkanAnimationTask>& tasks, ThreadPool* threadPool);
+};
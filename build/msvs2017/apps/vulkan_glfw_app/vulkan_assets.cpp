@@ -4,6 +4,7 @@
 #include "vulkan_geometry.hpp"
 #include <tiny_obj_loader.h>
 #include <algorithm>
+#include <cfloat>
 
 // VulkanAssetManager::VulkanAssetManager
 VulkanAssetManager::VulkanAssetManager(VulkanContext& context)
@@ -22,10 +23,8 @@ VulkanAssetManager::~VulkanAssetManager()
 		delete mesh_group;
 	meshGroups.clear();
 	// destroy meshes
-	for (auto mesh_item : meshItems) {
+	for (auto mesh_item : meshItems)
 		delete mesh_item->mesh;
-		delete mesh_item->meshDebug;
-	};
 	meshItems.clear();
 	// destroy materials
 	for (auto material_item : materialItems)
@@ -111,7 +110,7 @@ void VulkanAssetManager::addImageFromfile(const std::string fileName) {
 	// add if not exist
 	if (!isImageExist(fileName)) {
 		VulkanImage* image = new VulkanImage;
-		loadImageFromFile(context.device, *image, fileName);
+		loadImageFromFile(context.device, *image, fileName, context.transfer);
 		imageItems.push_back(new VulkanImageItem(fileName, image));
 	}
 }
@@ -155,7 +154,7 @@ void VulkanAssetManager::addMesh(const std::string name, VulkanMeshMatObj* mesh)
 	assert(name.size() > 0);
 	// add if not exist
 	if (!isImageExist(name))
-		meshItems.push_back(new VulkanMeshItem(name, mesh, nullptr));
+		meshItems.push_back(new VulkanMeshItem(name, mesh));
 }
 
 // VulkanAssetManager::addMeshGroup
@@ -251,8 +250,6 @@ VulkanModel* VulkanAssetManager::createModelByMeshNames(const std::vector<std::s
 			if (mesh_item->name == name) {
 				if (mesh_item->mesh) 
 					model->meshes.push_back(mesh_item->mesh);
-				if (mesh_item->meshDebug) 
-					model->meshes_debug.push_back(mesh_item->meshDebug);
 			}
 		}
 	}
@@ -270,8 +267,6 @@ VulkanModel* VulkanAssetManager::createModelByMeshGroupName(const std::string na
 		for (auto& mesh_item : mesh_group->meshes) {
 			if (mesh_item->mesh) 
 				model->meshes.push_back(mesh_item->mesh);
-			if (mesh_item->meshDebug) 
-				model->meshes_debug.push_back(mesh_item->meshDebug);
 		}
 		return model;
 	}
@@ -282,21 +277,47 @@ VulkanModel* VulkanAssetManager::createModelByMeshGroupName(const std::string na
 std::vector<std::string> VulkanAssetManager::loadFromFileObj(
 	const std::string fileName,
 	const std::string basePath)
+{
+	// parse obj file
+	VulkanObjData objData{};
+	parseFromFileObj(fileName, basePath, objData);
+
+	// upload images and meshes in one transfer
+	bool uploads = context.beginUploads();
+	std::vector<std::string> mesh_names = loadFromObjData(objData);
+	if (uploads) context.endUploads();
+	return mesh_names;
+}
+
+// VulkanAssetManager::parseFromFileObj
+void VulkanAssetManager::parseFromFileObj(
+	const std::string fileName,
+	const std::string basePath,
+	VulkanObjData&    objData)
 {
 	// load and parse obj file
 	std::string warm, err;
 	tinyobj::attrib_t attribs;
 	std::vector<tinyobj::shape_t> shapes;
-	std::vector<tinyobj::material_t> materials;
-	tinyobj::LoadObj(&attribs, &shapes, &materials, &warm, &err, fileName.data(), basePath.data(), true);
+	tinyobj::LoadObj(&attribs, &shapes, &objData.materials, &warm, &err, fileName.data(), basePath.data(), true);
 	assert(shapes.size() > 0);
-
-	// load materials
-	for (const auto& material_obj : materials)
-		addMeterialFromObj(basePath, material_obj);
+	objData.fileName = fileName;
+	objData.basePath = basePath;
+
+	// decode material images
+	for (const auto& material_obj : objData.materials) {
+		if (material_obj.diffuse_texname.size() > 0) {
+			std::string imageDiffuseFilePath = basePath + material_obj.diffuse_texname;
+			if (objData.images.find(imageDiffuseFilePath) == objData.images.end()) {
+				VulkanImageData imageData{};
+				decodeImageFromFile(imageData, imageDiffuseFilePath);
+				if (imageData.pixels) objData.images[imageDiffuseFilePath] = imageData;
+			}
+		}
+	}
 
 	// find min and max
-	glm::vec3 maxPos = glm::vec3(FLT_MIN);
+	glm::vec3 maxPos = glm::vec3(-FLT_MAX);
 	glm::vec3 minPos = glm::vec3(FLT_MAX);
 	for (const auto& shape : shapes)
 	{
@@ -314,35 +335,21 @@ std::vector<std::string> VulkanAssetManager::loadFromFileObj(
 	glm::vec3 lengthPos = maxPos - minPos;
 	float scale = 1.0f / (std::max(std::max(lengthPos.x, lengthPos.y), lengthPos.z)*0.5f);
 
-	// mesh names
-	std::vector<std::string> mesh_names;
-
-	// allocate buffers mesh
-	std::vector<glm::vec4> vectorPos{};
-	std::vector<glm::vec3> vectorNrm{};
-	std::vector<glm::vec3> vectorTan{};
-	std::vector<glm::vec3> vectorBit{};
-	std::vector<glm::vec2> vectorTex{};
-	// allocate buffers normals
-	std::vector<glm::vec4> vectorNrmPos{};
-	std::vector<glm::vec4> vectorNrmCol{};
-	for (const auto& shape : shapes)
+	// shapes (debug lines of normals and tangent space are generated by renderer when shown)
+	objData.shapes.resize(shapes.size());
+	for (size_t s = 0; s < shapes.size(); s++)
 	{
+		// shape and its mesh buffers
+		const auto& shape = shapes[s];
+		VulkanObjShapeData& shapeData = objData.shapes[s];
+		VulkanHostVector<glm::vec4>& vectorPos = shapeData.vectorPos;
+		VulkanHostVector<glm::vec3>& vectorNrm = shapeData.vectorNrm;
+		VulkanHostVector<glm::vec2>& vectorTex = shapeData.vectorTex;
+
 		// prepare containers
-		vectorPos.clear();
-		vectorNrm.clear();
-		vectorTan.clear();
-		vectorBit.clear();
-		vectorTex.clear();
-		vectorNrmPos.clear();
-		vectorNrmCol.clear();
 		vectorPos.reserve(shape.mesh.indices.size());
 		vectorNrm.reserve(shape.mesh.indices.size());
-		vectorTan.reserve(shape.mesh.indices.size());
-		vectorBit.reserve(shape.mesh.indices.size());
 		vectorTex.reserve(shape.mesh.indices.size());
-		vectorNrmPos.reserve(shape.mesh.indices.size() * 2 * 3);
-		vectorNrmCol.reserve(shape.mesh.indices.size() * 2 * 3);
 
 		// create buffers
 		for (tinyobj::index_t index : shape.mesh.indices)
@@ -371,56 +378,69 @@ std::vector<std::string> VulkanAssetManager::loadFromFileObj(
 			else vectorTex.push_back(glm::vec2(0.0f, 0.0f));
 		}
 
-		// calculate bi-normal and tangent
-		calcTangentSpace(vectorPos, vectorTex, vectorNrm, vectorTan, vectorBit);
-
-		// add normals, tangents and bi-normals
-		for (size_t i = 0; i < vectorPos.size(); i++) {
-			vectorNrmPos.push_back(vectorPos[i]);
-			vectorNrmPos.push_back(vectorPos[i] + glm::vec4(vectorNrm[i] * 0.05f, 1.0f));
-			vectorNrmCol.push_back(glm::vec4(1.0f, 0.0f, 0.0f, 1.0f));
-			vectorNrmCol.push_back(glm::vec4(1.0f, 0.0f, 0.0f, 1.0f));
-
-			vectorNrmPos.push_back(vectorPos[i]);
-			vectorNrmPos.push_back(vectorPos[i] + glm::vec4(vectorTan[i] * 0.05f, 1.0f));
-			vectorNrmCol.push_back(glm::vec4(0.0f, 1.0f, 0.0f, 1.0f));
-			vectorNrmCol.push_back(glm::vec4(0.0f, 1.0f, 0.0f, 1.0f));
-
-			vectorNrmPos.push_back(vectorPos[i]);
-			vectorNrmPos.push_back(vectorPos[i] + glm::vec4(vectorBit[i] * 0.05f, 1.0f));
-			vectorNrmCol.push_back(glm::vec4(0.0f, 0.0f, 1.0f, 1.0f));
-			vectorNrmCol.push_back(glm::vec4(0.0f, 0.0f, 1.0f, 1.0f));
-		}
+		// simplified levels of detail (appended to vectors), welded into indexed vertices shared by levels
+		calcMeshLods(vectorPos, vectorTex, vectorNrm, shapeData.lods);
+		calcWeldedVertices(vectorPos, vectorTex, vectorNrm, shapeData.vectorInd, shapeData.lods);
+
+		// meshlets (full resolution indices are reordered)
+		calcMeshlets(vectorPos, vectorNrm, shapeData.vectorInd, shapeData.lods[0].indexCount, shapeData.meshlets);
 
 		// get material name
-		std::string materialName = "";
+		shapeData.name = shape.name;
 		if (shape.mesh.material_ids[0] >= 0)
-			materialName = materials[shape.mesh.material_ids[0]].name;
+			shapeData.materialName = objData.materials[shape.mesh.material_ids[0]].name;
+	}
+}
+
+// VulkanAssetManager::loadFromObjData
+std::vector<std::string> VulkanAssetManager::loadFromObjData(
+	VulkanObjData& objData)
+{
+	// upload decoded images (image data is released)
+	for (auto& image : objData.images) {
+		if (!isImageExist(image.first)) {
+			VulkanImage* vulkanImage = new VulkanImage;
+			createImageFromData(context.device, *vulkanImage, image.second, context.transfer);
+			addImage(image.first, vulkanImage);
+		}
+		freeImageData(image.second);
+	}
+	objData.images.clear();
 
+	// load materials
+	for (const auto& material_obj : objData.materials)
+		addMeterialFromObj(objData.basePath, material_obj);
+
+	// mesh names
+	std::vector<std::string> mesh_names;
+	for (auto& shapeData : objData.shapes)
+	{
 		// get image from material
-		VulkanMaterial* material = getMaterialByName(materialName);
+		VulkanMaterial* material = getMaterialByName(shapeData.materialName);
 		if (!material) material = defaultMaterial;
 
-		// create mesh
-		VulkanMeshMatObj* mesh = new VulkanMeshMatObj(context,
-			vectorPos, vectorTex, vectorNrm);
+		// skip shapes without triangles
+		if (shapeData.vectorPos.empty())
+			continue;
+
+		// create mesh (corners stay unwelded and non-indexed when attributes are missing)
+		VulkanMeshMatObj* mesh = shapeData.vectorInd.empty() ?
+			new VulkanMeshMatObj(context, shapeData.vectorPos, shapeData.vectorTex, shapeData.vectorNrm) :
+			new VulkanMeshMatObjIndexed(context, shapeData.vectorPos, shapeData.vectorTex, shapeData.vectorNrm, shapeData.vectorInd);
+		mesh->setLods(shapeData.lods);
+		mesh->setMeshlets(shapeData.meshlets);
 		mesh->material = material;
 		mesh->materialUsage = VULKAN_MATERIAL_USAGE_COLOR_TEXTURE;
 		mesh->primitiveTopology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
 		//mesh->materialUsage = VULKAN_MATERIAL_USAGE_COLOR;
 
-		// create debug mesh
-		//VulkanMeshMatObj* mesh_debug = new VulkanMesh_color(
-		//	context, VK_PRIMITIVE_TOPOLOGY_LINE_LIST,
-		//	vectorNrmPos, vectorNrmCol);
-
 		// create and add mesh item
-		VulkanMeshItem* mesh_item = new VulkanMeshItem(shape.name, mesh, nullptr);
+		VulkanMeshItem* mesh_item = new VulkanMeshItem(shapeData.name, mesh);
 		meshItems.push_back(mesh_item);
 
 		// store local meshes
-		mesh_names.push_back(shape.name);
+		mesh_names.push_back(shapeData.name);
 	}
-	addMeshGroup(fileName, mesh_names);
+	addMeshGroup(objData.fileName, mesh_names);
 	return mesh_names;
 }
\ No newline at end of file
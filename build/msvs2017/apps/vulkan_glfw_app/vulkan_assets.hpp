@@ -1,6 +1,8 @@
 #pragma once
 #include "vulkan_renderer.hpp"
+#include "vulkan_loaders.hpp"
 #include <tiny_obj_loader.h>
+#include <map>
 
 // VulkanContext
 class VulkanContext;
@@ -27,14 +29,11 @@ struct VulkanMaterialItem {
 struct VulkanMeshItem {
 	std::string          name{};
 	VulkanMeshMatObj* mesh{};
-	VulkanMeshMatObj* meshDebug{};
 	VulkanMeshItem(
 		std::string       name,
-		VulkanMeshMatObj* mesh,
-		VulkanMeshMatObj* meshDebug) :
+		VulkanMeshMatObj* mesh) :
 		name(name),
-		mesh(mesh),
-		meshDebug(meshDebug) {}
+		mesh(mesh) {}
 };
 
 // VulkanMeshGroup
@@ -45,6 +44,29 @@ struct VulkanMeshGroup {
 	VulkanMeshGroup(std::string name) :	name(name) {};
 };
 
+// VulkanObjShapeData
+struct VulkanObjShapeData {
+	std::string                 name{};
+	std::string                 materialName{};
+	VulkanHostVector<glm::vec4> vectorPos{};
+	VulkanHostVector<glm::vec3> vectorNrm{};
+	VulkanHostVector<glm::vec2> vectorTex{};
+	VulkanHostVector<uint32_t>  vectorInd{};
+	// levels of detail (indices hold full resolution followed by simplified levels)
+	std::vector<VulkanMeshLod>  lods{};
+	// meshlets of full resolution level
+	std::vector<VulkanMeshlet>  meshlets{};
+};
+
+// VulkanObjData (parsed obj file, ready for upload)
+struct VulkanObjData {
+	std::string                            fileName{};
+	std::string                            basePath{};
+	std::vector<tinyobj::material_t>       materials{};
+	std::map<std::string, VulkanImageData> images{};
+	std::vector<VulkanObjShapeData>        shapes{};
+};
+
 // VulkanAssetManager
 class VulkanAssetManager {
 protected:
@@ -101,4 +123,8 @@ public:
 
 	// load obj file
 	std::vector<std::string> loadFromFileObj(const std::string fileName, const std::string basePath);
+
+	// load obj file in two stages: parse (no device access, any thread) and upload (render thread)
+	static void parseFromFileObj(const std::string fileName, const std::string basePath, VulkanObjData& objData);
+	std::vector<std::string> loadFromObjData(VulkanObjData& objData);
 };
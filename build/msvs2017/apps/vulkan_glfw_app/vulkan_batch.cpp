@@ -0,0 +1,299 @@
+#include "vulkan_batch.hpp"
+#include "vulkan_loaders.hpp"
+#include "time_measure.hpp"
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+// VulkanBatchJobState
+struct VulkanBatchJobState {
+	const VulkanBatchJob* job{};
+	VulkanObjData         objData{};
+	bool                  parsed{};
+	VulkanAssetManager*   assetManager{};
+	VulkanModel*          model{};
+	uint32_t              framesRemaining{};
+};
+
+// VulkanBatchFrameState
+struct VulkanBatchFrameState {
+	VulkanBatchRenderer*     batchRenderer{};
+	VulkanBatchJobState*     jobState{};
+	VulkanScene*             scene{};
+	std::vector<std::string> outputFileNames{};
+};
+
+// VulkanBatchRenderer::VulkanBatchRenderer
+VulkanBatchRenderer::VulkanBatchRenderer(
+	VulkanContext& context,
+	uint32_t       width,
+	uint32_t       height,
+	uint32_t       framesInFlight,
+	uint32_t       viewsCount,
+	uint32_t       loadThreadsCount,
+	uint32_t       encodeThreadsCount) :
+	context(context)
+{
+	// create offscreen renderer and thread pools
+	renderer = new VulkanRenderer_offscreen(context, width, height, framesInFlight, viewsCount);
+	renderer->setReadbackFunc(readbackFunc);
+	loadThreadPool = new ThreadPool(loadThreadsCount);
+	encodeThreadPool = new ThreadPool(encodeThreadsCount);
+	loadAheadCount = loadThreadsCount * 2;
+
+	// create upload transfers (one more than frames in flight, so next job records while older uploads run)
+	transfers.resize(framesInFlight + 1);
+	for (auto& transfer : transfers)
+		vulkanTransferCreate(context.device, &transfer);
+}
+
+// VulkanBatchRenderer::~VulkanBatchRenderer
+VulkanBatchRenderer::~VulkanBatchRenderer()
+{
+	// destroy handles
+	delete encodeThreadPool;
+	delete loadThreadPool;
+	delete renderer;
+
+	// destroy scenes and transfers (device is idle after renderer)
+	for (auto scene : scenes)
+		delete scene;
+	scenes.clear();
+	freeScenes.clear();
+	for (auto& transfer : transfers)
+		vulkanTransferDestroy(context.device, transfer);
+	transfers.clear();
+}
+
+// VulkanBatchRenderer::acquireScene
+VulkanScene* VulkanBatchRenderer::acquireScene()
+{
+	// reuse scene of completed frame or create new one
+	if (freeScenes.empty()) {
+		scenes.push_back(new VulkanScene(context));
+		return scenes.back();
+	}
+	VulkanScene* scene = freeScenes.back();
+	freeScenes.pop_back();
+	return scene;
+}
+
+// VulkanBatchRenderer::releaseScene
+void VulkanBatchRenderer::releaseScene(VulkanScene* scene)
+{
+	// frame is complete on device
+	scene->models.clear();
+	freeScenes.push_back(scene);
+}
+
+// VulkanBatchRenderer::parseJob
+void VulkanBatchRenderer::parseJob(VulkanBatchJobState* jobState)
+{
+	// parse obj file and decode images (loader thread)
+	VulkanAssetManager::parseFromFileObj(jobState->job->fileName, jobState->job->basePath, jobState->objData);
+	// notify render thread
+	{
+		std::unique_lock<std::mutex> lock(jobStatesMutex);
+		jobState->parsed = true;
+	}
+	jobStatesCondition.notify_all();
+}
+
+// VulkanBatchRenderer::renderJob
+void VulkanBatchRenderer::renderJob(VulkanBatchJobState* jobState)
+{
+	// record uploads into transfer of job (waits only if transfer is still used by older job)
+	VulkanTransfer& transfer = transfers[transferIndex];
+	transferIndex = (transferIndex + 1) % (uint32_t)transfers.size();
+	vulkanTransferBegin(context.device, transfer);
+	context.transfer = &transfer;
+
+	// upload parsed data and release host copy (data is staged by transfer)
+	jobState->assetManager = new VulkanAssetManager(context);
+	jobState->assetManager->loadFromObjData(jobState->objData);
+	jobState->objData = VulkanObjData();
+	jobState->model = jobState->assetManager->createModelByMeshGroupName(jobState->job->fileName);
+
+	// submit uploads (frames of job follow on same queue)
+	context.transfer = nullptr;
+	vulkanTransferSubmit(context.device, transfer);
+	const uint32_t viewsCount = renderer->getViewsCount();
+	const uint32_t camerasCount = (uint32_t)jobState->job->cameras.size();
+	jobState->framesRemaining = (camerasCount + viewsCount - 1) / viewsCount;
+
+	// nothing to render
+	if (jobState->framesRemaining == 0) {
+		releaseJob(jobState);
+		return;
+	}
+
+	// render model from all camera presets (one scene per frame in flight, one camera per view)
+	for (uint32_t cameraIndex = 0; cameraIndex < camerasCount; cameraIndex += viewsCount) {
+		// create frame state
+		VulkanBatchFrameState* frameState = new VulkanBatchFrameState;
+		frameState->batchRenderer = this;
+		frameState->jobState = jobState;
+
+		// setup scene (unused views repeat last camera)
+		VulkanScene* scene = acquireScene();
+		scene->viewsCount = viewsCount;
+		for (uint32_t viewIndex = 0; viewIndex < viewsCount; viewIndex++) {
+			const auto& camera = jobState->job->cameras[std::min(cameraIndex + viewIndex, camerasCount - 1)];
+			scene->matrixViews[viewIndex] = glm::lookAt(camera.eye, camera.center, camera.up);
+			scene->matrixProjections[viewIndex] = glm::perspective(glm::radians(camera.fovY), renderer->getViewAspect(), 0.1f, 10.f);
+			if (cameraIndex + viewIndex < camerasCount)
+				frameState->outputFileNames.push_back(jobState->job->outputPrefix + "_" + camera.name + ".png");
+		}
+		scene->models.push_back(jobState->model);
+		frameState->scene = scene;
+
+		// draw scene (may deliver readbacks of older frames)
+		renderer->drawScene(scene, frameState);
+	}
+}
+
+// VulkanBatchRenderer::releaseJob
+void VulkanBatchRenderer::releaseJob(VulkanBatchJobState* jobState)
+{
+	// destroy job assets
+	delete jobState->model;
+	delete jobState->assetManager;
+	jobState->model = nullptr;
+	jobState->assetManager = nullptr;
+}
+
+// VulkanBatchRenderer::readbackFunc
+void VulkanBatchRenderer::readbackFunc(VulkanRenderer&, const void* pixels, uint32_t width, uint32_t height, void* userData)
+{
+	// forward to batch renderer
+	VulkanBatchFrameState* frameState = (VulkanBatchFrameState*)userData;
+	if (frameState)
+		frameState->batchRenderer->readbackFrame(frameState, pixels, width, height);
+}
+
+// VulkanBatchRenderer::readbackFrame
+void VulkanBatchRenderer::readbackFrame(VulkanBatchFrameState* frameState, const void* pixels, uint32_t width, uint32_t height)
+{
+	// views are stacked vertically - one image per camera
+	const uint32_t viewHeight = height / renderer->getViewsCount();
+	const size_t viewSize = (size_t)width * viewHeight * 4;
+	for (size_t viewIndex = 0; viewIndex < frameState->outputFileNames.size(); viewIndex++) {
+		// copy pixels (readback buffer is reused by next frame) and encode on thread pool
+		const uint8_t* viewPixels = (const uint8_t*)pixels + viewIndex * viewSize;
+		std::vector<uint8_t> image(viewPixels, viewPixels + viewSize);
+		std::string outputFileName = frameState->outputFileNames[viewIndex];
+		encodeThreadPool->push([this, outputFileName, width, viewHeight, image]() {
+			saveImageToFilePng(outputFileName, width, viewHeight, image.data());
+			imagesCount++;
+		});
+	}
+
+	// frame is complete on device - release scene and job assets after last frame
+	VulkanBatchJobState* jobState = frameState->jobState;
+	releaseScene(frameState->scene);
+	delete frameState;
+	if (--jobState->framesRemaining == 0)
+		releaseJob(jobState);
+}
+
+// VulkanBatchRenderer::run
+VulkanBatchStats VulkanBatchRenderer::run(const std::vector<VulkanBatchJob>& jobs)
+{
+	// create time stamp
+	TimeStamp timeStamp{};
+	timeStampReset(timeStamp);
+	imagesCount = 0;
+
+	// create job states
+	jobStates.resize(jobs.size());
+	for (size_t i = 0; i < jobs.size(); i++) {
+		jobStates[i] = new VulkanBatchJobState;
+		jobStates[i]->job = &jobs[i];
+	}
+
+	// parse first jobs ahead
+	size_t parseIndex = 0;
+	for (; parseIndex < std::min((size_t)loadAheadCount, jobs.size()); parseIndex++) {
+		VulkanBatchJobState* jobState = jobStates[parseIndex];
+		loadThreadPool->push([this, jobState]() { parseJob(jobState); });
+	}
+
+	// render jobs in order as soon as they are parsed
+	for (size_t i = 0; i < jobs.size(); i++) {
+		// wait job parsed
+		{
+			std::unique_lock<std::mutex> lock(jobStatesMutex);
+			jobStatesCondition.wait(lock, [this, i]() { return jobStates[i]->parsed; });
+		}
+		// keep loaders busy
+		if (parseIndex < jobs.size()) {
+			VulkanBatchJobState* jobState = jobStates[parseIndex++];
+			loadThreadPool->push([this, jobState]() { parseJob(jobState); });
+		}
+		// upload and render
+		renderJob(jobStates[i]);
+	}
+
+	// wait frames in flight and encoders
+	renderer->finish();
+	encodeThreadPool->wait();
+
+	// destroy job states
+	for (auto jobState : jobStates)
+		delete jobState;
+	jobStates.clear();
+
+	// fill stats
+	timeStampTick(timeStamp);
+	VulkanBatchStats stats{};
+	stats.assetsCount = (uint32_t)jobs.size();
+	stats.imagesCount = imagesCount;
+	stats.totalTime = timeStamp.accumTime;
+	stats.assetsPerSecond = stats.totalTime > 0.0f ? stats.assetsCount / stats.totalTime : 0.0f;
+	stats.imagesPerSecond = stats.totalTime > 0.0f ? stats.imagesCount / stats.totalTime : 0.0f;
+	return stats;
+}
+
+// VulkanBatchRenderer::getDefaultCameras
+std::vector<VulkanBatchCamera> VulkanBatchRenderer::getDefaultCameras()
+{
+	std::vector<VulkanBatchCamera> cameras(4);
+	cameras[0] = { "front", glm::vec3(0.0f, 0.0f, 3.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f), 45.0f };
+	cameras[1] = { "side",  glm::vec3(3.0f, 0.0f, 0.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f), 45.0f };
+	cameras[2] = { "top",   glm::vec3(0.0f, 3.0f, 0.0f), glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), 45.0f };
+	cameras[3] = { "iso",   glm::vec3(1.8f, 1.4f, 1.8f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f), 45.0f };
+	return cameras;
+}
+
+// VulkanBatchRenderer::loadJobsFromFile
+std::vector<VulkanBatchJob> VulkanBatchRenderer::loadJobsFromFile(const std::string fileName)
+{
+	// camera presets
+	std::vector<VulkanBatchCamera> defaultCameras = getDefaultCameras();
+
+	// read jobs line by line
+	std::vector<VulkanBatchJob> jobs;
+	std::ifstream file(fileName);
+	std::string line;
+	while (std::getline(file, line)) {
+		// skip empty lines and comments
+		std::istringstream lineStream(line);
+		VulkanBatchJob job{};
+		if (!(lineStream >> job.fileName) || job.fileName[0] == '#')
+			continue;
+		lineStream >> job.basePath >> job.outputPrefix;
+		assert(job.outputPrefix.size() > 0);
+
+		// selected camera presets (all by default)
+		std::string cameraName;
+		while (lineStream >> cameraName)
+			for (const auto& camera : defaultCameras)
+				if (camera.name == cameraName)
+					job.cameras.push_back(camera);
+		if (job.cameras.empty())
+			job.cameras = defaultCameras;
+		jobs.push_back(job);
+	}
+	return jobs;
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "vulkan_renderer_offscreen.hpp"
+#include "vulkan_assets.hpp"
+#include "thread_pool.hpp"
+#include <glm/vec3.hpp>
+#include <atomic>
+
+// VulkanBatchCamera (camera preset, loaded models are normalized to [-1, 1])
+struct VulkanBatchCamera {
+	std::string name{};
+	glm::vec3   eye{};
+	glm::vec3   center{};
+	glm::vec3   up{};
+	float       fovY{};
+};
+
+// VulkanBatchJob (obj file rendered from several camera presets)
+struct VulkanBatchJob {
+	std::string                    fileName{};
+	std::string                    basePath{};
+	std::string                    outputPrefix{};
+	std::vector<VulkanBatchCamera> cameras{};
+};
+
+// VulkanBatchStats
+struct VulkanBatchStats {
+	uint32_t assetsCount{};
+	uint32_t imagesCount{};
+	float    totalTime{};
+	float    assetsPerSecond{};
+	float    imagesPerSecond{};
+};
+
+// VulkanBatchJobState
+struct VulkanBatchJobState;
+
+// VulkanBatchFrameState
+struct VulkanBatchFrameState;
+
+// VulkanBatchRenderer
+class VulkanBatchRenderer {
+protected:
+	// base handles
+	VulkanContext& context;
+protected:
+	// offscreen renderer (its frames in flight are the render targets pool, one view per camera)
+	VulkanRenderer_offscreen* renderer{};
+	// loader and encoder thread pools
+	ThreadPool* loadThreadPool{};
+	ThreadPool* encodeThreadPool{};
+	// max jobs parsed ahead of rendering
+	uint32_t loadAheadCount{};
+protected:
+	// upload transfers of jobs in flight (ring, uploads are recorded and fenced instead of waiting for queue)
+	std::vector<VulkanTransfer> transfers{};
+	uint32_t                    transferIndex{};
+	// scenes of frames in flight (returned after readback and reused)
+	std::vector<VulkanScene*>   scenes{};
+	std::vector<VulkanScene*>   freeScenes{};
+protected:
+	// job states
+	std::vector<VulkanBatchJobState*> jobStates{};
+	std::mutex                        jobStatesMutex{};
+	std::condition_variable           jobStatesCondition{};
+	std::atomic<uint32_t>             imagesCount{};
+protected:
+	// job functions
+	void parseJob(VulkanBatchJobState* jobState);
+	void renderJob(VulkanBatchJobState* jobState);
+	void releaseJob(VulkanBatchJobState* jobState);
+
+	// scene functions
+	VulkanScene* acquireScene();
+	void releaseScene(VulkanScene* scene);
+
+	// readback functions
+	static void readbackFunc(VulkanRenderer& renderer, const void* pixels, uint32_t width, uint32_t height, void* userData);
+	void readbackFrame(VulkanBatchFrameState* frameState, const void* pixels, uint32_t width, uint32_t height);
+public:
+	// constructor and destructor
+	VulkanBatchRenderer(
+		VulkanContext& context,
+		uint32_t       width,
+		uint32_t       height,
+		uint32_t       framesInFlight,
+		uint32_t       viewsCount,
+		uint32_t       loadThreadsCount,
+		uint32_t       encodeThreadsCount);
+	~VulkanBatchRenderer();
+
+	// render all jobs and write PNG files
+	VulkanBatchStats run(const std::vector<VulkanBatchJob>& jobs);
+
+	// camera presets (front, side, top, iso)
+	static std::vector<VulkanBatchCamera> getDefaultCameras();
+
+	// load job list: one "objFile basePath outputPrefix [camera ...]" per line
+	static std::vector<VulkanBatchJob> loadJobsFromFile(const std::string fileName);
+};
@@ -17,33 +17,92 @@ VulkanContext::VulkanContext(
 	vulkanDescriptorSetLayoutCreate(device, VKT_ARRAY_ELEMENTS_COUNT(descriptorSetLayoutBindings_material), descriptorSetLayoutBindings_material, &descriptorSetLayout_material);
 	vulkanDescriptorSetLayoutCreate(device, VKT_ARRAY_ELEMENTS_COUNT(descriptorSetLayoutBindings_model), descriptorSetLayoutBindings_model, &descriptorSetLayout_model);
 	vulkanDescriptorSetLayoutCreate(device, VKT_ARRAY_ELEMENTS_COUNT(descriptorSetLayoutBindings_scene), descriptorSetLayoutBindings_scene, &descriptorSetLayout_scene);
+	vulkanDescriptorSetLayoutCreate(device, VKT_ARRAY_ELEMENTS_COUNT(descriptorSetLayoutBindings_draw), descriptorSetLayoutBindings_draw, &descriptorSetLayout_draw);
+	vulkanDescriptorSetLayoutCreate(device, VKT_ARRAY_ELEMENTS_COUNT(descriptorSetLayoutBindings_cull), descriptorSetLayoutBindings_cull, &descriptorSetLayout_cull);
+	vulkanDescriptorSetLayoutCreate(device, VKT_ARRAY_ELEMENTS_COUNT(descriptorSetLayoutBindings_depthPyramid), descriptorSetLayoutBindings_depthPyramid, &descriptorSetLayout_depthPyramid);
+	vulkanDescriptorSetLayoutCreate(device, VKT_ARRAY_ELEMENTS_COUNT(descriptorSetLayoutBindings_lightClusters), descriptorSetLayoutBindings_lightClusters, &descriptorSetLayout_lightClusters);
+	vulkanDescriptorSetLayoutCreate(device, VKT_ARRAY_ELEMENTS_COUNT(descriptorSetLayoutBindings_gbuffer), descriptorSetLayoutBindings_gbuffer, &descriptorSetLayout_gbuffer);
+	vulkanDescriptorSetLayoutCreate(device, VKT_ARRAY_ELEMENTS_COUNT(descriptorSetLayoutBindings_debugGeometry), descriptorSetLayoutBindings_debugGeometry, &descriptorSetLayout_debugGeometry);
+	vulkanDescriptorSetLayoutCreate(device, VKT_ARRAY_ELEMENTS_COUNT(descriptorSetLayoutBindings_skinning), descriptorSetLayoutBindings_skinning, &descriptorSetLayout_skinning);
+	vulkanDescriptorSetLayoutCreate(device, VKT_ARRAY_ELEMENTS_COUNT(descriptorSetLayoutBindings_particles), descriptorSetLayoutBindings_particles, &descriptorSetLayout_particles);
+	vulkanDescriptorSetLayoutCreate(device, VKT_ARRAY_ELEMENTS_COUNT(descriptorSetLayoutBindings_particlesDraw), descriptorSetLayoutBindings_particlesDraw, &descriptorSetLayout_particlesDraw);
 
 	// list of descriptor set layout
 	VkDescriptorSetLayout descriptorSetLayouts[] = {
 		descriptorSetLayout_material.descriptorSetLayout,
 		descriptorSetLayout_model.descriptorSetLayout,
 		descriptorSetLayout_scene.descriptorSetLayout,
+		descriptorSetLayout_draw.descriptorSetLayout,
+	};
+
+	// list of deferred lighting descriptor set layouts (sets before G-buffer set are same as graphics - scene set stays bound)
+	VkDescriptorSetLayout descriptorSetLayouts_deferred[] = {
+		descriptorSetLayout_material.descriptorSetLayout,
+		descriptorSetLayout_model.descriptorSetLayout,
+		descriptorSetLayout_scene.descriptorSetLayout,
+		descriptorSetLayout_gbuffer.descriptorSetLayout,
+	};
+
+	// list of particles draw descriptor set layouts (sets before particles set are same as graphics - scene set stays bound)
+	VkDescriptorSetLayout descriptorSetLayouts_particlesDraw[] = {
+		descriptorSetLayout_material.descriptorSetLayout,
+		descriptorSetLayout_model.descriptorSetLayout,
+		descriptorSetLayout_scene.descriptorSetLayout,
+		descriptorSetLayout_particlesDraw.descriptorSetLayout,
 	};
 
 	// create pipeline layout
 	vulkanPipelineLayoutCreate(device, VKT_ARRAY_ELEMENTS_COUNT(descriptorSetLayouts), descriptorSetLayouts, &pipelineLayout);
+	vulkanPipelineLayoutCreate(device, 1, &descriptorSetLayout_cull.descriptorSetLayout, &pipelineLayout_cull);
+	vulkanPipelineLayoutCreate(device, 1, &descriptorSetLayout_depthPyramid.descriptorSetLayout, &pipelineLayout_depthPyramid);
+	vulkanPipelineLayoutCreate(device, 1, &descriptorSetLayout_lightClusters.descriptorSetLayout, &pipelineLayout_lightClusters);
+	vulkanPipelineLayoutCreate(device, VKT_ARRAY_ELEMENTS_COUNT(descriptorSetLayouts_deferred), descriptorSetLayouts_deferred, &pipelineLayout_deferred);
+	vulkanPipelineLayoutCreate(device, 1, &descriptorSetLayout_debugGeometry.descriptorSetLayout, &pipelineLayout_debugGeometry);
+	vulkanPipelineLayoutCreate(device, 1, &descriptorSetLayout_skinning.descriptorSetLayout, &pipelineLayout_skinning);
+	vulkanPipelineLayoutCreate(device, 1, &descriptorSetLayout_particles.descriptorSetLayout, &pipelineLayout_particles);
+	vulkanPipelineLayoutCreate(device, VKT_ARRAY_ELEMENTS_COUNT(descriptorSetLayouts_particlesDraw), descriptorSetLayouts_particlesDraw, &pipelineLayout_particlesDraw);
 
 	// create default sampler and material
+	vulkanTransferCreate(device, &uploadTransfer);
 	vulkanSamplerCreate(device, VK_FILTER_LINEAR, VK_SAMPLER_ADDRESS_MODE_REPEAT, VK_TRUE, &defaultSampler);
 	createDefaultImage();
+
+	// create geometry pool
+	geometryPool = new VulkanGeometryPool(device, VULKAN_GEOMETRY_POOL_VERTEX_CAPACITY, VULKAN_GEOMETRY_POOL_INDEX_CAPACITY, VULKAN_GEOMETRY_POOL_SKIN_VERTEX_CAPACITY);
 }
 
 // VulkanContext::~VulkanContext
 VulkanContext::~VulkanContext()
 {
+	// destroy geometry pool
+	delete geometryPool;
+
 	// destroy default material and sampler
 	vulkanImageDestroy(device, defaultImage);
 	vulkanSamplerDestroy(device, defaultSampler);
+	vulkanTransferDestroy(device, uploadTransfer);
 
 	// destroy pipeline layouts
+	vulkanPipelineLayoutDestroy(device, pipelineLayout_particlesDraw);
+	vulkanPipelineLayoutDestroy(device, pipelineLayout_particles);
+	vulkanPipelineLayoutDestroy(device, pipelineLayout_skinning);
+	vulkanPipelineLayoutDestroy(device, pipelineLayout_debugGeometry);
+	vulkanPipelineLayoutDestroy(device, pipelineLayout_deferred);
+	vulkanPipelineLayoutDestroy(device, pipelineLayout_lightClusters);
+	vulkanPipelineLayoutDestroy(device, pipelineLayout_depthPyramid);
+	vulkanPipelineLayoutDestroy(device, pipelineLayout_cull);
 	vulkanPipelineLayoutDestroy(device, pipelineLayout);
 
 	// destroy shaders
+	vulkanDescriptorSetLayoutDestroy(device, descriptorSetLayout_particlesDraw);
+	vulkanDescriptorSetLayoutDestroy(device, descriptorSetLayout_particles);
+	vulkanDescriptorSetLayoutDestroy(device, descriptorSetLayout_skinning);
+	vulkanDescriptorSetLayoutDestroy(device, descriptorSetLayout_debugGeometry);
+	vulkanDescriptorSetLayoutDestroy(device, descriptorSetLayout_gbuffer);
+	vulkanDescriptorSetLayoutDestroy(device, descriptorSetLayout_lightClusters);
+	vulkanDescriptorSetLayoutDestroy(device, descriptorSetLayout_depthPyramid);
+	vulkanDescriptorSetLayoutDestroy(device, descriptorSetLayout_cull);
+	vulkanDescriptorSetLayoutDestroy(device, descriptorSetLayout_draw);
 	vulkanDescriptorSetLayoutDestroy(device, descriptorSetLayout_scene);
 	vulkanDescriptorSetLayoutDestroy(device, descriptorSetLayout_model);
 	vulkanDescriptorSetLayoutDestroy(device, descriptorSetLayout_material);
@@ -53,8 +112,43 @@ VulkanContext::~VulkanContext()
 	vulkanInstanceDestroy(instance);
 }
 
+// VulkanContext::writeBuffer
+void VulkanContext::writeBuffer(VulkanBuffer& buffer, VkDeviceSize offset, VkDeviceSize size, const void* data)
+{
+	// record into transfer (data is staged) or import and wait
+	if (transfer)
+		vulkanTransferBufferWrite(device, *transfer, buffer, offset, size, data);
+	else
+		vulkanBufferWriteHostMemory(device, buffer, offset, size, data);
+}
+
+// VulkanContext::beginUploads
+bool VulkanContext::beginUploads()
+{
+	// uploads are already recorded (batch job)
+	if (transfer)
+		return false;
+	// staging buffer of upload transfer is reused
+	vulkanTransferBegin(device, uploadTransfer);
+	transfer = &uploadTransfer;
+	return true;
+}
+
+// VulkanContext::endUploads
+void VulkanContext::endUploads()
+{
+	// one submit and fence wait for all uploads
+	assert(transfer == &uploadTransfer);
+	transfer = nullptr;
+	vulkanTransferSubmit(device, uploadTransfer);
+	vulkanTransferWait(device, uploadTransfer);
+}
+
 // createDefaultImage
 void VulkanContext::createDefaultImage()
 {
-	createImageProcedural(device, 1024, 1024, defaultImage);
+	// image and mipmaps in one upload
+	beginUploads();
+	createImageProcedural(device, 1024, 1024, defaultImage, transfer);
+	endUploads();
 }
@@ -1,5 +1,6 @@
 #pragma once
 #include <vktoolkit.hpp>
+#include "vulkan_geometry_pool.hpp"
 
 // VulkanContext
 class VulkanContext {
@@ -12,8 +13,32 @@ public:
 	VulkanDescriptorSetLayout descriptorSetLayout_material{};
 	VulkanDescriptorSetLayout descriptorSetLayout_model{};
 	VulkanDescriptorSetLayout descriptorSetLayout_scene{};
-	// pipeline layout
+	VulkanDescriptorSetLayout descriptorSetLayout_draw{};
+	VulkanDescriptorSetLayout descriptorSetLayout_cull{};
+	VulkanDescriptorSetLayout descriptorSetLayout_depthPyramid{};
+	VulkanDescriptorSetLayout descriptorSetLayout_lightClusters{};
+	VulkanDescriptorSetLayout descriptorSetLayout_gbuffer{};
+	VulkanDescriptorSetLayout descriptorSetLayout_debugGeometry{};
+	VulkanDescriptorSetLayout descriptorSetLayout_skinning{};
+	VulkanDescriptorSetLayout descriptorSetLayout_particles{};
+	VulkanDescriptorSetLayout descriptorSetLayout_particlesDraw{};
+	// pipeline layouts (graphics, culling, depth pyramid and light binning compute, deferred lighting, debug geometry, skinning and particles compute, particles draw)
 	VulkanPipelineLayout pipelineLayout{};
+	VulkanPipelineLayout pipelineLayout_cull{};
+	VulkanPipelineLayout pipelineLayout_depthPyramid{};
+	VulkanPipelineLayout pipelineLayout_lightClusters{};
+	VulkanPipelineLayout pipelineLayout_deferred{};
+	VulkanPipelineLayout pipelineLayout_debugGeometry{};
+	VulkanPipelineLayout pipelineLayout_skinning{};
+	VulkanPipelineLayout pipelineLayout_particles{};
+	VulkanPipelineLayout pipelineLayout_particlesDraw{};
+public:
+	// shared geometry buffers (meshes in one pool can be drawn by one indirect call)
+	VulkanGeometryPool* geometryPool{};
+	// uploads of assets and meshes are recorded here when set (null - uploads wait for queue)
+	VulkanTransfer* transfer{};
+	// transfer of uploads outside batch jobs (submitted and waited once per load)
+	VulkanTransfer  uploadTransfer{};
 public:
 	VulkanImage   defaultImage{};
 	VulkanSampler defaultSampler{};
@@ -27,6 +52,14 @@ public:
 		std::vector<const char *>& enabledDeviceExtensionNames,
 		VkPhysicalDeviceFeatures&  physicalDeviceFeatures);
 	~VulkanContext();
+
+	// write buffer by transfer or with queue wait
+	void writeBuffer(VulkanBuffer& buffer, VkDeviceSize offset, VkDeviceSize size, const void* data);
+
+	// record following uploads into one transfer (returns false when caller's transfer already records them)
+	bool beginUploads();
+	// submit recorded uploads and wait for them
+	void endUploads();
 };
 
 // VulkanContextObject
@@ -0,0 +1,98 @@
+#include "vulkan_debug_geometry.hpp"
+#include <algorithm>
+
+// VulkanDebugGeometry::VulkanDebugGeometry
+VulkanDebugGeometry::VulkanDebugGeometry(VulkanContext& context) :
+	context(context)
+{
+	// create compute pipeline
+	vulkanPipelineCreateCompute(context.device, shader_debug_geometry_file_comp, context.pipelineLayout_debugGeometry, &pipeline_debug_geometry);
+
+	// create debug geometry data buffer
+	vulkanBufferCreate(context.device, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, sizeof(VulkanDebugGeometryData), &bufferDebugGeometryData);
+	debugGeometryData.params = glm::vec4(VULKAN_DEBUG_GEOMETRY_LINE_LENGTH, 0.0f, 0.0f, 0.0f);
+
+	// create descriptor set (geometry pool is source and destination of lines)
+	vulkanDescriptorSetCreate(context.device, context.descriptorSetLayout_debugGeometry, &descriptorSet);
+	vulkanDescriptorSetUpdateBufferUniform(context.device, descriptorSet, bufferDebugGeometryData, 0);
+	if (context.geometryPool) {
+		vulkanDescriptorSetUpdateBufferStorage(context.device, descriptorSet, context.geometryPool->bufferPos, 1);
+		vulkanDescriptorSetUpdateBufferStorage(context.device, descriptorSet, context.geometryPool->bufferTex, 2);
+		vulkanDescriptorSetUpdateBufferStorage(context.device, descriptorSet, context.geometryPool->bufferNrm, 3);
+	}
+}
+
+// VulkanDebugGeometry::~VulkanDebugGeometry
+VulkanDebugGeometry::~VulkanDebugGeometry()
+{
+	// destroy descriptor set and buffer
+	vulkanDescriptorSetDestroy(context.device, descriptorSet);
+	vulkanBufferDestroy(context.device, bufferDebugGeometryData);
+	// destroy pipeline
+	vulkanPipelineDestroy(context.device, pipeline_debug_geometry);
+}
+
+// VulkanDebugGeometry::update
+void VulkanDebugGeometry::update(VulkanCommandBuffer& commandBuffer, VulkanScene* scene)
+{
+	VulkanGeometryPool* geometryPool = context.geometryPool;
+	if (!geometryPool) return;
+
+	// create debug meshes of pooled meshes without one (remaining meshes are generated in next frames)
+	uint32_t jobsCount = 0;
+	uint32_t groupsCount = 0;
+	for (auto& model : scene->models) {
+		if (!model->visibleDebug) continue;
+		model->meshes_debug.clear();
+		for (auto& mesh : model->meshes) {
+			VkBool32 pooled = mesh->drawInfo.vertexBuffers[0] == geometryPool->bufferPos.buffer;
+			if (!mesh->meshDebug && pooled && jobsCount < VULKAN_DEBUG_GEOMETRY_MAX_JOBS) {
+				// lines of full resolution vertices (unlit color lines, bounds of mesh grown by line length)
+				const VulkanMeshLod& lod = mesh->lods[0];
+				VulkanMeshMatObj* meshDebug = new VulkanMeshMatObj(context, lod.vertexCount * VULKAN_DEBUG_GEOMETRY_LINE_VERTICES);
+				meshDebug->materialUsage = VULKAN_MATERIAL_USAGE_COLOR_LIGHT;
+				meshDebug->primitiveTopology = VK_PRIMITIVE_TOPOLOGY_LINE_LIST;
+				meshDebug->drawInfo.boundingSphere = mesh->drawInfo.boundingSphere + glm::vec4(0.0f, 0.0f, 0.0f, VULKAN_DEBUG_GEOMETRY_LINE_LENGTH);
+				meshDebug->drawInfo.boundingBoxMin = mesh->drawInfo.boundingBoxMin - glm::vec3(VULKAN_DEBUG_GEOMETRY_LINE_LENGTH);
+				meshDebug->drawInfo.boundingBoxMax = mesh->drawInfo.boundingBoxMax + glm::vec3(VULKAN_DEBUG_GEOMETRY_LINE_LENGTH);
+				mesh->meshDebug = meshDebug;
+				// job of mesh (tangent space needs non-indexed triangle list, full pool leaves debug mesh empty)
+				if (meshDebug->drawInfo.vertexCount) {
+					VkBool32 triangles = !mesh->drawInfo.indexBuffer && mesh->primitiveTopology == VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+					debugGeometryData.jobs[jobsCount++] = glm::uvec4(lod.firstVertex, meshDebug->drawInfo.firstVertex, lod.vertexCount, triangles);
+					groupsCount = std::max(groupsCount, (lod.vertexCount + VULKAN_DEBUG_GEOMETRY_GROUP_SIZE - 1) / VULKAN_DEBUG_GEOMETRY_GROUP_SIZE);
+				}
+			}
+			if (mesh->meshDebug && mesh->meshDebug->drawInfo.vertexCount)
+				model->meshes_debug.push_back(mesh->meshDebug);
+		}
+	}
+	if (!jobsCount)
+		return;
+
+	// VkMemoryBarrier - previous frames in flight finished reading debug geometry data and pool vertices
+	VkMemoryBarrier memoryBarrier{};
+	memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+	memoryBarrier.pNext = VK_NULL_HANDLE;
+	memoryBarrier.srcAccessMask = VK_ACCESS_UNIFORM_READ_BIT | VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;
+	memoryBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+	vkCmdPipelineBarrier(commandBuffer.commandBuffer, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &memoryBarrier, 0, VK_NULL_HANDLE, 0, VK_NULL_HANDLE);
+
+	// debug geometry data (line length and jobs)
+	vkCmdUpdateBuffer(commandBuffer.commandBuffer, bufferDebugGeometryData.buffer, 0, sizeof(glm::vec4) + sizeof(glm::uvec4) * jobsCount, &debugGeometryData);
+
+	// VkMemoryBarrier - updated debug geometry data visible to generation
+	memoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	memoryBarrier.dstAccessMask = VK_ACCESS_UNIFORM_READ_BIT;
+	vkCmdPipelineBarrier(commandBuffer.commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &memoryBarrier, 0, VK_NULL_HANDLE, 0, VK_NULL_HANDLE);
+
+	// generate lines (one invocation per source vertex, one row of work groups per mesh)
+	vkCmdBindPipeline(commandBuffer.commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline_debug_geometry.pipeline);
+	vkCmdBindDescriptorSets(commandBuffer.commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, context.pipelineLayout_debugGeometry.pipelineLayout, 0, 1, &descriptorSet.descriptorSet, 0, VK_NULL_HANDLE);
+	vkCmdDispatch(commandBuffer.commandBuffer, groupsCount, jobsCount, 1);
+
+	// VkMemoryBarrier - generated lines visible to vertex input
+	memoryBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+	memoryBarrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;
+	vkCmdPipelineBarrier(commandBuffer.commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, 0, 1, &memoryBarrier, 0, VK_NULL_HANDLE, 0, VK_NULL_HANDLE);
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "vulkan_scene.hpp"
+#include <glm/vec4.hpp>
+
+// max meshes generated per frame and line length in model space (must match shader)
+#define VULKAN_DEBUG_GEOMETRY_MAX_JOBS 64
+#define VULKAN_DEBUG_GEOMETRY_LINE_LENGTH 0.05f
+
+// debug geometry shader work group size and lines per source vertex (normal, tangent, bi-normal)
+#define VULKAN_DEBUG_GEOMETRY_GROUP_SIZE 64
+#define VULKAN_DEBUG_GEOMETRY_LINE_VERTICES 6
+
+// VulkanDebugGeometryData (std140 uniforms of debug geometry shader)
+struct VulkanDebugGeometryData {
+	glm::vec4  params;                               // line length
+	glm::uvec4 jobs[VULKAN_DEBUG_GEOMETRY_MAX_JOBS]; // source first vertex, debug first vertex, source vertex count, triangle list flag
+};
+
+// VulkanDebugGeometry (debug lines of pooled meshes written into geometry pool by compute shader when first shown)
+class VulkanDebugGeometry {
+protected:
+	// base handles
+	VulkanContext& context;
+protected:
+	// debug geometry shader file
+	const char* shader_debug_geometry_file_comp = "shaders/debug_geometry.comp.spv";
+	// compute pipeline and its descriptor set
+	VulkanPipeline      pipeline_debug_geometry{};
+	VulkanDescriptorSet descriptorSet{};
+protected:
+	// debug geometry data buffer
+	VulkanBuffer            bufferDebugGeometryData{};
+	VulkanDebugGeometryData debugGeometryData{};
+public:
+	// constructor and destructor
+	VulkanDebugGeometry(VulkanContext& context);
+	~VulkanDebugGeometry();
+
+	// create and record generation of missing debug lines of models with visible debug, fill debug meshes of models
+	void update(VulkanCommandBuffer& commandBuffer, VulkanScene* scene);
+};
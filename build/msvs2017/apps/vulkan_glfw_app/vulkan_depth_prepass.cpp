@@ -0,0 +1,76 @@
+#include "vulkan_depth_prepass.hpp"
+#include "vulkan_descriptors.hpp"
+
+// VulkanDepthPrepass::VulkanDepthPrepass
+VulkanDepthPrepass::VulkanDepthPrepass(VulkanContext& context) :
+	context(context)
+{
+	// create depth only shader (pipelines are created with render pass of renderer)
+	vulkanShaderCreate(context.device, shader_depth_file_vert, nullptr, &shader_depth);
+}
+
+// VulkanDepthPrepass::~VulkanDepthPrepass
+VulkanDepthPrepass::~VulkanDepthPrepass()
+{
+	// destroy pipelines and shader
+	destroyPipelines();
+	vulkanShaderDestroy(context.device, shader_depth);
+}
+
+// VulkanDepthPrepass::createPipelines
+void VulkanDepthPrepass::createPipelines(VkRenderPass renderPass, VulkanShader shaders[VULKAN_MATERIAL_USAGE_RANGE_SIZE])
+{
+	// VulkanPipelineDepthState - color subpass shades visible fragments only (same depth by invariant positions)
+	VulkanPipelineDepthState pipelineDepthState{};
+	pipelineDepthState.depthTestEnable = VK_TRUE;
+	pipelineDepthState.depthWriteEnable = VK_FALSE;
+	pipelineDepthState.depthCompareOp = VK_COMPARE_OP_EQUAL;
+
+	// create all pipelines
+	for (uint32_t topology = VK_PRIMITIVE_TOPOLOGY_LINE_LIST; topology <= VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP_WITH_ADJACENCY; topology++) {
+		// create pipeline mesh object depth (first subpass, no color attachments)
+		vulkanPipelineCreate(context.device, shader_depth, context.pipelineLayout, renderPass, 0,
+			(VkPrimitiveTopology)topology, VK_POLYGON_MODE_FILL,
+			VKT_ARRAY_ELEMENTS_COUNT(vertexBindingDescriptions_mesh_obj_depth), vertexBindingDescriptions_mesh_obj_depth,
+			VKT_ARRAY_ELEMENTS_COUNT(vertexAttributeDescriptions_mesh_obj_depth), vertexAttributeDescriptions_mesh_obj_depth,
+			0, nullptr,
+			nullptr, &pipeline_mesh_obj_depth[topology]);
+		// create pipelines for materials (second subpass)
+		for (uint32_t materialUsage = VULKAN_MATERIAL_USAGE_COLOR; materialUsage <= VULKAN_MATERIAL_USAGE_COLOR_TEXTURE_LIGHT; materialUsage++) {
+			vulkanPipelineCreate(context.device, shaders[materialUsage], context.pipelineLayout, renderPass, 1,
+				(VkPrimitiveTopology)topology, VK_POLYGON_MODE_FILL,
+				VKT_ARRAY_ELEMENTS_COUNT(vertexBindingDescriptions_mesh_obj), vertexBindingDescriptions_mesh_obj,
+				VKT_ARRAY_ELEMENTS_COUNT(vertexAttributeDescriptions_mesh_obj), vertexAttributeDescriptions_mesh_obj,
+				VKT_ARRAY_ELEMENTS_COUNT(pipelineColorBlendAttachmentStates_default), pipelineColorBlendAttachmentStates_default,
+				&pipelineDepthState, &pipeline_mesh_obj_prepass[materialUsage][topology]);
+		}
+		// create pipelines for bump materials (second subpass)
+		for (uint32_t materialUsage = VULKAN_MATERIAL_USAGE_COLOR_TEXTURE_LIGHT_BUMPMAP; materialUsage <= VULKAN_MATERIAL_USAGE_COLOR_TEXTURE_LIGHT_PBR; materialUsage++) {
+			vulkanPipelineCreate(context.device, shaders[materialUsage], context.pipelineLayout, renderPass, 1,
+				(VkPrimitiveTopology)topology, VK_POLYGON_MODE_FILL,
+				VKT_ARRAY_ELEMENTS_COUNT(vertexBindingDescriptions_mesh_obj_bump), vertexBindingDescriptions_mesh_obj_bump,
+				VKT_ARRAY_ELEMENTS_COUNT(vertexAttributeDescriptions_mesh_obj_bump), vertexAttributeDescriptions_mesh_obj_bump,
+				VKT_ARRAY_ELEMENTS_COUNT(pipelineColorBlendAttachmentStates_default), pipelineColorBlendAttachmentStates_default,
+				&pipelineDepthState, &pipeline_mesh_obj_prepass[materialUsage][topology]);
+		}
+	}
+}
+
+// VulkanDepthPrepass::destroyPipelines
+void VulkanDepthPrepass::destroyPipelines()
+{
+	// destroy all pipelines
+	for (uint32_t topology = VK_PRIMITIVE_TOPOLOGY_LINE_LIST; topology <= VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP_WITH_ADJACENCY; topology++) {
+		vulkanPipelineDestroy(context.device, pipeline_mesh_obj_depth[topology]);
+		for (uint32_t materialUsage = VULKAN_MATERIAL_USAGE_BEGIN_RANGE; materialUsage <= VULKAN_MATERIAL_USAGE_END_RANGE; materialUsage++)
+			vulkanPipelineDestroy(context.device, pipeline_mesh_obj_prepass[materialUsage][topology]);
+	}
+}
+
+// VulkanDepthPrepass::begin
+VkBool32 VulkanDepthPrepass::begin(VulkanScene* scene)
+{
+	// depth pre-pass of frame (render queue is built with pipelines of both subpasses)
+	used = scene->depthPrepass && pipeline_mesh_obj_depth[VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST].pipeline;
+	return used;
+}
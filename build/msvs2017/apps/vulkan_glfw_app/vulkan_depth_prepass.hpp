@@ -0,0 +1,36 @@
+#pragma once
+
+#include "vulkan_scene.hpp"
+
+// VulkanDepthPrepass (depth only first subpass of render queue, color second subpass shades visible fragments only)
+class VulkanDepthPrepass {
+protected:
+	// base handles
+	VulkanContext& context;
+protected:
+	// depth only vertex shader file (position stream only)
+	const char* shader_depth_file_vert = "shaders/mesh_obj_depth.vert.spv";
+	// depth only shader
+	VulkanShader shader_depth{};
+	// depth subpass pipelines and color subpass pipelines (equal depth test)
+	VulkanPipeline pipeline_mesh_obj_depth[VK_PRIMITIVE_TOPOLOGY_RANGE_SIZE]{};
+	VulkanPipeline pipeline_mesh_obj_prepass[VULKAN_MATERIAL_USAGE_RANGE_SIZE][VK_PRIMITIVE_TOPOLOGY_RANGE_SIZE]{};
+	// depth pre-pass of recorded frame
+	VkBool32 used{};
+public:
+	// constructor and destructor
+	VulkanDepthPrepass(VulkanContext& context);
+	~VulkanDepthPrepass();
+
+	// create and destroy pipelines of render pass with depth pre-pass (color subpass uses mesh object shaders of renderer)
+	void createPipelines(VkRenderPass renderPass, VulkanShader shaders[VULKAN_MATERIAL_USAGE_RANGE_SIZE]);
+	void destroyPipelines();
+
+	// depth pre-pass is used when scene requests it and pipelines exist (first subpass of frame is depth only)
+	VkBool32 begin(VulkanScene* scene);
+
+	// getters
+	VkBool32 isUsed() const { return used; }
+	VkPipeline getDepthPipeline(VulkanMeshMatObj* mesh) const { return pipeline_mesh_obj_depth[mesh->primitiveTopology].pipeline; }
+	VkPipeline getColorPipeline(VulkanMeshMatObj* mesh) const { return pipeline_mesh_obj_prepass[mesh->materialUsage][mesh->primitiveTopology].pipeline; }
+};
@@ -0,0 +1,181 @@
+#include "vulkan_depth_pyramid.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+// vulkanDepthPyramidWriteImage (image descriptor of explicit view and layout)
+static void vulkanDepthPyramidWriteImage(
+	VulkanDevice&        device,
+	VulkanDescriptorSet& descriptorSet,
+	uint32_t             binding,
+	VkDescriptorType     descriptorType,
+	VkSampler            sampler,
+	VkImageView          imageView,
+	VkImageLayout        imageLayout)
+{
+	// VkDescriptorImageInfo
+	VkDescriptorImageInfo descriptorImageInfo{};
+	descriptorImageInfo.sampler = sampler;
+	descriptorImageInfo.imageView = imageView;
+	descriptorImageInfo.imageLayout = imageLayout;
+
+	// VkWriteDescriptorSet
+	VkWriteDescriptorSet writeDescriptorSet{};
+	writeDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	writeDescriptorSet.pNext = VK_NULL_HANDLE;
+	writeDescriptorSet.dstSet = descriptorSet.descriptorSet;
+	writeDescriptorSet.dstBinding = binding;
+	writeDescriptorSet.dstArrayElement = 0;
+	writeDescriptorSet.descriptorCount = 1;
+	writeDescriptorSet.descriptorType = descriptorType;
+	writeDescriptorSet.pImageInfo = &descriptorImageInfo;
+	writeDescriptorSet.pBufferInfo = VK_NULL_HANDLE;
+	writeDescriptorSet.pTexelBufferView = VK_NULL_HANDLE;
+	vkUpdateDescriptorSets(device.device, 1, &writeDescriptorSet, 0, VK_NULL_HANDLE);
+}
+
+// VulkanDepthPyramid::VulkanDepthPyramid
+VulkanDepthPyramid::VulkanDepthPyramid(VulkanContext& context, uint32_t depthWidth, uint32_t depthHeight) :
+	context(context),
+	depthWidth(depthWidth),
+	depthHeight(depthHeight)
+{
+	// pyramid size
+	width = std::max(1U, depthWidth / 2);
+	height = std::max(1U, depthHeight / 2);
+	levelsCount = (uint32_t)std::floor(std::log2(std::max(width, height))) + 1;
+
+	// create compute pipeline and sampler
+	vulkanPipelineCreateCompute(context.device, shader_depth_pyramid_file_comp, context.pipelineLayout_depthPyramid, &pipeline_depth_pyramid);
+	vulkanSamplerCreate(context.device, VK_FILTER_NEAREST, VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE, VK_FALSE, &sampler);
+
+	// VkImageCreateInfo - written by compute, sampled by culling
+	VkImageCreateInfo imageCreateInfo{};
+	imageCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+	imageCreateInfo.pNext = VK_NULL_HANDLE;
+	imageCreateInfo.flags = 0;
+	imageCreateInfo.imageType = VK_IMAGE_TYPE_2D;
+	imageCreateInfo.format = VK_FORMAT_R32_SFLOAT;
+	imageCreateInfo.extent.width = width;
+	imageCreateInfo.extent.height = height;
+	imageCreateInfo.extent.depth = 1;
+	imageCreateInfo.mipLevels = levelsCount;
+	imageCreateInfo.arrayLayers = 1;
+	imageCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+	imageCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+	imageCreateInfo.usage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+	imageCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+	imageCreateInfo.queueFamilyIndexCount = VK_QUEUE_FAMILY_IGNORED;
+	imageCreateInfo.pQueueFamilyIndices = VK_NULL_HANDLE;
+	imageCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+	// VmaAllocationCreateInfo
+	VmaAllocationCreateInfo allocCreateInfo{};
+	allocCreateInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+	allocCreateInfo.flags = 0;
+
+	// vmaCreateImage
+	VKT_CHECK(vmaCreateImage(context.device.allocator, &imageCreateInfo, &allocCreateInfo, &image, &allocation, VK_NULL_HANDLE));
+	assert(image);
+	assert(allocation);
+
+	// create view of all levels (index 0) and views of single levels
+	levelImageViews.resize(levelsCount);
+	for (uint32_t level = 0; level <= levelsCount; level++) {
+		// VkImageViewCreateInfo
+		VkImageViewCreateInfo imageViewCreateInfo{};
+		imageViewCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+		imageViewCreateInfo.pNext = VK_NULL_HANDLE;
+		imageViewCreateInfo.flags = 0;
+		imageViewCreateInfo.image = image;
+		imageViewCreateInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+		imageViewCreateInfo.format = VK_FORMAT_R32_SFLOAT;
+		imageViewCreateInfo.components.r = VK_COMPONENT_SWIZZLE_IDENTITY;
+		imageViewCreateInfo.components.g = VK_COMPONENT_SWIZZLE_IDENTITY;
+		imageViewCreateInfo.components.b = VK_COMPONENT_SWIZZLE_IDENTITY;
+		imageViewCreateInfo.components.a = VK_COMPONENT_SWIZZLE_IDENTITY;
+		imageViewCreateInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		imageViewCreateInfo.subresourceRange.baseMipLevel = level == 0 ? 0 : level - 1;
+		imageViewCreateInfo.subresourceRange.levelCount = level == 0 ? levelsCount : 1;
+		imageViewCreateInfo.subresourceRange.baseArrayLayer = 0;
+		imageViewCreateInfo.subresourceRange.layerCount = 1;
+		VkImageView& view = level == 0 ? imageView : levelImageViews[level - 1];
+		VKT_CHECK(vkCreateImageView(context.device.device, &imageViewCreateInfo, VK_NULL_HANDLE, &view));
+		assert(view);
+	}
+
+	// create level descriptor sets (level 0 source is set by build)
+	descriptorSets.resize(levelsCount);
+	for (uint32_t level = 0; level < levelsCount; level++) {
+		vulkanDescriptorSetCreate(context.device, context.descriptorSetLayout_depthPyramid, &descriptorSets[level]);
+		if (level > 0)
+			vulkanDepthPyramidWriteImage(context.device, descriptorSets[level], 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, sampler.sampler, levelImageViews[level - 1], VK_IMAGE_LAYOUT_GENERAL);
+		vulkanDepthPyramidWriteImage(context.device, descriptorSets[level], 1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_NULL_HANDLE, levelImageViews[level], VK_IMAGE_LAYOUT_GENERAL);
+	}
+}
+
+// VulkanDepthPyramid::~VulkanDepthPyramid
+VulkanDepthPyramid::~VulkanDepthPyramid()
+{
+	// destroy descriptor sets
+	for (auto& descriptorSet : descriptorSets)
+		vulkanDescriptorSetDestroy(context.device, descriptorSet);
+	// destroy image views and image
+	for (auto& levelImageView : levelImageViews)
+		vkDestroyImageView(context.device.device, levelImageView, VK_NULL_HANDLE);
+	vkDestroyImageView(context.device.device, imageView, VK_NULL_HANDLE);
+	vmaDestroyImage(context.device.allocator, image, allocation);
+	// destroy sampler and pipeline
+	vulkanSamplerDestroy(context.device, sampler);
+	vulkanPipelineDestroy(context.device, pipeline_depth_pyramid);
+}
+
+// VulkanDepthPyramid::build
+void VulkanDepthPyramid::build(VulkanCommandBuffer& commandBuffer, VkImageView depthImageView)
+{
+	// level 0 reduces depth attachment of frame
+	vulkanDepthPyramidWriteImage(context.device, descriptorSets[0], 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, sampler.sampler, depthImageView, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL);
+
+	// VkImageMemoryBarrier - previous pyramid is discarded (culling of previous frame has read it)
+	VkImageMemoryBarrier imageMemoryBarrier{};
+	imageMemoryBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+	imageMemoryBarrier.pNext = VK_NULL_HANDLE;
+	imageMemoryBarrier.srcAccessMask = 0;
+	imageMemoryBarrier.dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+	imageMemoryBarrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	imageMemoryBarrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+	imageMemoryBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	imageMemoryBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	imageMemoryBarrier.image = image;
+	imageMemoryBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	imageMemoryBarrier.subresourceRange.baseMipLevel = 0;
+	imageMemoryBarrier.subresourceRange.levelCount = levelsCount;
+	imageMemoryBarrier.subresourceRange.baseArrayLayer = 0;
+	imageMemoryBarrier.subresourceRange.layerCount = 1;
+	vkCmdPipelineBarrier(commandBuffer.commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, VK_NULL_HANDLE, 0, VK_NULL_HANDLE, 1, &imageMemoryBarrier);
+
+	// VkMemoryBarrier - each level is read by next level and culling
+	VkMemoryBarrier memoryBarrier{};
+	memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+	memoryBarrier.pNext = VK_NULL_HANDLE;
+	memoryBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+	memoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+	// reduce levels
+	vkCmdBindPipeline(commandBuffer.commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline_depth_pyramid.pipeline);
+	for (uint32_t level = 0; level < levelsCount; level++) {
+		uint32_t levelWidth = std::max(1U, width >> level);
+		uint32_t levelHeight = std::max(1U, height >> level);
+		vkCmdBindDescriptorSets(commandBuffer.commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, context.pipelineLayout_depthPyramid.pipelineLayout, 0, 1, &descriptorSets[level].descriptorSet, 0, VK_NULL_HANDLE);
+		vkCmdDispatch(commandBuffer.commandBuffer,
+			(levelWidth + VULKAN_DEPTH_PYRAMID_GROUP_SIZE - 1) / VULKAN_DEPTH_PYRAMID_GROUP_SIZE,
+			(levelHeight + VULKAN_DEPTH_PYRAMID_GROUP_SIZE - 1) / VULKAN_DEPTH_PYRAMID_GROUP_SIZE, 1);
+		vkCmdPipelineBarrier(commandBuffer.commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &memoryBarrier, 0, VK_NULL_HANDLE, 0, VK_NULL_HANDLE);
+	}
+}
+
+// VulkanDepthPyramid::updateDescriptorSet
+void VulkanDepthPyramid::updateDescriptorSet(VulkanDescriptorSet& descriptorSet, uint32_t binding)
+{
+	vulkanDepthPyramidWriteImage(context.device, descriptorSet, binding, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, sampler.sampler, imageView, VK_IMAGE_LAYOUT_GENERAL);
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "vulkan_context.hpp"
+#include <vector>
+
+// depth pyramid shader work group size (must match shader)
+#define VULKAN_DEPTH_PYRAMID_GROUP_SIZE 8
+
+// VulkanDepthPyramid (farthest depth mip chain of depth attachment for occlusion culling)
+class VulkanDepthPyramid {
+protected:
+	// base handles
+	VulkanContext& context;
+protected:
+	// reduction shader file
+	const char* shader_depth_pyramid_file_comp = "shaders/depth_pyramid.comp.spv";
+	// compute pipeline
+	VulkanPipeline pipeline_depth_pyramid{};
+protected:
+	// depth attachment size and pyramid size (level 0 is half of depth attachment)
+	uint32_t depthWidth{};
+	uint32_t depthHeight{};
+	uint32_t width{};
+	uint32_t height{};
+	uint32_t levelsCount{};
+	// pyramid image (general layout), view of all levels and views of single levels
+	VkImage                  image{};
+	VmaAllocation            allocation{};
+	VkImageView              imageView{};
+	std::vector<VkImageView> levelImageViews{};
+	// nearest sampler (texels are fetched)
+	VulkanSampler sampler{};
+	// descriptor set per level (source is depth attachment or previous level)
+	std::vector<VulkanDescriptorSet> descriptorSets{};
+public:
+	// constructor and destructor
+	VulkanDepthPyramid(VulkanContext& context, uint32_t depthWidth, uint32_t depthHeight);
+	~VulkanDepthPyramid();
+
+	// record pyramid build (depth attachment view has depth aspect only, in depth-stencil read only layout)
+	void build(VulkanCommandBuffer& commandBuffer, VkImageView depthImageView);
+
+	// write pyramid into descriptor set as combined image sampler
+	void updateDescriptorSet(VulkanDescriptorSet& descriptorSet, uint32_t binding);
+
+	// getters
+	uint32_t getDepthWidth() const { return depthWidth; }
+	uint32_t getDepthHeight() const { return depthHeight; }
+	uint32_t getLevelsCount() const { return levelsCount; }
+};
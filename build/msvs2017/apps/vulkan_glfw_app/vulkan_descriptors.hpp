@@ -41,6 +41,18 @@ const VkVertexInputAttributeDescription vertexAttributeDescriptions_mesh_obj[]{
 
 //////////////////////////////////////////////////////////////////////////
 
+// VkVertexInputBindingDescription (position stream of mesh objects, depth only pipelines)
+const VkVertexInputBindingDescription vertexBindingDescriptions_mesh_obj_depth[]{
+{ 0, sizeof(float) * 4, VK_VERTEX_INPUT_RATE_VERTEX },
+};
+
+// VkVertexInputAttributeDescription
+const VkVertexInputAttributeDescription vertexAttributeDescriptions_mesh_obj_depth[]{
+{ 0, 0, VK_FORMAT_R32G32B32A32_SFLOAT, 0 }, // position - 4
+};
+
+//////////////////////////////////////////////////////////////////////////
+
 // VkVertexInputBindingDescription
 const VkVertexInputBindingDescription vertexBindingDescriptions_mesh_obj_bump[]{
 { 0, sizeof(float) * 4, VK_VERTEX_INPUT_RATE_VERTEX },
@@ -134,7 +146,87 @@ const VkDescriptorSetLayoutBinding descriptorSetLayoutBindings_model[]{
 // VkDescriptorSetLayoutBinding - Scene set
 const VkDescriptorSetLayoutBinding descriptorSetLayoutBindings_scene[]{
 { 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT, VK_NULL_HANDLE }, // camera (view, projection)
-{ 1, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT, VK_NULL_HANDLE }, // light sources
+{ 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_FRAGMENT_BIT, VK_NULL_HANDLE }, // light sources (point lights)
+{ 2, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_FRAGMENT_BIT, VK_NULL_HANDLE }, // shadow data (cascade matrices and splits)
+{ 3, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_FRAGMENT_BIT, VK_NULL_HANDLE }, // shadow maps (layer per cascade)
+{ 4, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_FRAGMENT_BIT, VK_NULL_HANDLE }, // light clusters (light counts and light indices per cluster)
+{ 5, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_FRAGMENT_BIT, VK_NULL_HANDLE }, // light clusters data (view of clusters, depth slices)
+};
+
+// VkDescriptorSetLayoutBinding - Draw set
+const VkDescriptorSetLayoutBinding descriptorSetLayoutBindings_draw[]{
+{ 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT, VK_NULL_HANDLE }, // draw data (model matrix, material id)
+};
+
+// VkDescriptorSetLayoutBinding - Cull set (compute)
+const VkDescriptorSetLayoutBinding descriptorSetLayoutBindings_cull[]{
+{ 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, VK_NULL_HANDLE }, // frustum planes, instances and commands count
+{ 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, VK_NULL_HANDLE }, // draw data (model matrix per instance)
+{ 2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, VK_NULL_HANDLE }, // cull data (bounding volumes, command of instance)
+{ 3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, VK_NULL_HANDLE }, // indirect commands
+{ 4, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, VK_NULL_HANDLE }, // culled indirect commands
+{ 5, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, VK_NULL_HANDLE }, // culled draw counts
+{ 6, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, VK_NULL_HANDLE }, // visibility of previous frame with same index
+{ 7, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_COMPUTE_BIT, VK_NULL_HANDLE }, // depth pyramid (occlusion phase)
+{ 8, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, VK_NULL_HANDLE }, // command cull data (batch of command)
+{ 9, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, VK_NULL_HANDLE }, // culled instance counts (per command)
+{ 10, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, VK_NULL_HANDLE }, // culled draw data (visible instances)
+};
+
+// VkDescriptorSetLayoutBinding - Depth pyramid set (compute)
+const VkDescriptorSetLayoutBinding descriptorSetLayoutBindings_depthPyramid[]{
+{ 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_COMPUTE_BIT, VK_NULL_HANDLE }, // source depth or level
+{ 1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,          1, VK_SHADER_STAGE_COMPUTE_BIT, VK_NULL_HANDLE }, // reduced level
+};
+
+// VkDescriptorSetLayoutBinding - Light clusters set (compute)
+const VkDescriptorSetLayoutBinding descriptorSetLayoutBindings_lightClusters[]{
+{ 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, VK_NULL_HANDLE }, // light clusters data (view of clusters, depth slices, lights count)
+{ 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, VK_NULL_HANDLE }, // light sources (point lights)
+{ 2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, VK_NULL_HANDLE }, // light clusters (light counts and light indices per cluster)
+};
+
+// VkDescriptorSetLayoutBinding - Debug geometry set (compute)
+const VkDescriptorSetLayoutBinding descriptorSetLayoutBindings_debugGeometry[]{
+{ 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, VK_NULL_HANDLE }, // debug geometry data (line length, source and debug vertex ranges)
+{ 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, VK_NULL_HANDLE }, // geometry pool positions
+{ 2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, VK_NULL_HANDLE }, // geometry pool texture coordinates
+{ 3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, VK_NULL_HANDLE }, // geometry pool normals
+};
+
+// VkDescriptorSetLayoutBinding - Skinning set (compute)
+const VkDescriptorSetLayoutBinding descriptorSetLayoutBindings_skinning[]{
+{ 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, VK_NULL_HANDLE }, // skinning jobs (skin vertex range, pool vertex range, palette)
+{ 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, VK_NULL_HANDLE }, // joint matrices palette (all skinned meshes of frame)
+{ 2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, VK_NULL_HANDLE }, // geometry pool skin vertices
+{ 3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, VK_NULL_HANDLE }, // geometry pool positions
+{ 4, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, VK_NULL_HANDLE }, // geometry pool normals
+};
+
+// VkDescriptorSetLayoutBinding - Particles set (compute)
+const VkDescriptorSetLayoutBinding descriptorSetLayoutBindings_particles[]{
+{ 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, VK_NULL_HANDLE }, // particles data (gravity and time step, emitters)
+{ 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, VK_NULL_HANDLE }, // particle state (position and age, velocity and emitter)
+{ 2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, VK_NULL_HANDLE }, // dead list
+{ 3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, VK_NULL_HANDLE }, // alive lists
+{ 4, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, VK_NULL_HANDLE }, // counters (simulation dispatch, alive, dead and emitted counts)
+{ 5, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, VK_NULL_HANDLE }, // drawn instances (position and size)
+{ 6, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, VK_NULL_HANDLE }, // drawn instances (packed color)
+{ 7, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, VK_NULL_HANDLE }, // indirect draw
+};
+
+// VkDescriptorSetLayoutBinding - Particles draw set
+const VkDescriptorSetLayoutBinding descriptorSetLayoutBindings_particlesDraw[]{
+{ 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT, VK_NULL_HANDLE }, // drawn instances (position and size)
+{ 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT, VK_NULL_HANDLE }, // drawn instances (packed color)
+};
+
+// VkDescriptorSetLayoutBinding - G-buffer set (deferred lighting subpass)
+const VkDescriptorSetLayoutBinding descriptorSetLayoutBindings_gbuffer[]{
+{ 0, VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, 1, VK_SHADER_STAGE_FRAGMENT_BIT, VK_NULL_HANDLE }, // albedo
+{ 1, VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, 1, VK_SHADER_STAGE_FRAGMENT_BIT, VK_NULL_HANDLE }, // normal and lit flag
+{ 2, VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, 1, VK_SHADER_STAGE_FRAGMENT_BIT, VK_NULL_HANDLE }, // depth
+{ 3, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_FRAGMENT_BIT, VK_NULL_HANDLE }, // deferred data (inverse view-projection, view, viewport)
 };
 
 //////////////////////////////////////////////////////////////////////////
@@ -149,5 +241,31 @@ const VkPipelineColorBlendAttachmentState pipelineColorBlendAttachmentStates_def
 	}
 };
 
+// VkPipelineColorBlendAttachmentState - additive (particles, destination alpha is kept)
+const VkPipelineColorBlendAttachmentState pipelineColorBlendAttachmentStates_additive[]{
+	{ // first attachments
+		VK_TRUE,
+		VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_ONE, VK_BLEND_OP_ADD,
+		VK_BLEND_FACTOR_ZERO, VK_BLEND_FACTOR_ONE, VK_BLEND_OP_ADD,
+		VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT
+	}
+};
+
+// VkPipelineColorBlendAttachmentState - G-buffer attachments (albedo, normal and lit flag)
+const VkPipelineColorBlendAttachmentState pipelineColorBlendAttachmentStates_gbuffer[]{
+	{ // albedo
+		VK_FALSE,
+		VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_ZERO, VK_BLEND_OP_ADD,
+		VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_ZERO, VK_BLEND_OP_ADD,
+		VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT
+	},
+	{ // normal and lit flag
+		VK_FALSE,
+		VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_ZERO, VK_BLEND_OP_ADD,
+		VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_ZERO, VK_BLEND_OP_ADD,
+		VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT
+	}
+};
+
 // vulkanDescriptorsInit
 void vulkanDescriptorsInit();
\ No newline at end of file
@@ -0,0 +1,311 @@
+#include "vulkan_draw_culling.hpp"
+#include <glm/matrix.hpp>
+#include <algorithm>
+
+// VulkanDrawCulling::VulkanDrawCulling
+VulkanDrawCulling::VulkanDrawCulling(VulkanContext& context, uint32_t framesCount) :
+	context(context)
+{
+	// create compute pipelines
+	vulkanPipelineCreateCompute(context.device, shader_cull_frustum_file_comp, context.pipelineLayout_cull, &pipeline_cull_frustum);
+	vulkanPipelineCreateCompute(context.device, shader_cull_occlusion_file_comp, context.pipelineLayout_cull, &pipeline_cull_occlusion);
+	vulkanPipelineCreateCompute(context.device, shader_cull_commands_file_comp, context.pipelineLayout_cull, &pipeline_cull_commands);
+
+	// VkCommandPoolCreateInfo - compute queue family
+	VkCommandPoolCreateInfo commandPoolCreateInfo{};
+	commandPoolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+	commandPoolCreateInfo.pNext = VK_NULL_HANDLE;
+	commandPoolCreateInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+	commandPoolCreateInfo.queueFamilyIndex = context.device.queueFamilyIndexCompute;
+	VKT_CHECK(vkCreateCommandPool(context.device.device, &commandPoolCreateInfo, VK_NULL_HANDLE, &commandPool));
+	assert(commandPool);
+
+	// create per frame handles
+	commandBuffers.resize(framesCount);
+	semaphores.resize(framesCount);
+	recorded.resize(framesCount, VK_FALSE);
+	instancesCounts.resize(framesCount, 0);
+	commandsCounts.resize(framesCount, 0);
+	cullDataBuffers.resize(framesCount);
+	commandCullDataBuffers.resize(framesCount);
+	uniformBuffers.resize(framesCount);
+	phases.resize(framesCount);
+	occlusionPhases.resize(framesCount);
+	visibilityBuffers.resize(framesCount);
+	visibilityCleared.resize(framesCount, VK_FALSE);
+	for (uint32_t frameIndex = 0; frameIndex < framesCount; frameIndex++) {
+		// VkCommandBufferAllocateInfo
+		VkCommandBufferAllocateInfo commandBufferAllocateInfo{};
+		commandBufferAllocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		commandBufferAllocateInfo.pNext = VK_NULL_HANDLE;
+		commandBufferAllocateInfo.commandPool = commandPool;
+		commandBufferAllocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+		commandBufferAllocateInfo.commandBufferCount = 1;
+		VKT_CHECK(vkAllocateCommandBuffers(context.device.device, &commandBufferAllocateInfo, &commandBuffers[frameIndex].commandBuffer));
+		assert(commandBuffers[frameIndex].commandBuffer);
+
+		// semaphore, uniforms, descriptor sets and buffers (phases of frame share uniforms and visibility)
+		vulkanSemaphoreCreate(context.device, &semaphores[frameIndex]);
+		vulkanBufferCreateMapped(context.device, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, sizeof(VulkanCullUniforms), &uniformBuffers[frameIndex]);
+		for (VulkanDrawCullingPhase* phase : { &phases[frameIndex], &occlusionPhases[frameIndex] }) {
+			vulkanDescriptorSetCreate(context.device, context.descriptorSetLayout_cull, &phase->descriptorSet);
+			vulkanDescriptorSetCreate(context.device, context.descriptorSetLayout_draw, &phase->drawDescriptorSet);
+			vulkanDescriptorSetUpdateBufferUniform(context.device, phase->descriptorSet, uniformBuffers[frameIndex], 0);
+		}
+		createBuffers(frameIndex, 1024);
+	}
+}
+
+// VulkanDrawCulling::~VulkanDrawCulling
+VulkanDrawCulling::~VulkanDrawCulling()
+{
+	// destroy per frame handles
+	for (uint32_t frameIndex = 0; frameIndex < (uint32_t)commandBuffers.size(); frameIndex++) {
+		destroyBuffers(frameIndex);
+		for (VulkanDrawCullingPhase* phase : { &occlusionPhases[frameIndex], &phases[frameIndex] }) {
+			vulkanDescriptorSetDestroy(context.device, phase->drawDescriptorSet);
+			vulkanDescriptorSetDestroy(context.device, phase->descriptorSet);
+		}
+		vulkanBufferDestroy(context.device, uniformBuffers[frameIndex]);
+		vulkanSemaphoreDestroy(context.device, semaphores[frameIndex]);
+	}
+	// destroy command pool (frees command buffers)
+	vkDestroyCommandPool(context.device.device, commandPool, VK_NULL_HANDLE);
+	commandPool = VK_NULL_HANDLE;
+	// destroy compute pipelines
+	vulkanPipelineDestroy(context.device, pipeline_cull_commands);
+	vulkanPipelineDestroy(context.device, pipeline_cull_occlusion);
+	vulkanPipelineDestroy(context.device, pipeline_cull_frustum);
+}
+
+// VulkanDrawCulling::createBuffers
+void VulkanDrawCulling::createBuffers(uint32_t frameIndex, VkDeviceSize instancesCapacity)
+{
+	// visibility is indexed by packet push order (previous visibility of frame is lost)
+	vulkanBufferCreateShared(context.device, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, instancesCapacity * sizeof(uint32_t), &visibilityBuffers[frameIndex]);
+	visibilityCleared[frameIndex] = VK_FALSE;
+	// cull data is written by host (commands count never exceeds instances count)
+	vulkanBufferCreateMapped(context.device, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, instancesCapacity * sizeof(VulkanDrawCullData), &cullDataBuffers[frameIndex]);
+	vulkanBufferCreateMapped(context.device, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, instancesCapacity * sizeof(VulkanDrawCommandCullData), &commandCullDataBuffers[frameIndex]);
+	createPhaseBuffers(phases[frameIndex], frameIndex, instancesCapacity);
+	createPhaseBuffers(occlusionPhases[frameIndex], frameIndex, instancesCapacity);
+}
+
+// VulkanDrawCulling::destroyBuffers
+void VulkanDrawCulling::destroyBuffers(uint32_t frameIndex)
+{
+	destroyPhaseBuffers(occlusionPhases[frameIndex]);
+	destroyPhaseBuffers(phases[frameIndex]);
+	vulkanBufferDestroy(context.device, commandCullDataBuffers[frameIndex]);
+	vulkanBufferDestroy(context.device, cullDataBuffers[frameIndex]);
+	vulkanBufferDestroy(context.device, visibilityBuffers[frameIndex]);
+}
+
+// VulkanDrawCulling::createPhaseBuffers
+void VulkanDrawCulling::createPhaseBuffers(VulkanDrawCullingPhase& phase, uint32_t frameIndex, VkDeviceSize instancesCapacity)
+{
+	// culled instances, commands and counts stay on device (batches count never exceeds commands count)
+	vulkanBufferCreateShared(context.device, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, instancesCapacity * sizeof(uint32_t), &phase.instanceCountBuffer);
+	vulkanBufferCreateShared(context.device, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, instancesCapacity * sizeof(VulkanDrawData), &phase.drawDataBuffer);
+	vulkanBufferCreateShared(context.device, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, instancesCapacity * VULKAN_DRAW_INDIRECT_STRIDE, &phase.indirectBuffer);
+	vulkanBufferCreateShared(context.device, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, instancesCapacity * sizeof(uint32_t), &phase.countBuffer);
+	// update descriptor sets
+	vulkanDescriptorSetUpdateBufferStorage(context.device, phase.descriptorSet, cullDataBuffers[frameIndex], 2);
+	vulkanDescriptorSetUpdateBufferStorage(context.device, phase.descriptorSet, phase.indirectBuffer, 4);
+	vulkanDescriptorSetUpdateBufferStorage(context.device, phase.descriptorSet, phase.countBuffer, 5);
+	vulkanDescriptorSetUpdateBufferStorage(context.device, phase.descriptorSet, visibilityBuffers[frameIndex], 6);
+	vulkanDescriptorSetUpdateBufferStorage(context.device, phase.descriptorSet, commandCullDataBuffers[frameIndex], 8);
+	vulkanDescriptorSetUpdateBufferStorage(context.device, phase.descriptorSet, phase.instanceCountBuffer, 9);
+	vulkanDescriptorSetUpdateBufferStorage(context.device, phase.descriptorSet, phase.drawDataBuffer, 10);
+	vulkanDescriptorSetUpdateBufferStorage(context.device, phase.drawDescriptorSet, phase.drawDataBuffer, 0);
+}
+
+// VulkanDrawCulling::destroyPhaseBuffers
+void VulkanDrawCulling::destroyPhaseBuffers(VulkanDrawCullingPhase& phase)
+{
+	vulkanBufferDestroy(context.device, phase.countBuffer);
+	vulkanBufferDestroy(context.device, phase.indirectBuffer);
+	vulkanBufferDestroy(context.device, phase.drawDataBuffer);
+	vulkanBufferDestroy(context.device, phase.instanceCountBuffer);
+}
+
+// VulkanDrawCulling::recordPhase
+void VulkanDrawCulling::recordPhase(VkCommandBuffer commandBuffer, VulkanPipeline& pipeline, VulkanDrawCullingPhase& phase, uint32_t frameIndex)
+{
+	// reset instance counts and draw counts (culled instances and compacted commands are appended)
+	vkCmdFillBuffer(commandBuffer, phase.instanceCountBuffer.buffer, 0, VK_WHOLE_SIZE, 0);
+	vkCmdFillBuffer(commandBuffer, phase.countBuffer.buffer, 0, VK_WHOLE_SIZE, 0);
+
+	// VkMemoryBarrier - cleared counts visible to culling shaders
+	VkMemoryBarrier memoryBarrier{};
+	memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+	memoryBarrier.pNext = VK_NULL_HANDLE;
+	memoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	memoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+	vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &memoryBarrier, 0, VK_NULL_HANDLE, 0, VK_NULL_HANDLE);
+
+	// one invocation per instance
+	vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline.pipeline);
+	vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, context.pipelineLayout_cull.pipelineLayout, 0, 1, &phase.descriptorSet.descriptorSet, 0, VK_NULL_HANDLE);
+	vkCmdDispatch(commandBuffer, (instancesCounts[frameIndex] + VULKAN_CULL_GROUP_SIZE - 1) / VULKAN_CULL_GROUP_SIZE, 1, 1);
+
+	// VkMemoryBarrier - culled instance counts visible to command culling
+	memoryBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+	memoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+	vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &memoryBarrier, 0, VK_NULL_HANDLE, 0, VK_NULL_HANDLE);
+
+	// one invocation per command (same descriptor set)
+	vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline_cull_commands.pipeline);
+	vkCmdDispatch(commandBuffer, (commandsCounts[frameIndex] + VULKAN_CULL_GROUP_SIZE - 1) / VULKAN_CULL_GROUP_SIZE, 1, 1);
+}
+
+// VulkanDrawCulling::record
+void VulkanDrawCulling::record(uint32_t frameIndex, VulkanScene* scene, const VulkanRenderQueue& renderQueue, VulkanBuffer& drawDataBuffer, VulkanBuffer& drawIndirectBuffer, VkBool32 compact, VkBool32 occlusion)
+{
+	// empty queue has no batches to draw
+	recorded[frameIndex] = VK_FALSE;
+	uint32_t instancesCount = (uint32_t)renderQueue.size();
+	instancesCounts[frameIndex] = instancesCount;
+	commandsCounts[frameIndex] = (uint32_t)renderQueue.commandsCount();
+	if (instancesCount == 0)
+		return;
+
+	// grow frame buffers (frame is complete on device)
+	VkDeviceSize instancesCapacity = cullDataBuffers[frameIndex].size / sizeof(VulkanDrawCullData);
+	if (instancesCapacity < instancesCount) {
+		destroyBuffers(frameIndex);
+		createBuffers(frameIndex, std::max((VkDeviceSize)instancesCount, instancesCapacity * 2));
+	}
+	// input buffers are owned by renderer and may be recreated
+	for (VulkanDrawCullingPhase* phase : { &phases[frameIndex], &occlusionPhases[frameIndex] }) {
+		vulkanDescriptorSetUpdateBufferStorage(context.device, phase->descriptorSet, drawDataBuffer, 1);
+		vulkanDescriptorSetUpdateBufferStorage(context.device, phase->descriptorSet, drawIndirectBuffer, 3);
+	}
+
+	// frustum planes and positions of all views (instance is kept if visible in any view, meshlet if front facing in any view)
+	VulkanCullUniforms* uniforms = (VulkanCullUniforms*)uniformBuffers[frameIndex].allocationInfo.pMappedData;
+	scene->getFrustumPlanes(uniforms->frustumPlanes);
+	for (uint32_t viewIndex = 0; viewIndex < scene->viewsCount; viewIndex++)
+		uniforms->viewPositions[viewIndex] = glm::inverse(scene->matrixViews[viewIndex])[3];
+	uniforms->viewsCount = scene->viewsCount;
+	uniforms->instancesCount = instancesCount;
+	uniforms->commandsCount = commandsCounts[frameIndex];
+	uniforms->compact = compact;
+	uniforms->occlusion = occlusion;
+
+	// write cull data
+	renderQueue.writeCullData(
+		(VulkanDrawCullData*)cullDataBuffers[frameIndex].allocationInfo.pMappedData,
+		(VulkanDrawCommandCullData*)commandCullDataBuffers[frameIndex].allocationInfo.pMappedData);
+	vmaFlushAllocation(context.device.allocator, uniformBuffers[frameIndex].allocation, 0, VK_WHOLE_SIZE);
+	vmaFlushAllocation(context.device.allocator, cullDataBuffers[frameIndex].allocation, 0, VK_WHOLE_SIZE);
+	vmaFlushAllocation(context.device.allocator, commandCullDataBuffers[frameIndex].allocation, 0, VK_WHOLE_SIZE);
+
+	// VkCommandBufferBeginInfo
+	VkCommandBuffer commandBuffer = commandBuffers[frameIndex].commandBuffer;
+	VkCommandBufferBeginInfo commandBufferBeginInfo{};
+	commandBufferBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	commandBufferBeginInfo.pNext = VK_NULL_HANDLE;
+	commandBufferBeginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+	commandBufferBeginInfo.pInheritanceInfo = VK_NULL_HANDLE;
+	VKT_CHECK(vkBeginCommandBuffer(commandBuffer, &commandBufferBeginInfo));
+
+	// reset new visibility (nothing was visible, made visible by barrier of phase)
+	if (!visibilityCleared[frameIndex]) {
+		vkCmdFillBuffer(commandBuffer, visibilityBuffers[frameIndex].buffer, 0, VK_WHOLE_SIZE, 0);
+		visibilityCleared[frameIndex] = VK_TRUE;
+	}
+
+	// cull instances and commands
+	recordPhase(commandBuffer, pipeline_cull_frustum, phases[frameIndex], frameIndex);
+
+	// end command buffer (semaphore makes results visible to indirect draws)
+	VKT_CHECK(vkEndCommandBuffer(commandBuffer));
+	recorded[frameIndex] = VK_TRUE;
+}
+
+// VulkanDrawCulling::recordOcclusion
+void VulkanDrawCulling::recordOcclusion(VulkanCommandBuffer& commandBuffer, uint32_t frameIndex, VulkanScene* scene, VulkanDepthPyramid& depthPyramid)
+{
+	// first phase culling is recorded (and not submitted yet)
+	if (!recorded[frameIndex] || instancesCounts[frameIndex] == 0)
+		return;
+
+	// depth pyramid and projection of first view
+	depthPyramid.updateDescriptorSet(occlusionPhases[frameIndex].descriptorSet, 7);
+	VulkanCullUniforms* uniforms = (VulkanCullUniforms*)uniformBuffers[frameIndex].allocationInfo.pMappedData;
+	uniforms->viewProjection = scene->matrixProjection * scene->matrixView;
+	uniforms->depthSize = glm::vec2((float)depthPyramid.getDepthWidth(), (float)depthPyramid.getDepthHeight());
+	uniforms->pyramidLevels = depthPyramid.getLevelsCount();
+	vmaFlushAllocation(context.device.allocator, uniformBuffers[frameIndex].allocation, 0, VK_WHOLE_SIZE);
+
+	// cull instances against depth pyramid and commands
+	recordPhase(commandBuffer.commandBuffer, pipeline_cull_occlusion, occlusionPhases[frameIndex], frameIndex);
+
+	// VkMemoryBarrier - culled commands, counts and draw data visible to indirect draws
+	VkMemoryBarrier memoryBarrier{};
+	memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+	memoryBarrier.pNext = VK_NULL_HANDLE;
+	memoryBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+	memoryBarrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+	vkCmdPipelineBarrier(commandBuffer.commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT, 0, 1, &memoryBarrier, 0, VK_NULL_HANDLE, 0, VK_NULL_HANDLE);
+}
+
+// VulkanDrawCulling::submit
+VkSemaphore VulkanDrawCulling::submit(uint32_t frameIndex)
+{
+	// nothing recorded
+	if (!recorded[frameIndex])
+		return VK_NULL_HANDLE;
+	recorded[frameIndex] = VK_FALSE;
+
+	// VkSubmitInfo
+	VkSubmitInfo submitInfo{};
+	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	submitInfo.pNext = VK_NULL_HANDLE;
+	submitInfo.waitSemaphoreCount = 0;
+	submitInfo.pWaitSemaphores = VK_NULL_HANDLE;
+	submitInfo.pWaitDstStageMask = VK_NULL_HANDLE;
+	submitInfo.commandBufferCount = 1;
+	submitInfo.pCommandBuffers = &commandBuffers[frameIndex].commandBuffer;
+	submitInfo.signalSemaphoreCount = 1;
+	submitInfo.pSignalSemaphores = &semaphores[frameIndex].semaphore;
+	VKT_CHECK(vkQueueSubmit(context.device.queueCompute, 1, &submitInfo, VK_NULL_HANDLE));
+	return semaphores[frameIndex].semaphore;
+}
+
+// VulkanDrawCulling::getIndirectBuffer
+VkBuffer VulkanDrawCulling::getIndirectBuffer(uint32_t frameIndex)
+{
+	return phases[frameIndex].indirectBuffer.buffer;
+}
+
+// VulkanDrawCulling::getCountBuffer
+VkBuffer VulkanDrawCulling::getCountBuffer(uint32_t frameIndex)
+{
+	return phases[frameIndex].countBuffer.buffer;
+}
+
+// VulkanDrawCulling::getDrawDescriptorSet
+VkDescriptorSet VulkanDrawCulling::getDrawDescriptorSet(uint32_t frameIndex)
+{
+	return phases[frameIndex].drawDescriptorSet.descriptorSet;
+}
+
+// VulkanDrawCulling::getOcclusionIndirectBuffer
+VkBuffer VulkanDrawCulling::getOcclusionIndirectBuffer(uint32_t frameIndex)
+{
+	return occlusionPhases[frameIndex].indirectBuffer.buffer;
+}
+
+// VulkanDrawCulling::getOcclusionCountBuffer
+VkBuffer VulkanDrawCulling::getOcclusionCountBuffer(uint32_t frameIndex)
+{
+	return occlusionPhases[frameIndex].countBuffer.buffer;
+}
+
+// VulkanDrawCulling::getOcclusionDrawDescriptorSet
+VkDescriptorSet VulkanDrawCulling::getOcclusionDrawDescriptorSet(uint32_t frameIndex)
+{
+	return occlusionPhases[frameIndex].drawDescriptorSet.descriptorSet;
+}
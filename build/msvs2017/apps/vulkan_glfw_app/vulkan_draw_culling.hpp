@@ -0,0 +1,102 @@
+#pragma once
+
+#include "vulkan_context.hpp"
+#include "vulkan_scene.hpp"
+#include "vulkan_render_queue.hpp"
+#include "vulkan_depth_pyramid.hpp"
+
+// culling shader work group size (must match shader)
+#define VULKAN_CULL_GROUP_SIZE 64
+
+// VulkanCullUniforms (std140 uniforms of culling shaders)
+struct VulkanCullUniforms {
+	glm::vec4 frustumPlanes[VULKAN_SCENE_MAX_VIEWS * 6];
+	glm::vec4 viewPositions[VULKAN_SCENE_MAX_VIEWS];
+	uint32_t  viewsCount;
+	uint32_t  instancesCount;
+	uint32_t  commandsCount;
+	uint32_t  compact;
+	uint32_t  occlusion;
+	uint32_t  padding0[3];
+	// occlusion phase (first view)
+	glm::mat4 viewProjection;
+	glm::vec2 depthSize;
+	uint32_t  pyramidLevels;
+	uint32_t  padding1;
+};
+
+// VulkanDrawCullingPhase (culled instances and commands of one phase, drawn with its draw descriptor set)
+struct VulkanDrawCullingPhase {
+	VulkanBuffer        instanceCountBuffer;
+	VulkanBuffer        drawDataBuffer;
+	VulkanBuffer        indirectBuffer;
+	VulkanBuffer        countBuffer;
+	VulkanDescriptorSet descriptorSet;
+	VulkanDescriptorSet drawDescriptorSet;
+};
+
+// VulkanDrawCulling (frustum and meshlet backface culling of render queue instances on compute queue, culled commands keep visible instances)
+class VulkanDrawCulling {
+protected:
+	// base handles
+	VulkanContext& context;
+protected:
+	// culling shader files
+	const char* shader_cull_frustum_file_comp = "shaders/cull_frustum.comp.spv";
+	const char* shader_cull_occlusion_file_comp = "shaders/cull_occlusion.comp.spv";
+	const char* shader_cull_commands_file_comp = "shaders/cull_commands.comp.spv";
+	// compute pipelines (instances are culled first, commands are written from culled instance counts)
+	VulkanPipeline pipeline_cull_frustum{};
+	VulkanPipeline pipeline_cull_occlusion{};
+	VulkanPipeline pipeline_cull_commands{};
+protected:
+	// compute command pool, command buffers and semaphores waited by graphics queue (per frame)
+	VkCommandPool                    commandPool{};
+	std::vector<VulkanCommandBuffer> commandBuffers{};
+	std::vector<VulkanSemaphore>     semaphores{};
+	std::vector<VkBool32>            recorded{};
+	std::vector<uint32_t>            instancesCounts{};
+	std::vector<uint32_t>            commandsCounts{};
+	// host written cull data and uniforms (per frame, grown with render queue)
+	std::vector<VulkanBuffer>        cullDataBuffers{};
+	std::vector<VulkanBuffer>        commandCullDataBuffers{};
+	std::vector<VulkanBuffer>        uniformBuffers{};
+	// first phase recorded on compute queue, occlusion phase recorded on graphics queue (per frame, grown with render queue)
+	std::vector<VulkanDrawCullingPhase> phases{};
+	std::vector<VulkanDrawCullingPhase> occlusionPhases{};
+	// visibility of instances written by occlusion phase, read by first phase of next frame with same index (per frame, frames in flight never share it)
+	std::vector<VulkanBuffer>        visibilityBuffers{};
+	std::vector<VkBool32>            visibilityCleared{};
+protected:
+	// create and destroy frame buffers
+	void createBuffers(uint32_t frameIndex, VkDeviceSize instancesCapacity);
+	void destroyBuffers(uint32_t frameIndex);
+	void createPhaseBuffers(VulkanDrawCullingPhase& phase, uint32_t frameIndex, VkDeviceSize instancesCapacity);
+	void destroyPhaseBuffers(VulkanDrawCullingPhase& phase);
+
+	// record culling of instances and commands of phase
+	void recordPhase(VkCommandBuffer commandBuffer, VulkanPipeline& pipeline, VulkanDrawCullingPhase& phase, uint32_t frameIndex);
+public:
+	// constructor and destructor
+	VulkanDrawCulling(VulkanContext& context, uint32_t framesCount);
+	~VulkanDrawCulling();
+
+	// record culling of sorted render queue (draw data and indirect commands of frame are written by host)
+	void record(uint32_t frameIndex, VulkanScene* scene, const VulkanRenderQueue& renderQueue, VulkanBuffer& drawDataBuffer, VulkanBuffer& drawIndirectBuffer, VkBool32 compact, VkBool32 occlusion);
+
+	// record occlusion phase of recorded frame into graphics command buffer (tests all instances against depth of first phase)
+	void recordOcclusion(VulkanCommandBuffer& commandBuffer, uint32_t frameIndex, VulkanScene* scene, VulkanDepthPyramid& depthPyramid);
+
+	// submit recorded frame to compute queue (returns semaphore to wait before indirect draws, or VK_NULL_HANDLE)
+	VkSemaphore submit(uint32_t frameIndex);
+
+	// culled indirect commands, draw counts and draw data descriptor set (set 3) of frame
+	VkBuffer getIndirectBuffer(uint32_t frameIndex);
+	VkBuffer getCountBuffer(uint32_t frameIndex);
+	VkDescriptorSet getDrawDescriptorSet(uint32_t frameIndex);
+
+	// newly visible indirect commands, draw counts and draw data descriptor set of occlusion phase
+	VkBuffer getOcclusionIndirectBuffer(uint32_t frameIndex);
+	VkBuffer getOcclusionCountBuffer(uint32_t frameIndex);
+	VkDescriptorSet getOcclusionDrawDescriptorSet(uint32_t frameIndex);
+};
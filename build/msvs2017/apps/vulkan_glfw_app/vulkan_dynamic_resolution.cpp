@@ -0,0 +1,119 @@
+#include "vulkan_dynamic_resolution.hpp"
+#include <algorithm>
+#include <cmath>
+
+// VulkanDynamicResolution::VulkanDynamicResolution
+VulkanDynamicResolution::VulkanDynamicResolution(VulkanContext& context) :
+	context(context)
+{
+}
+
+// VulkanDynamicResolution::~VulkanDynamicResolution
+VulkanDynamicResolution::~VulkanDynamicResolution()
+{
+	// destroy timestamp queries
+	destroyQueries();
+}
+
+// VulkanDynamicResolution::createQueries
+void VulkanDynamicResolution::createQueries(uint32_t framesCount)
+{
+	// create timestamp queries (begin and end of each frame)
+	queried.assign(framesCount, VK_FALSE);
+	if (context.device.queueFamilyPropertiesGraphics.timestampValidBits) {
+		// VkQueryPoolCreateInfo
+		VkQueryPoolCreateInfo queryPoolCreateInfo{};
+		queryPoolCreateInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+		queryPoolCreateInfo.pNext = VK_NULL_HANDLE;
+		queryPoolCreateInfo.flags = 0;
+		queryPoolCreateInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+		queryPoolCreateInfo.queryCount = framesCount * 2;
+		queryPoolCreateInfo.pipelineStatistics = 0;
+		VKT_CHECK(vkCreateQueryPool(context.device.device, &queryPoolCreateInfo, VK_NULL_HANDLE, &queryPool));
+		assert(queryPool);
+	}
+}
+
+// VulkanDynamicResolution::destroyQueries
+void VulkanDynamicResolution::destroyQueries()
+{
+	// destroy timestamp queries (frames are complete on device)
+	vkDestroyQueryPool(context.device.device, queryPool, VK_NULL_HANDLE);
+	queryPool = VK_NULL_HANDLE;
+	queried.clear();
+}
+
+// VulkanDynamicResolution::set
+VkBool32 VulkanDynamicResolution::set(VkBool32 enabled, float targetTime, float scaleMin)
+{
+	// disabled dynamic resolution renders at full scale again
+	this->enabled = enabled;
+	this->targetTime = targetTime;
+	this->scaleMin = std::min(std::max(scaleMin, VULKAN_DYNAMIC_RESOLUTION_SCALE_STEP), 1.0f);
+	if (enabled || scaleApplied == 1.0f)
+		return VK_FALSE;
+	reset();
+	return VK_TRUE;
+}
+
+// VulkanDynamicResolution::update
+VkBool32 VulkanDynamicResolution::update()
+{
+	// no measured frame time keeps scale
+	if (!enabled || frameTime <= 0.0f)
+		return VK_FALSE;
+
+	// shading cost follows pixels count (square of scale), move part way to scale of target time against noise
+	float targetScale = scale * std::sqrt(targetTime / frameTime);
+	scale += (targetScale - scale) * 0.25f;
+	scale = std::min(std::max(scale, scaleMin), 1.0f);
+
+	// scale of render targets moves when scale moved by more than one step (snapped to steps, full extent at top)
+	if (std::abs(scale - scaleApplied) <= VULKAN_DYNAMIC_RESOLUTION_SCALE_STEP)
+		return VK_FALSE;
+	float appliedScale = std::round(scale / VULKAN_DYNAMIC_RESOLUTION_SCALE_STEP) * VULKAN_DYNAMIC_RESOLUTION_SCALE_STEP;
+	scaleApplied = std::min(std::max(appliedScale, scaleMin), 1.0f);
+	return VK_TRUE;
+}
+
+// VulkanDynamicResolution::reset
+void VulkanDynamicResolution::reset()
+{
+	// full scale
+	scale = 1.0f;
+	scaleApplied = 1.0f;
+}
+
+// VulkanDynamicResolution::beginFrame
+void VulkanDynamicResolution::beginFrame(VulkanCommandBuffer& commandBuffer, uint32_t frameIndex)
+{
+	// timestamps are not supported
+	if (!queryPool)
+		return;
+
+	// previous results of frame (frame is complete on device, ticks are masked by valid bits)
+	if (queried[frameIndex]) {
+		uint64_t timestamps[2]{};
+		VkResult result = vkGetQueryPoolResults(context.device.device, queryPool, frameIndex * 2, 2,
+			sizeof(timestamps), timestamps, sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+		assert(result == VK_SUCCESS || result == VK_NOT_READY);
+		uint32_t validBits = context.device.queueFamilyPropertiesGraphics.timestampValidBits;
+		uint64_t validMask = validBits >= 64 ? ~0ULL : ((1ULL << validBits) - 1);
+		uint64_t ticks = ((timestamps[1] & validMask) - (timestamps[0] & validMask)) & validMask;
+		if (result == VK_SUCCESS)
+			frameTime = (float)((double)ticks * context.device.physicalDeviceProperties.limits.timestampPeriod * 1e-6);
+	}
+
+	// begin timestamp of frame
+	vkCmdResetQueryPool(commandBuffer.commandBuffer, queryPool, frameIndex * 2, 2);
+	vkCmdWriteTimestamp(commandBuffer.commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, queryPool, frameIndex * 2);
+	queried[frameIndex] = VK_TRUE;
+}
+
+// VulkanDynamicResolution::endFrame
+void VulkanDynamicResolution::endFrame(VulkanCommandBuffer& commandBuffer, uint32_t frameIndex)
+{
+	// end timestamp of frame (all recorded work is complete)
+	if (queryPool)
+		vkCmdWriteTimestamp(commandBuffer.commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, queryPool, frameIndex * 2 + 1);
+}
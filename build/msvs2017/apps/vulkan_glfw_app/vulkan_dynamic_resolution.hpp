@@ -0,0 +1,50 @@
+#pragma once
+
+#include "vulkan_context.hpp"
+#include <vector>
+
+// render scale step of dynamic resolution (render targets are recreated when scale moves by more than one step)
+#define VULKAN_DYNAMIC_RESOLUTION_SCALE_STEP 0.0625f
+
+// VulkanDynamicResolution (render scale follows GPU frame time of timestamps against target frame time)
+class VulkanDynamicResolution {
+protected:
+	// base handles
+	VulkanContext& context;
+protected:
+	// target frame time in milliseconds and minimal scale, scale moved by frame times and scale of render targets
+	VkBool32 enabled = VK_FALSE;
+	float    targetTime = 16.6f;
+	float    scaleMin = 0.5f;
+	float    scale = 1.0f;
+	float    scaleApplied = 1.0f;
+	// timestamps of frame begin and end per frame (previous results of frame are read when frame is complete on device)
+	VkQueryPool           queryPool{};
+	std::vector<VkBool32> queried{};
+	float                 frameTime{};
+public:
+	// constructor and destructor
+	VulkanDynamicResolution(VulkanContext& context);
+	~VulkanDynamicResolution();
+
+	// create and destroy timestamp queries of frames (graphics queue without timestamps keeps render scale)
+	void createQueries(uint32_t framesCount);
+	void destroyQueries();
+
+	// set target frame time and minimal scale (returns true when scale of render targets changed)
+	VkBool32 set(VkBool32 enabled, float targetTime, float scaleMin);
+
+	// update scale from measured frame time (returns true when scale of render targets changed)
+	VkBool32 update();
+
+	// full scale (swapchain images that can not be blitted to)
+	void reset();
+
+	// GPU frame time of frame (timestamps around recorded frame, frame is complete on device)
+	void beginFrame(VulkanCommandBuffer& commandBuffer, uint32_t frameIndex);
+	void endFrame(VulkanCommandBuffer& commandBuffer, uint32_t frameIndex);
+
+	// getters
+	float getScale() const { return scaleApplied; }
+	float getFrameTime() const { return frameTime; }
+};
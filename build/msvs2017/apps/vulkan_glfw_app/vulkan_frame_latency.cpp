@@ -0,0 +1,54 @@
+#include "vulkan_frame_latency.hpp"
+
+// VulkanFrameLatency::VulkanFrameLatency
+VulkanFrameLatency::VulkanFrameLatency(VulkanContext& context) :
+	context(context)
+{
+}
+
+// VulkanFrameLatency::~VulkanFrameLatency
+VulkanFrameLatency::~VulkanFrameLatency()
+{
+}
+
+// VulkanFrameLatency::setFramesCount
+void VulkanFrameLatency::setFramesCount(uint32_t framesCount)
+{
+	// frame begin times (no frame latency is pending)
+	beginTimes.resize(framesCount);
+	pending.assign(framesCount, VK_FALSE);
+}
+
+// VulkanFrameLatency::beginFrame
+void VulkanFrameLatency::beginFrame(uint32_t frameIndex, std::chrono::steady_clock::time_point beginTime)
+{
+	// latency of frame is pending until its fence is observed
+	beginTimes[frameIndex] = beginTime;
+	pending[frameIndex] = VK_TRUE;
+}
+
+// VulkanFrameLatency::completeFrame
+void VulkanFrameLatency::completeFrame(uint32_t frameIndex)
+{
+	// latency of frame is measured once (polled frames are observed late by up to one frame)
+	if (pending[frameIndex]) {
+		std::chrono::duration<float, std::milli> frameLatency = std::chrono::steady_clock::now() - beginTimes[frameIndex];
+		latency = frameLatency.count();
+		pending[frameIndex] = VK_FALSE;
+	}
+}
+
+// VulkanFrameLatency::limit
+void VulkanFrameLatency::limit(const std::vector<VkFence>& frameFences, uint32_t frameIndex, uint32_t maxQueuedFrames)
+{
+	// frame submitted max queued frames ago (including last submitted frame) must be complete
+	uint32_t framesCount = (uint32_t)frameFences.size();
+	uint32_t index = (frameIndex + framesCount + 1 - maxQueuedFrames) % framesCount;
+	VKT_CHECK(vkWaitForFences(context.device.device, 1, &frameFences[index], VK_TRUE, UINT64_MAX));
+	completeFrame(index);
+
+	// poll other queued frames for their latency
+	for (index = 0; index < framesCount; index++)
+		if (pending[index] && vkGetFenceStatus(context.device.device, frameFences[index]) == VK_SUCCESS)
+			completeFrame(index);
+}
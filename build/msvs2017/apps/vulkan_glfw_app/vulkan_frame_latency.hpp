@@ -0,0 +1,34 @@
+#pragma once
+
+#include "vulkan_context.hpp"
+#include <chrono>
+#include <vector>
+
+// VulkanFrameLatency (queued frames are limited on frame fences, host time from frame begin to completion of frame observed on fence)
+class VulkanFrameLatency {
+protected:
+	// base handles
+	VulkanContext& context;
+protected:
+	// frame begin times of submitted frames (presentation is not included in latency)
+	std::vector<std::chrono::steady_clock::time_point> beginTimes{};
+	std::vector<VkBool32>                              pending{};
+	float                                              latency{};
+public:
+	// constructor and destructor
+	VulkanFrameLatency(VulkanContext& context);
+	~VulkanFrameLatency();
+
+	// frames count of renderer (no frame latency is pending)
+	void setFramesCount(uint32_t framesCount);
+
+	// frame begins when application sampled its input, frame fence is observed signaled
+	void beginFrame(uint32_t frameIndex, std::chrono::steady_clock::time_point beginTime);
+	void completeFrame(uint32_t frameIndex);
+
+	// wait until queued frames are within limit (frame submitted max queued frames ago is complete, other queued frames are polled)
+	void limit(const std::vector<VkFence>& frameFences, uint32_t frameIndex, uint32_t maxQueuedFrames);
+
+	// getters
+	float getLatency() const { return latency; }
+};
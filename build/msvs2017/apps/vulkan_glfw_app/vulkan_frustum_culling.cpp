@@ -0,0 +1,165 @@
+#include "vulkan_frustum_culling.hpp"
+#include <glm/geometric.hpp>
+#include <glm/common.hpp>
+#include <cassert>
+
+// SIMD lanes (AVX when compiled with /arch:AVX, otherwise SSE)
+#if defined(__AVX__)
+#include <immintrin.h>
+#define VULKAN_FRUSTUM_LANES 8
+typedef __m256 VulkanFrustumFloats;
+#define vulkanFrustumLoad(p)       _mm256_loadu_ps(p)
+#define vulkanFrustumSet1(f)       _mm256_set1_ps(f)
+#define vulkanFrustumAdd(a, b)     _mm256_add_ps(a, b)
+#define vulkanFrustumMul(a, b)     _mm256_mul_ps(a, b)
+#define vulkanFrustumMin(a, b)     _mm256_min_ps(a, b)
+#define vulkanFrustumGe(a, b)      _mm256_cmp_ps(a, b, _CMP_GE_OQ)
+#define vulkanFrustumAnd(a, b)     _mm256_and_ps(a, b)
+#define vulkanFrustumOr(a, b)      _mm256_or_ps(a, b)
+#define vulkanFrustumZero()        _mm256_setzero_ps()
+#define vulkanFrustumOnes()        _mm256_castsi256_ps(_mm256_set1_epi32(-1))
+#define vulkanFrustumMask(a)       _mm256_movemask_ps(a)
+#else
+#include <emmintrin.h>
+#define VULKAN_FRUSTUM_LANES 4
+typedef __m128 VulkanFrustumFloats;
+#define vulkanFrustumLoad(p)       _mm_loadu_ps(p)
+#define vulkanFrustumSet1(f)       _mm_set1_ps(f)
+#define vulkanFrustumAdd(a, b)     _mm_add_ps(a, b)
+#define vulkanFrustumMul(a, b)     _mm_mul_ps(a, b)
+#define vulkanFrustumMin(a, b)     _mm_min_ps(a, b)
+#define vulkanFrustumGe(a, b)      _mm_cmpge_ps(a, b)
+#define vulkanFrustumAnd(a, b)     _mm_and_ps(a, b)
+#define vulkanFrustumOr(a, b)      _mm_or_ps(a, b)
+#define vulkanFrustumZero()        _mm_setzero_ps()
+#define vulkanFrustumOnes()        _mm_castsi128_ps(_mm_set1_epi32(-1))
+#define vulkanFrustumMask(a)       _mm_movemask_ps(a)
+#endif
+
+// VulkanFrustumCulling::begin
+void VulkanFrustumCulling::begin(VulkanScene* scene)
+{
+	// frustum planes of all views
+	glm::vec4 planes[VULKAN_SCENE_MAX_VIEWS * 6];
+	scene->getFrustumPlanes(planes);
+	begin(planes, scene->viewsCount);
+}
+
+// VulkanFrustumCulling::begin
+void VulkanFrustumCulling::begin(const glm::vec4* planes, uint32_t viewsCount)
+{
+	assert(viewsCount <= VULKAN_SCENE_MAX_VIEWS);
+	// frustum planes of all views
+	for (uint32_t planeIndex = 0; planeIndex < viewsCount * 6; planeIndex++)
+		frustumPlanes[planeIndex] = planes[planeIndex];
+	this->viewsCount = viewsCount;
+	// clear bounding volumes (capacity is kept between frames)
+	boundsCount = 0;
+	centersX.clear();
+	centersY.clear();
+	centersZ.clear();
+	radiuses.clear();
+	extentsX.clear();
+	extentsY.clear();
+	extentsZ.clear();
+}
+
+// VulkanFrustumCulling::push
+uint32_t VulkanFrustumCulling::push(
+	const glm::mat4& matrixModel,
+	const glm::vec3& boundingBoxMin,
+	const glm::vec3& boundingBoxMax,
+	const glm::vec4& boundingSphere)
+{
+	// world space sphere (radius scaled by largest axis scale)
+	glm::vec3 center = glm::vec3(matrixModel * glm::vec4(glm::vec3(boundingSphere), 1.0f));
+	glm::vec3 axisX = glm::vec3(matrixModel[0]);
+	glm::vec3 axisY = glm::vec3(matrixModel[1]);
+	glm::vec3 axisZ = glm::vec3(matrixModel[2]);
+	float radius = boundingSphere.w * glm::max(glm::length(axisX), glm::max(glm::length(axisY), glm::length(axisZ)));
+	// world space box extents around same center (absolute model axes)
+	glm::vec3 halfSize = (boundingBoxMax - boundingBoxMin) * 0.5f;
+	glm::vec3 extent = glm::abs(axisX) * halfSize.x + glm::abs(axisY) * halfSize.y + glm::abs(axisZ) * halfSize.z;
+
+	// append to arrays
+	centersX.push_back(center.x);
+	centersY.push_back(center.y);
+	centersZ.push_back(center.z);
+	radiuses.push_back(radius);
+	extentsX.push_back(extent.x);
+	extentsY.push_back(extent.y);
+	extentsZ.push_back(extent.z);
+	return boundsCount++;
+}
+
+// VulkanFrustumCulling::cull
+void VulkanFrustumCulling::cull()
+{
+	// pad arrays to whole SIMD batches
+	size_t paddedCount = (boundsCount + VULKAN_FRUSTUM_LANES - 1) / VULKAN_FRUSTUM_LANES * VULKAN_FRUSTUM_LANES;
+	centersX.resize(paddedCount);
+	centersY.resize(paddedCount);
+	centersZ.resize(paddedCount);
+	radiuses.resize(paddedCount);
+	extentsX.resize(paddedCount);
+	extentsY.resize(paddedCount);
+	extentsZ.resize(paddedCount);
+	visible.resize(paddedCount);
+
+	// broadcast planes and absolute plane normals (box projected radius)
+	uint32_t planesCount = viewsCount * 6;
+	VulkanFrustumFloats planes[VULKAN_SCENE_MAX_VIEWS * 6][7];
+	for (uint32_t planeIndex = 0; planeIndex < planesCount; planeIndex++) {
+		const glm::vec4& plane = frustumPlanes[planeIndex];
+		planes[planeIndex][0] = vulkanFrustumSet1(plane.x);
+		planes[planeIndex][1] = vulkanFrustumSet1(plane.y);
+		planes[planeIndex][2] = vulkanFrustumSet1(plane.z);
+		planes[planeIndex][3] = vulkanFrustumSet1(plane.w);
+		planes[planeIndex][4] = vulkanFrustumSet1(glm::abs(plane.x));
+		planes[planeIndex][5] = vulkanFrustumSet1(glm::abs(plane.y));
+		planes[planeIndex][6] = vulkanFrustumSet1(glm::abs(plane.z));
+	}
+
+	// test batches of bounding volumes
+	for (size_t first = 0; first < paddedCount; first += VULKAN_FRUSTUM_LANES) {
+		VulkanFrustumFloats centerX = vulkanFrustumLoad(&centersX[first]);
+		VulkanFrustumFloats centerY = vulkanFrustumLoad(&centersY[first]);
+		VulkanFrustumFloats centerZ = vulkanFrustumLoad(&centersZ[first]);
+		VulkanFrustumFloats radius = vulkanFrustumLoad(&radiuses[first]);
+		VulkanFrustumFloats extentX = vulkanFrustumLoad(&extentsX[first]);
+		VulkanFrustumFloats extentY = vulkanFrustumLoad(&extentsY[first]);
+		VulkanFrustumFloats extentZ = vulkanFrustumLoad(&extentsZ[first]);
+		VulkanFrustumFloats visibleMask = vulkanFrustumZero();
+		for (uint32_t viewIndex = 0; viewIndex < viewsCount; viewIndex++) {
+			// inside view if inside all its planes
+			VulkanFrustumFloats insideMask = vulkanFrustumOnes();
+			for (uint32_t planeIndex = viewIndex * 6; planeIndex < viewIndex * 6 + 6; planeIndex++) {
+				const VulkanFrustumFloats* plane = planes[planeIndex];
+				// signed distance of center
+				VulkanFrustumFloats distance = vulkanFrustumAdd(
+					vulkanFrustumAdd(vulkanFrustumMul(plane[0], centerX), vulkanFrustumMul(plane[1], centerY)),
+					vulkanFrustumAdd(vulkanFrustumMul(plane[2], centerZ), plane[3]));
+				// tighter of sphere radius and box radius projected on plane normal
+				VulkanFrustumFloats boxRadius = vulkanFrustumAdd(
+					vulkanFrustumAdd(vulkanFrustumMul(plane[4], extentX), vulkanFrustumMul(plane[5], extentY)),
+					vulkanFrustumMul(plane[6], extentZ));
+				VulkanFrustumFloats reach = vulkanFrustumMin(radius, boxRadius);
+				insideMask = vulkanFrustumAnd(insideMask, vulkanFrustumGe(vulkanFrustumAdd(distance, reach), vulkanFrustumZero()));
+			}
+			visibleMask = vulkanFrustumOr(visibleMask, insideMask);
+		}
+
+		// store batch results
+		int mask = vulkanFrustumMask(visibleMask);
+		for (size_t lane = 0; lane < VULKAN_FRUSTUM_LANES; lane++)
+			visible[first + lane] = (uint8_t)((mask >> lane) & 1);
+	}
+
+	// count results (padding is ignored)
+	visibleCount = 0;
+	culledCount = 0;
+	for (uint32_t i = 0; i < boundsCount; i++) {
+		if (visible[i]) visibleCount++;
+		else culledCount++;
+	}
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "vulkan_scene.hpp"
+#include <vector>
+
+// VulkanFrustumCulling (host frustum culling of world space bounding volumes, tested in SIMD batches)
+class VulkanFrustumCulling {
+protected:
+	// normalized frustum planes of scene views
+	glm::vec4 frustumPlanes[VULKAN_SCENE_MAX_VIEWS * 6]{};
+	uint32_t  viewsCount{};
+	// world space bounding volumes (structure of arrays padded to SIMD lanes, boxes share sphere centers)
+	uint32_t           boundsCount{};
+	std::vector<float> centersX{};
+	std::vector<float> centersY{};
+	std::vector<float> centersZ{};
+	std::vector<float> radiuses{};
+	std::vector<float> extentsX{};
+	std::vector<float> extentsY{};
+	std::vector<float> extentsZ{};
+	// visibility of bounding volumes (written by cull)
+	std::vector<uint8_t> visible{};
+	uint32_t             visibleCount{};
+	uint32_t             culledCount{};
+public:
+	// begin culling against views of scene (clears bounding volumes)
+	void begin(VulkanScene* scene);
+
+	// begin culling against normalized planes (6 per view, e.g. shadow cascade volumes)
+	void begin(const glm::vec4* planes, uint32_t viewsCount);
+
+	// add model space bounding volumes of mesh placed by model matrix (returns bounding volume index)
+	uint32_t push(const glm::mat4& matrixModel, const glm::vec3& boundingBoxMin, const glm::vec3& boundingBoxMax, const glm::vec4& boundingSphere);
+
+	// test all bounding volumes (visible if inside all planes of any view)
+	void cull();
+
+	// culling results
+	bool isVisible(uint32_t index) const { return visible[index] != 0; }
+	uint32_t getVisibleCount() const { return visibleCount; }
+	uint32_t getCulledCount() const { return culledCount; }
+};
@@ -1,13 +1,23 @@
 #include "vulkan_geometry.hpp"
 #include "glm/mat4x4.hpp"
+#include <glm/geometric.hpp>
+#include <algorithm>
+#include <numeric>
+#include <queue>
+#include <iterator>
+#include <map>
+#include <unordered_map>
+#include <cstring>
+#include <cassert>
+#include <cfloat>
 
 // calcTangentSpace
 void calcTangentSpace(
-	const std::vector<glm::vec4>& pos,
-	const std::vector<glm::vec2>& tex,
-	const std::vector<glm::vec3>& nrm,
-	std::vector<glm::vec3>& tng,
-	std::vector<glm::vec3>& bnm)
+	const VulkanHostVector<glm::vec4>& pos,
+	const VulkanHostVector<glm::vec2>& tex,
+	const VulkanHostVector<glm::vec3>& nrm,
+	VulkanHostVector<glm::vec3>& tng,
+	VulkanHostVector<glm::vec3>& bnm)
 {
 	// calculate bi-normal and tangent
 	tng.clear();
@@ -45,3 +55,433 @@ void calcTangentSpace(
 		bnm.push_back(binormal);
 	}
 }
+
+// weldCorners (corners of triangle list with same position share vertex, triangle list has no connectivity)
+static void weldCorners(
+	const VulkanHostVector<glm::vec4>& pos,
+	std::vector<uint32_t>& cornerVertices,
+	std::vector<glm::vec3>& vertices)
+{
+	// sort corners by position
+	std::vector<uint32_t> order(pos.size());
+	std::iota(order.begin(), order.end(), 0);
+	auto less = [&](uint32_t a, uint32_t b) {
+		if (pos[a].x != pos[b].x) return pos[a].x < pos[b].x;
+		if (pos[a].y != pos[b].y) return pos[a].y < pos[b].y;
+		return pos[a].z < pos[b].z;
+	};
+	std::sort(order.begin(), order.end(), less);
+	// one vertex per position
+	cornerVertices.resize(order.size());
+	vertices.clear();
+	for (size_t i = 0; i < order.size(); i++) {
+		if (i == 0 || less(order[i - 1], order[i]))
+			vertices.push_back(glm::vec3(pos[order[i]]));
+		cornerVertices[order[i]] = (uint32_t)vertices.size() - 1;
+	}
+}
+
+// calcMeshlets
+void calcMeshlets(
+	const VulkanHostVector<glm::vec4>& pos,
+	const VulkanHostVector<glm::vec3>& nrm,
+	VulkanHostVector<uint32_t>& ind,
+	uint32_t indexCount,
+	std::vector<VulkanMeshlet>& meshlets)
+{
+	// indexed triangle list (indices of vertices with attributes)
+	uint32_t trianglesCount = std::min(indexCount, (uint32_t)ind.size()) / 3;
+	uint32_t verticesCount = (uint32_t)pos.size();
+	meshlets.clear();
+	if (trianglesCount == 0 || nrm.size() != pos.size())
+		return;
+
+	// triangles of each vertex
+	std::vector<uint32_t> vertexTrianglesFirst(verticesCount + 1, 0);
+	for (uint32_t corner = 0; corner < trianglesCount * 3; corner++)
+		vertexTrianglesFirst[ind[corner] + 1]++;
+	for (uint32_t v = 0; v < verticesCount; v++)
+		vertexTrianglesFirst[v + 1] += vertexTrianglesFirst[v];
+	std::vector<uint32_t> vertexTriangles(trianglesCount * 3);
+	std::vector<uint32_t> vertexTrianglesCount(verticesCount, 0);
+	for (uint32_t corner = 0; corner < trianglesCount * 3; corner++) {
+		uint32_t v = ind[corner];
+		vertexTriangles[vertexTrianglesFirst[v] + vertexTrianglesCount[v]++] = corner / 3;
+	}
+
+	// grow meshlets from first unused triangle over neighbors (triangles adding too many vertices are left for later meshlets)
+	std::vector<uint8_t> triangleUsed(trianglesCount, 0);
+	std::vector<uint32_t> vertexMeshlet(verticesCount, UINT32_MAX);
+	std::vector<uint32_t> triangleOrder;
+	std::vector<uint32_t> candidates;
+	triangleOrder.reserve(trianglesCount);
+	uint32_t seed = 0;
+	while (triangleOrder.size() < trianglesCount) {
+		uint32_t meshletIndex = (uint32_t)meshlets.size();
+		uint32_t meshletFirst = (uint32_t)triangleOrder.size();
+		uint32_t meshletVertices = 0;
+		while (triangleUsed[seed]) seed++;
+		candidates.clear();
+		candidates.push_back(seed);
+		for (size_t candidate = 0; candidate < candidates.size(); candidate++) {
+			uint32_t t = candidates[candidate];
+			if (triangleUsed[t]) continue;
+			const uint32_t* v = &ind[t * 3];
+			uint32_t newVertices = 0;
+			for (uint32_t k = 0; k < 3; k++)
+				if (vertexMeshlet[v[k]] != meshletIndex && (k == 0 || v[k] != v[0]) && (k < 2 || v[k] != v[1])) newVertices++;
+			if (meshletVertices + newVertices > VULKAN_MESHLET_MAX_VERTICES) continue;
+
+			// add triangle and queue its neighbors
+			triangleUsed[t] = 1;
+			triangleOrder.push_back(t);
+			meshletVertices += newVertices;
+			for (uint32_t k = 0; k < 3; k++)
+				vertexMeshlet[v[k]] = meshletIndex;
+			if (triangleOrder.size() - meshletFirst == VULKAN_MESHLET_MAX_TRIANGLES) break;
+			for (uint32_t k = 0; k < 3; k++)
+				for (uint32_t i = vertexTrianglesFirst[v[k]]; i < vertexTrianglesFirst[v[k] + 1]; i++)
+					if (!triangleUsed[vertexTriangles[i]]) candidates.push_back(vertexTriangles[i]);
+		}
+		uint32_t meshletTriangles = (uint32_t)triangleOrder.size() - meshletFirst;
+
+		// bounding sphere from bounding box center and farthest corner
+		glm::vec3 boxMin = glm::vec3(pos[ind[triangleOrder[meshletFirst] * 3]]);
+		glm::vec3 boxMax = boxMin;
+		for (uint32_t i = meshletFirst; i < meshletFirst + meshletTriangles; i++)
+			for (uint32_t k = 0; k < 3; k++) {
+				boxMin = glm::min(boxMin, glm::vec3(pos[ind[triangleOrder[i] * 3 + k]]));
+				boxMax = glm::max(boxMax, glm::vec3(pos[ind[triangleOrder[i] * 3 + k]]));
+			}
+		glm::vec3 center = (boxMin + boxMax) * 0.5f;
+		float radius2 = 0.0f;
+		for (uint32_t i = meshletFirst; i < meshletFirst + meshletTriangles; i++)
+			for (uint32_t k = 0; k < 3; k++) {
+				glm::vec3 d = glm::vec3(pos[ind[triangleOrder[i] * 3 + k]]) - center;
+				radius2 = glm::max(radius2, glm::dot(d, d));
+			}
+
+		// normal cone of triangles (cone is inverted into backface cone, wide cones and winding not matching normals are never culled)
+		std::vector<glm::vec3> normals(meshletTriangles);
+		glm::vec3 axis = glm::vec3(0.0f);
+		bool coneValid = true;
+		for (uint32_t i = 0; i < meshletTriangles; i++) {
+			const uint32_t* v = &ind[triangleOrder[meshletFirst + i] * 3];
+			glm::vec3 normal = glm::cross(glm::vec3(pos[v[1]] - pos[v[0]]), glm::vec3(pos[v[2]] - pos[v[0]]));
+			float length = glm::length(normal);
+			normals[i] = length > 0.0f ? normal / length : glm::vec3(0.0f);
+			if (glm::dot(normals[i], nrm[v[0]] + nrm[v[1]] + nrm[v[2]]) < 0.0f)
+				coneValid = false;
+			axis += normals[i];
+		}
+		float axisLength = glm::length(axis);
+		float dotMin = 1.0f;
+		if (coneValid && axisLength > 0.0f) {
+			axis /= axisLength;
+			for (const auto& normal : normals)
+				if (normal != glm::vec3(0.0f))
+					dotMin = glm::min(dotMin, glm::dot(normal, axis));
+		}
+		VulkanMeshlet meshlet{};
+		meshlet.firstVertex = 0;
+		meshlet.vertexCount = verticesCount;
+		meshlet.firstIndex = meshletFirst * 3;
+		meshlet.indexCount = meshletTriangles * 3;
+		meshlet.boundingSphere = glm::vec4(center, glm::sqrt(radius2));
+		meshlet.cone = coneValid && axisLength > 0.0f && dotMin > 0.1f ?
+			glm::vec4(axis, glm::sqrt(1.0f - dotMin * dotMin)) : glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+		meshlets.push_back(meshlet);
+	}
+
+	// write triangles in meshlet order
+	std::vector<uint32_t> meshletInd(trianglesCount * 3);
+	for (uint32_t i = 0; i < trianglesCount; i++)
+		for (uint32_t k = 0; k < 3; k++)
+			meshletInd[i * 3 + k] = ind[triangleOrder[i] * 3 + k];
+	std::copy(meshletInd.begin(), meshletInd.end(), ind.begin());
+}
+
+// VulkanQuadric (symmetric 4x4 error quadric, upper triangle: aa ab ac ad bb bc bd cc cd dd)
+struct VulkanQuadric {
+	double m[10]{};
+};
+
+// quadricAddPlane (plane a*x + b*y + c*z + d = 0 with unit normal)
+static void quadricAddPlane(VulkanQuadric& q, const glm::vec3& n, float d, double weight)
+{
+	double a = n.x, b = n.y, c = n.z, e = d;
+	q.m[0] += a * a * weight; q.m[1] += a * b * weight; q.m[2] += a * c * weight; q.m[3] += a * e * weight;
+	q.m[4] += b * b * weight; q.m[5] += b * c * weight; q.m[6] += b * e * weight;
+	q.m[7] += c * c * weight; q.m[8] += c * e * weight;
+	q.m[9] += e * e * weight;
+}
+
+// quadricError (sum of squared plane distances of point, clamped against rounding)
+static double quadricError(const VulkanQuadric& q0, const VulkanQuadric& q1, const glm::vec3& p)
+{
+	double m[10];
+	for (int i = 0; i < 10; i++)
+		m[i] = q0.m[i] + q1.m[i];
+	double x = p.x, y = p.y, z = p.z;
+	double error =
+		m[0] * x * x + 2.0 * m[1] * x * y + 2.0 * m[2] * x * z + 2.0 * m[3] * x +
+		m[4] * y * y + 2.0 * m[5] * y * z + 2.0 * m[6] * y +
+		m[7] * z * z + 2.0 * m[8] * z +
+		m[9];
+	return std::max(error, 0.0);
+}
+
+// VulkanEdgeCollapse (vertex from is moved to vertex to, stale when vertex versions changed)
+struct VulkanEdgeCollapse {
+	double   cost;
+	uint32_t from;
+	uint32_t to;
+	uint32_t versionFrom;
+	uint32_t versionTo;
+	bool operator>(const VulkanEdgeCollapse& other) const { return cost > other.cost; }
+};
+
+// calcMeshLods
+void calcMeshLods(
+	VulkanHostVector<glm::vec4>& pos,
+	VulkanHostVector<glm::vec2>& tex,
+	VulkanHostVector<glm::vec3>& nrm,
+	std::vector<VulkanMeshLod>& lods)
+{
+	// full resolution level
+	uint32_t cornersCount = (uint32_t)pos.size();
+	uint32_t trianglesCount = cornersCount / 3;
+	lods.clear();
+	lods.push_back({ 0, cornersCount, 0, 0, 0.0f });
+	if (trianglesCount < VULKAN_MESH_LOD_MIN_TRIANGLES * 2 || tex.size() != pos.size() || nrm.size() != pos.size())
+		return;
+
+	// weld corners with same position (corners keep their attributes)
+	std::vector<uint32_t> cornerVertices;
+	std::vector<glm::vec3> vertices;
+	weldCorners(pos, cornerVertices, vertices);
+	uint32_t verticesCount = (uint32_t)vertices.size();
+
+	// triangles of vertices and undirected edges (boundary edges have one triangle)
+	std::vector<uint8_t> triangleAlive(trianglesCount, 0);
+	std::vector<std::vector<uint32_t>> vertexTriangles(verticesCount);
+	std::map<uint64_t, uint32_t> edgeTriangles;
+	uint32_t trianglesAlive = 0;
+	for (uint32_t t = 0; t < trianglesCount; t++) {
+		const uint32_t* v = &cornerVertices[t * 3];
+		if (v[0] == v[1] || v[1] == v[2] || v[0] == v[2]) continue;
+		triangleAlive[t] = 1;
+		trianglesAlive++;
+		for (uint32_t k = 0; k < 3; k++) {
+			uint32_t a = v[k], b = v[(k + 1) % 3];
+			vertexTriangles[a].push_back(t);
+			edgeTriangles[((uint64_t)std::min(a, b) << 32) | std::max(a, b)]++;
+		}
+	}
+
+	// vertex quadrics from triangle planes, boundary edges add perpendicular planes
+	std::vector<VulkanQuadric> quadrics(verticesCount);
+	std::vector<uint8_t> vertexBoundary(verticesCount, 0);
+	for (uint32_t t = 0; t < trianglesCount; t++) {
+		if (!triangleAlive[t]) continue;
+		const uint32_t* v = &cornerVertices[t * 3];
+		glm::vec3 normal = glm::cross(vertices[v[1]] - vertices[v[0]], vertices[v[2]] - vertices[v[0]]);
+		float length = glm::length(normal);
+		if (length <= 0.0f) continue;
+		normal /= length;
+		for (uint32_t k = 0; k < 3; k++)
+			quadricAddPlane(quadrics[v[k]], normal, -glm::dot(normal, vertices[v[0]]), 1.0);
+		for (uint32_t k = 0; k < 3; k++) {
+			uint32_t a = v[k], b = v[(k + 1) % 3];
+			if (edgeTriangles[((uint64_t)std::min(a, b) << 32) | std::max(a, b)] != 1) continue;
+			glm::vec3 edge = vertices[b] - vertices[a];
+			glm::vec3 boundaryNormal = glm::cross(edge, normal);
+			float boundaryLength = glm::length(boundaryNormal);
+			if (boundaryLength <= 0.0f) continue;
+			boundaryNormal /= boundaryLength;
+			float d = -glm::dot(boundaryNormal, vertices[a]);
+			quadricAddPlane(quadrics[a], boundaryNormal, d, 10.0);
+			quadricAddPlane(quadrics[b], boundaryNormal, d, 10.0);
+			vertexBoundary[a] = vertexBoundary[b] = 1;
+		}
+	}
+
+	// collapse candidates (cheaper direction of edge, boundary vertices are not moved inside)
+	std::vector<uint32_t> vertexVersions(verticesCount, 0);
+	std::priority_queue<VulkanEdgeCollapse, std::vector<VulkanEdgeCollapse>, std::greater<VulkanEdgeCollapse>> collapses;
+	auto pushCollapse = [&](uint32_t a, uint32_t b) {
+		double costAB = vertexBoundary[a] && !vertexBoundary[b] ? DBL_MAX : quadricError(quadrics[a], quadrics[b], vertices[b]);
+		double costBA = vertexBoundary[b] && !vertexBoundary[a] ? DBL_MAX : quadricError(quadrics[a], quadrics[b], vertices[a]);
+		if (costAB == DBL_MAX && costBA == DBL_MAX) return;
+		if (costAB <= costBA)
+			collapses.push({ costAB, a, b, vertexVersions[a], vertexVersions[b] });
+		else
+			collapses.push({ costBA, b, a, vertexVersions[b], vertexVersions[a] });
+	};
+	for (const auto& edge : edgeTriangles)
+		pushCollapse((uint32_t)(edge.first >> 32), (uint32_t)edge.first);
+
+	// collapse is valid when no triangle flips and edge keeps surface manifold (link condition)
+	std::vector<uint32_t> neighborsFrom, neighborsTo, neighborsShared;
+	auto collectNeighbors = [&](uint32_t v, std::vector<uint32_t>& neighbors) {
+		neighbors.clear();
+		for (uint32_t t : vertexTriangles[v]) {
+			if (!triangleAlive[t]) continue;
+			for (uint32_t k = 0; k < 3; k++)
+				if (cornerVertices[t * 3 + k] != v) neighbors.push_back(cornerVertices[t * 3 + k]);
+		}
+		std::sort(neighbors.begin(), neighbors.end());
+		neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+	};
+	auto isCollapseValid = [&](uint32_t from, uint32_t to) {
+		uint32_t sharedTriangles = 0;
+		for (uint32_t t : vertexTriangles[from]) {
+			if (!triangleAlive[t]) continue;
+			const uint32_t* v = &cornerVertices[t * 3];
+			if (v[0] == to || v[1] == to || v[2] == to) {
+				sharedTriangles++;
+				continue;
+			}
+			glm::vec3 p[3], q[3];
+			for (uint32_t k = 0; k < 3; k++) {
+				p[k] = vertices[v[k]];
+				q[k] = v[k] == from ? vertices[to] : p[k];
+			}
+			glm::vec3 normalBefore = glm::cross(p[1] - p[0], p[2] - p[0]);
+			glm::vec3 normalAfter = glm::cross(q[1] - q[0], q[2] - q[0]);
+			if (glm::dot(normalBefore, normalAfter) <= 0.0f) return false;
+		}
+		collectNeighbors(from, neighborsFrom);
+		collectNeighbors(to, neighborsTo);
+		neighborsShared.clear();
+		std::set_intersection(neighborsFrom.begin(), neighborsFrom.end(), neighborsTo.begin(), neighborsTo.end(), std::back_inserter(neighborsShared));
+		return neighborsShared.size() == sharedTriangles;
+	};
+
+	// halve triangles count per level, levels continue collapsing previous level
+	double costMax = 0.0;
+	for (uint32_t lod = 1; lod < VULKAN_MESH_MAX_LODS; lod++) {
+		uint32_t trianglesTarget = trianglesCount >> lod;
+		uint32_t trianglesPrevious = trianglesAlive;
+		if (trianglesTarget < VULKAN_MESH_LOD_MIN_TRIANGLES) break;
+		while (trianglesAlive > trianglesTarget && !collapses.empty()) {
+			VulkanEdgeCollapse collapse = collapses.top();
+			collapses.pop();
+			uint32_t from = collapse.from, to = collapse.to;
+			if (collapse.versionFrom != vertexVersions[from] || collapse.versionTo != vertexVersions[to]) continue;
+			if (!isCollapseValid(from, to)) continue;
+
+			// move vertex (triangles of collapsed edge are removed)
+			for (uint32_t t : vertexTriangles[from]) {
+				if (!triangleAlive[t]) continue;
+				uint32_t* v = &cornerVertices[t * 3];
+				if (v[0] == to || v[1] == to || v[2] == to) {
+					triangleAlive[t] = 0;
+					trianglesAlive--;
+					continue;
+				}
+				for (uint32_t k = 0; k < 3; k++)
+					if (v[k] == from) v[k] = to;
+				vertexTriangles[to].push_back(t);
+			}
+			vertexTriangles[from].clear();
+			for (int i = 0; i < 10; i++)
+				quadrics[to].m[i] += quadrics[from].m[i];
+			vertexVersions[from]++;
+			vertexVersions[to]++;
+			costMax = std::max(costMax, collapse.cost);
+
+			// drop removed triangles of vertex and requeue its edges
+			auto& triangles = vertexTriangles[to];
+			triangles.erase(std::remove_if(triangles.begin(), triangles.end(), [&](uint32_t t) { return !triangleAlive[t]; }), triangles.end());
+			collectNeighbors(to, neighborsTo);
+			for (uint32_t neighbor : neighborsTo)
+				pushCollapse(to, neighbor);
+		}
+		// stop when mesh can not be simplified further (locked by boundaries and flips)
+		if (trianglesAlive * 10 > trianglesPrevious * 9) break;
+
+		// append level triangles (corners at their collapsed vertex, attributes of original corner)
+		VulkanMeshLod meshLod{};
+		meshLod.firstVertex = (uint32_t)pos.size();
+		meshLod.vertexCount = trianglesAlive * 3;
+		meshLod.error = (float)glm::sqrt(costMax);
+		for (uint32_t t = 0; t < trianglesCount; t++) {
+			if (!triangleAlive[t]) continue;
+			for (uint32_t k = 0; k < 3; k++) {
+				uint32_t corner = t * 3 + k;
+				glm::vec2 cornerTex = tex[corner];
+				glm::vec3 cornerNrm = nrm[corner];
+				pos.push_back(glm::vec4(vertices[cornerVertices[corner]], 1.0f));
+				tex.push_back(cornerTex);
+				nrm.push_back(cornerNrm);
+			}
+		}
+		lods.push_back(meshLod);
+	}
+}
+
+// VulkanWeldKey (bits of position, normal and texture coordinates of corner)
+struct VulkanWeldKey {
+	uint32_t bits[8];
+	bool operator==(const VulkanWeldKey& other) const { return std::equal(bits, bits + 8, other.bits); }
+};
+
+// VulkanWeldKeyHash (FNV-1a of key bits)
+struct VulkanWeldKeyHash {
+	size_t operator()(const VulkanWeldKey& key) const {
+		uint64_t hash = 14695981039346656037ull;
+		for (uint32_t bits : key.bits)
+			hash = (hash ^ bits) * 1099511628211ull;
+		return (size_t)hash;
+	}
+};
+
+// calcWeldedVertices
+void calcWeldedVertices(
+	VulkanHostVector<glm::vec4>& pos,
+	VulkanHostVector<glm::vec2>& tex,
+	VulkanHostVector<glm::vec3>& nrm,
+	VulkanHostVector<uint32_t>& ind,
+	std::vector<VulkanMeshLod>& lods)
+{
+	// triangle lists of levels follow each other
+	uint32_t cornersCount = (uint32_t)pos.size();
+	ind.clear();
+	if (tex.size() != pos.size() || nrm.size() != pos.size())
+		return;
+	if (lods.empty())
+		lods.push_back({ 0, cornersCount, 0, 0, 0.0f });
+
+	// corners become index of first equal corner, vertices are compacted in place in order of first use
+	std::unordered_map<VulkanWeldKey, uint32_t, VulkanWeldKeyHash> vertices;
+	vertices.reserve(cornersCount);
+	ind.resize(cornersCount);
+	uint32_t verticesCount = 0;
+	for (auto& lod : lods) {
+		assert(lod.firstVertex + lod.vertexCount <= cornersCount);
+		for (uint32_t corner = lod.firstVertex; corner < lod.firstVertex + lod.vertexCount; corner++) {
+			VulkanWeldKey key{};
+			glm::vec3 cornerPos = glm::vec3(pos[corner]);
+			memcpy(&key.bits[0], &cornerPos, sizeof(glm::vec3));
+			memcpy(&key.bits[3], &nrm[corner], sizeof(glm::vec3));
+			memcpy(&key.bits[6], &tex[corner], sizeof(glm::vec2));
+			auto vertex = vertices.emplace(key, verticesCount);
+			if (vertex.second) {
+				pos[verticesCount] = pos[corner];
+				tex[verticesCount] = tex[corner];
+				nrm[verticesCount] = nrm[corner];
+				verticesCount++;
+			}
+			ind[corner] = vertex.first->second;
+		}
+		// level indexes vertices of its own and finer levels
+		lod.firstIndex = lod.firstVertex;
+		lod.indexCount = lod.vertexCount;
+		lod.firstVertex = 0;
+		lod.vertexCount = verticesCount;
+	}
+	pos.resize(verticesCount);
+	tex.resize(verticesCount);
+	nrm.resize(verticesCount);
+}
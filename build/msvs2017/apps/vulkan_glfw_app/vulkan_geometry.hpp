@@ -1,14 +1,69 @@
 #pragma once
+#include <vktoolkit.hpp>
 #include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
 #include <glm/vec4.hpp>
 #include <vector>
 
+// max levels of detail of mesh (full resolution and simplified levels)
+#define VULKAN_MESH_MAX_LODS 5
+// simplified levels are not generated below this triangles count
+#define VULKAN_MESH_LOD_MIN_TRIANGLES 64
+
+// max vertices and triangles of meshlet
+#define VULKAN_MESHLET_MAX_VERTICES  64
+#define VULKAN_MESHLET_MAX_TRIANGLES 124
+
+// VulkanMeshLod (vertex or index range of level of detail and its model space error)
+struct VulkanMeshLod {
+	uint32_t firstVertex;
+	uint32_t vertexCount;
+	uint32_t firstIndex;
+	uint32_t indexCount;
+	float    error;
+};
+
+// VulkanMeshlet (vertex or index range of triangles clustered at full resolution, model space bounding sphere and backface cone)
+struct VulkanMeshlet {
+	uint32_t  firstVertex;
+	uint32_t  vertexCount;
+	uint32_t  firstIndex;
+	uint32_t  indexCount;
+	glm::vec4 boundingSphere; // center and radius
+	glm::vec4 cone;           // axis and cutoff (zero axis is never culled)
+};
+
 // calcTangentSpace
 void calcTangentSpace(
-	const std::vector<glm::vec4>& pos,
-	const std::vector<glm::vec2>& tex,
-	const std::vector<glm::vec3>& nrm,
-	std::vector<glm::vec3>& tng,
-	std::vector<glm::vec3>& bnm
+	const VulkanHostVector<glm::vec4>& pos,
+	const VulkanHostVector<glm::vec2>& tex,
+	const VulkanHostVector<glm::vec3>& nrm,
+	VulkanHostVector<glm::vec3>& tng,
+	VulkanHostVector<glm::vec3>& bnm
+);
+
+// calcMeshlets (reorders indexed triangle list meshlet by meshlet, meshlets are index ranges)
+void calcMeshlets(
+	const VulkanHostVector<glm::vec4>& pos,
+	const VulkanHostVector<glm::vec3>& nrm,
+	VulkanHostVector<uint32_t>& ind,
+	uint32_t indexCount,
+	std::vector<VulkanMeshlet>& meshlets
+);
+
+// calcMeshLods (appends simplified triangle lists after full resolution triangle list, quadric edge collapse)
+void calcMeshLods(
+	VulkanHostVector<glm::vec4>& pos,
+	VulkanHostVector<glm::vec2>& tex,
+	VulkanHostVector<glm::vec3>& nrm,
+	std::vector<VulkanMeshLod>& lods
+);
+
+// calcWeldedVertices (corners with same attributes share vertex, triangle lists of levels become index ranges)
+void calcWeldedVertices(
+	VulkanHostVector<glm::vec4>& pos,
+	VulkanHostVector<glm::vec2>& tex,
+	VulkanHostVector<glm::vec3>& nrm,
+	VulkanHostVector<uint32_t>& ind,
+	std::vector<VulkanMeshLod>& lods
 );
@@ -0,0 +1,115 @@
+#include "vulkan_geometry_pool.hpp"
+#include <iterator>
+#include <cassert>
+
+// VulkanGeometryAllocator::VulkanGeometryAllocator
+VulkanGeometryAllocator::VulkanGeometryAllocator(uint32_t capacity)
+{
+	// one free range
+	if (capacity)
+		freeRanges[0] = capacity;
+}
+
+// VulkanGeometryAllocator::allocate
+bool VulkanGeometryAllocator::allocate(uint32_t count, VulkanGeometryRange& range)
+{
+	// find first free range large enough
+	assert(count);
+	for (auto it = freeRanges.begin(); it != freeRanges.end(); ++it) {
+		if (it->second >= count) {
+			// split free range
+			range.first = it->first;
+			range.count = count;
+			uint32_t freeCount = it->second - count;
+			freeRanges.erase(it);
+			if (freeCount)
+				freeRanges[range.first + count] = freeCount;
+			return true;
+		}
+	}
+	return false;
+}
+
+// VulkanGeometryAllocator::free
+void VulkanGeometryAllocator::free(const VulkanGeometryRange& range)
+{
+	// insert free range
+	if (range.count == 0) return;
+	auto it = freeRanges.insert({ range.first, range.count }).first;
+	// merge with next range
+	auto next = std::next(it);
+	if (next != freeRanges.end() && it->first + it->second == next->first) {
+		it->second += next->second;
+		freeRanges.erase(next);
+	}
+	// merge with previous range
+	if (it != freeRanges.begin()) {
+		auto prev = std::prev(it);
+		if (prev->first + prev->second == it->first) {
+			prev->second += it->second;
+			freeRanges.erase(it);
+		}
+	}
+}
+
+// VulkanGeometryPool::VulkanGeometryPool
+VulkanGeometryPool::VulkanGeometryPool(VulkanDevice& device, uint32_t vertexCapacity, uint32_t indexCapacity, uint32_t skinVertexCapacity) :
+	device(device),
+	vertexAllocator(vertexCapacity),
+	indexAllocator(indexCapacity),
+	skinVertexAllocator(skinVertexCapacity)
+{
+	// create buffers
+	vulkanBufferCreate(device, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, (VkDeviceSize)vertexCapacity * sizeof(float) * 4, &bufferPos);
+	vulkanBufferCreate(device, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, (VkDeviceSize)vertexCapacity * sizeof(float) * 2, &bufferTex);
+	vulkanBufferCreate(device, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, (VkDeviceSize)vertexCapacity * sizeof(float) * 3, &bufferNrm);
+	vulkanBufferCreate(device, VK_BUFFER_USAGE_INDEX_BUFFER_BIT, (VkDeviceSize)indexCapacity * sizeof(uint32_t), &bufferInd);
+	vulkanBufferCreate(device, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, (VkDeviceSize)skinVertexCapacity * sizeof(VulkanSkinVertex), &bufferSkin);
+}
+
+// VulkanGeometryPool::~VulkanGeometryPool
+VulkanGeometryPool::~VulkanGeometryPool()
+{
+	// destroy buffers
+	vulkanBufferDestroy(device, bufferSkin);
+	vulkanBufferDestroy(device, bufferInd);
+	vulkanBufferDestroy(device, bufferNrm);
+	vulkanBufferDestroy(device, bufferTex);
+	vulkanBufferDestroy(device, bufferPos);
+}
+
+// VulkanGeometryPool::allocateVertices
+bool VulkanGeometryPool::allocateVertices(uint32_t count, VulkanGeometryRange& range)
+{
+	return vertexAllocator.allocate(count, range);
+}
+
+// VulkanGeometryPool::freeVertices
+void VulkanGeometryPool::freeVertices(const VulkanGeometryRange& range)
+{
+	vertexAllocator.free(range);
+}
+
+// VulkanGeometryPool::allocateIndices
+bool VulkanGeometryPool::allocateIndices(uint32_t count, VulkanGeometryRange& range)
+{
+	return indexAllocator.allocate(count, range);
+}
+
+// VulkanGeometryPool::freeIndices
+void VulkanGeometryPool::freeIndices(const VulkanGeometryRange& range)
+{
+	indexAllocator.free(range);
+}
+
+// VulkanGeometryPool::allocateSkinVertices
+bool VulkanGeometryPool::allocateSkinVertices(uint32_t count, VulkanGeometryRange& range)
+{
+	return skinVertexAllocator.allocate(count, range);
+}
+
+// VulkanGeometryPool::freeSkinVertices
+void VulkanGeometryPool::freeSkinVertices(const VulkanGeometryRange& range)
+{
+	skinVertexAllocator.free(range);
+}
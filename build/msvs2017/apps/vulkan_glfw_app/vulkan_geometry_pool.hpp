@@ -0,0 +1,72 @@
+#pragma once
+#include <vktoolkit.hpp>
+#include <glm/vec4.hpp>
+#include <map>
+
+// default geometry pool capacity (in vertices, indices and skin vertices)
+#define VULKAN_GEOMETRY_POOL_VERTEX_CAPACITY      (1 << 20)
+#define VULKAN_GEOMETRY_POOL_INDEX_CAPACITY       (1 << 22)
+#define VULKAN_GEOMETRY_POOL_SKIN_VERTEX_CAPACITY (1 << 19)
+
+// VulkanSkinVertex (std430 bind pose vertex with joint weights and indices of skin buffer)
+struct VulkanSkinVertex {
+	glm::vec4  position;
+	glm::vec4  normal;
+	glm::vec4  weights; // normalized weights of joints
+	glm::uvec4 joints;  // joint indices into palette of mesh
+};
+
+// VulkanGeometryRange (first element and elements count)
+struct VulkanGeometryRange {
+	uint32_t first{};
+	uint32_t count{};
+};
+
+// VulkanGeometryAllocator (first fit free list of elements)
+class VulkanGeometryAllocator {
+protected:
+	// free ranges (first element to elements count)
+	std::map<uint32_t, uint32_t> freeRanges{};
+public:
+	// constructor
+	VulkanGeometryAllocator(uint32_t capacity);
+
+	// allocate and free ranges
+	bool allocate(uint32_t count, VulkanGeometryRange& range);
+	void free(const VulkanGeometryRange& range);
+};
+
+// VulkanGeometryPool (shared mesh buffers - meshes are not thread safe to create and destroy)
+class VulkanGeometryPool {
+protected:
+	// device
+	VulkanDevice& device;
+	// vertex, index and skin vertex allocators
+	VulkanGeometryAllocator vertexAllocator;
+	VulkanGeometryAllocator indexAllocator;
+	VulkanGeometryAllocator skinVertexAllocator;
+public:
+	// vertex buffers (mesh object layout, also storage for vertices written on device) and index buffer (32-bit elements, two 16-bit indices each)
+	VulkanBuffer bufferPos{};
+	VulkanBuffer bufferTex{};
+	VulkanBuffer bufferNrm{};
+	VulkanBuffer bufferInd{};
+	// skin vertices (source of skinning compute shader)
+	VulkanBuffer bufferSkin{};
+public:
+	// constructor and destructor
+	VulkanGeometryPool(VulkanDevice& device, uint32_t vertexCapacity, uint32_t indexCapacity, uint32_t skinVertexCapacity);
+	~VulkanGeometryPool();
+
+	// allocate and free vertices
+	bool allocateVertices(uint32_t count, VulkanGeometryRange& range);
+	void freeVertices(const VulkanGeometryRange& range);
+
+	// allocate and free indices
+	bool allocateIndices(uint32_t count, VulkanGeometryRange& range);
+	void freeIndices(const VulkanGeometryRange& range);
+
+	// allocate and free skin vertices
+	bool allocateSkinVertices(uint32_t count, VulkanGeometryRange& range);
+	void freeSkinVertices(const VulkanGeometryRange& range);
+};
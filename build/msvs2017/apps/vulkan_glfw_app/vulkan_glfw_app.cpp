@@ -1,41 +1,227 @@
 #include "vulkan_context.hpp"
 #include "vulkan_renderer.hpp"
+#include "vulkan_renderer_offscreen.hpp"
+#include "vulkan_renderer_deferred.hpp"
+#include "vulkan_batch.hpp"
 #include "vulkan_assets.hpp"
 #include "vulkan_scene.hpp"
+#include "vulkan_animation.hpp"
 #include "time_measure.hpp"
 #include <iostream>
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include <algorithm>
+#ifndef VULKAN_APP_HEADLESS_ONLY
 #include <GLFW/glfw3.h>
+#endif
 #include <glm/gtc/matrix_transform.hpp>
 
 // global renderer
 VulkanRenderer* renderer{};
 
+#ifndef VULKAN_APP_HEADLESS_ONLY
 // framebufferSizeFunc
-void framebufferSizeFunc(GLFWwindow* window, int width, int height) {
+void framebufferSizeFunc(GLFWwindow*, int, int) {
 	assert(renderer);
 	renderer->reinitialize();
 }
+#endif
+
+// headless readback statistics
+uint64_t readbackFramesCount{};
+uint64_t readbackBytesCount{};
+
+// readbackFunc
+void readbackFunc(VulkanRenderer&, const void*, uint32_t width, uint32_t height, void*) {
+	readbackFramesCount++;
+	readbackBytesCount += (uint64_t)width * height * 4;
+}
+
+// printRenderQueueStats
+void printRenderQueueStats(std::ostream& os, const VulkanRenderQueueStats& stats) {
+	os << "Draws: " << stats.drawsCount << " (commands " << stats.drawCommandsCount << ", calls " << stats.drawCallsCount << ") ";
+	os << "Pipeline binds: " << stats.pipelineBindsCount << " (saved " << stats.pipelineBindsSaved << ") ";
+	os << "Descriptor set binds: " << stats.descriptorSetBindsCount << " (saved " << stats.descriptorSetBindsSaved << ") ";
+	os << "Vertex buffer binds: " << stats.vertexBufferBindsCount << " (saved " << stats.vertexBufferBindsSaved << ") ";
+	os << "Meshes visible: " << stats.visibleCount << " (culled " << stats.culledCount << ", simplified " << stats.simplifiedCount << ", clustered " << stats.clusteredCount << ") ";
+	os << "Shadow draws: " << stats.shadowDrawsCount << " (cached cascades " << stats.shadowCachedCount << ")" << std::endl;
+}
+
+// printPipelineStatistics (overdraw is shaded fragments per view pixel, depth pre-pass shades each pixel once)
+void printPipelineStatistics(std::ostream& os, const VulkanPipelineStatistics& statistics, uint64_t viewPixelsCount) {
+	os << "Vertices: " << statistics.inputAssemblyVertices << " ";
+	os << "Primitives: " << statistics.inputAssemblyPrimitives << " (clipped " << statistics.clippingPrimitives << ") ";
+	os << "Vertex invocations: " << statistics.vertexShaderInvocations << " ";
+	os << "Fragment invocations: " << statistics.fragmentShaderInvocations << " ";
+	os << "(overdraw " << (double)statistics.fragmentShaderInvocations / (double)std::max(viewPixelsCount, (uint64_t)1) << ")" << std::endl;
+}
+
+// skinned sample tentacles (joints chain along y, rings of tube skinned by two nearest joints)
+#define SAMPLE_TENTACLE_JOINTS  8
+#define SAMPLE_TENTACLE_SEGMENT 0.1f
+#define SAMPLE_TENTACLE_RADIUS  0.03f
+#define SAMPLE_TENTACLE_SIDES   8
+
+// createTentacleSkeleton (bind pose of joints chain)
+VulkanSkeleton createTentacleSkeleton() {
+	VulkanSkeleton skeleton{};
+	for (int32_t joint = 0; joint < SAMPLE_TENTACLE_JOINTS; joint++) {
+		skeleton.parents.push_back(joint - 1);
+		skeleton.inverseBindMatrices.push_back(glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, -SAMPLE_TENTACLE_SEGMENT * joint, 0.0f)));
+	}
+	return skeleton;
+}
+
+// createTentacleClip (looped bending of joints around axis, phase travels down chain)
+VulkanAnimationClip* createTentacleClip(const glm::vec3& axis, float angle, uint32_t framesCount, float sampleRate) {
+	VulkanAnimationClip* clip = new VulkanAnimationClip(SAMPLE_TENTACLE_JOINTS, framesCount, sampleRate);
+	for (uint32_t frame = 0; frame < framesCount; frame++) {
+		float phase = 6.2831853f * (float)frame / (float)(framesCount - 1);
+		for (uint32_t joint = 0; joint < SAMPLE_TENTACLE_JOINTS; joint++)
+			clip->setJoint(frame, joint,
+				glm::vec3(0.0f, joint ? SAMPLE_TENTACLE_SEGMENT : 0.0f, 0.0f),
+				glm::angleAxis(joint ? angle * std::sin(phase - 0.5f * joint) : 0.0f, axis),
+				glm::vec3(1.0f));
+	}
+	return clip;
+}
+
+// createTentacleMesh (triangle list tube of bind pose, offset from chain)
+VulkanMeshMatObjSkinned* createTentacleMesh(VulkanContext& context, const glm::vec3& offset) {
+	VulkanHostVector<glm::vec4> pos;
+	VulkanHostVector<glm::vec2> tex;
+	VulkanHostVector<glm::vec3> nrm;
+	VulkanHostVector<glm::vec4> weights;
+	VulkanHostVector<glm::uvec4> joints;
+	uint32_t ringsCount = (SAMPLE_TENTACLE_JOINTS - 1) * 2 + 1;
+	for (uint32_t ring = 0; ring + 1 < ringsCount; ring++) {
+		for (uint32_t side = 0; side < SAMPLE_TENTACLE_SIDES; side++) {
+			// two triangles of quad (ring, side) to (ring + 1, side + 1)
+			const uint32_t corners[6][2] = { { 0, 0 }, { 1, 0 }, { 1, 1 }, { 0, 0 }, { 1, 1 }, { 0, 1 } };
+			for (auto& corner : corners) {
+				float y = (float)(ring + corner[0]) / (float)(ringsCount - 1) * SAMPLE_TENTACLE_SEGMENT * (SAMPLE_TENTACLE_JOINTS - 1);
+				float angle = 6.2831853f * (float)(side + corner[1]) / (float)SAMPLE_TENTACLE_SIDES;
+				glm::vec3 normal(std::cos(angle), 0.0f, -std::sin(angle));
+				uint32_t joint = std::min((uint32_t)(y / SAMPLE_TENTACLE_SEGMENT), (uint32_t)SAMPLE_TENTACLE_JOINTS - 2);
+				float weight = glm::clamp(y / SAMPLE_TENTACLE_SEGMENT - (float)joint, 0.0f, 1.0f);
+				pos.push_back(glm::vec4(offset + normal * SAMPLE_TENTACLE_RADIUS + glm::vec3(0.0f, y, 0.0f), 1.0f));
+				tex.push_back(glm::vec2((float)(side + corner[1]) / (float)SAMPLE_TENTACLE_SIDES, (float)(ring + corner[0]) / (float)(ringsCount - 1)));
+				nrm.push_back(normal);
+				weights.push_back(glm::vec4(1.0f - weight, weight, 0.0f, 0.0f));
+				joints.push_back(glm::uvec4(joint, joint + 1, 0, 0));
+			}
+		}
+	}
+	VulkanMeshMatObjSkinned* mesh = new VulkanMeshMatObjSkinned(context, pos, tex, nrm, weights, joints, SAMPLE_TENTACLE_JOINTS);
+	mesh->primitiveTopology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+	return mesh;
+}
 
 // main
 int main(int argc, char ** argv)
 {
-	// init GLFW
-	glfwInit();
-	if (!glfwVulkanSupported()) assert(0 && "Vulkan not supported");
-	glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
-	GLFWwindow* window = glfwCreateWindow(800, 600, "Simple example", NULL, NULL);
-	glfwSetFramebufferSizeCallback(window, framebufferSizeFunc);
+	// parse arguments: --headless [frames count], --batch <jobs file>, --depth-prepass, --shadows, --lights <count>, --dynamic-resolution [target ms],
+	// --present-mode <mailbox|immediate|fifo|fifo-relaxed>, --swapchain-images <count>, --max-queued-frames <count>, --throughput, --deferred,
+	// --particles <per second>, --skinned <count>
+#ifdef VULKAN_APP_HEADLESS_ONLY
+	// built without window system (offscreen and batch modes only)
+	bool headless = true;
+#else
+	bool headless = false;
+#endif
+	bool deferred = false;
+	bool depthPrepass = false;
+	bool shadows = false;
+	uint32_t lightsCount = 0;
+	float particlesRate = 0.0f;
+	uint32_t skinnedCount = 0;
+	float dynamicResolutionTargetTime = 0.0f;
+	uint32_t headlessFramesCount = 1000;
+	const char* batchJobsFileName{};
+	// swapchain config (default is low latency - one frame queued ahead of device, throughput queues frame per image)
+	VulkanSwapchainConfig swapchainConfig{};
+	swapchainConfig.presentMode = VK_PRESENT_MODE_MAILBOX_KHR;
+	swapchainConfig.imageCount = 3;
+	swapchainConfig.maxQueuedFrames = 1;
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--headless") == 0) {
+			headless = true;
+			if ((i + 1 < argc) && atoi(argv[i + 1]) > 0)
+				headlessFramesCount = (uint32_t)atoi(argv[++i]);
+		}
+		if ((strcmp(argv[i], "--batch") == 0) && (i + 1 < argc)) {
+			headless = true;
+			batchJobsFileName = argv[++i];
+		}
+		if (strcmp(argv[i], "--depth-prepass") == 0)
+			depthPrepass = true;
+		if (strcmp(argv[i], "--shadows") == 0)
+			shadows = true;
+		if ((strcmp(argv[i], "--lights") == 0) && (i + 1 < argc))
+			lightsCount = std::min((uint32_t)std::max(atoi(argv[++i]), 0), (uint32_t)VULKAN_LIGHT_CLUSTERS_MAX_LIGHTS);
+		if (strcmp(argv[i], "--dynamic-resolution") == 0) {
+			dynamicResolutionTargetTime = 16.6f;
+			if ((i + 1 < argc) && atof(argv[i + 1]) > 0.0)
+				dynamicResolutionTargetTime = (float)atof(argv[++i]);
+		}
+		if ((strcmp(argv[i], "--present-mode") == 0) && (i + 1 < argc)) {
+			i++;
+			if (strcmp(argv[i], "mailbox") == 0)
+				swapchainConfig.presentMode = VK_PRESENT_MODE_MAILBOX_KHR;
+			if (strcmp(argv[i], "immediate") == 0)
+				swapchainConfig.presentMode = VK_PRESENT_MODE_IMMEDIATE_KHR;
+			if (strcmp(argv[i], "fifo") == 0)
+				swapchainConfig.presentMode = VK_PRESENT_MODE_FIFO_KHR;
+			if (strcmp(argv[i], "fifo-relaxed") == 0)
+				swapchainConfig.presentMode = VK_PRESENT_MODE_FIFO_RELAXED_KHR;
+		}
+		if ((strcmp(argv[i], "--swapchain-images") == 0) && (i + 1 < argc))
+			swapchainConfig.imageCount = (uint32_t)std::max(atoi(argv[++i]), 1);
+		if ((strcmp(argv[i], "--max-queued-frames") == 0) && (i + 1 < argc))
+			swapchainConfig.maxQueuedFrames = (uint32_t)std::max(atoi(argv[++i]), 1);
+		if (strcmp(argv[i], "--throughput") == 0)
+			swapchainConfig.maxQueuedFrames = UINT32_MAX;
+		if (strcmp(argv[i], "--deferred") == 0)
+			deferred = true;
+		if ((strcmp(argv[i], "--particles") == 0) && (i + 1 < argc))
+			particlesRate = (float)std::max(atof(argv[++i]), 0.0);
+		if ((strcmp(argv[i], "--skinned") == 0) && (i + 1 < argc))
+			skinnedCount = (uint32_t)std::max(atoi(argv[++i]), 0);
+	}
 
 	// vulkan extensions
 	std::vector<const char *> enabledInstanceLayerNames{ "VK_LAYER_LUNARG_standard_validation" };
-	std::vector<const char *> enabledInstanceExtensionNames{ VK_EXT_DEBUG_REPORT_EXTENSION_NAME, VK_KHR_WIN32_SURFACE_EXTENSION_NAME, VK_KHR_SURFACE_EXTENSION_NAME };
-	std::vector<const char *> enabledDeviceExtensionNames{ VK_KHR_SWAPCHAIN_EXTENSION_NAME };
+	std::vector<const char *> enabledInstanceExtensionNames{ VK_EXT_DEBUG_REPORT_EXTENSION_NAME };
+	std::vector<const char *> enabledDeviceExtensionNames{ VK_EXT_EXTERNAL_MEMORY_HOST_EXTENSION_NAME, VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME };
+
+#ifndef VULKAN_APP_HEADLESS_ONLY
+	// init GLFW (window system is not touched in headless mode)
+	GLFWwindow* window{};
+	if (!headless) {
+		glfwInit();
+		if (!glfwVulkanSupported()) assert(0 && "Vulkan not supported");
+		glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
+		window = glfwCreateWindow(800, 600, "Simple example", NULL, NULL);
+		glfwSetFramebufferSizeCallback(window, framebufferSizeFunc);
+
+		// surface extensions required by platform
+		uint32_t glfwExtensionsCount = 0;
+		const char** glfwExtensionNames = glfwGetRequiredInstanceExtensions(&glfwExtensionsCount);
+		enabledInstanceExtensionNames.insert(enabledInstanceExtensionNames.end(), glfwExtensionNames, glfwExtensionNames + glfwExtensionsCount);
+		enabledDeviceExtensionNames.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+	}
+#endif
 
 	// VkPhysicalDeviceFeatures
 	VkPhysicalDeviceFeatures physicalDeviceFeatures{};
 	physicalDeviceFeatures.depthBounds = VK_TRUE;
 	physicalDeviceFeatures.samplerAnisotropy = VK_TRUE;
 	physicalDeviceFeatures.fillModeNonSolid = VK_TRUE;
+	physicalDeviceFeatures.multiDrawIndirect = VK_TRUE;
+	physicalDeviceFeatures.drawIndirectFirstInstance = VK_TRUE;
+	physicalDeviceFeatures.pipelineStatisticsQuery = VK_TRUE;
+	physicalDeviceFeatures.inheritedQueries = VK_TRUE;
 
 	// create vulkan context
 	VulkanContext* context = new VulkanContext(
@@ -44,12 +230,65 @@ int main(int argc, char ** argv)
 		enabledDeviceExtensionNames, 
 		physicalDeviceFeatures);
 
-	// create window surface
-	VulkanSurface* surface = new VulkanSurface();
-	glfwCreateWindowSurface(context->instance.instance, window, NULL, &surface->surface);
+#ifndef VULKAN_APP_HEADLESS_ONLY
+	// window needs swapchain (other extensions and features are optional and checked where used)
+	if (!headless && !vulkanDeviceExtensionEnabled(context->device, VK_KHR_SWAPCHAIN_EXTENSION_NAME)) {
+		std::cerr << "Device does not support " << VK_KHR_SWAPCHAIN_EXTENSION_NAME << std::endl;
+		delete context;
+		glfwDestroyWindow(window);
+		glfwTerminate();
+		return 1;
+	}
+#endif
+
+	// batch mode: render previews for all jobs and exit
+	if (batchJobsFileName) {
+		// worker threads for loading and encoding
+		uint32_t threadsCount = std::max(std::thread::hardware_concurrency() / 2, 1u);
+		// all camera presets in one multiview frame if supported
+		uint32_t viewsCount = context->device.multiviewEnabled ? std::min(context->device.maxMultiviewViewCount, 4u) : 1u;
+		std::vector<VulkanBatchJob> jobs = VulkanBatchRenderer::loadJobsFromFile(batchJobsFileName);
+		VulkanBatchRenderer* batchRenderer = new VulkanBatchRenderer(*context, 256, 256, 4, viewsCount, threadsCount, threadsCount);
+		VulkanBatchStats stats = batchRenderer->run(jobs);
+		delete batchRenderer;
+		delete context;
+
+		// print stats
+		std::cout << "Assets: " << stats.assetsCount << " ";
+		std::cout << "Images: " << stats.imagesCount << " ";
+		std::cout << "Time: " << stats.totalTime << " ";
+		std::cout << "Assets/s: " << stats.assetsPerSecond << " ";
+		std::cout << "Images/s: " << stats.imagesPerSecond << std::endl;
+		return 0;
+	}
 
-	// create vulkan renderer
-	renderer = new VulkanRenderer_default(*context, *surface);
+	// create window surface and vulkan renderer
+	VulkanSurface* surface{};
+	VulkanRenderer_offscreen* rendererOffscreen{};
+	if (headless) {
+		rendererOffscreen = new VulkanRenderer_offscreen(*context, 800, 600, 3);
+		rendererOffscreen->setReadbackFunc(readbackFunc);
+		renderer = rendererOffscreen;
+	}
+#ifdef VULKAN_APP_HEADLESS_ONLY
+	// window options are parsed but not used without window system
+	(void)deferred;
+	(void)dynamicResolutionTargetTime;
+	(void)swapchainConfig;
+#else
+	VulkanRenderer_default* rendererDefault{};
+	if (!headless) {
+		surface = new VulkanSurface();
+		glfwCreateWindowSurface(context->instance.instance, window, NULL, &surface->surface);
+		// deferred renderer shades G-buffer in lighting subpass (window only)
+		if (deferred)
+			rendererDefault = new VulkanRenderer_deferred(*context, *surface, swapchainConfig);
+		else
+			rendererDefault = new VulkanRenderer_default(*context, *surface, swapchainConfig);
+		rendererDefault->setDynamicResolution(dynamicResolutionTargetTime > 0.0f ? VK_TRUE : VK_FALSE, dynamicResolutionTargetTime, 0.5f);
+		renderer = rendererDefault;
+	}
+#endif
 
 	// create assets manages
 	VulkanAssetManager* assetsManager = new VulkanAssetManager(*context);
@@ -67,35 +306,144 @@ int main(int argc, char ** argv)
 	scene->matrixView = glm::lookAt(glm::vec3(0.0f, 1.0f, 2.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
 	scene->matrixProjection = glm::perspective(glm::radians(45.0f), renderer->getViewAspect(), 0.1f, 10.f);
 	scene->models.push_back(model);
+	scene->depthPrepass = depthPrepass ? VK_TRUE : VK_FALSE;
+	scene->shadows = shadows ? VK_TRUE : VK_FALSE;
+	// model is rotated every frame (its shadows are not cached)
+	model->dynamic = VK_TRUE;
+	// point lights on spiral around model (golden angle steps, hue cycles with index)
+	for (uint32_t i = 0; i < lightsCount; i++) {
+		float t = (float)(i + 1) / (float)lightsCount;
+		float angle = (float)i * 2.39996f;
+		glm::vec3 color = glm::vec3(0.5f) + 0.5f * glm::vec3(std::cos(angle), std::cos(angle + 2.094f), std::cos(angle + 4.189f));
+		scene->lights.push_back({ glm::vec4(2.0f * t * std::cos(angle), 1.0f - 2.0f * t, 2.0f * t * std::sin(angle), 0.5f), glm::vec4(color, 1.0f) });
+	}
+	// particle fountain above model (alive particles are rate times life)
+	if (particlesRate > 0.0f) {
+		VulkanParticleEmitter emitter{};
+		emitter.position = glm::vec3(0.0f, 0.5f, 0.0f);
+		emitter.velocity = glm::vec3(0.0f, 3.0f, 0.0f);
+		emitter.rate = particlesRate;
+		scene->particleEmitters.push_back(emitter);
+	}
+	// skinned tentacles on circle around model (two meshes share animator of model, two blended clips per animator)
+	VulkanSkeleton tentacleSkeleton = createTentacleSkeleton();
+	VulkanAnimationClip* tentacleClips[2]{};
+	std::vector<VulkanModel*> skinnedModels;
+	std::vector<VulkanAnimator*> animators;
+	context->beginUploads();
+	if (skinnedCount) {
+		tentacleClips[0] = createTentacleClip(glm::vec3(0.0f, 0.0f, 1.0f), 0.3f, 31, 30.0f);
+		tentacleClips[1] = createTentacleClip(glm::vec3(1.0f, 0.0f, 0.0f), 0.4f, 21, 10.0f);
+	}
+	for (uint32_t i = 0; i < skinnedCount; i++) {
+		// animator with layer times between keyframes
+		VulkanAnimator* animator = new VulkanAnimator(tentacleSkeleton);
+		animator->layers[0] = { tentacleClips[0], 0.137f * i + 0.011f, 1.0f, 0.7f };
+		animator->layers[1] = { tentacleClips[1], 0.291f * i + 0.023f, 0.5f, 0.3f };
+		animator->layersCount = 2;
+		// SIMD sampling and blending matches scalar reference
+		bool animatorValid = animator->validate(1e-4f);
+		assert(animatorValid && "SIMD animation differs from scalar reference");
+		(void)animatorValid;
+		animators.push_back(animator);
+		// model of two meshes
+		float angle = 6.2831853f * (float)i / (float)skinnedCount;
+		VulkanModel* skinnedModel = new VulkanModel(*context);
+		skinnedModel->matrixModel = glm::translate(glm::mat4(1.0f), glm::vec3(0.7f * std::cos(angle), -0.3f, 0.7f * std::sin(angle)));
+		for (float offset : { -0.04f, 0.04f }) {
+			VulkanMeshMatObjSkinned* mesh = createTentacleMesh(*context, glm::vec3(offset, 0.0f, 0.0f));
+			mesh->material = model->meshes[0]->material;
+			mesh->materialUsage = model->meshes[0]->materialUsage;
+			mesh->animator = animator;
+			skinnedModel->addMeshSkinned(mesh);
+		}
+		skinnedModels.push_back(skinnedModel);
+		scene->models.push_back(skinnedModel);
+	}
+	context->endUploads();
 
 	// create time stamp
 	TimeStamp timeStamp{};
 	timeStampReset(timeStamp);
 
+	// headless loop
+	if (headless) {
+		for (uint32_t frame = 0; frame < headlessFramesCount; frame++)
+		{
+			// get time tick
+			timeStampTick(timeStamp);
+
+			// rotate model and advance animators
+			model->matrixModel = glm::rotate(glm::scale(glm::mat4(1.0f), glm::vec3(1.0f / 1.0f)), timeStamp.accumTime, glm::vec3(0.0f, 1.0f, 0.0f));
+			for (auto& animator : animators)
+				animator->advance(timeStamp.deltaTime);
+
+			// draw scene (readback of older frames is delivered meanwhile)
+			rendererOffscreen->drawScene(scene);
+		}
+		rendererOffscreen->finish();
+
+		// print throughput
+		timeStampTick(timeStamp);
+		std::cout << "Frames: " << readbackFramesCount << " ";
+		std::cout << "FPS: " << readbackFramesCount / timeStamp.accumTime << " ";
+		std::cout << "Readback MB/s: " << readbackBytesCount / timeStamp.accumTime / (1024.0f * 1024.0f) << std::endl;
+		printRenderQueueStats(std::cout, renderer->getRenderQueueStats());
+		printPipelineStatistics(std::cout, renderer->getPipelineStatistics(), (uint64_t)renderer->getRenderWidth() * renderer->getRenderHeight());
+	}
+
+#ifndef VULKAN_APP_HEADLESS_ONLY
 	// main loop
-	while (!glfwWindowShouldClose(window))
+	while (!headless && !glfwWindowShouldClose(window))
 	{
 		// get time tick
 		timeStampTick(timeStamp);
+		if (timeStamp.printTime >= 1.0f) {
+			printRenderQueueStats(std::cout, renderer->getRenderQueueStats());
+			printPipelineStatistics(std::cout, renderer->getPipelineStatistics(), (uint64_t)renderer->getRenderWidth() * renderer->getRenderHeight());
+			std::cout << "Render scale: " << rendererDefault->getRenderScale() << " (GPU frame ms " << rendererDefault->getFrameTime() << ") ";
+			std::cout << "Latency ms: " << rendererDefault->getFrameLatency() << " (present mode " << rendererDefault->getPresentMode() << ", queued frames " << rendererDefault->getMaxQueuedFrames() << ")" << std::endl;
+		}
 		timeStampPrint(std::cout, timeStamp, 1.0f);
 
-		// rotate model
+		// rotate model, advance particles and animators
 		model->matrixModel = glm::rotate(glm::scale(glm::mat4(1.0f), glm::vec3(1.0f / 1.0f)), timeStamp.accumTime, glm::vec3(0.0f, 1.0f, 0.0f));
+		scene->particleTimeStep = timeStamp.deltaTime;
+		for (auto& animator : animators)
+			animator->advance(timeStamp.deltaTime);
 
 		// draw scene
 		renderer->drawScene(scene);
 
 		glfwPollEvents();
 	}
+#endif
 
 	// destroy handles
 	delete scene;
+	for (auto& skinnedModel : skinnedModels) {
+		for (auto& mesh : skinnedModel->meshes_skinned)
+			delete mesh;
+		delete skinnedModel;
+	}
+	for (auto& animator : animators)
+		delete animator;
+	for (auto& clip : tentacleClips)
+		delete clip;
 	delete model;
 	delete assetsManager;
 	delete renderer;
+	if (surface) {
+		vkDestroySurfaceKHR(context->instance.instance, surface->surface, VK_NULL_HANDLE);
+		delete surface;
+	}
 	delete context;
 
+#ifndef VULKAN_APP_HEADLESS_ONLY
 	// destroy GLFW
-	glfwDestroyWindow(window);
-	glfwTerminate();
+	if (!headless) {
+		glfwDestroyWindow(window);
+		glfwTerminate();
+	}
+#endif
 }
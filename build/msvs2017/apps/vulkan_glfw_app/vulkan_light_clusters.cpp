@@ -0,0 +1,94 @@
+#include "vulkan_light_clusters.hpp"
+#include <glm/exponential.hpp>
+#include <glm/matrix.hpp>
+#include <algorithm>
+#include <cassert>
+
+// VulkanLightClusters::VulkanLightClusters
+VulkanLightClusters::VulkanLightClusters(VulkanContext& context) :
+	context(context)
+{
+	// create compute pipeline
+	vulkanPipelineCreateCompute(context.device, shader_light_clusters_file_comp, context.pipelineLayout_lightClusters, &pipeline_light_clusters);
+
+	// create buffers (light counts of clusters are followed by light indices of clusters)
+	vulkanBufferCreate(context.device, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, sizeof(VulkanLightClustersData), &bufferClustersData);
+	vulkanBufferCreate(context.device, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, sizeof(VulkanLight) * VULKAN_LIGHT_CLUSTERS_MAX_LIGHTS, &bufferLights);
+	vulkanBufferCreate(context.device, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, sizeof(uint32_t) * VULKAN_LIGHT_CLUSTERS_COUNT * (1 + VULKAN_LIGHT_CLUSTER_MAX_LIGHTS), &bufferClusters);
+
+	// create binning descriptor set
+	vulkanDescriptorSetCreate(context.device, context.descriptorSetLayout_lightClusters, &descriptorSet);
+	vulkanDescriptorSetUpdateBufferUniform(context.device, descriptorSet, bufferClustersData, 0);
+	vulkanDescriptorSetUpdateBufferStorage(context.device, descriptorSet, bufferLights, 1);
+	vulkanDescriptorSetUpdateBufferStorage(context.device, descriptorSet, bufferClusters, 2);
+}
+
+// VulkanLightClusters::~VulkanLightClusters
+VulkanLightClusters::~VulkanLightClusters()
+{
+	// destroy descriptor set and buffers
+	vulkanDescriptorSetDestroy(context.device, descriptorSet);
+	vulkanBufferDestroy(context.device, bufferClusters);
+	vulkanBufferDestroy(context.device, bufferLights);
+	vulkanBufferDestroy(context.device, bufferClustersData);
+	// destroy pipeline
+	vulkanPipelineDestroy(context.device, pipeline_light_clusters);
+}
+
+// VulkanLightClusters::update
+void VulkanLightClusters::update(VulkanCommandBuffer& commandBuffer, const glm::mat4& matrixView, const glm::mat4& matrixProjection, const std::vector<VulkanLight>& lights)
+{
+	// clustered depth range from near and far planes of projection
+	glm::mat4 matrixProjectionInverse = glm::inverse(matrixProjection);
+	glm::vec4 nearPoint = matrixProjectionInverse * glm::vec4(0.0f, 0.0f, -1.0f, 1.0f);
+	glm::vec4 farPoint = matrixProjectionInverse * glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+	float nearDepth = std::max(-nearPoint.z / nearPoint.w, 1e-3f);
+	float farDepth = std::max(-farPoint.z / farPoint.w, nearDepth * 2.0f);
+	float logRatio = glm::log(farDepth / nearDepth);
+
+	// cluster data (slice of view depth d is log(d) * scale + bias)
+	assert(lights.size() <= VULKAN_LIGHT_CLUSTERS_MAX_LIGHTS);
+	clustersData.matrixView = matrixView;
+	clustersData.matrixViewProjection = matrixProjection * matrixView;
+	clustersData.matrixProjectionInverse = matrixProjectionInverse;
+	clustersData.depthParams = glm::vec4(nearDepth, farDepth, VULKAN_LIGHT_CLUSTERS_Z / logRatio, -VULKAN_LIGHT_CLUSTERS_Z * glm::log(nearDepth) / logRatio);
+	clustersData.lightsCount = (uint32_t)std::min(lights.size(), (size_t)VULKAN_LIGHT_CLUSTERS_MAX_LIGHTS);
+	vkCmdUpdateBuffer(commandBuffer.commandBuffer, bufferClustersData.buffer, 0, sizeof(VulkanLightClustersData), &clustersData);
+	if (!clustersData.lightsCount)
+		return;
+
+	// VkMemoryBarrier - previous frames in flight finished reading light list and clusters
+	VkMemoryBarrier memoryBarrier{};
+	memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+	memoryBarrier.pNext = VK_NULL_HANDLE;
+	memoryBarrier.srcAccessMask = VK_ACCESS_SHADER_READ_BIT;
+	memoryBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+	vkCmdPipelineBarrier(commandBuffer.commandBuffer, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &memoryBarrier, 0, VK_NULL_HANDLE, 0, VK_NULL_HANDLE);
+
+	// light list
+	vkCmdUpdateBuffer(commandBuffer.commandBuffer, bufferLights.buffer, 0, sizeof(VulkanLight) * clustersData.lightsCount, lights.data());
+
+	// VkMemoryBarrier - updated light list and cluster data visible to binning
+	memoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	memoryBarrier.dstAccessMask = VK_ACCESS_UNIFORM_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+	vkCmdPipelineBarrier(commandBuffer.commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &memoryBarrier, 0, VK_NULL_HANDLE, 0, VK_NULL_HANDLE);
+
+	// bin lights (one invocation per cluster)
+	vkCmdBindPipeline(commandBuffer.commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline_light_clusters.pipeline);
+	vkCmdBindDescriptorSets(commandBuffer.commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, context.pipelineLayout_lightClusters.pipelineLayout, 0, 1, &descriptorSet.descriptorSet, 0, VK_NULL_HANDLE);
+	vkCmdDispatch(commandBuffer.commandBuffer, (VULKAN_LIGHT_CLUSTERS_COUNT + VULKAN_LIGHT_CLUSTERS_GROUP_SIZE - 1) / VULKAN_LIGHT_CLUSTERS_GROUP_SIZE, 1, 1);
+
+	// VkMemoryBarrier - binned clusters visible to lit fragment shaders
+	memoryBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+	memoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+	vkCmdPipelineBarrier(commandBuffer.commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 1, &memoryBarrier, 0, VK_NULL_HANDLE, 0, VK_NULL_HANDLE);
+}
+
+// VulkanLightClusters::updateDescriptorSet
+void VulkanLightClusters::updateDescriptorSet(VulkanDescriptorSet& descriptorSet, uint32_t bindingLights, uint32_t bindingClusters, uint32_t bindingClustersData)
+{
+	// light list, cluster grid and cluster data
+	vulkanDescriptorSetUpdateBufferStorage(context.device, descriptorSet, bufferLights, bindingLights);
+	vulkanDescriptorSetUpdateBufferStorage(context.device, descriptorSet, bufferClusters, bindingClusters);
+	vulkanDescriptorSetUpdateBufferUniform(context.device, descriptorSet, bufferClustersData, bindingClustersData);
+}
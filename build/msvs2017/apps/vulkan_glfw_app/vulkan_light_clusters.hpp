@@ -0,0 +1,69 @@
+#pragma once
+
+#include "vulkan_context.hpp"
+#include <glm/vec4.hpp>
+#include <glm/mat4x4.hpp>
+#include <vector>
+
+// cluster grid of view frustum (tiles of normalized device coordinates, exponential depth slices, must match shaders)
+#define VULKAN_LIGHT_CLUSTERS_X 16
+#define VULKAN_LIGHT_CLUSTERS_Y 9
+#define VULKAN_LIGHT_CLUSTERS_Z 24
+#define VULKAN_LIGHT_CLUSTERS_COUNT (VULKAN_LIGHT_CLUSTERS_X * VULKAN_LIGHT_CLUSTERS_Y * VULKAN_LIGHT_CLUSTERS_Z)
+
+// max lights of scene and max lights binned per cluster (must match shaders)
+#define VULKAN_LIGHT_CLUSTERS_MAX_LIGHTS 1024
+#define VULKAN_LIGHT_CLUSTER_MAX_LIGHTS 128
+
+// light binning shader work group size (must match shader)
+#define VULKAN_LIGHT_CLUSTERS_GROUP_SIZE 64
+
+// VulkanLight (std430 point light of light list, scene set binding 1)
+struct VulkanLight {
+	glm::vec4 positionRadius; // world position and radius of influence
+	glm::vec4 colorIntensity; // linear color and intensity
+};
+
+// VulkanLightClustersData (std140 cluster uniforms of light binning and lit fragment shaders, scene set binding 5)
+struct VulkanLightClustersData {
+	glm::mat4 matrixView;
+	glm::mat4 matrixViewProjection;
+	glm::mat4 matrixProjectionInverse;
+	glm::vec4 depthParams; // near and far of clustered depth range, scale and bias of slice from log of view depth
+	uint32_t  lightsCount;
+	uint32_t  padding[3];
+};
+
+// VulkanLightClusters (point lights binned into froxel clusters of first view by compute shader every frame)
+class VulkanLightClusters {
+protected:
+	// base handles
+	VulkanContext& context;
+protected:
+	// binning shader file
+	const char* shader_light_clusters_file_comp = "shaders/light_clusters.comp.spv";
+	// compute pipeline and its descriptor set
+	VulkanPipeline      pipeline_light_clusters{};
+	VulkanDescriptorSet descriptorSet{};
+protected:
+	// cluster data buffer (binning and lit shaders)
+	VulkanBuffer            bufferClustersData{};
+	VulkanLightClustersData clustersData{};
+	// light list buffer (lights of scene)
+	VulkanBuffer bufferLights{};
+	// cluster grid buffer (light count per cluster, then fixed range of light indices per cluster)
+	VulkanBuffer bufferClusters{};
+public:
+	// constructor and destructor
+	VulkanLightClusters(VulkanContext& context);
+	~VulkanLightClusters();
+
+	// update light list and record light binning of first view (no lights skips binning)
+	void update(VulkanCommandBuffer& commandBuffer, const glm::mat4& matrixView, const glm::mat4& matrixProjection, const std::vector<VulkanLight>& lights);
+
+	// write light list, cluster grid and cluster data into descriptor set
+	void updateDescriptorSet(VulkanDescriptorSet& descriptorSet, uint32_t bindingLights, uint32_t bindingClusters, uint32_t bindingClustersData);
+
+	// getters
+	uint32_t getLightsCount() const { return clustersData.lightsCount; }
+};
@@ -2,6 +2,11 @@
 #include <algorithm>
 #include <string>
 
+// decode images to aligned host memory (can be imported by device)
+#define STBI_MALLOC(size)                       vulkanHostMemoryAlloc(size)
+#define STBI_REALLOC(data, size)                vulkanHostMemoryRealloc(data, size)
+#define STBI_FREE(data)                         vulkanHostMemoryFree(data)
+
 #define STB_IMAGE_IMPLEMENTATION
 #define STB_IMAGE_WRITE_IMPLEMENTATION
 #pragma warning(push)
@@ -10,21 +15,22 @@
 #include <stb_image_write.h>
 #pragma warning(pop)
 
-// createImageProcedural
+// createImageProcedural (upload is recorded into transfer when given)
 void createImageProcedural(
-	VulkanDevice& device,
-	uint32_t      width,
-	uint32_t      height,
-	VulkanImage&  image)
+	VulkanDevice&   device,
+	uint32_t        width,
+	uint32_t        height,
+	VulkanImage&    image,
+	VulkanTransfer* transfer)
 {
 	// create data for image
 	struct pixel_u8 { uint8_t r, g, b, a; };
 	pixel_u8 color0{ 255, 128, 000, 255 };
 	pixel_u8 color1{ 255, 255, 255, 255 };
-	pixel_u8* texData = new pixel_u8[width * height];
+	pixel_u8* texData = (pixel_u8*)vulkanHostMemoryAlloc(width * height * sizeof(pixel_u8));
 
 	// create image instance
-	vulkanImageCreate(device, VK_FORMAT_R8G8B8A8_UNORM, width, height, 1, &image);
+	vulkanImageCreate(device, VK_FORMAT_R8G8B8A8_UNORM, width, height, 1, 1, &image);
 
 	// fill image buffer
 	for (uint32_t i = 0; i < height; i++) {
@@ -35,26 +41,86 @@ void createImageProcedural(
 				texData[i*width + j] = color1;
 		}
 	}
-	vulkanImageWrite(device, image, 0, texData);
-	vulkanImageBuildMipmaps(device, image);
-	delete[] texData;
+	if (transfer) {
+		vulkanTransferImageWrite(device, *transfer, image, 0, texData);
+		vulkanTransferImageBuildMipmaps(device, *transfer, image);
+	}
+	else {
+		vulkanImageWriteHostMemory(device, image, 0, texData);
+		vulkanImageBuildMipmaps(device, image);
+	}
+	vulkanHostMemoryFree(texData);
 }
 
-// loadImageFromFile
+// loadImageFromFile (upload is recorded into transfer when given)
 void loadImageFromFile(
-	VulkanDevice& device,
-	VulkanImage&  image,
-	std::string   fileName)
+	VulkanDevice&   device,
+	VulkanImage&    image,
+	std::string     fileName,
+	VulkanTransfer* transfer)
+{
+	// load image data from file
+	VulkanImageData imageData{};
+	decodeImageFromFile(imageData, fileName);
+
+	// create and setup vulkan image
+	createImageFromData(device, image, imageData, transfer);
+
+	// free image data
+	freeImageData(imageData);
+}
+
+// decodeImageFromFile (no device access, can be called from any thread)
+void decodeImageFromFile(
+	VulkanImageData& imageData,
+	std::string      fileName)
 {
 	// load image data from file
 	int width = 0, height = 0, channels = 0;
-	stbi_uc* texData = stbi_load(fileName.data(), &width, &height, &channels, 4);
+	imageData.pixels = stbi_load(fileName.data(), &width, &height, &channels, 4);
+	imageData.width = (uint32_t)width;
+	imageData.height = (uint32_t)height;
+}
+
+// createImageFromData (upload is recorded into transfer when given, image data can be freed right after)
+void createImageFromData(
+	VulkanDevice&    device,
+	VulkanImage&     image,
+	VulkanImageData& imageData,
+	VulkanTransfer*  transfer)
+{
+	// check image data
+	assert(imageData.pixels);
 
 	// create and setup vulkan image
-	vulkanImageCreate(device, VK_FORMAT_R8G8B8A8_UNORM, width, height, 1, &image);
-	vulkanImageWrite(device, image, 0, texData);
+	vulkanImageCreate(device, VK_FORMAT_R8G8B8A8_UNORM, imageData.width, imageData.height, 1, 1, &image);
+	if (transfer) {
+		vulkanTransferImageWrite(device, *transfer, image, 0, imageData.pixels);
+		vulkanTransferImageBuildMipmaps(device, *transfer, image);
+		return;
+	}
+	vulkanImageWriteHostMemory(device, image, 0, imageData.pixels);
 	vulkanImageBuildMipmaps(device, image);
+}
 
+// freeImageData
+void freeImageData(
+	VulkanImageData& imageData)
+{
 	// free image data
-	stbi_image_free(texData);
-}
\ No newline at end of file
+	stbi_image_free(imageData.pixels);
+	imageData.pixels = nullptr;
+	imageData.width = 0;
+	imageData.height = 0;
+}
+
+// saveImageToFilePng (no device access, can be called from any thread)
+void saveImageToFilePng(
+	std::string fileName,
+	uint32_t    width,
+	uint32_t    height,
+	const void* pixels)
+{
+	// write RGBA8 rows
+	stbi_write_png(fileName.data(), (int)width, (int)height, 4, pixels, (int)width * 4);
+}
@@ -3,13 +3,41 @@
 #include <vktoolkit.hpp>
 #include <iostream>
 
+// image pixels decoded to host memory (RGBA8)
+typedef struct VulkanImageData {
+	uint32_t width;
+	uint32_t height;
+	void*    pixels;
+} VulkanImageData;
+
 void createImageProcedural(
-	VulkanDevice& device,
-	uint32_t      width,
-	uint32_t      height,
-	VulkanImage&  image);
+	VulkanDevice&   device,
+	uint32_t        width,
+	uint32_t        height,
+	VulkanImage&    image,
+	VulkanTransfer* transfer = nullptr);
 
 void loadImageFromFile(
-	VulkanDevice& device,
-	VulkanImage&  image,
-	std::string   fileName);
+	VulkanDevice&   device,
+	VulkanImage&    image,
+	std::string     fileName,
+	VulkanTransfer* transfer = nullptr);
+
+void decodeImageFromFile(
+	VulkanImageData& imageData,
+	std::string      fileName);
+
+void createImageFromData(
+	VulkanDevice&    device,
+	VulkanImage&     image,
+	VulkanImageData& imageData,
+	VulkanTransfer*  transfer = nullptr);
+
+void freeImageData(
+	VulkanImageData& imageData);
+
+void saveImageToFilePng(
+	std::string fileName,
+	uint32_t    width,
+	uint32_t    height,
+	const void* pixels);
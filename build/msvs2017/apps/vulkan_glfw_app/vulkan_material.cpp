@@ -1,5 +1,9 @@
 #include "vulkan_material.hpp"
 #include "vulkan_context.hpp"
+#include <atomic>
+
+// unique material identifiers
+static std::atomic<uint32_t> materialIdCounter{};
 
 // VulkamMaterial::VulkamMaterial
 VulkanMaterial::VulkanMaterial(VulkanContext& context) : VulkanContextObject(context) {
@@ -9,6 +13,8 @@ VulkanMaterial::VulkanMaterial(VulkanContext& context) : VulkanContextObject(con
 	vulkanBufferCreate(context.device, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, sizeof(materialInfo), &bufferMaterialColors);
 	// set descriptor set (binding 1)
 	vulkanDescriptorSetUpdateBufferUniform(context.device, descriptorSet, bufferMaterialColors, 1);
+	// assign material identifier
+	materialId = materialIdCounter++;
 }
 
 // VulkamMaterial::~VulkamMaterial
@@ -93,3 +99,13 @@ void VulkanMaterial::bind(VulkanCommandBuffer& commandBuffer) {
 	vkCmdBindDescriptorSets(commandBuffer.commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
 		context.pipelineLayout.pipelineLayout, 0, 1, &descriptorSet.descriptorSet, 0, VK_NULL_HANDLE);
 };
+
+// VulkanMaterial::getDescriptorSet
+VkDescriptorSet VulkanMaterial::getDescriptorSet() const {
+	return descriptorSet.descriptorSet;
+}
+
+// VulkanMaterial::getMaterialId
+uint32_t VulkanMaterial::getMaterialId() const {
+	return materialId;
+}
@@ -35,6 +35,8 @@ protected:
 	VulkanBuffer bufferMaterialColors{};
 	// material info
 	VulkanMaterialInfo materialInfo{};
+	// unique material identifier (render queue sort keys)
+	uint32_t materialId{};
 public:
 	// constructor and destructor
 	VulkanMaterial(VulkanContext& context);
@@ -63,4 +65,8 @@ public:
 
 	// bind
 	virtual void bind(VulkanCommandBuffer& commandBuffer);
+
+	// getters
+	VkDescriptorSet getDescriptorSet() const;
+	uint32_t getMaterialId() const;
 };
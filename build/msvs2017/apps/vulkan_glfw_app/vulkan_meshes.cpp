@@ -1,97 +1,274 @@
 #include "vulkan_meshes.hpp"
 #include "vulkan_context.hpp"
+#include <glm/geometric.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+
+// unique mesh identifiers (render queue sort keys)
+static std::atomic<uint32_t> meshIdCounter{};
+
+// vulkanMeshBounds (bounding box, sphere from bounding box center and farthest vertex)
+static void vulkanMeshBounds(
+	VulkanHostVector<glm::vec4>& pos,
+	glm::vec3&                   boundingBoxMin,
+	glm::vec3&                   boundingBoxMax,
+	glm::vec4&                   boundingSphere)
+{
+	// bounding box
+	boundingBoxMin = glm::vec3(0.0f);
+	boundingBoxMax = glm::vec3(0.0f);
+	boundingSphere = glm::vec4(0.0f);
+	if (pos.empty()) return;
+	boundingBoxMin = glm::vec3(pos[0]);
+	boundingBoxMax = glm::vec3(pos[0]);
+	for (const auto& p : pos) {
+		boundingBoxMin = glm::min(boundingBoxMin, glm::vec3(p));
+		boundingBoxMax = glm::max(boundingBoxMax, glm::vec3(p));
+	}
+	// radius
+	glm::vec3 center = (boundingBoxMin + boundingBoxMax) * 0.5f;
+	float radius2 = 0.0f;
+	for (const auto& p : pos) {
+		glm::vec3 d = glm::vec3(p) - center;
+		radius2 = glm::max(radius2, glm::dot(d, d));
+	}
+	boundingSphere = glm::vec4(center, glm::sqrt(radius2));
+}
 
 // VulkanMeshMatObj::VulkanMeshMatObj
 VulkanMeshMatObj::VulkanMeshMatObj(
-	VulkanContext&          context,
-	std::vector<glm::vec4>& pos,
-	std::vector<glm::vec2>& tex,
-	std::vector<glm::vec3>& nrm) :
+	VulkanContext&               context,
+	VulkanHostVector<glm::vec4>& pos,
+	VulkanHostVector<glm::vec2>& tex,
+	VulkanHostVector<glm::vec3>& nrm,
+	VkBool32                     pooled) :
 	VulkanMeshMaterial(context)
 {
-	// create buffers
-	vulkanBufferCreate(context.device, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VKT_VECTOR_DATA_SIZE(pos), &bufferPos);
-	vulkanBufferCreate(context.device, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VKT_VECTOR_DATA_SIZE(tex), &bufferTex);
-	vulkanBufferCreate(context.device, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VKT_VECTOR_DATA_SIZE(nrm), &bufferNrm);
-	// write buffers
-	vulkanBufferWrite(context.device, bufferPos, 0, VKT_VECTOR_DATA_SIZE(pos), pos.data());
-	vulkanBufferWrite(context.device, bufferTex, 0, VKT_VECTOR_DATA_SIZE(tex), tex.data());
-	vulkanBufferWrite(context.device, bufferNrm, 0, VKT_VECTOR_DATA_SIZE(nrm), nrm.data());
 	vertexCount = (uint32_t)pos.size();
-	// setup buffer handles and offsets
-	bufferHandles = { bufferPos.buffer, bufferTex.buffer, bufferNrm.buffer };
-	bufferOffsets = { 0, 0, 0 };
+	// allocate vertices in geometry pool
+	VulkanGeometryPool* geometryPool = context.geometryPool;
+	if (pooled && geometryPool && vertexCount && geometryPool->allocateVertices(vertexCount, vertexRange)) {
+		// write pool buffers
+		context.writeBuffer(geometryPool->bufferPos, vertexRange.first * sizeof(glm::vec4), VKT_VECTOR_DATA_SIZE(pos), pos.data());
+		context.writeBuffer(geometryPool->bufferTex, vertexRange.first * sizeof(glm::vec2), VKT_VECTOR_DATA_SIZE(tex), tex.data());
+		context.writeBuffer(geometryPool->bufferNrm, vertexRange.first * sizeof(glm::vec3), VKT_VECTOR_DATA_SIZE(nrm), nrm.data());
+		drawInfo.vertexBuffers[0] = geometryPool->bufferPos.buffer;
+		drawInfo.vertexBuffers[1] = geometryPool->bufferTex.buffer;
+		drawInfo.vertexBuffers[2] = geometryPool->bufferNrm.buffer;
+	}
+	else {
+		// create buffers
+		vulkanBufferCreate(context.device, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VKT_VECTOR_DATA_SIZE(pos), &bufferPos);
+		vulkanBufferCreate(context.device, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VKT_VECTOR_DATA_SIZE(tex), &bufferTex);
+		vulkanBufferCreate(context.device, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VKT_VECTOR_DATA_SIZE(nrm), &bufferNrm);
+		// write buffers
+		context.writeBuffer(bufferPos, 0, VKT_VECTOR_DATA_SIZE(pos), pos.data());
+		context.writeBuffer(bufferTex, 0, VKT_VECTOR_DATA_SIZE(tex), tex.data());
+		context.writeBuffer(bufferNrm, 0, VKT_VECTOR_DATA_SIZE(nrm), nrm.data());
+		drawInfo.vertexBuffers[0] = bufferPos.buffer;
+		drawInfo.vertexBuffers[1] = bufferTex.buffer;
+		drawInfo.vertexBuffers[2] = bufferNrm.buffer;
+	}
+	// setup draw info (pooled meshes draw from first vertex of their range)
+	drawInfo.vertexBufferOffsets[0] = 0;
+	drawInfo.vertexBufferOffsets[1] = 0;
+	drawInfo.vertexBufferOffsets[2] = 0;
+	drawInfo.vertexBuffersCount = 3;
+	drawInfo.indexBuffer = VK_NULL_HANDLE;
+	drawInfo.indexType = VK_INDEX_TYPE_UINT32;
+	drawInfo.vertexCount = vertexCount;
+	drawInfo.indexCount = 0;
+	drawInfo.firstVertex = vertexRange.first;
+	drawInfo.firstIndex = 0;
+	drawInfo.meshId = meshIdCounter++;
+	vulkanMeshBounds(pos, drawInfo.boundingBoxMin, drawInfo.boundingBoxMax, drawInfo.boundingSphere);
+	// full resolution is only level
+	lods[0] = { drawInfo.firstVertex, drawInfo.vertexCount, 0, 0, 0.0f };
+	lodsCount = 1;
+}
+
+// VulkanMeshMatObj::VulkanMeshMatObj
+VulkanMeshMatObj::VulkanMeshMatObj(
+	VulkanContext& context,
+	uint32_t       vertexCount) :
+	VulkanMeshMaterial(context),
+	vertexCount(vertexCount)
+{
+	// allocate vertices in geometry pool (contents are undefined until written on device)
+	VulkanGeometryPool* geometryPool = context.geometryPool;
+	if (!geometryPool || !vertexCount || !geometryPool->allocateVertices(vertexCount, vertexRange))
+		this->vertexCount = 0;
+	if (geometryPool) {
+		drawInfo.vertexBuffers[0] = geometryPool->bufferPos.buffer;
+		drawInfo.vertexBuffers[1] = geometryPool->bufferTex.buffer;
+		drawInfo.vertexBuffers[2] = geometryPool->bufferNrm.buffer;
+	}
+	// setup draw info (bounds are set by writer of vertices)
+	drawInfo.vertexBufferOffsets[0] = 0;
+	drawInfo.vertexBufferOffsets[1] = 0;
+	drawInfo.vertexBufferOffsets[2] = 0;
+	drawInfo.vertexBuffersCount = 3;
+	drawInfo.indexBuffer = VK_NULL_HANDLE;
+	drawInfo.indexType = VK_INDEX_TYPE_UINT32;
+	drawInfo.vertexCount = this->vertexCount;
+	drawInfo.indexCount = 0;
+	drawInfo.firstVertex = vertexRange.first;
+	drawInfo.firstIndex = 0;
+	drawInfo.meshId = meshIdCounter++;
+	// full resolution is only level
+	lods[0] = { drawInfo.firstVertex, drawInfo.vertexCount, 0, 0, 0.0f };
+	lodsCount = 1;
 }
 
 // VulkanMeshMatObj::~VulkanMeshMatObj
 VulkanMeshMatObj::~VulkanMeshMatObj() {
-	// destroy buffers
-	vulkanBufferDestroy(context.device, bufferNrm);
-	vulkanBufferDestroy(context.device, bufferTex);
-	vulkanBufferDestroy(context.device, bufferPos);
+	// destroy debug lines
+	delete meshDebug;
+	// free vertices or destroy buffers
+	if (vertexRange.count)
+		context.geometryPool->freeVertices(vertexRange);
+	else {
+		vulkanBufferDestroy(context.device, bufferNrm);
+		vulkanBufferDestroy(context.device, bufferTex);
+		vulkanBufferDestroy(context.device, bufferPos);
+	}
 }
 
 // VulkanMeshMatObj::draw
 void VulkanMeshMatObj::draw(VulkanCommandBuffer& commandBuffer) {
 	// bind and draw
-	vkCmdBindVertexBuffers(commandBuffer.commandBuffer, 0, (uint32_t)bufferHandles.size(), bufferHandles.data(), bufferOffsets.data());
-	vkCmdDraw(commandBuffer.commandBuffer, vertexCount, 1, 0, 0);
+	vkCmdBindVertexBuffers(commandBuffer.commandBuffer, 0, drawInfo.vertexBuffersCount, drawInfo.vertexBuffers, drawInfo.vertexBufferOffsets);
+	if (drawInfo.indexBuffer) {
+		vkCmdBindIndexBuffer(commandBuffer.commandBuffer, drawInfo.indexBuffer, 0, drawInfo.indexType);
+		vkCmdDrawIndexed(commandBuffer.commandBuffer, drawInfo.indexCount, 1, drawInfo.firstIndex, drawInfo.firstVertex, 0);
+	}
+	else
+		vkCmdDraw(commandBuffer.commandBuffer, drawInfo.vertexCount, 1, drawInfo.firstVertex, 0);
+}
+
+// VulkanMeshMatObj::setLods
+void VulkanMeshMatObj::setLods(const std::vector<VulkanMeshLod>& meshLods)
+{
+	// offset ranges by first vertex and index of mesh (pooled meshes)
+	assert(meshLods.size() > 0);
+	lodsCount = std::min((uint32_t)meshLods.size(), (uint32_t)VULKAN_MESH_MAX_LODS);
+	for (uint32_t i = 0; i < lodsCount; i++) {
+		lods[i] = meshLods[i];
+		lods[i].firstVertex += vertexRange.first;
+		lods[i].firstIndex += drawInfo.firstIndex;
+	}
+	// draw info draws full resolution
+	drawInfo.vertexCount = lods[0].vertexCount;
+	drawInfo.firstVertex = lods[0].firstVertex;
+	if (drawInfo.indexBuffer) {
+		drawInfo.indexCount = lods[0].indexCount;
+		drawInfo.firstIndex = lods[0].firstIndex;
+	}
+}
+
+// VulkanMeshMatObj::setMeshlets
+void VulkanMeshMatObj::setMeshlets(const std::vector<VulkanMeshlet>& meshMeshlets)
+{
+	// offset ranges by first vertex and index of mesh (pooled meshes)
+	meshlets = meshMeshlets;
+	for (auto& meshlet : meshlets) {
+		meshlet.firstVertex += vertexRange.first;
+		meshlet.firstIndex += drawInfo.firstIndex;
+	}
+}
+
+// VulkanMeshMatObj::selectLod
+uint32_t VulkanMeshMatObj::selectLod(float errorScale, float pixelErrorMax) const
+{
+	// errors grow with level
+	uint32_t lod = 0;
+	while (lod + 1 < lodsCount && lods[lod + 1].error * errorScale <= pixelErrorMax)
+		lod++;
+	return lod;
 }
 
 //////////////////////////////////////////////////////////////////////////
 
 // VulkanMeshMatObjIndexed::VulkanMeshMatObjIndexed
 VulkanMeshMatObjIndexed::VulkanMeshMatObjIndexed(
-	VulkanContext&          context,
-	std::vector<glm::vec4>& pos,
-	std::vector<glm::vec2>& tex,
-	std::vector<glm::vec3>& nrm,
-	std::vector<uint32_t>&  ind) :
+	VulkanContext&               context,
+	VulkanHostVector<glm::vec4>& pos,
+	VulkanHostVector<glm::vec2>& tex,
+	VulkanHostVector<glm::vec3>& nrm,
+	VulkanHostVector<uint32_t>&   ind) :
 	VulkanMeshMatObj(context, pos, tex, nrm)
 {
-	// create index buffer
-	vulkanBufferCreate(context.device, VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VKT_VECTOR_DATA_SIZE(ind), &bufferInd);
-	// write index buffers
-	vulkanBufferWrite(context.device, bufferInd, 0, VKT_VECTOR_DATA_SIZE(ind), ind.data());
 	indexCount = (uint32_t)ind.size();
+	// pack 16-bit indices when vertices count allows (pool elements are 32-bit, two indices each)
+	VulkanHostVector<uint16_t> ind16;
+	VkIndexType indexType = VK_INDEX_TYPE_UINT32;
+	const void* indexData = ind.data();
+	VkDeviceSize indexDataSize = VKT_VECTOR_DATA_SIZE(ind);
+	uint32_t indexElements = indexCount;
+	if (pos.size() <= VULKAN_MESH_INDEX16_MAX_VERTICES) {
+		ind16.assign(ind.begin(), ind.end());
+		indexType = VK_INDEX_TYPE_UINT16;
+		indexData = ind16.data();
+		indexDataSize = VKT_VECTOR_DATA_SIZE(ind16);
+		indexElements = (indexCount + 1) / 2;
+	}
+	// allocate indices in geometry pool (only with pooled vertices, indices are relative to first vertex)
+	VulkanGeometryPool* geometryPool = context.geometryPool;
+	if (vertexRange.count && indexCount && geometryPool->allocateIndices(indexElements, indexRange)) {
+		// write pool index buffer
+		context.writeBuffer(geometryPool->bufferInd, indexRange.first * sizeof(uint32_t), indexDataSize, indexData);
+		drawInfo.indexBuffer = geometryPool->bufferInd.buffer;
+	}
+	else {
+		// create index buffer
+		vulkanBufferCreate(context.device, VK_BUFFER_USAGE_INDEX_BUFFER_BIT, indexDataSize, &bufferInd);
+		// write index buffers
+		context.writeBuffer(bufferInd, 0, indexDataSize, indexData);
+		drawInfo.indexBuffer = bufferInd.buffer;
+	}
+	// setup draw info (first index counts indices of index type)
+	drawInfo.indexType = indexType;
+	drawInfo.indexCount = indexCount;
+	drawInfo.firstIndex = indexType == VK_INDEX_TYPE_UINT16 ? indexRange.first * 2 : indexRange.first;
+	lods[0].firstIndex = drawInfo.firstIndex;
+	lods[0].indexCount = drawInfo.indexCount;
 }
 
 // VulkanMeshMatObjIndexed::~VulkanMeshMatObjIndexed
 VulkanMeshMatObjIndexed::~VulkanMeshMatObjIndexed()
 {
-	// destroy buffers
-	vulkanBufferDestroy(context.device, bufferInd);
-}
-
-// draw
-void VulkanMeshMatObjIndexed::draw(VulkanCommandBuffer& commandBuffer) {
-	// bind and draw
-	vkCmdBindVertexBuffers(commandBuffer.commandBuffer, 0, (uint32_t)bufferHandles.size(), bufferHandles.data(), bufferOffsets.data());
-	vkCmdBindIndexBuffer(commandBuffer.commandBuffer, bufferInd.buffer, 0, VK_INDEX_TYPE_UINT32);
-	vkCmdDrawIndexed(commandBuffer.commandBuffer, indexCount, 1, 0, 0, 0);
+	// free indices or destroy buffers
+	if (indexRange.count)
+		context.geometryPool->freeIndices(indexRange);
+	else
+		vulkanBufferDestroy(context.device, bufferInd);
 }
 
 //////////////////////////////////////////////////////////////////////////
 
 // VulkanMeshMatObjTBN::VulkanMeshMatObjTBN
 VulkanMeshMatObjTBN::VulkanMeshMatObjTBN(
-	VulkanContext&          context,
-	std::vector<glm::vec4>& pos,
-	std::vector<glm::vec2>& tex,
-	std::vector<glm::vec3>& nrm,
-	std::vector<glm::vec3>& tng,
-	std::vector<glm::vec3>& bnm) : 
-	VulkanMeshMatObj(context, pos, tex, nrm)
+	VulkanContext&               context,
+	VulkanHostVector<glm::vec4>& pos,
+	VulkanHostVector<glm::vec2>& tex,
+	VulkanHostVector<glm::vec3>& nrm,
+	VulkanHostVector<glm::vec3>& tng,
+	VulkanHostVector<glm::vec3>& bnm) : 
+	VulkanMeshMatObj(context, pos, tex, nrm, VK_FALSE)
 {
 	// create buffers
 	vulkanBufferCreate(context.device, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VKT_VECTOR_DATA_SIZE(tng), &bufferTng);
 	vulkanBufferCreate(context.device, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VKT_VECTOR_DATA_SIZE(bnm), &bufferBnm);
 	// write buffers
-	vulkanBufferWrite(context.device, bufferTng, 0, VKT_VECTOR_DATA_SIZE(tng), tng.data());
-	vulkanBufferWrite(context.device, bufferBnm, 0, VKT_VECTOR_DATA_SIZE(bnm), bnm.data());
-	// setup buffer handles and offsets
-	bufferHandlesTB = { bufferTng.buffer, bufferBnm.buffer };
-	bufferOffsetsTB = { 0, 0 };
+	context.writeBuffer(bufferTng, 0, VKT_VECTOR_DATA_SIZE(tng), tng.data());
+	context.writeBuffer(bufferBnm, 0, VKT_VECTOR_DATA_SIZE(bnm), bnm.data());
+	// setup draw info (tangents and binormals follow base buffers at binding 3)
+	drawInfo.vertexBuffers[3] = bufferTng.buffer;
+	drawInfo.vertexBuffers[4] = bufferBnm.buffer;
+	drawInfo.vertexBufferOffsets[3] = 0;
+	drawInfo.vertexBufferOffsets[4] = 0;
+	drawInfo.vertexBuffersCount = 5;
 }
 
 // VulkanMeshMatObjTBN::~VulkanMeshMatObjTBN
@@ -101,32 +278,28 @@ VulkanMeshMatObjTBN::~VulkanMeshMatObjTBN() {
 	vulkanBufferDestroy(context.device, bufferTng);
 }
 
-// VulkanMeshMatObjTBN::draw
-void VulkanMeshMatObjTBN::draw(VulkanCommandBuffer& commandBuffer) {
-	// bind and draw
-	vkCmdBindVertexBuffers(commandBuffer.commandBuffer, 0, (uint32_t)bufferHandles.size(), bufferHandles.data(), bufferOffsets.data());
-	vkCmdBindVertexBuffers(commandBuffer.commandBuffer, 3, (uint32_t)bufferHandlesTB.size(), bufferHandlesTB.data(), bufferOffsetsTB.data());
-	vkCmdDraw(commandBuffer.commandBuffer, vertexCount, 1, 0, 0);
-}
-
 //////////////////////////////////////////////////////////////////////////
 
 // VulkanMeshMatObjTBNIndexed::VulkanMeshMatObjTBNIndexed
 VulkanMeshMatObjTBNIndexed::VulkanMeshMatObjTBNIndexed(
-	VulkanContext&          context,
-	std::vector<glm::vec4>& pos,
-	std::vector<glm::vec2>& tex,
-	std::vector<glm::vec3>& nrm,
-	std::vector<glm::vec3>& tng,
-	std::vector<glm::vec3>& bnm,
-	std::vector<uint32_t>&  ind) : 
+	VulkanContext&               context,
+	VulkanHostVector<glm::vec4>& pos,
+	VulkanHostVector<glm::vec2>& tex,
+	VulkanHostVector<glm::vec3>& nrm,
+	VulkanHostVector<glm::vec3>& tng,
+	VulkanHostVector<glm::vec3>& bnm,
+	VulkanHostVector<uint32_t>&   ind) : 
 	VulkanMeshMatObjTBN(context, pos, tex, nrm, tng, bnm)
 {
 	// create index buffer
 	vulkanBufferCreate(context.device, VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VKT_VECTOR_DATA_SIZE(ind), &bufferInd);
 	// write index buffers
-	vulkanBufferWrite(context.device, bufferInd, 0, VKT_VECTOR_DATA_SIZE(ind), ind.data());
+	context.writeBuffer(bufferInd, 0, VKT_VECTOR_DATA_SIZE(ind), ind.data());
 	indexCount = (uint32_t)ind.size();
+	// setup draw info
+	drawInfo.indexBuffer = bufferInd.buffer;
+	drawInfo.indexCount = indexCount;
+	lods[0].indexCount = drawInfo.indexCount;
 }
 
 // VulkanMeshMatObjTBNIndexed::~VulkanMeshMatObjTBNIndexed
@@ -135,11 +308,47 @@ VulkanMeshMatObjTBNIndexed::~VulkanMeshMatObjTBNIndexed() {
 	vulkanBufferDestroy(context.device, bufferInd);
 }
 
-// VulkanMeshMatObjTBNIndexed::draw
-void VulkanMeshMatObjTBNIndexed::draw(VulkanCommandBuffer& commandBuffer) {
-	// bind and draw
-	vkCmdBindVertexBuffers(commandBuffer.commandBuffer, 0, (uint32_t)bufferHandles.size(), bufferHandles.data(), bufferOffsets.data());
-	vkCmdBindVertexBuffers(commandBuffer.commandBuffer, 3, (uint32_t)bufferHandlesTB.size(), bufferHandlesTB.data(), bufferOffsetsTB.data());
-	vkCmdBindIndexBuffer(commandBuffer.commandBuffer, bufferInd.buffer, 0, VK_INDEX_TYPE_UINT32);
-	vkCmdDrawIndexed(commandBuffer.commandBuffer, indexCount, 1, 0, 0, 0);
-}
\ No newline at end of file
+// VulkanMeshMatObjSkinned::VulkanMeshMatObjSkinned
+VulkanMeshMatObjSkinned::VulkanMeshMatObjSkinned(
+	VulkanContext&                context,
+	VulkanHostVector<glm::vec4>&  pos,
+	VulkanHostVector<glm::vec2>&  tex,
+	VulkanHostVector<glm::vec3>&  nrm,
+	VulkanHostVector<glm::vec4>&  weights,
+	VulkanHostVector<glm::uvec4>& joints,
+	uint32_t                      jointsCount) :
+	VulkanMeshMatObj(context, (uint32_t)pos.size()),
+	palette(jointsCount, glm::mat4(1.0f))
+{
+	assert(pos.size() == weights.size() && pos.size() == joints.size());
+	// bounds of bind pose (scaled for animated vertices)
+	vulkanMeshBounds(pos, drawInfo.boundingBoxMin, drawInfo.boundingBoxMax, drawInfo.boundingSphere);
+	glm::vec3 center = glm::vec3(drawInfo.boundingSphere);
+	drawInfo.boundingBoxMin = center + (drawInfo.boundingBoxMin - center) * VULKAN_MESH_SKINNED_BOUNDS_SCALE;
+	drawInfo.boundingBoxMax = center + (drawInfo.boundingBoxMax - center) * VULKAN_MESH_SKINNED_BOUNDS_SCALE;
+	drawInfo.boundingSphere.w *= VULKAN_MESH_SKINNED_BOUNDS_SCALE;
+	if (!drawInfo.vertexCount) return;
+
+	// texture coordinates are not skinned (written once)
+	VulkanGeometryPool* geometryPool = context.geometryPool;
+	context.writeBuffer(geometryPool->bufferTex, drawInfo.firstVertex * sizeof(glm::vec2), VKT_VECTOR_DATA_SIZE(tex), tex.data());
+
+	// bind pose of pool vertices (drawn when skin buffer is full or renderer has no skinning)
+	context.writeBuffer(geometryPool->bufferPos, drawInfo.firstVertex * sizeof(glm::vec4), VKT_VECTOR_DATA_SIZE(pos), pos.data());
+	context.writeBuffer(geometryPool->bufferNrm, drawInfo.firstVertex * sizeof(glm::vec3), VKT_VECTOR_DATA_SIZE(nrm), nrm.data());
+
+	// skin vertices (source of skinning, skinned into pool vertices every frame)
+	if (geometryPool->allocateSkinVertices(drawInfo.vertexCount, skinVertexRange)) {
+		VulkanHostVector<VulkanSkinVertex> skinVertices(pos.size());
+		for (size_t i = 0; i < pos.size(); i++)
+			skinVertices[i] = { pos[i], glm::vec4(nrm[i], 0.0f), weights[i], joints[i] };
+		context.writeBuffer(geometryPool->bufferSkin, skinVertexRange.first * sizeof(VulkanSkinVertex), VKT_VECTOR_DATA_SIZE(skinVertices), skinVertices.data());
+	}
+}
+
+// VulkanMeshMatObjSkinned::~VulkanMeshMatObjSkinned
+VulkanMeshMatObjSkinned::~VulkanMeshMatObjSkinned() {
+	// free skin vertices
+	if (skinVertexRange.count)
+		context.geometryPool->freeSkinVertices(skinVertexRange);
+}
@@ -1,9 +1,13 @@
 #pragma once
 #include "vulkan_material.hpp"
+#include "vulkan_geometry_pool.hpp"
+#include "vulkan_geometry.hpp"
 #include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
 #include <glm/vec4.hpp>
+#include <glm/mat4x4.hpp>
 #include <array>
+#include <vector>
 
 //	VulkanMesh
 //		VulkanMeshMaterial
@@ -11,10 +15,37 @@
 //				VulkanMeshMatObjIndexed
 //				VulkanMeshMatObjTBN
 //					VulkanMeshMatObjTBNIndexed
-//			VulkanMeshMatObjSkinned
-//				VulkanMeshMatObjSkinnedIndexed
-//				VulkanMeshMatObjSkinnedTBN
-//					VulkanMeshMatObjSkinnedTBNIndexed
+//				VulkanMeshMatObjSkinned
+
+// animation state of skinned meshes
+class VulkanAnimator;
+
+// max vertex buffers bound by mesh (pos, tex, nrm, tng, bnm)
+#define VULKAN_MESH_MAX_VERTEX_BUFFERS 5
+
+// meshes with at most this vertices count use 16-bit indices
+#define VULKAN_MESH_INDEX16_MAX_VERTICES 0xFFFF
+
+// bounds of skinned meshes (bind pose bounds scaled about center, animated vertices are not bounded on host)
+#define VULKAN_MESH_SKINNED_BOUNDS_SCALE 1.5f
+
+// VulkanMeshDrawInfo (plain draw parameters of mesh, copied into render queue packets)
+struct VulkanMeshDrawInfo {
+	VkBuffer     vertexBuffers[VULKAN_MESH_MAX_VERTEX_BUFFERS];
+	VkDeviceSize vertexBufferOffsets[VULKAN_MESH_MAX_VERTEX_BUFFERS];
+	uint32_t     vertexBuffersCount;
+	VkBuffer     indexBuffer;
+	VkIndexType  indexType;
+	uint32_t     vertexCount;
+	uint32_t     indexCount;
+	uint32_t     firstVertex;
+	uint32_t     firstIndex;
+	uint32_t     meshId;
+	glm::vec4    boundingSphere; // model space center and radius
+	glm::vec3    boundingBoxMin; // model space bounding box (centered at bounding sphere)
+	glm::vec3    boundingBoxMax;
+	glm::vec4    cone;           // model space backface cone axis and cutoff of meshlet (zero axis is never culled)
+};
 
 // VulkanMesh
 class VulkanMesh : public VulkanContextDrawableObject {
@@ -44,71 +75,85 @@ public:
 // VulkanMeshMatObj
 class VulkanMeshMatObj : public VulkanMeshMaterial {
 protected:
-	// buffer handles
-	std::array<VkBuffer, 3>     bufferHandles;
-	std::array<VkDeviceSize, 3> bufferOffsets;
-protected:
-	// buffers
+	// own buffers (used when mesh is not pooled or geometry pool is full)
 	VulkanBuffer bufferPos{};
 	VulkanBuffer bufferTex{};
 	VulkanBuffer bufferNrm{};
 	uint32_t     vertexCount;
+	// vertices in geometry pool (empty when own buffers are used)
+	VulkanGeometryRange vertexRange{};
+public:
+	// draw parameters (filled by constructors, full resolution level)
+	VulkanMeshDrawInfo drawInfo{};
+	// levels of detail (ranges in mesh buffers like draw info, full resolution first)
+	VulkanMeshLod lods[VULKAN_MESH_MAX_LODS]{};
+	uint32_t      lodsCount{};
+	// meshlets of full resolution level (ranges in mesh buffers like draw info, culled on device instead of whole mesh)
+	std::vector<VulkanMeshlet> meshlets{};
+	// debug lines of vertices (normal, tangent and bi-normal, written on device when first shown)
+	VulkanMeshMatObj* meshDebug{};
 public:
 	// constructor and destructor
 	VulkanMeshMatObj(
-		VulkanContext&          context,
-		std::vector<glm::vec4>& pos,
-		std::vector<glm::vec2>& tex,
-		std::vector<glm::vec3>& nrm);
+		VulkanContext&               context,
+		VulkanHostVector<glm::vec4>& pos,
+		VulkanHostVector<glm::vec2>& tex,
+		VulkanHostVector<glm::vec3>& nrm,
+		VkBool32                     pooled = VK_TRUE);
+	// vertices in geometry pool written on device (no vertices when pool is full)
+	VulkanMeshMatObj(
+		VulkanContext& context,
+		uint32_t       vertexCount);
 	~VulkanMeshMatObj();
 
-	// draw
+	// draw (all mesh object variants, from draw info)
 	void draw(VulkanCommandBuffer& commandBuffer) override;
+
+	// set levels of detail stored after full resolution vertices (ranges relative to mesh vertices)
+	void setLods(const std::vector<VulkanMeshLod>& meshLods);
+
+	// set meshlets of full resolution level (ranges relative to mesh vertices)
+	void setMeshlets(const std::vector<VulkanMeshlet>& meshMeshlets);
+
+	// coarsest level with projected error within max pixel error (error scale in pixels per model space unit)
+	uint32_t selectLod(float errorScale, float pixelErrorMax) const;
 };
 
 // VulkanMeshMatObjIndexed
 class VulkanMeshMatObjIndexed : public VulkanMeshMatObj {
 protected:
-	// index buffer
+	// index buffer (16-bit indices when vertices count allows)
 	VulkanBuffer bufferInd{};
 	uint32_t     indexCount;
+	// indices in geometry pool (32-bit elements, empty when own buffer is used)
+	VulkanGeometryRange indexRange{};
 public:
 	// constructor and destructor
 	VulkanMeshMatObjIndexed(
-		VulkanContext&          context,
-		std::vector<glm::vec4>& pos,
-		std::vector<glm::vec2>& tex,
-		std::vector<glm::vec3>& nrm,
-		std::vector<uint32_t>&  ind);
+		VulkanContext&               context,
+		VulkanHostVector<glm::vec4>& pos,
+		VulkanHostVector<glm::vec2>& tex,
+		VulkanHostVector<glm::vec3>& nrm,
+		VulkanHostVector<uint32_t>&   ind);
 	~VulkanMeshMatObjIndexed();
-
-	// draw
-	void draw(VulkanCommandBuffer& commandBuffer) override;
 };
 
 // VulkanMeshMatObjTBN
 class VulkanMeshMatObjTBN : public VulkanMeshMatObj {
 protected:
-	// BPR buffer handles handles
-	std::array<VkBuffer, 2>     bufferHandlesTB;
-	std::array<VkDeviceSize, 2> bufferOffsetsTB;
-protected:
-	// buffers
+	// buffers (geometry pool has no tangent space buffers)
 	VulkanBuffer bufferTng{};
 	VulkanBuffer bufferBnm{};
 public:
 	// constructor and destructor
 	VulkanMeshMatObjTBN(
-		VulkanContext&          context,
-		std::vector<glm::vec4>& pos,
-		std::vector<glm::vec2>& tex,
-		std::vector<glm::vec3>& nrm,
-		std::vector<glm::vec3>& tng,
-		std::vector<glm::vec3>& bnm);
+		VulkanContext&               context,
+		VulkanHostVector<glm::vec4>& pos,
+		VulkanHostVector<glm::vec2>& tex,
+		VulkanHostVector<glm::vec3>& nrm,
+		VulkanHostVector<glm::vec3>& tng,
+		VulkanHostVector<glm::vec3>& bnm);
 	~VulkanMeshMatObjTBN();
-
-	// draw
-	void draw(VulkanCommandBuffer& commandBuffer) override;
 };
 
 // VulkanMeshMatObjTBNIndexed
@@ -120,18 +165,38 @@ protected:
 public:
 	// constructor and destructor
 	VulkanMeshMatObjTBNIndexed(
-		VulkanContext&          context,
-		std::vector<glm::vec4>& pos,
-		std::vector<glm::vec2>& tex,
-		std::vector<glm::vec3>& nrm,
-		std::vector<glm::vec3>& tng,
-		std::vector<glm::vec3>& bnm,
-		std::vector<uint32_t>&  ind);
+		VulkanContext&               context,
+		VulkanHostVector<glm::vec4>& pos,
+		VulkanHostVector<glm::vec2>& tex,
+		VulkanHostVector<glm::vec3>& nrm,
+		VulkanHostVector<glm::vec3>& tng,
+		VulkanHostVector<glm::vec3>& bnm,
+		VulkanHostVector<uint32_t>&   ind);
 	~VulkanMeshMatObjTBNIndexed();
-
-	// draw
-	void draw(VulkanCommandBuffer& commandBuffer) override;
 };
 
-// VulkanMeshMatObjSkinned
-class VulkanMeshMatObjSkinned : public VulkanMeshMaterial {};
+// VulkanMeshMatObjSkinned (vertices in geometry pool skinned by compute every frame, drawn by all passes like mesh object)
+class VulkanMeshMatObjSkinned : public VulkanMeshMatObj {
+protected:
+	// skin vertices in geometry pool (empty when skin buffer is full, bind pose is drawn instead)
+	VulkanGeometryRange skinVertexRange{};
+public:
+	// joint matrices (joint transform times inverse bind matrix, set before frame)
+	std::vector<glm::mat4> palette{};
+	// animation evaluated into palette of frame by renderer (palette is used when null)
+	VulkanAnimator* animator{};
+public:
+	// constructor and destructor
+	VulkanMeshMatObjSkinned(
+		VulkanContext&                context,
+		VulkanHostVector<glm::vec4>&  pos,
+		VulkanHostVector<glm::vec2>&  tex,
+		VulkanHostVector<glm::vec3>&  nrm,
+		VulkanHostVector<glm::vec4>&  weights,
+		VulkanHostVector<glm::uvec4>& joints,
+		uint32_t                      jointsCount);
+	~VulkanMeshMatObjSkinned();
+
+	// getters
+	const VulkanGeometryRange& getSkinVertexRange() const { return skinVertexRange; }
+};
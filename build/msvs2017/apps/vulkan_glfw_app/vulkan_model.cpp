@@ -46,4 +46,18 @@ void VulkanModel::bind(VulkanCommandBuffer& commandBuffer)
 {
 	// bind descriptor set
 	vkCmdBindDescriptorSets(commandBuffer.commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, context.pipelineLayout.pipelineLayout, 1, 1, &descriptorSet.descriptorSet, 0, VK_NULL_HANDLE);
-}
\ No newline at end of file
+}
+
+// VulkanModel::addMeshSkinned
+void VulkanModel::addMeshSkinned(VulkanMeshMatObjSkinned* mesh)
+{
+	// drawn from skinned vertices like other meshes
+	meshes.push_back(mesh);
+	meshes_skinned.push_back(mesh);
+}
+
+// VulkanModel::getDescriptorSet
+VkDescriptorSet VulkanModel::getDescriptorSet() const
+{
+	return descriptorSet.descriptorSet;
+}
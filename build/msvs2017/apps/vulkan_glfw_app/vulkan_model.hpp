@@ -16,13 +16,16 @@ public:
 	// model matrix
 	glm::mat4 matrixModel = glm::mat4(1.0f);
 public:
-	// meshes
+	// meshes (debug meshes are debug lines of meshes, filled by renderer while debug is visible)
 	std::vector<VulkanMeshMatObj*> meshes{};
 	std::vector<VulkanMeshMatObj*> meshes_debug{};
+	// skinned meshes (skinned by renderer before passes, drawn as meshes)
 	std::vector<VulkanMeshMatObjSkinned*> meshes_skinned{};
 public:
 	VkBool32 visible{};
 	VkBool32 visibleDebug{};
+	// moved every frame (shadow casters of dynamic models are not cached)
+	VkBool32 dynamic{};
 public:
 	// constructor and destructor
 	VulkanModel(VulkanContext& context);
@@ -33,4 +36,10 @@ public:
 
 	// bind
 	virtual void bind(VulkanCommandBuffer& commandBuffer);
+
+	// add skinned mesh to meshes and skinned meshes
+	void addMeshSkinned(VulkanMeshMatObjSkinned* mesh);
+
+	// getters
+	VkDescriptorSet getDescriptorSet() const;
 };
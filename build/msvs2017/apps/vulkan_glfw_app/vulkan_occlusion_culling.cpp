@@ -0,0 +1,56 @@
+#include "vulkan_occlusion_culling.hpp"
+
+// VulkanOcclusionCulling::VulkanOcclusionCulling
+VulkanOcclusionCulling::VulkanOcclusionCulling(VulkanContext& context) :
+	context(context)
+{
+}
+
+// VulkanOcclusionCulling::~VulkanOcclusionCulling
+VulkanOcclusionCulling::~VulkanOcclusionCulling()
+{
+	// destroy depth pyramid
+	destroyDepthPyramid();
+}
+
+// VulkanOcclusionCulling::createDepthPyramid
+void VulkanOcclusionCulling::createDepthPyramid(uint32_t depthWidth, uint32_t depthHeight)
+{
+	// create depth pyramid (recreated with depth attachments)
+	destroyDepthPyramid();
+	depthPyramid = new VulkanDepthPyramid(context, depthWidth, depthHeight);
+}
+
+// VulkanOcclusionCulling::destroyDepthPyramid
+void VulkanOcclusionCulling::destroyDepthPyramid()
+{
+	// destroy depth pyramid (frames are complete on device)
+	delete depthPyramid;
+	depthPyramid = nullptr;
+}
+
+// VulkanOcclusionCulling::begin
+VkBool32 VulkanOcclusionCulling::begin(VulkanScene* scene, VkBool32 enabled)
+{
+	// pyramid is built from depth of first view only
+	used = enabled && depthPyramid && scene->viewsCount == 1;
+	return used;
+}
+
+// VulkanOcclusionCulling::setDrawBuffers
+void VulkanOcclusionCulling::setDrawBuffers(VulkanDrawCulling& drawCulling, uint32_t frameIndex, const VulkanDrawIndirectInfo& drawIndirectInfo)
+{
+	// newly visible commands and instances of occlusion phase (draw counts when first phase uses them)
+	indirectInfo = drawIndirectInfo;
+	indirectInfo.indirectBuffer = drawCulling.getOcclusionIndirectBuffer(frameIndex);
+	indirectInfo.countBuffer = context.device.drawIndirectCountEnabled ? drawCulling.getOcclusionCountBuffer(frameIndex) : VK_NULL_HANDLE;
+	drawDescriptorSet = drawCulling.getOcclusionDrawDescriptorSet(frameIndex);
+}
+
+// VulkanOcclusionCulling::record
+void VulkanOcclusionCulling::record(VulkanCommandBuffer& commandBuffer, VulkanDrawCulling& drawCulling, uint32_t frameIndex, VulkanScene* scene, VkImageView depthImageView)
+{
+	// reduce depth of first phase and cull draws which were not drawn against it
+	depthPyramid->build(commandBuffer, depthImageView);
+	drawCulling.recordOcclusion(commandBuffer, frameIndex, scene, *depthPyramid);
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "vulkan_draw_culling.hpp"
+#include "vulkan_depth_pyramid.hpp"
+
+// VulkanOcclusionCulling (depth of first phase draws is reduced into depth pyramid, second phase draws instances newly visible against it)
+class VulkanOcclusionCulling {
+protected:
+	// base handles
+	VulkanContext& context;
+protected:
+	// depth pyramid of depth attachments (one pyramid is shared, overlapped frames are ordered by compute barriers of graphics queue)
+	VulkanDepthPyramid* depthPyramid{};
+	// occlusion culling of recorded frame and its second phase commands and instances
+	VkBool32               used{};
+	VulkanDrawIndirectInfo indirectInfo{};
+	VkDescriptorSet        drawDescriptorSet{};
+public:
+	// constructor and destructor
+	VulkanOcclusionCulling(VulkanContext& context);
+	~VulkanOcclusionCulling();
+
+	// create and destroy depth pyramid (size of depth attachments)
+	void createDepthPyramid(uint32_t depthWidth, uint32_t depthHeight);
+	void destroyDepthPyramid();
+
+	// occlusion culling of frame is used when enabled by renderer for scenes of single view (depth pyramid of first view)
+	VkBool32 begin(VulkanScene* scene, VkBool32 enabled);
+
+	// second phase commands and instances of culled frame (same batches as first phase draws)
+	void setDrawBuffers(VulkanDrawCulling& drawCulling, uint32_t frameIndex, const VulkanDrawIndirectInfo& drawIndirectInfo);
+
+	// record second phase culling into graphics command buffer (depth attachment view in depth-stencil read only layout)
+	void record(VulkanCommandBuffer& commandBuffer, VulkanDrawCulling& drawCulling, uint32_t frameIndex, VulkanScene* scene, VkImageView depthImageView);
+
+	// getters
+	VkBool32 isUsed() const { return used; }
+	const VulkanDrawIndirectInfo& getIndirectInfo() const { return indirectInfo; }
+	VkDescriptorSet getDrawDescriptorSet() const { return drawDescriptorSet; }
+};
@@ -0,0 +1,253 @@
+#include "vulkan_particles.hpp"
+#include "vulkan_descriptors.hpp"
+#include <algorithm>
+#include <cassert>
+
+// VulkanParticles::VulkanParticles
+VulkanParticles::VulkanParticles(VulkanContext& context) :
+	context(context)
+{
+	// create compute pipelines
+	vulkanPipelineCreateCompute(context.device, shader_particles_init_file_comp, context.pipelineLayout_particles, &pipeline_particles_init);
+	vulkanPipelineCreateCompute(context.device, shader_particles_simulate_file_comp, context.pipelineLayout_particles, &pipeline_particles_simulate);
+	vulkanPipelineCreateCompute(context.device, shader_particles_emit_file_comp, context.pipelineLayout_particles, &pipeline_particles_emit);
+	vulkanPipelineCreateCompute(context.device, shader_particles_finish_file_comp, context.pipelineLayout_particles, &pipeline_particles_finish);
+	// create draw shader (draw pipeline is created with render pass of renderer)
+	vulkanShaderCreate(context.device, shader_particles_file_vert, shader_particles_file_frag, &shader_particles);
+
+	// create particle buffers (position and age, velocity and emitter per particle, two alive lists)
+	vulkanBufferCreate(context.device, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, (VkDeviceSize)VULKAN_PARTICLES_CAPACITY * sizeof(glm::vec4) * 2, &bufferParticles);
+	vulkanBufferCreate(context.device, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, (VkDeviceSize)VULKAN_PARTICLES_CAPACITY * sizeof(uint32_t), &bufferDead);
+	vulkanBufferCreate(context.device, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, (VkDeviceSize)VULKAN_PARTICLES_CAPACITY * sizeof(uint32_t) * 2, &bufferAlive);
+	vulkanBufferCreate(context.device, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, sizeof(VulkanParticlesCounters), &bufferCounters);
+
+	// VkCommandPoolCreateInfo - compute queue family
+	VkCommandPoolCreateInfo commandPoolCreateInfo{};
+	commandPoolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+	commandPoolCreateInfo.pNext = VK_NULL_HANDLE;
+	commandPoolCreateInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+	commandPoolCreateInfo.queueFamilyIndex = context.device.queueFamilyIndexCompute;
+	VKT_CHECK(vkCreateCommandPool(context.device.device, &commandPoolCreateInfo, VK_NULL_HANDLE, &commandPool));
+	assert(commandPool);
+}
+
+// VulkanParticles::~VulkanParticles
+VulkanParticles::~VulkanParticles()
+{
+	// destroy frames
+	for (auto& frame : frames)
+		destroyFrame(frame);
+	frames.clear();
+	// destroy command pool (frees command buffers)
+	vkDestroyCommandPool(context.device.device, commandPool, VK_NULL_HANDLE);
+	commandPool = VK_NULL_HANDLE;
+	// destroy particle buffers
+	vulkanBufferDestroy(context.device, bufferCounters);
+	vulkanBufferDestroy(context.device, bufferAlive);
+	vulkanBufferDestroy(context.device, bufferDead);
+	vulkanBufferDestroy(context.device, bufferParticles);
+	// destroy draw pipeline and shader
+	destroyDrawPipeline();
+	vulkanShaderDestroy(context.device, shader_particles);
+	// destroy compute pipelines
+	vulkanPipelineDestroy(context.device, pipeline_particles_finish);
+	vulkanPipelineDestroy(context.device, pipeline_particles_emit);
+	vulkanPipelineDestroy(context.device, pipeline_particles_simulate);
+	vulkanPipelineDestroy(context.device, pipeline_particles_init);
+}
+
+// VulkanParticles::createDrawPipeline
+void VulkanParticles::createDrawPipeline(VkRenderPass renderPass)
+{
+	// VulkanPipelineDepthState - particles are hidden by geometry and do not hide each other
+	VulkanPipelineDepthState pipelineDepthState{};
+	pipelineDepthState.depthTestEnable = VK_TRUE;
+	pipelineDepthState.depthWriteEnable = VK_FALSE;
+	pipelineDepthState.depthCompareOp = VK_COMPARE_OP_LESS;
+
+	// create particles pipeline (quads without vertex input, additive blending does not need sorting)
+	vulkanPipelineCreate(context.device, shader_particles, context.pipelineLayout_particlesDraw, renderPass, 0,
+		VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, VK_POLYGON_MODE_FILL,
+		0, nullptr,
+		0, nullptr,
+		VKT_ARRAY_ELEMENTS_COUNT(pipelineColorBlendAttachmentStates_additive), pipelineColorBlendAttachmentStates_additive,
+		&pipelineDepthState, &pipeline_particles);
+}
+
+// VulkanParticles::destroyDrawPipeline
+void VulkanParticles::destroyDrawPipeline()
+{
+	// destroy particles pipeline
+	vulkanPipelineDestroy(context.device, pipeline_particles);
+}
+
+// VulkanParticles::createFrame
+void VulkanParticles::createFrame(VulkanParticlesFrame& frame)
+{
+	// VkCommandBufferAllocateInfo
+	VkCommandBufferAllocateInfo commandBufferAllocateInfo{};
+	commandBufferAllocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+	commandBufferAllocateInfo.pNext = VK_NULL_HANDLE;
+	commandBufferAllocateInfo.commandPool = commandPool;
+	commandBufferAllocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+	commandBufferAllocateInfo.commandBufferCount = 1;
+	VKT_CHECK(vkAllocateCommandBuffers(context.device.device, &commandBufferAllocateInfo, &frame.commandBuffer.commandBuffer));
+	assert(frame.commandBuffer.commandBuffer);
+	vulkanSemaphoreCreate(context.device, &frame.semaphore);
+
+	// uniforms are written by host, drawn instances and indirect draw are written by compute queue and read by graphics queue
+	vulkanBufferCreateMapped(context.device, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, sizeof(VulkanParticlesData), &frame.bufferData);
+	vulkanBufferCreateShared(context.device, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, (VkDeviceSize)VULKAN_PARTICLES_CAPACITY * sizeof(glm::vec4), &frame.bufferInstances);
+	vulkanBufferCreateShared(context.device, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, (VkDeviceSize)VULKAN_PARTICLES_CAPACITY * sizeof(uint32_t), &frame.bufferColors);
+	vulkanBufferCreateShared(context.device, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, sizeof(VkDrawIndirectCommand), &frame.bufferDraw);
+
+	// simulation descriptor set
+	vulkanDescriptorSetCreate(context.device, context.descriptorSetLayout_particles, &frame.descriptorSet);
+	vulkanDescriptorSetUpdateBufferUniform(context.device, frame.descriptorSet, frame.bufferData, 0);
+	vulkanDescriptorSetUpdateBufferStorage(context.device, frame.descriptorSet, bufferParticles, 1);
+	vulkanDescriptorSetUpdateBufferStorage(context.device, frame.descriptorSet, bufferDead, 2);
+	vulkanDescriptorSetUpdateBufferStorage(context.device, frame.descriptorSet, bufferAlive, 3);
+	vulkanDescriptorSetUpdateBufferStorage(context.device, frame.descriptorSet, bufferCounters, 4);
+	vulkanDescriptorSetUpdateBufferStorage(context.device, frame.descriptorSet, frame.bufferInstances, 5);
+	vulkanDescriptorSetUpdateBufferStorage(context.device, frame.descriptorSet, frame.bufferColors, 6);
+	vulkanDescriptorSetUpdateBufferStorage(context.device, frame.descriptorSet, frame.bufferDraw, 7);
+
+	// draw descriptor set
+	vulkanDescriptorSetCreate(context.device, context.descriptorSetLayout_particlesDraw, &frame.drawDescriptorSet);
+	vulkanDescriptorSetUpdateBufferStorage(context.device, frame.drawDescriptorSet, frame.bufferInstances, 0);
+	vulkanDescriptorSetUpdateBufferStorage(context.device, frame.drawDescriptorSet, frame.bufferColors, 1);
+}
+
+// VulkanParticles::destroyFrame
+void VulkanParticles::destroyFrame(VulkanParticlesFrame& frame)
+{
+	vulkanDescriptorSetDestroy(context.device, frame.drawDescriptorSet);
+	vulkanDescriptorSetDestroy(context.device, frame.descriptorSet);
+	vulkanBufferDestroy(context.device, frame.bufferDraw);
+	vulkanBufferDestroy(context.device, frame.bufferColors);
+	vulkanBufferDestroy(context.device, frame.bufferInstances);
+	vulkanBufferDestroy(context.device, frame.bufferData);
+	vulkanSemaphoreDestroy(context.device, frame.semaphore);
+}
+
+// VulkanParticles::update
+void VulkanParticles::update(std::vector<VulkanParticleEmitter>& emitters, const glm::vec3& gravity, float timeStep, uint32_t frameIndex)
+{
+	// create frame handles
+	if (frames.size() <= frameIndex)
+		frames.resize(frameIndex + 1);
+	VulkanParticlesFrame& frame = frames[frameIndex];
+	if (!frame.commandBuffer.commandBuffer)
+		createFrame(frame);
+
+	// emitted particles of time step (fractions are carried by emitters, emission beyond free particles is dropped on device)
+	VulkanParticlesData* data = (VulkanParticlesData*)frame.bufferData.allocationInfo.pMappedData;
+	data->gravityTimeStep = glm::vec4(gravity, timeStep);
+	data->emittersCount = (uint32_t)std::min(emitters.size(), (size_t)VULKAN_PARTICLES_MAX_EMITTERS);
+	data->aliveList = aliveList;
+	data->seed = seed++;
+	emitCount = 0;
+	for (uint32_t emitterIndex = 0; emitterIndex < data->emittersCount; emitterIndex++) {
+		VulkanParticleEmitter& emitter = emitters[emitterIndex];
+		float emitted = emitter.rate * std::max(timeStep, 0.0f) + emitter.emitFraction;
+		uint32_t count = std::min((uint32_t)emitted, (uint32_t)VULKAN_PARTICLES_CAPACITY - emitCount);
+		emitter.emitFraction = emitted - (float)(uint32_t)emitted;
+
+		VulkanParticleEmitterData& emitterData = data->emitters[emitterIndex];
+		emitterData.positionRadius = glm::vec4(emitter.position, emitter.radius);
+		emitterData.velocitySpread = glm::vec4(emitter.velocity, emitter.velocitySpread);
+		emitterData.colorBegin = emitter.colorBegin;
+		emitterData.colorEnd = emitter.colorEnd;
+		emitterData.params = glm::vec4(std::max(emitter.life, 1e-3f), emitter.sizeBegin, emitter.sizeEnd, emitter.drag);
+		emitterData.range = glm::uvec4(emitCount, count, 0, 0);
+		emitCount += count;
+	}
+	data->emitCount = emitCount;
+	vmaFlushAllocation(context.device.allocator, frame.bufferData.allocation, 0, VK_WHOLE_SIZE);
+
+	// VkCommandBufferBeginInfo
+	VkCommandBuffer commandBuffer = frame.commandBuffer.commandBuffer;
+	VkCommandBufferBeginInfo commandBufferBeginInfo{};
+	commandBufferBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	commandBufferBeginInfo.pNext = VK_NULL_HANDLE;
+	commandBufferBeginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+	commandBufferBeginInfo.pInheritanceInfo = VK_NULL_HANDLE;
+	VKT_CHECK(vkBeginCommandBuffer(commandBuffer, &commandBufferBeginInfo));
+	vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, context.pipelineLayout_particles.pipelineLayout, 0, 1, &frame.descriptorSet.descriptorSet, 0, VK_NULL_HANDLE);
+
+	// VkMemoryBarrier - particles of previous submits visible to this frame (simulation dispatch is read indirectly)
+	VkMemoryBarrier memoryBarrier{};
+	memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+	memoryBarrier.pNext = VK_NULL_HANDLE;
+	memoryBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+	memoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+	vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &memoryBarrier, 0, VK_NULL_HANDLE, 0, VK_NULL_HANDLE);
+
+	// all particles are dead on first use (dead list holds every particle, counters are cleared)
+	if (!initialized) {
+		vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline_particles_init.pipeline);
+		vkCmdDispatch(commandBuffer, VULKAN_PARTICLES_CAPACITY / VULKAN_PARTICLES_GROUP_SIZE, 1, 1);
+		vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &memoryBarrier, 0, VK_NULL_HANDLE, 0, VK_NULL_HANDLE);
+		initialized = VK_TRUE;
+	}
+
+	// simulate alive particles (dispatch of last alive count, dead particles are pushed to dead list)
+	vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline_particles_simulate.pipeline);
+	vkCmdDispatchIndirect(commandBuffer, bufferCounters.buffer, 0);
+	memoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+	vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &memoryBarrier, 0, VK_NULL_HANDLE, 0, VK_NULL_HANDLE);
+
+	// emit particles popped from dead list
+	if (emitCount) {
+		vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline_particles_emit.pipeline);
+		vkCmdDispatch(commandBuffer, (emitCount + VULKAN_PARTICLES_GROUP_SIZE - 1) / VULKAN_PARTICLES_GROUP_SIZE, 1, 1);
+		vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &memoryBarrier, 0, VK_NULL_HANDLE, 0, VK_NULL_HANDLE);
+	}
+
+	// counters of next frame and indirect draw of frame (one invocation)
+	vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline_particles_finish.pipeline);
+	vkCmdDispatch(commandBuffer, 1, 1, 1);
+
+	// end command buffer (semaphore makes drawn instances and indirect draw visible to graphics queue)
+	VKT_CHECK(vkEndCommandBuffer(commandBuffer));
+	frame.recorded = VK_TRUE;
+	aliveList ^= 1;
+}
+
+// VulkanParticles::submit
+VkSemaphore VulkanParticles::submit(uint32_t frameIndex)
+{
+	// nothing recorded
+	if (frames.size() <= frameIndex || !frames[frameIndex].recorded)
+		return VK_NULL_HANDLE;
+	VulkanParticlesFrame& frame = frames[frameIndex];
+	frame.recorded = VK_FALSE;
+
+	// VkSubmitInfo
+	VkSubmitInfo submitInfo{};
+	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	submitInfo.pNext = VK_NULL_HANDLE;
+	submitInfo.waitSemaphoreCount = 0;
+	submitInfo.pWaitSemaphores = VK_NULL_HANDLE;
+	submitInfo.pWaitDstStageMask = VK_NULL_HANDLE;
+	submitInfo.commandBufferCount = 1;
+	submitInfo.pCommandBuffers = &frame.commandBuffer.commandBuffer;
+	submitInfo.signalSemaphoreCount = 1;
+	submitInfo.pSignalSemaphores = &frame.semaphore.semaphore;
+	VKT_CHECK(vkQueueSubmit(context.device.queueCompute, 1, &submitInfo, VK_NULL_HANDLE));
+	return frame.semaphore.semaphore;
+}
+
+// VulkanParticles::draw
+void VulkanParticles::draw(VulkanCommandBuffer& commandBuffer, uint32_t frameIndex)
+{
+	// frame was not simulated
+	if (frames.size() <= frameIndex || !frames[frameIndex].commandBuffer.commandBuffer)
+		return;
+
+	// six vertices per particle, instance count written by simulation
+	VulkanParticlesFrame& frame = frames[frameIndex];
+	vkCmdBindPipeline(commandBuffer.commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_particles.pipeline);
+	vkCmdBindDescriptorSets(commandBuffer.commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, context.pipelineLayout_particlesDraw.pipelineLayout, 3, 1, &frame.drawDescriptorSet.descriptorSet, 0, VK_NULL_HANDLE);
+	vkCmdDrawIndirect(commandBuffer.commandBuffer, frame.bufferDraw.buffer, 0, 1, sizeof(VkDrawIndirectCommand));
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include "vulkan_context.hpp"
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <vector>
+
+// particles of pool and max emitters of scene (must match shaders)
+#define VULKAN_PARTICLES_CAPACITY (1 << 20)
+#define VULKAN_PARTICLES_MAX_EMITTERS 16
+
+// particle shaders work group size (must match shaders)
+#define VULKAN_PARTICLES_GROUP_SIZE 64
+
+// VulkanParticleEmitter (particles emitted per second at emitter, color and size interpolated over life)
+struct VulkanParticleEmitter {
+	glm::vec3 position{};
+	float     radius = 0.1f;                             // emission sphere
+	glm::vec3 velocity = glm::vec3(0.0f, 2.0f, 0.0f);
+	float     velocitySpread = 1.0f;                     // random velocity of emission
+	glm::vec4 colorBegin = glm::vec4(1.0f, 0.6f, 0.2f, 1.0f);
+	glm::vec4 colorEnd = glm::vec4(0.2f, 0.1f, 0.1f, 0.0f);
+	float     rate = 1000.0f;                            // particles per second
+	float     life = 2.0f;                               // seconds
+	float     sizeBegin = 0.05f;
+	float     sizeEnd = 0.01f;
+	float     drag = 0.0f;
+	float     emitFraction = 0.0f;                       // part of particle carried into next frame
+};
+
+// VulkanParticleEmitterData (std140 emitter of particle shaders)
+struct VulkanParticleEmitterData {
+	glm::vec4  positionRadius;
+	glm::vec4  velocitySpread;
+	glm::vec4  colorBegin;
+	glm::vec4  colorEnd;
+	glm::vec4  params; // life, begin size, end size, drag
+	glm::uvec4 range;  // first emit invocation, emitted count
+};
+
+// VulkanParticlesData (std140 uniforms of particle shaders)
+struct VulkanParticlesData {
+	glm::vec4                 gravityTimeStep;
+	uint32_t                  emitCount;
+	uint32_t                  emittersCount;
+	uint32_t                  aliveList; // list simulated this frame (other list receives survivors and emitted)
+	uint32_t                  seed;
+	VulkanParticleEmitterData emitters[VULKAN_PARTICLES_MAX_EMITTERS];
+};
+
+// VulkanParticlesCounters (std430 counters of particle shaders, simulation dispatch is read indirectly)
+struct VulkanParticlesCounters {
+	VkDispatchIndirectCommand simulateDispatch;
+	uint32_t                  aliveCount;
+	uint32_t                  aliveNextCount;
+	uint32_t                  deadCount;
+	uint32_t                  emitted;
+};
+
+// VulkanParticlesFrame (frame in flight: compute command buffer, drawn instances and indirect draw written by simulation)
+struct VulkanParticlesFrame {
+	VulkanCommandBuffer commandBuffer{};
+	VulkanSemaphore     semaphore{};
+	VkBool32            recorded{};
+	VulkanBuffer        bufferData{};
+	VulkanBuffer        bufferInstances{};
+	VulkanBuffer        bufferColors{};
+	VulkanBuffer        bufferDraw{};
+	VulkanDescriptorSet descriptorSet{};
+	VulkanDescriptorSet drawDescriptorSet{};
+};
+
+// VulkanParticles (particles emitted and simulated by compute shaders on compute queue, free list and draw count live on device)
+class VulkanParticles {
+protected:
+	// base handles
+	VulkanContext& context;
+protected:
+	// particle shader files
+	const char* shader_particles_init_file_comp = "shaders/particles_init.comp.spv";
+	const char* shader_particles_simulate_file_comp = "shaders/particles_simulate.comp.spv";
+	const char* shader_particles_emit_file_comp = "shaders/particles_emit.comp.spv";
+	const char* shader_particles_finish_file_comp = "shaders/particles_finish.comp.spv";
+	// compute pipelines (free list is filled once, then simulation, emission and counters every frame)
+	VulkanPipeline pipeline_particles_init{};
+	VulkanPipeline pipeline_particles_simulate{};
+	VulkanPipeline pipeline_particles_emit{};
+	VulkanPipeline pipeline_particles_finish{};
+	// draw shader files (camera facing quads without vertex input)
+	const char* shader_particles_file_vert = "shaders/particles.vert.spv";
+	const char* shader_particles_file_frag = "shaders/particles.frag.spv";
+	// draw shader and pipeline (additive, depth tested without depth writes)
+	VulkanShader   shader_particles{};
+	VulkanPipeline pipeline_particles{};
+protected:
+	// particle state, dead list, alive lists and counters (used by compute queue only)
+	VulkanBuffer bufferParticles{};
+	VulkanBuffer bufferDead{};
+	VulkanBuffer bufferAlive{};
+	VulkanBuffer bufferCounters{};
+	VkBool32     initialized{};
+	uint32_t     aliveList{};
+	uint32_t     seed{};
+protected:
+	// compute command pool and frames in flight (created on first use of frame)
+	VkCommandPool                     commandPool{};
+	std::vector<VulkanParticlesFrame> frames{};
+	// emitted particles of last frame
+	uint32_t emitCount{};
+protected:
+	// create and destroy frame handles
+	void createFrame(VulkanParticlesFrame& frame);
+	void destroyFrame(VulkanParticlesFrame& frame);
+public:
+	// constructor and destructor
+	VulkanParticles(VulkanContext& context);
+	~VulkanParticles();
+
+	// create and destroy draw pipeline of render pass loading attachments of frame
+	void createDrawPipeline(VkRenderPass renderPass);
+	void destroyDrawPipeline();
+
+	// record emission of emitters and simulation of time step on compute queue (frame is complete on device)
+	void update(std::vector<VulkanParticleEmitter>& emitters, const glm::vec3& gravity, float timeStep, uint32_t frameIndex);
+
+	// submit recorded frame (returns semaphore to wait at draw indirect stage, or VK_NULL_HANDLE)
+	VkSemaphore submit(uint32_t frameIndex);
+
+	// draw particles of frame as camera facing quads (scene set is bound, binds draw pipeline and particles set 3)
+	void draw(VulkanCommandBuffer& commandBuffer, uint32_t frameIndex);
+
+	// getters
+	uint32_t getEmitCount() const { return emitCount; }
+};
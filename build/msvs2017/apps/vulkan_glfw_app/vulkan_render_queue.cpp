@@ -0,0 +1,342 @@
+#include "vulkan_render_queue.hpp"
+#include <cstring>
+
+// sameVertexBuffers (buffers and offsets of first streams, draws share bound vertex buffers)
+static bool sameVertexBuffers(const VulkanMeshDrawInfo& drawInfo0, const VulkanMeshDrawInfo& drawInfo1, uint32_t streamsCount)
+{
+	for (uint32_t i = 0; i < streamsCount; i++)
+		if (drawInfo0.vertexBuffers[i] != drawInfo1.vertexBuffers[i] || drawInfo0.vertexBufferOffsets[i] != drawInfo1.vertexBufferOffsets[i])
+			return false;
+	return true;
+}
+
+// VulkanRenderQueue::makeKey
+uint64_t VulkanRenderQueue::makeKey(VulkanDrawPass pass, uint32_t pipelineId, uint32_t materialId, uint32_t meshId, float depth)
+{
+	// non-negative floats keep their order when compared as integers (top 16 bits are enough)
+	uint32_t depthBits = 0;
+	depth = depth > 0.0f ? depth : 0.0f;
+	memcpy(&depthBits, &depth, sizeof(depthBits));
+	// pack fields
+	return
+		((uint64_t)(pass & 0xF) << VULKAN_DRAW_KEY_PASS_SHIFT) |
+		((uint64_t)(pipelineId & 0xFFF) << VULKAN_DRAW_KEY_PIPELINE_SHIFT) |
+		((uint64_t)(materialId & 0xFFFF) << VULKAN_DRAW_KEY_MATERIAL_SHIFT) |
+		((uint64_t)(meshId & 0xFFFF) << VULKAN_DRAW_KEY_MESH_SHIFT) |
+		((uint64_t)(depthBits >> 16) << VULKAN_DRAW_KEY_DEPTH_SHIFT);
+}
+
+// VulkanRenderQueue::makeMeshletKey
+uint64_t VulkanRenderQueue::makeMeshletKey(VulkanDrawPass pass, uint32_t pipelineId, uint32_t materialId, uint32_t meshId, uint32_t meshlet)
+{
+	// instances of meshlet are merged into one command (depth orders only instances within command)
+	assert(meshlet <= 0xFFFF);
+	return makeKey(pass, pipelineId, materialId, meshId, 0.0f) | ((uint64_t)(meshlet & 0xFFFF) << VULKAN_DRAW_KEY_DEPTH_SHIFT);
+}
+
+// VulkanRenderQueue::clear
+void VulkanRenderQueue::clear()
+{
+	// keep capacity for next frame
+	packets.clear();
+	sortItems.clear();
+}
+
+// VulkanRenderQueue::push
+void VulkanRenderQueue::push(const VulkanDrawPacket& packet)
+{
+	sortItems.push_back({ packet.key, (uint32_t)packets.size() });
+	packets.push_back(packet);
+}
+
+// VulkanRenderQueue::sort
+void VulkanRenderQueue::sort(VkBool32 instancing)
+{
+	// 8 passes of 8 bits, passes with one bucket are skipped
+	sortScratch.resize(sortItems.size());
+	for (uint32_t shift = 0; shift < 64; shift += 8) {
+		// histogram
+		size_t offsets[256]{};
+		for (const auto& sortItem : sortItems)
+			offsets[(sortItem.key >> shift) & 0xFF]++;
+		if (offsets[(sortItems.empty() ? 0 : (sortItems[0].key >> shift) & 0xFF)] == sortItems.size())
+			continue;
+		// prefix sum
+		size_t offset = 0;
+		for (auto& bucketOffset : offsets) {
+			size_t bucketSize = bucketOffset;
+			bucketOffset = offset;
+			offset += bucketSize;
+		}
+		// scatter (stable)
+		for (const auto& sortItem : sortItems)
+			sortScratch[offsets[(sortItem.key >> shift) & 0xFF]++] = sortItem;
+		sortItems.swap(sortScratch);
+	}
+
+	// merge consecutive packets with same state and geometry into instances of one command (same mesh is adjacent within state)
+	commands.clear();
+	batches.clear();
+	for (uint32_t i = 0; i < (uint32_t)sortItems.size(); i++) {
+		if (i) {
+			const VulkanDrawPacket& packet = packets[sortItems[i].index];
+			const VulkanDrawPacket& packetPrev = packets[sortItems[i - 1].index];
+			bool sameBatch =
+				(packet.key >> VULKAN_DRAW_KEY_PASS_SHIFT) == (packetPrev.key >> VULKAN_DRAW_KEY_PASS_SHIFT) &&
+				packet.pipeline == packetPrev.pipeline &&
+				packet.descriptorSetMaterial == packetPrev.descriptorSetMaterial &&
+				packet.drawInfo.vertexBuffersCount == packetPrev.drawInfo.vertexBuffersCount &&
+				sameVertexBuffers(packet.drawInfo, packetPrev.drawInfo, packet.drawInfo.vertexBuffersCount) &&
+				packet.drawInfo.indexBuffer == packetPrev.drawInfo.indexBuffer &&
+				packet.drawInfo.indexType == packetPrev.drawInfo.indexType;
+			bool sameGeometry = sameBatch &&
+				packet.drawInfo.indexCount == packetPrev.drawInfo.indexCount &&
+				packet.drawInfo.firstIndex == packetPrev.drawInfo.firstIndex &&
+				packet.drawInfo.vertexCount == packetPrev.drawInfo.vertexCount &&
+				packet.drawInfo.firstVertex == packetPrev.drawInfo.firstVertex;
+			if (instancing && sameGeometry) {
+				commands.back().count++;
+				continue;
+			}
+			if (sameBatch) {
+				commands.push_back({ i, 1 });
+				batches.back().count++;
+				continue;
+			}
+		}
+		batches.push_back({ (uint32_t)commands.size(), 1 });
+		commands.push_back({ i, 1 });
+	}
+}
+
+// VulkanRenderQueue::writeDrawData
+void VulkanRenderQueue::writeDrawData(VulkanDrawData* drawData) const
+{
+	// sorted packet index is draw data index
+	for (size_t i = 0; i < sortItems.size(); i++)
+		drawData[i] = packets[sortItems[i].index].drawData;
+}
+
+// VulkanRenderQueue::writeIndirectCommands
+void VulkanRenderQueue::writeIndirectCommands(VkDrawIndexedIndirectCommand* indirectCommands, uint32_t* counts) const
+{
+	// one command slot per draw command (non-indexed commands fit into indexed slot)
+	for (uint32_t i = 0; i < (uint32_t)commands.size(); i++) {
+		const VulkanDrawCommand& drawCommand = commands[i];
+		const VulkanMeshDrawInfo& drawInfo = packets[sortItems[drawCommand.first].index].drawInfo;
+		if (drawInfo.indexBuffer) {
+			// VkDrawIndexedIndirectCommand
+			VkDrawIndexedIndirectCommand command{};
+			command.indexCount = drawInfo.indexCount;
+			command.instanceCount = drawCommand.count;
+			command.firstIndex = drawInfo.firstIndex;
+			command.vertexOffset = (int32_t)drawInfo.firstVertex;
+			command.firstInstance = drawCommand.first;
+			indirectCommands[i] = command;
+		}
+		else {
+			// VkDrawIndirectCommand
+			VkDrawIndirectCommand command{};
+			command.vertexCount = drawInfo.vertexCount;
+			command.instanceCount = drawCommand.count;
+			command.firstVertex = drawInfo.firstVertex;
+			command.firstInstance = drawCommand.first;
+			memcpy(&indirectCommands[i], &command, sizeof(command));
+		}
+	}
+	// draw counts
+	for (size_t i = 0; i < batches.size(); i++)
+		counts[i] = batches[i].count;
+}
+
+// VulkanRenderQueue::writeCullData
+void VulkanRenderQueue::writeCullData(VulkanDrawCullData* cullData, VulkanDrawCommandCullData* commandCullData) const
+{
+	// bounding volumes and command of each instance, batch range of each command (culled instances and commands are compacted)
+	for (uint32_t batchIndex = 0; batchIndex < (uint32_t)batches.size(); batchIndex++) {
+		const VulkanDrawBatch& batch = batches[batchIndex];
+		for (uint32_t commandIndex = batch.first; commandIndex < batch.first + batch.count; commandIndex++) {
+			const VulkanDrawCommand& command = commands[commandIndex];
+			commandCullData[commandIndex].batchIndex = batchIndex;
+			commandCullData[commandIndex].batchFirst = batch.first;
+			for (uint32_t i = command.first; i < command.first + command.count; i++) {
+				const VulkanMeshDrawInfo& drawInfo = packets[sortItems[i].index].drawInfo;
+				cullData[i].boundingSphere = drawInfo.boundingSphere;
+				cullData[i].boundingBoxExtent = glm::vec4((drawInfo.boundingBoxMax - drawInfo.boundingBoxMin) * 0.5f, 0.0f);
+				cullData[i].cone = drawInfo.cone;
+				cullData[i].commandIndex = commandIndex;
+				cullData[i].commandFirst = command.first;
+				// push order is stable while scene is unchanged (visibility is kept between frames)
+				cullData[i].visibilityIndex = sortItems[i].index;
+			}
+		}
+	}
+}
+
+// VulkanRenderQueue::submit
+void VulkanRenderQueue::submit(VulkanCommandBuffer& commandBuffer, VkPipelineLayout pipelineLayout, size_t first, size_t count, const VulkanDrawIndirectInfo* indirectInfo, VkBool32 depthOnly, VulkanRenderQueueStats& stats) const
+{
+	// currently bound state
+	VkPipeline      pipeline = VK_NULL_HANDLE;
+	VkDescriptorSet descriptorSetMaterial = VK_NULL_HANDLE;
+	const VulkanMeshDrawInfo* vertexBuffersInfo = nullptr;
+	VkBuffer        indexBuffer = VK_NULL_HANDLE;
+	VkIndexType     indexType = VK_INDEX_TYPE_UINT32;
+
+	// record batches in key order
+	assert(first + count <= batches.size());
+	for (size_t batchIndex = first; batchIndex < first + count; batchIndex++) {
+		const VulkanDrawBatch& batch = batches[batchIndex];
+		const VulkanDrawPacket& packet = packets[sortItems[commands[batch.first].first].index];
+		// draws in batch share bound state
+		uint32_t batchSaved = batch.count - 1;
+
+		// bind pipeline
+		VkPipeline packetPipeline = depthOnly ? packet.pipelineDepth : packet.pipeline;
+		assert(packetPipeline);
+		if (packetPipeline != pipeline) {
+			pipeline = packetPipeline;
+			vkCmdBindPipeline(commandBuffer.commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+			stats.pipelineBindsCount++;
+			stats.pipelineBindsSaved += batchSaved;
+		} else
+			stats.pipelineBindsSaved += batch.count;
+
+		// bind material descriptor set (set 0, optional, not used by depth only draws)
+		if (packet.descriptorSetMaterial && !depthOnly) {
+			if (packet.descriptorSetMaterial != descriptorSetMaterial) {
+				descriptorSetMaterial = packet.descriptorSetMaterial;
+				vkCmdBindDescriptorSets(commandBuffer.commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &descriptorSetMaterial, 0, VK_NULL_HANDLE);
+				stats.descriptorSetBindsCount++;
+				stats.descriptorSetBindsSaved += batchSaved;
+			} else
+				stats.descriptorSetBindsSaved += batch.count;
+		}
+
+		// bind vertex buffers (first one is position stream, depth only draws bind only positions)
+		const VulkanMeshDrawInfo& drawInfo = packet.drawInfo;
+		uint32_t streamsCount = depthOnly ? 1 : drawInfo.vertexBuffersCount;
+		if (!vertexBuffersInfo || (depthOnly ? 1 : vertexBuffersInfo->vertexBuffersCount) != streamsCount || !sameVertexBuffers(drawInfo, *vertexBuffersInfo, streamsCount)) {
+			vertexBuffersInfo = &drawInfo;
+			vkCmdBindVertexBuffers(commandBuffer.commandBuffer, 0, streamsCount, drawInfo.vertexBuffers, drawInfo.vertexBufferOffsets);
+			stats.vertexBufferBindsCount++;
+			stats.vertexBufferBindsSaved += batchSaved;
+		} else
+			stats.vertexBufferBindsSaved += batch.count;
+
+		// bind index buffer (16-bit and 32-bit indices share pool buffer)
+		if (drawInfo.indexBuffer && (drawInfo.indexBuffer != indexBuffer || drawInfo.indexType != indexType)) {
+			indexBuffer = drawInfo.indexBuffer;
+			indexType = drawInfo.indexType;
+			vkCmdBindIndexBuffer(commandBuffer.commandBuffer, indexBuffer, 0, indexType);
+		}
+		const VulkanDrawCommand& batchLast = commands[batch.first + batch.count - 1];
+		stats.drawsCount += batchLast.first + batchLast.count - commands[batch.first].first;
+		stats.drawCommandsCount += batch.count;
+
+		// direct draws (draw data index is instance index)
+		if (!indirectInfo) {
+			for (uint32_t i = batch.first; i < batch.first + batch.count; i++) {
+				const VulkanDrawCommand& command = commands[i];
+				const VulkanMeshDrawInfo& drawInfoCommand = packets[sortItems[command.first].index].drawInfo;
+				if (drawInfoCommand.indexBuffer)
+					vkCmdDrawIndexed(commandBuffer.commandBuffer, drawInfoCommand.indexCount, command.count, drawInfoCommand.firstIndex, drawInfoCommand.firstVertex, command.first);
+				else
+					vkCmdDraw(commandBuffer.commandBuffer, drawInfoCommand.vertexCount, command.count, drawInfoCommand.firstVertex, command.first);
+			}
+			stats.drawCallsCount += batch.count;
+			continue;
+		}
+
+		// indirect draws (count from buffer, one multi draw or one indirect draw per command)
+		VkDeviceSize indirectOffset = (VkDeviceSize)batch.first * VULKAN_DRAW_INDIRECT_STRIDE;
+		if (indirectInfo->countBuffer) {
+			VkDeviceSize countOffset = (VkDeviceSize)batchIndex * sizeof(uint32_t);
+			if (drawInfo.indexBuffer)
+				indirectInfo->fnCmdDrawIndexedIndirectCountKHR(commandBuffer.commandBuffer, indirectInfo->indirectBuffer, indirectOffset, indirectInfo->countBuffer, countOffset, batch.count, VULKAN_DRAW_INDIRECT_STRIDE);
+			else
+				indirectInfo->fnCmdDrawIndirectCountKHR(commandBuffer.commandBuffer, indirectInfo->indirectBuffer, indirectOffset, indirectInfo->countBuffer, countOffset, batch.count, VULKAN_DRAW_INDIRECT_STRIDE);
+			stats.drawCallsCount++;
+		}
+		else if (indirectInfo->multiDrawIndirect) {
+			if (drawInfo.indexBuffer)
+				vkCmdDrawIndexedIndirect(commandBuffer.commandBuffer, indirectInfo->indirectBuffer, indirectOffset, batch.count, VULKAN_DRAW_INDIRECT_STRIDE);
+			else
+				vkCmdDrawIndirect(commandBuffer.commandBuffer, indirectInfo->indirectBuffer, indirectOffset, batch.count, VULKAN_DRAW_INDIRECT_STRIDE);
+			stats.drawCallsCount++;
+		}
+		else {
+			for (uint32_t i = 0; i < batch.count; i++) {
+				if (drawInfo.indexBuffer)
+					vkCmdDrawIndexedIndirect(commandBuffer.commandBuffer, indirectInfo->indirectBuffer, indirectOffset + i * VULKAN_DRAW_INDIRECT_STRIDE, 1, VULKAN_DRAW_INDIRECT_STRIDE);
+				else
+					vkCmdDrawIndirect(commandBuffer.commandBuffer, indirectInfo->indirectBuffer, indirectOffset + i * VULKAN_DRAW_INDIRECT_STRIDE, 1, VULKAN_DRAW_INDIRECT_STRIDE);
+			}
+			stats.drawCallsCount += batch.count;
+		}
+	}
+}
+
+// VulkanRenderQueue::getPassBatches
+void VulkanRenderQueue::getPassBatches(uint32_t pass, size_t* first, size_t* count) const
+{
+	// batches are sorted by pass (first packet of batch has pass of whole batch)
+	*first = 0;
+	while (*first < batches.size() && (packets[sortItems[commands[batches[*first].first].first].index].key >> VULKAN_DRAW_KEY_PASS_SHIFT) < pass)
+		(*first)++;
+	*count = 0;
+	while (*first + *count < batches.size() && (packets[sortItems[commands[batches[*first + *count].first].first].index].key >> VULKAN_DRAW_KEY_PASS_SHIFT) == pass)
+		(*count)++;
+}
+
+// VulkanRenderQueue::splitBatches
+void VulkanRenderQueue::splitBatches(size_t rangesCount, VkBool32 commandsWeighted, std::vector<size_t>& firsts) const
+{
+	// range starts at first batch reaching its part of batches or commands (unreached ranges are empty)
+	firsts.assign(rangesCount + 1, batches.size());
+	size_t total = commandsWeighted ? commands.size() : batches.size();
+	size_t range = 0;
+	for (size_t batchIndex = 0; batchIndex < batches.size() && range < rangesCount; batchIndex++) {
+		size_t done = commandsWeighted ? batches[batchIndex].first : batchIndex;
+		while (range < rangesCount && done >= total * range / rangesCount)
+			firsts[range++] = batchIndex;
+	}
+}
+
+// VulkanRenderQueue::size
+size_t VulkanRenderQueue::size() const
+{
+	return packets.size();
+}
+
+// VulkanRenderQueue::commandsCount
+size_t VulkanRenderQueue::commandsCount() const
+{
+	return commands.size();
+}
+
+// VulkanRenderQueue::batchesCount
+size_t VulkanRenderQueue::batchesCount() const
+{
+	return batches.size();
+}
+
+// vulkanRenderQueueStatsAdd
+void vulkanRenderQueueStatsAdd(VulkanRenderQueueStats& stats, const VulkanRenderQueueStats& other)
+{
+	stats.drawsCount += other.drawsCount;
+	stats.drawCommandsCount += other.drawCommandsCount;
+	stats.drawCallsCount += other.drawCallsCount;
+	stats.pipelineBindsCount += other.pipelineBindsCount;
+	stats.pipelineBindsSaved += other.pipelineBindsSaved;
+	stats.descriptorSetBindsCount += other.descriptorSetBindsCount;
+	stats.descriptorSetBindsSaved += other.descriptorSetBindsSaved;
+	stats.vertexBufferBindsCount += other.vertexBufferBindsCount;
+	stats.vertexBufferBindsSaved += other.vertexBufferBindsSaved;
+	stats.visibleCount += other.visibleCount;
+	stats.culledCount += other.culledCount;
+	stats.simplifiedCount += other.simplifiedCount;
+	stats.clusteredCount += other.clusteredCount;
+	stats.shadowDrawsCount += other.shadowDrawsCount;
+	stats.shadowCachedCount += other.shadowCachedCount;
+}
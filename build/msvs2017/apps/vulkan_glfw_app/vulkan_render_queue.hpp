@@ -0,0 +1,157 @@
+#pragma once
+
+#include "vulkan_meshes.hpp"
+#include <glm/mat4x4.hpp>
+#include <vector>
+
+// VulkanDrawPass (most significant sort key bits)
+enum VulkanDrawPass {
+	VULKAN_DRAW_PASS_OPAQUE = 0,
+	VULKAN_DRAW_PASS_DEBUG = 1,
+	VULKAN_DRAW_PASS_SHADOW = 2, // static and dynamic casters of each cascade (VULKAN_DRAW_PASS_SHADOW + cascade * 2 + dynamic)
+	VULKAN_DRAW_PASS_MAX_ENUM = 0xF
+};
+
+// sort key layout: pass (4) | pipeline (12) | material (16) | mesh and level of detail (16) | depth (16)
+#define VULKAN_DRAW_KEY_PASS_SHIFT     60
+#define VULKAN_DRAW_KEY_PIPELINE_SHIFT 48
+#define VULKAN_DRAW_KEY_MATERIAL_SHIFT 32
+#define VULKAN_DRAW_KEY_MESH_SHIFT     16
+#define VULKAN_DRAW_KEY_DEPTH_SHIFT    0
+
+// indirect command stride (indexed and non-indexed commands share one slot per draw command)
+#define VULKAN_DRAW_INDIRECT_STRIDE sizeof(VkDrawIndexedIndirectCommand)
+
+// VulkanDrawData (per instance shader data, std430 DrawData of vertex shaders indexed by instance index)
+struct VulkanDrawData {
+	glm::mat4 model;
+	uint32_t  materialId;
+	uint32_t  padding[3];
+};
+
+// VulkanDrawCullData (per instance culling data, std430 CullData of culling shaders)
+struct VulkanDrawCullData {
+	glm::vec4 boundingSphere;
+	glm::vec4 boundingBoxExtent;
+	uint32_t  commandIndex;
+	uint32_t  commandFirst;
+	uint32_t  visibilityIndex;
+	uint32_t  padding;
+	glm::vec4 cone;
+};
+
+// VulkanDrawCommandCullData (per draw command culling data, std430 CommandCullData of culling shaders)
+struct VulkanDrawCommandCullData {
+	uint32_t batchIndex;
+	uint32_t batchFirst;
+};
+
+// VulkanDrawPacket (plain data, everything needed to record one draw)
+struct VulkanDrawPacket {
+	uint64_t           key;
+	VkPipeline         pipeline;
+	VkPipeline         pipelineDepth; // depth pre-pass (position stream only)
+	VkDescriptorSet    descriptorSetMaterial;
+	VulkanMeshDrawInfo drawInfo;
+	VulkanDrawData     drawData;
+};
+
+// VulkanDrawSortItem (sort key and packet index)
+struct VulkanDrawSortItem {
+	uint64_t key;
+	uint32_t index;
+};
+
+// VulkanDrawCommand (sorted packets sharing geometry - one instanced draw, first packet is first instance)
+struct VulkanDrawCommand {
+	uint32_t first;
+	uint32_t count;
+};
+
+// VulkanDrawBatch (draw commands sharing pipeline, material and buffers - one multi draw)
+struct VulkanDrawBatch {
+	uint32_t first;
+	uint32_t count;
+};
+
+// VulkanDrawIndirectInfo (per frame indirect buffers, draw data index is instance index)
+struct VulkanDrawIndirectInfo {
+	// commands (one per draw command) and draw counts (one per batch, optional)
+	VkBuffer indirectBuffer;
+	VkBuffer countBuffer;
+	// VK_KHR_draw_indirect_count functions (used with count buffer)
+	PFN_vkCmdDrawIndirectCountKHR        fnCmdDrawIndirectCountKHR;
+	PFN_vkCmdDrawIndexedIndirectCountKHR fnCmdDrawIndexedIndirectCountKHR;
+	// multiDrawIndirect feature (one indirect call per draw without it)
+	VkBool32 multiDrawIndirect;
+};
+
+// VulkanRenderQueueStats (per frame bind counters)
+struct VulkanRenderQueueStats {
+	uint32_t drawsCount{};
+	uint32_t drawCommandsCount{};
+	uint32_t drawCallsCount{};
+	uint32_t pipelineBindsCount{};
+	uint32_t pipelineBindsSaved{};
+	uint32_t descriptorSetBindsCount{};
+	uint32_t descriptorSetBindsSaved{};
+	uint32_t vertexBufferBindsCount{};
+	uint32_t vertexBufferBindsSaved{};
+	// host frustum culling of meshes (zero when culled on device)
+	uint32_t visibleCount{};
+	uint32_t culledCount{};
+	// meshes drawn at simplified level of detail and meshes drawn as meshlets culled on device
+	uint32_t simplifiedCount{};
+	uint32_t clusteredCount{};
+	// shadow casters drawn and shadow cascades reused from cache (static casters not drawn)
+	uint32_t shadowDrawsCount{};
+	uint32_t shadowCachedCount{};
+};
+
+// VulkanRenderQueue
+class VulkanRenderQueue {
+protected:
+	// draw packets (in push order)
+	std::vector<VulkanDrawPacket> packets{};
+	// sorted items and radix sort scratch
+	std::vector<VulkanDrawSortItem> sortItems{};
+	std::vector<VulkanDrawSortItem> sortScratch{};
+	// instanced draw commands of sorted packets and their batches
+	std::vector<VulkanDrawCommand> commands{};
+	std::vector<VulkanDrawBatch>   batches{};
+public:
+	// build sort key
+	static uint64_t makeKey(VulkanDrawPass pass, uint32_t pipelineId, uint32_t materialId, uint32_t meshId, float depth);
+
+	// build sort key of meshlet (meshlet index in place of depth, same meshlet of all instances is adjacent)
+	static uint64_t makeMeshletKey(VulkanDrawPass pass, uint32_t pipelineId, uint32_t materialId, uint32_t meshId, uint32_t meshlet);
+
+	// fill queue
+	void clear();
+	void push(const VulkanDrawPacket& packet);
+
+	// sort packets by key (stable LSD radix sort), merge packets sharing geometry into instanced commands (optional) and build batches
+	void sort(VkBool32 instancing);
+
+	// write draw data in sorted order, indirect commands and draw counts per batch
+	void writeDrawData(VulkanDrawData* drawData) const;
+	void writeIndirectCommands(VkDrawIndexedIndirectCommand* indirectCommands, uint32_t* counts) const;
+	void writeCullData(VulkanDrawCullData* cullData, VulkanDrawCommandCullData* commandCullData) const;
+
+	// record batches [first, first + count) with redundant state elimination (thread safe, direct draws without indirect info, depth only draws bind depth pipelines and position stream)
+	void submit(VulkanCommandBuffer& commandBuffer, VkPipelineLayout pipelineLayout, size_t first, size_t count, const VulkanDrawIndirectInfo* indirectInfo, VkBool32 depthOnly, VulkanRenderQueueStats& stats) const;
+
+	// batches range of pass (batches never span passes)
+	void getPassBatches(uint32_t pass, size_t* first, size_t* count) const;
+
+	// split batches into ranges of similar batches or commands count (firsts of ranges and end, ranges never split batch)
+	void splitBatches(size_t rangesCount, VkBool32 commandsWeighted, std::vector<size_t>& firsts) const;
+
+	// getters
+	size_t size() const;
+	size_t commandsCount() const;
+	size_t batchesCount() const;
+};
+
+// accumulate stats
+void vulkanRenderQueueStatsAdd(VulkanRenderQueueStats& stats, const VulkanRenderQueueStats& other);
@@ -1,56 +1,877 @@
 #include "vulkan_renderer.hpp"
 #include "vulkan_loaders.hpp"
+#include <algorithm>
+#include <cmath>
+#include <glm/geometric.hpp>
+
+// VulkanRenderer::VulkanRenderer
+VulkanRenderer::VulkanRenderer(VulkanContext& context) :
+	context(context)
+{
+	// one record thread per core
+	recordThreadsCount = std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+// VulkanRenderer::~VulkanRenderer
+VulkanRenderer::~VulkanRenderer()
+{
+	// destroy skinning, debug geometry, light clusters, shadow pass, depth pre-pass and occlusion culling
+	delete skinning;
+	delete debugGeometry;
+	delete lightClusters;
+	delete shadowPass;
+	delete depthPrepass;
+	delete occlusionCulling;
+}
+
+// VulkanRenderer::createShaders
+void VulkanRenderer::createShaders() {
+	// create all shaders
+	for (uint32_t materialUsage = VULKAN_MATERIAL_USAGE_BEGIN_RANGE; materialUsage <= VULKAN_MATERIAL_USAGE_END_RANGE; materialUsage++) {
+		// create mesh object shaders
+		vulkanShaderCreate(context.device,
+			shaders_mesh_obj_files_vert[materialUsage],
+			shaders_mesh_obj_files_frag[materialUsage],
+			&shader_mesh_obj[materialUsage]);
+		// create mesh object skin shaders
+		vulkanShaderCreate(context.device,
+			shaders_mesh_obj_skin_files_vert[materialUsage],
+			shaders_mesh_obj_skin_files_frag[materialUsage],
+			&shader_mesh_obj_skin[materialUsage]);
+	}
+}
+
+// VulkanRenderer::createPipelines
+void VulkanRenderer::createPipelines(VkRenderPass renderPass) {
+	// create all pipelines
+	for (uint32_t topology = VK_PRIMITIVE_TOPOLOGY_LINE_LIST; topology <= VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP_WITH_ADJACENCY; topology++) {
+		// create pipelines for materials
+		for (uint32_t materialUsage = VULKAN_MATERIAL_USAGE_COLOR; materialUsage <= VULKAN_MATERIAL_USAGE_COLOR_TEXTURE_LIGHT; materialUsage++) {
+			// create pipeline mesh object
+			vulkanPipelineCreate(context.device, shader_mesh_obj[materialUsage], context.pipelineLayout, renderPass, 0,
+				(VkPrimitiveTopology)topology, VK_POLYGON_MODE_FILL,
+				VKT_ARRAY_ELEMENTS_COUNT(vertexBindingDescriptions_mesh_obj), vertexBindingDescriptions_mesh_obj,
+				VKT_ARRAY_ELEMENTS_COUNT(vertexAttributeDescriptions_mesh_obj), vertexAttributeDescriptions_mesh_obj,
+				VKT_ARRAY_ELEMENTS_COUNT(pipelineColorBlendAttachmentStates_default), pipelineColorBlendAttachmentStates_default,
+				nullptr, &pipeline_mesh_obj[materialUsage][topology]);
+			// create pipeline mesh object (wire-frame)
+			vulkanPipelineCreate(context.device, shader_mesh_obj[materialUsage], context.pipelineLayout, renderPass, 0,
+				(VkPrimitiveTopology)topology, VK_POLYGON_MODE_LINE,
+				VKT_ARRAY_ELEMENTS_COUNT(vertexBindingDescriptions_mesh_obj), vertexBindingDescriptions_mesh_obj,
+				VKT_ARRAY_ELEMENTS_COUNT(vertexAttributeDescriptions_mesh_obj), vertexAttributeDescriptions_mesh_obj,
+				VKT_ARRAY_ELEMENTS_COUNT(pipelineColorBlendAttachmentStates_default), pipelineColorBlendAttachmentStates_default,
+				nullptr, &pipeline_mesh_obj_wf[materialUsage][topology]);
+			// create pipeline mesh object skin
+			vulkanPipelineCreate(context.device, shader_mesh_obj_skin[materialUsage], context.pipelineLayout, renderPass, 0,
+				(VkPrimitiveTopology)topology, VK_POLYGON_MODE_FILL,
+				VKT_ARRAY_ELEMENTS_COUNT(vertexBindingDescriptions_mesh_obj_skin), vertexBindingDescriptions_mesh_obj_skin,
+				VKT_ARRAY_ELEMENTS_COUNT(vertexAttributeDescriptions_mesh_obj_skin), vertexAttributeDescriptions_mesh_obj_skin,
+				VKT_ARRAY_ELEMENTS_COUNT(pipelineColorBlendAttachmentStates_default), pipelineColorBlendAttachmentStates_default,
+				nullptr, &pipeline_mesh_obj_skin[materialUsage][topology]);
+			// create pipeline mesh object skin (wire-frame)
+			vulkanPipelineCreate(context.device, shader_mesh_obj_skin[materialUsage], context.pipelineLayout, renderPass, 0,
+				(VkPrimitiveTopology)topology, VK_POLYGON_MODE_LINE,
+				VKT_ARRAY_ELEMENTS_COUNT(vertexBindingDescriptions_mesh_obj_skin), vertexBindingDescriptions_mesh_obj_skin,
+				VKT_ARRAY_ELEMENTS_COUNT(vertexAttributeDescriptions_mesh_obj_skin), vertexAttributeDescriptions_mesh_obj_skin,
+				VKT_ARRAY_ELEMENTS_COUNT(pipelineColorBlendAttachmentStates_default), pipelineColorBlendAttachmentStates_default,
+				nullptr, &pipeline_mesh_obj_skin_wf[materialUsage][topology]);
+		}
+		// create pipelines for bump materials
+		for (uint32_t materialUsage = VULKAN_MATERIAL_USAGE_COLOR_TEXTURE_LIGHT_BUMPMAP; materialUsage <= VULKAN_MATERIAL_USAGE_COLOR_TEXTURE_LIGHT_PBR; materialUsage++) {
+			// create pipeline mesh object
+			vulkanPipelineCreate(context.device, shader_mesh_obj[materialUsage], context.pipelineLayout, renderPass, 0,
+				(VkPrimitiveTopology)topology, VK_POLYGON_MODE_FILL,
+				VKT_ARRAY_ELEMENTS_COUNT(vertexBindingDescriptions_mesh_obj_bump), vertexBindingDescriptions_mesh_obj_bump,
+				VKT_ARRAY_ELEMENTS_COUNT(vertexAttributeDescriptions_mesh_obj_bump), vertexAttributeDescriptions_mesh_obj_bump,
+				VKT_ARRAY_ELEMENTS_COUNT(pipelineColorBlendAttachmentStates_default), pipelineColorBlendAttachmentStates_default,
+				nullptr, &pipeline_mesh_obj[materialUsage][topology]);
+			// create pipeline mesh object (wire-frame)
+			vulkanPipelineCreate(context.device, shader_mesh_obj[materialUsage], context.pipelineLayout, renderPass, 0,
+				(VkPrimitiveTopology)topology, VK_POLYGON_MODE_LINE,
+				VKT_ARRAY_ELEMENTS_COUNT(vertexBindingDescriptions_mesh_obj_bump), vertexBindingDescriptions_mesh_obj_bump,
+				VKT_ARRAY_ELEMENTS_COUNT(vertexAttributeDescriptions_mesh_obj_bump), vertexAttributeDescriptions_mesh_obj_bump,
+				VKT_ARRAY_ELEMENTS_COUNT(pipelineColorBlendAttachmentStates_default), pipelineColorBlendAttachmentStates_default,
+				nullptr, &pipeline_mesh_obj_wf[materialUsage][topology]);
+			// create pipeline mesh object skin
+			vulkanPipelineCreate(context.device, shader_mesh_obj_skin[materialUsage], context.pipelineLayout, renderPass, 0,
+				(VkPrimitiveTopology)topology, VK_POLYGON_MODE_FILL,
+				VKT_ARRAY_ELEMENTS_COUNT(vertexBindingDescriptions_mesh_obj_skin_bump), vertexBindingDescriptions_mesh_obj_skin_bump,
+				VKT_ARRAY_ELEMENTS_COUNT(vertexAttributeDescriptions_mesh_obj_skin_bump), vertexAttributeDescriptions_mesh_obj_skin_bump,
+				VKT_ARRAY_ELEMENTS_COUNT(pipelineColorBlendAttachmentStates_default), pipelineColorBlendAttachmentStates_default,
+				nullptr, &pipeline_mesh_obj_skin[materialUsage][topology]);
+			// create pipeline mesh object skin (wire-frame)
+			vulkanPipelineCreate(context.device, shader_mesh_obj_skin[materialUsage], context.pipelineLayout, renderPass, 0,
+				(VkPrimitiveTopology)topology, VK_POLYGON_MODE_LINE,
+				VKT_ARRAY_ELEMENTS_COUNT(vertexBindingDescriptions_mesh_obj_skin_bump), vertexBindingDescriptions_mesh_obj_skin_bump,
+				VKT_ARRAY_ELEMENTS_COUNT(vertexAttributeDescriptions_mesh_obj_skin_bump), vertexAttributeDescriptions_mesh_obj_skin_bump,
+				VKT_ARRAY_ELEMENTS_COUNT(pipelineColorBlendAttachmentStates_default), pipelineColorBlendAttachmentStates_default,
+				nullptr, &pipeline_mesh_obj_skin_wf[materialUsage][topology]);
+		}
+	}
+}
+
+// VulkanRenderer::createRecordCommandBuffers
+void VulkanRenderer::createRecordCommandBuffers(uint32_t framesCount) {
+	// create record threads
+	recordThreadPool = new ThreadPool(recordThreadsCount);
+	// create command pools (one per frame and thread - pools are not thread safe) with command buffer per subpass
+	recordCommandPools.resize(framesCount * recordThreadsCount);
+	recordCommandBuffers.resize(framesCount * recordThreadsCount * VULKAN_RENDERER_MAX_SUBPASSES);
+	for (uint32_t i = 0; i < framesCount * recordThreadsCount; i++) {
+		// VkCommandPoolCreateInfo
+		VkCommandPoolCreateInfo commandPoolCreateInfo{};
+		commandPoolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+		commandPoolCreateInfo.pNext = VK_NULL_HANDLE;
+		commandPoolCreateInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+		commandPoolCreateInfo.queueFamilyIndex = context.device.queueFamilyIndexGraphics;
+		VKT_CHECK(vkCreateCommandPool(context.device.device, &commandPoolCreateInfo, VK_NULL_HANDLE, &recordCommandPools[i]));
+		assert(recordCommandPools[i]);
+
+		// VkCommandBufferAllocateInfo
+		VkCommandBufferAllocateInfo commandBufferAllocateInfo{};
+		commandBufferAllocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		commandBufferAllocateInfo.pNext = VK_NULL_HANDLE;
+		commandBufferAllocateInfo.commandPool = recordCommandPools[i];
+		commandBufferAllocateInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+		commandBufferAllocateInfo.commandBufferCount = 1;
+		for (uint32_t subpass = 0; subpass < VULKAN_RENDERER_MAX_SUBPASSES; subpass++) {
+			VulkanCommandBuffer& recordCommandBuffer = recordCommandBuffers[i * VULKAN_RENDERER_MAX_SUBPASSES + subpass];
+			VKT_CHECK(vkAllocateCommandBuffers(context.device.device, &commandBufferAllocateInfo, &recordCommandBuffer.commandBuffer));
+			assert(recordCommandBuffer.commandBuffer);
+		}
+	}
+}
+
+// VulkanRenderer::createDrawBuffers
+void VulkanRenderer::createDrawBuffers(uint32_t framesCount) {
+	// create buffers and descriptor sets (one per frame - host writes them while other frames are in flight)
+	drawDataBuffers.resize(framesCount);
+	drawIndirectBuffers.resize(framesCount);
+	drawCountBuffers.resize(framesCount);
+	drawDescriptorSets.resize(framesCount);
+	for (uint32_t i = 0; i < framesCount; i++) {
+		vulkanBufferCreateMapped(context.device, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, drawPacketsMin * sizeof(VulkanDrawData), &drawDataBuffers[i]);
+		vulkanBufferCreateMapped(context.device, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, drawPacketsMin * VULKAN_DRAW_INDIRECT_STRIDE, &drawIndirectBuffers[i]);
+		vulkanBufferCreateMapped(context.device, VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, drawPacketsMin * sizeof(uint32_t), &drawCountBuffers[i]);
+		vulkanDescriptorSetCreate(context.device, context.descriptorSetLayout_draw, &drawDescriptorSets[i]);
+		vulkanDescriptorSetUpdateBufferStorage(context.device, drawDescriptorSets[i], drawDataBuffers[i], 0);
+	}
+	// create culling
+	drawCulling = new VulkanDrawCulling(context, framesCount);
+
+	// create pipeline statistics queries (recorded by secondary command buffers too)
+	pipelineStatisticsQueried.resize(framesCount, VK_FALSE);
+	if (context.device.physicalDeviceFeaturesEnabled.pipelineStatisticsQuery && context.device.physicalDeviceFeaturesEnabled.inheritedQueries) {
+		// VkQueryPoolCreateInfo
+		VkQueryPoolCreateInfo queryPoolCreateInfo{};
+		queryPoolCreateInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+		queryPoolCreateInfo.pNext = VK_NULL_HANDLE;
+		queryPoolCreateInfo.flags = 0;
+		queryPoolCreateInfo.queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+		queryPoolCreateInfo.queryCount = framesCount;
+		queryPoolCreateInfo.pipelineStatistics = VULKAN_PIPELINE_STATISTICS_FLAGS;
+		VKT_CHECK(vkCreateQueryPool(context.device.device, &queryPoolCreateInfo, VK_NULL_HANDLE, &pipelineStatisticsQueryPool));
+		assert(pipelineStatisticsQueryPool);
+	}
+}
+
+// VulkanRenderer::destroyShaders
+void VulkanRenderer::destroyShaders() {
+	// destroy all shaders
+	for (uint32_t materialUsage = VULKAN_MATERIAL_USAGE_BEGIN_RANGE; materialUsage <= VULKAN_MATERIAL_USAGE_END_RANGE; materialUsage++) {
+		vulkanShaderDestroy(context.device, shader_mesh_obj_skin[materialUsage]);
+		vulkanShaderDestroy(context.device, shader_mesh_obj[materialUsage]);
+	}
+}
+
+// VulkanRenderer::destroyPipelines
+void VulkanRenderer::destroyPipelines() {
+	// destroy all pipelines
+	for (uint32_t materialUsage = VULKAN_MATERIAL_USAGE_BEGIN_RANGE; materialUsage <= VULKAN_MATERIAL_USAGE_END_RANGE; materialUsage++) {
+		for (uint32_t topology = VK_PRIMITIVE_TOPOLOGY_LINE_LIST; topology <= VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP_WITH_ADJACENCY; topology++) {
+			vulkanPipelineDestroy(context.device, pipeline_mesh_obj_skin_wf[materialUsage][topology]);
+			vulkanPipelineDestroy(context.device, pipeline_mesh_obj_skin[materialUsage][topology]);
+			vulkanPipelineDestroy(context.device, pipeline_mesh_obj_wf[materialUsage][topology]);
+			vulkanPipelineDestroy(context.device, pipeline_mesh_obj[materialUsage][topology]);
+		}
+	}
+}
+
+// VulkanRenderer::destroyRecordCommandBuffers
+void VulkanRenderer::destroyRecordCommandBuffers() {
+	// destroy record threads
+	delete recordThreadPool;
+	recordThreadPool = nullptr;
+	// destroy command pools (frees secondary command buffers)
+	for (auto& commandPool : recordCommandPools)
+		vkDestroyCommandPool(context.device.device, commandPool, VK_NULL_HANDLE);
+	recordCommandPools.clear();
+	recordCommandBuffers.clear();
+}
+
+// VulkanRenderer::destroyDrawBuffers
+void VulkanRenderer::destroyDrawBuffers() {
+	// destroy pipeline statistics queries
+	vkDestroyQueryPool(context.device.device, pipelineStatisticsQueryPool, VK_NULL_HANDLE);
+	pipelineStatisticsQueryPool = VK_NULL_HANDLE;
+	pipelineStatisticsQueried.clear();
+	// destroy culling
+	delete drawCulling;
+	drawCulling = nullptr;
+	// destroy buffers and descriptor sets
+	for (auto& descriptorSet : drawDescriptorSets)
+		vulkanDescriptorSetDestroy(context.device, descriptorSet);
+	for (auto& buffer : drawCountBuffers)
+		vulkanBufferDestroy(context.device, buffer);
+	for (auto& buffer : drawIndirectBuffers)
+		vulkanBufferDestroy(context.device, buffer);
+	for (auto& buffer : drawDataBuffers)
+		vulkanBufferDestroy(context.device, buffer);
+	drawDescriptorSets.clear();
+	drawCountBuffers.clear();
+	drawIndirectBuffers.clear();
+	drawDataBuffers.clear();
+}
+
+// VulkanRenderer::beforeRenderPass
+void VulkanRenderer::beforeRenderPass(VulkanCommandBuffer& commandBuffer, VulkanScene* scene, uint32_t frameIndex)
+{
+	// VkMemoryBarrier - previous frames in flight finished reading uniforms
+	VkMemoryBarrier memoryBarrier{};
+	memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+	memoryBarrier.pNext = VK_NULL_HANDLE;
+	memoryBarrier.srcAccessMask = VK_ACCESS_UNIFORM_READ_BIT;
+	memoryBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	vkCmdPipelineBarrier(commandBuffer.commandBuffer, VK_PIPELINE_STAGE_ALL_GRAPHICS_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &memoryBarrier, 0, VK_NULL_HANDLE, 0, VK_NULL_HANDLE);
+
+	// scene is drawn with shadow maps and light clusters of renderer
+	if (shadowPass)
+		shadowPass->bind(scene);
+	if (lightClusters)
+		scene->setLightClusters(lightClusters);
+
+	// skinned meshes of visible models (once per frame, shared by shadow, depth and color passes, record threads are idle before passes)
+	if (skinning)
+		skinning->update(commandBuffer, scene, frameIndex, recordThreadPool);
+
+	// debug lines of models with visible debug (missing lines are generated before render queue is built, none without debug geometry)
+	if (debugGeometry)
+		debugGeometry->update(commandBuffer, scene);
+
+	// scene before render pass
+	scene->update(commandBuffer);
+
+	// VkMemoryBarrier - updated uniforms visible to shaders
+	memoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	memoryBarrier.dstAccessMask = VK_ACCESS_UNIFORM_READ_BIT;
+	vkCmdPipelineBarrier(commandBuffer.commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_GRAPHICS_BIT, 0, 1, &memoryBarrier, 0, VK_NULL_HANDLE, 0, VK_NULL_HANDLE);
+}
+
+// VulkanRenderer::presentSubPass
+void VulkanRenderer::presentSubPass(VulkanCommandBuffer& commandBuffer, VulkanScene* scene)
+{
+	// bind scene and draw data to shader
+	scene->bind(commandBuffer);
+	bindDrawBuffers(commandBuffer);
+	// draw sorted render queue
+	submitRenderQueue(commandBuffer, 0, renderQueue.batchesCount(), VK_FALSE, renderQueueStats);
+}
+
+// VulkanRenderer::presentDepthSubPass
+void VulkanRenderer::presentDepthSubPass(VulkanCommandBuffer& commandBuffer, VulkanScene* scene)
+{
+	// bind scene and draw data to shader
+	scene->bind(commandBuffer);
+	bindDrawBuffers(commandBuffer);
+	// draw sorted render queue depth only (same order and instances as color subpass)
+	submitRenderQueue(commandBuffer, 0, renderQueue.batchesCount(), VK_TRUE, renderQueueStats);
+}
+
+// VulkanRenderer::presentShadowPass
+void VulkanRenderer::presentShadowPass(VulkanCommandBuffer& commandBuffer, VulkanScene* scene, uint32_t frameIndex)
+{
+	// casters into shadow maps of renderers with shadow pass
+	if (shadowPass)
+		shadowPass->present(commandBuffer, scene, frameIndex, drawInstancing);
+}
+
+// VulkanRenderer::presentResolveSubPass
+void VulkanRenderer::presentResolveSubPass(VulkanCommandBuffer& commandBuffer, VulkanScene* scene, const VkRenderPassBeginInfo& renderPassBeginInfo)
+{
+}
+
+// VulkanRenderer::afterRenderPass
+void VulkanRenderer::afterRenderPass(VulkanCommandBuffer& commandBuffer, VulkanScene* scene)
+{
+}
+
+// VulkanRenderer::presentRenderPass
+void VulkanRenderer::presentRenderPass(VulkanCommandBuffer& commandBuffer, VulkanScene* scene, const VkRenderPassBeginInfo& renderPassBeginInfo, uint32_t frameIndex)
+{
+	// build and sort render queue, write its draw buffers
+	VkBool32 depthPrepassUsed = depthPrepass && depthPrepass->isUsed();
+	buildRenderQueue(scene);
+	writeDrawBuffers(scene, frameIndex);
+	renderQueueStats = {};
+	renderQueueStats.simplifiedCount = lodSimplifiedCount;
+	renderQueueStats.clusteredCount = clusteredCount;
+	if (shadowPass) {
+		renderQueueStats.shadowDrawsCount = shadowPass->getDrawsCount();
+		renderQueueStats.shadowCachedCount = shadowPass->getCachedCount();
+	}
+	if (frustumCulled) {
+		renderQueueStats.visibleCount = frustumCulling.getVisibleCount();
+		renderQueueStats.culledCount = frustumCulling.getCulledCount();
+	}
+
+	// draw calls to record (one per batch with multi draw or draw count, one per command otherwise)
+	VkBool32 drawCallPerBatch = drawIndirectUsed && (drawIndirectInfo.countBuffer || drawIndirectInfo.multiDrawIndirect);
+	size_t drawCallsCount = drawCallPerBatch ? renderQueue.batchesCount() : renderQueue.commandsCount();
+
+	// record threads count (few draw calls are recorded inline, threads record whole batches)
+	size_t threadsCount = std::min((size_t)recordThreadsCount, drawCallsCount / recordThreadDrawCallsMin);
+	threadsCount = std::min(threadsCount, renderQueue.batchesCount());
+	if (threadsCount <= 1 || recordCommandBuffers.empty()) {
+		// record inline (depth pre-pass is first subpass)
+		vkCmdBeginRenderPass(commandBuffer.commandBuffer, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
+		setDynamicState(commandBuffer, renderPassBeginInfo.renderArea.extent);
+		if (depthPrepassUsed) {
+			presentDepthSubPass(commandBuffer, scene);
+			vkCmdNextSubpass(commandBuffer.commandBuffer, VK_SUBPASS_CONTENTS_INLINE);
+		}
+		presentSubPass(commandBuffer, scene);
+		presentResolveSubPass(commandBuffer, scene, renderPassBeginInfo);
+		vkCmdEndRenderPass(commandBuffer.commandBuffer);
+		return;
+	}
+
+	// record render queue ranges into secondary command buffers on record threads (each thread records its range of all subpasses)
+	uint32_t subpassCount = depthPrepassUsed ? 2 : 1;
+	std::vector<size_t> rangeFirsts;
+	renderQueue.splitBatches(threadsCount, !drawCallPerBatch, rangeFirsts);
+	std::vector<VkCommandBuffer> secondaryCommandBuffers(threadsCount * subpassCount);
+	std::vector<VulkanRenderQueueStats> secondaryStats(threadsCount);
+	for (size_t threadIndex = 0; threadIndex < threadsCount; threadIndex++) {
+		// frame is complete on device - reset its command pool
+		size_t recordIndex = frameIndex * recordThreadsCount + threadIndex;
+		VKT_CHECK(vkResetCommandPool(context.device.device, recordCommandPools[recordIndex], 0));
+		for (uint32_t subpass = 0; subpass < subpassCount; subpass++)
+			secondaryCommandBuffers[subpass * threadsCount + threadIndex] = recordCommandBuffers[recordIndex * VULKAN_RENDERER_MAX_SUBPASSES + subpass].commandBuffer;
+
+		// render queue batches range of similar draw calls count
+		size_t first = rangeFirsts[threadIndex];
+		size_t count = rangeFirsts[threadIndex + 1] - first;
+		VulkanCommandBuffer* secondaryCommandBuffer = &recordCommandBuffers[recordIndex * VULKAN_RENDERER_MAX_SUBPASSES];
+		VulkanRenderQueueStats& stats = secondaryStats[threadIndex];
+		recordThreadPool->push([this, secondaryCommandBuffer, scene, &renderPassBeginInfo, subpassCount, first, count, &stats]() {
+			for (uint32_t subpass = 0; subpass < subpassCount; subpass++)
+				recordSecondaryCommandBuffer(secondaryCommandBuffer[subpass], scene, renderPassBeginInfo, subpass, first, count, stats);
+		});
+	}
+	recordThreadPool->wait();
+	for (const auto& stats : secondaryStats)
+		vulkanRenderQueueStatsAdd(renderQueueStats, stats);
+
+	// execute secondary command buffers of each subpass
+	vkCmdBeginRenderPass(commandBuffer.commandBuffer, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+	for (uint32_t subpass = 0; subpass < subpassCount; subpass++) {
+		if (subpass)
+			vkCmdNextSubpass(commandBuffer.commandBuffer, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+		vkCmdExecuteCommands(commandBuffer.commandBuffer, (uint32_t)threadsCount, &secondaryCommandBuffers[subpass * threadsCount]);
+	}
+	presentResolveSubPass(commandBuffer, scene, renderPassBeginInfo);
+	vkCmdEndRenderPass(commandBuffer.commandBuffer);
+}
+
+// VulkanRenderer::presentOcclusionRenderPass
+void VulkanRenderer::presentOcclusionRenderPass(VulkanCommandBuffer& commandBuffer, VulkanScene* scene, const VkRenderPassBeginInfo& renderPassBeginInfo, VkImageView depthImageView)
+{
+	// reduce depth of first phase and cull draws which were not drawn against it
+	occlusionCulling->record(commandBuffer, *drawCulling, drawFrameIndex, scene, depthImageView);
+
+	// draw newly visible batches inline (same batches with second phase commands and instances)
+	VulkanDrawIndirectInfo indirectInfo = drawIndirectInfo;
+	VkDescriptorSet descriptorSet = drawDescriptorSet;
+	drawIndirectInfo = occlusionCulling->getIndirectInfo();
+	drawDescriptorSet = occlusionCulling->getDrawDescriptorSet();
+	vkCmdBeginRenderPass(commandBuffer.commandBuffer, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
+	setDynamicState(commandBuffer, renderPassBeginInfo.renderArea.extent);
+	presentSubPass(commandBuffer, scene);
+	vkCmdEndRenderPass(commandBuffer.commandBuffer);
+	drawIndirectInfo = indirectInfo;
+	drawDescriptorSet = descriptorSet;
+}
+
+// VulkanRenderer::recordSecondaryCommandBuffer
+void VulkanRenderer::recordSecondaryCommandBuffer(VulkanCommandBuffer& commandBuffer, VulkanScene* scene, const VkRenderPassBeginInfo& renderPassBeginInfo, uint32_t subpass, size_t first, size_t count, VulkanRenderQueueStats& stats)
+{
+	// VkCommandBufferInheritanceInfo
+	VkCommandBufferInheritanceInfo commandBufferInheritanceInfo{};
+	commandBufferInheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+	commandBufferInheritanceInfo.pNext = VK_NULL_HANDLE;
+	commandBufferInheritanceInfo.renderPass = renderPassBeginInfo.renderPass;
+	commandBufferInheritanceInfo.subpass = subpass;
+	commandBufferInheritanceInfo.framebuffer = renderPassBeginInfo.framebuffer;
+	commandBufferInheritanceInfo.occlusionQueryEnable = VK_FALSE;
+	commandBufferInheritanceInfo.queryFlags = 0;
+	commandBufferInheritanceInfo.pipelineStatistics = pipelineStatisticsQueryPool ? VULKAN_PIPELINE_STATISTICS_FLAGS : 0;
+
+	// VkCommandBufferBeginInfo
+	VkCommandBufferBeginInfo commandBufferBeginInfo{};
+	commandBufferBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	commandBufferBeginInfo.pNext = VK_NULL_HANDLE;
+	commandBufferBeginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+	commandBufferBeginInfo.pInheritanceInfo = &commandBufferInheritanceInfo;
+	VKT_CHECK(vkBeginCommandBuffer(commandBuffer.commandBuffer, &commandBufferBeginInfo));
+
+	// dynamic state and bindings are not inherited from primary command buffer
+	setDynamicState(commandBuffer, renderPassBeginInfo.renderArea.extent);
+	scene->bind(commandBuffer);
+	bindDrawBuffers(commandBuffer);
+	submitRenderQueue(commandBuffer, first, count, depthPrepass && depthPrepass->isUsed() && subpass == 0, stats);
+
+	// end command buffer
+	VKT_CHECK(vkEndCommandBuffer(commandBuffer.commandBuffer));
+}
+
+// VulkanRenderer::setDynamicState
+void VulkanRenderer::setDynamicState(VulkanCommandBuffer& commandBuffer, VkExtent2D extent)
+{
+	// VkViewport
+	VkViewport viewport{};
+	viewport.x = 0.0f;
+	viewport.y = (float)extent.height;
+	viewport.width = (float)extent.width;
+	viewport.height = -(float)extent.height;
+	viewport.minDepth = 0.0f;
+	viewport.maxDepth = 1.0f;
+	vkCmdSetViewport(commandBuffer.commandBuffer, 0, 1, &viewport);
+
+	// VkRect2D (scissor)
+	VkRect2D scissor{};
+	scissor.offset = { 0, 0 };
+	scissor.extent = extent;
+	vkCmdSetScissor(commandBuffer.commandBuffer, 0, 1, &scissor);
+
+	// set line width
+	vkCmdSetLineWidth(commandBuffer.commandBuffer, 1.0f);
+}
+
+// VulkanRenderer::buildRenderQueue
+void VulkanRenderer::buildRenderQueue(VulkanScene* scene)
+{
+	// cull meshes on host
+	cullRenderQueue(scene);
+
+	// one packet per visible mesh (bounding volumes are pushed in same order by cullRenderQueue)
+	uint32_t boundsIndex = 0;
+	renderQueue.clear();
+	lodSimplifiedCount = 0;
+	clusteredCount = 0;
+	// depth subpass pipelines of packets (depth pre-pass of frame)
+	VkBool32 depthPrepassUsed = depthPrepass && depthPrepass->isUsed();
+	// meshlets are culled only on compute queue (host culling tests whole meshes) and drawn by multi draws
+	VkBool32 clustersCulled = drawClusters && drawCull && !frustumCulled && context.device.physicalDeviceFeaturesEnabled.multiDrawIndirect;
+	// pixels per view space unit at unit distance (first view)
+	float lodScale = glm::abs(scene->matrixProjection[1][1]) * 0.5f * (float)getRenderHeight();
+	for (auto& model : scene->models) {
+		// model depth in first view (front to back within same state)
+		glm::vec4 position = scene->matrixView * model->matrixModel[3];
+		float depth = -position.z;
+		// largest axis scale of model (model space errors and radii to view space)
+		float modelScale = glm::max(glm::max(
+			glm::length(glm::vec3(model->matrixModel[0])),
+			glm::length(glm::vec3(model->matrixModel[1]))),
+			glm::length(glm::vec3(model->matrixModel[2])));
+		// meshes and debug meshes
+		for (VulkanDrawPass pass : { VULKAN_DRAW_PASS_OPAQUE, VULKAN_DRAW_PASS_DEBUG }) {
+			if (pass == VULKAN_DRAW_PASS_OPAQUE && !model->visible) continue;
+			if (pass == VULKAN_DRAW_PASS_DEBUG && !model->visibleDebug) continue;
+			for (auto& mesh : pass == VULKAN_DRAW_PASS_OPAQUE ? model->meshes : model->meshes_debug) {
+				assert(mesh->primitiveTopology != VK_PRIMITIVE_TOPOLOGY_POINT_LIST);
+				assert(mesh->primitiveTopology != VK_PRIMITIVE_TOPOLOGY_PATCH_LIST);
+				if (frustumCulled && !frustumCulling.isVisible(boundsIndex++)) continue;
+				// VulkanDrawPacket
+				VulkanDrawPacket packet{};
+				packet.pipeline = getMeshPipeline(mesh);
+				packet.pipelineDepth = depthPrepassUsed ? depthPrepass->getDepthPipeline(mesh) : VK_NULL_HANDLE;
+				packet.descriptorSetMaterial = mesh->material ? mesh->material->getDescriptorSet() : VK_NULL_HANDLE;
+				packet.drawInfo = mesh->drawInfo;
+				packet.drawData.model = model->matrixModel;
+				packet.drawData.materialId = mesh->material ? mesh->material->getMaterialId() : 0;
+				// level of detail from distance to bounding sphere (full resolution inside sphere)
+				uint32_t lod = 0;
+				if (drawLod && mesh->lodsCount > 1) {
+					glm::vec4 center = scene->matrixView * model->matrixModel * glm::vec4(glm::vec3(mesh->drawInfo.boundingSphere), 1.0f);
+					float distance = glm::length(glm::vec3(center)) - mesh->drawInfo.boundingSphere.w * modelScale;
+					if (distance > 0.0f)
+						lod = mesh->selectLod(lodScale * modelScale / distance, lodPixelError);
+				}
+				if (lod) {
+					const VulkanMeshLod& meshLod = mesh->lods[lod];
+					packet.drawInfo.firstVertex = meshLod.firstVertex;
+					packet.drawInfo.vertexCount = meshLod.vertexCount;
+					packet.drawInfo.firstIndex = meshLod.firstIndex;
+					packet.drawInfo.indexCount = meshLod.indexCount;
+					lodSimplifiedCount++;
+				}
+				// same levels of same mesh are adjacent (merged into instances)
+				packet.key = VulkanRenderQueue::makeKey(pass,
+					mesh->materialUsage * VK_PRIMITIVE_TOPOLOGY_RANGE_SIZE + mesh->primitiveTopology,
+					mesh->material ? mesh->material->getMaterialId() : 0,
+					mesh->drawInfo.meshId * VULKAN_MESH_MAX_LODS + lod, depth);
+				// full resolution as meshlets (bounding box of meshlet is box of its sphere, same meshlet of instances is merged)
+				if (clustersCulled && pass == VULKAN_DRAW_PASS_OPAQUE && lod == 0 && !mesh->meshlets.empty()) {
+					for (uint32_t meshletIndex = 0; meshletIndex < (uint32_t)mesh->meshlets.size(); meshletIndex++) {
+						const VulkanMeshlet& meshlet = mesh->meshlets[meshletIndex];
+						packet.key = VulkanRenderQueue::makeMeshletKey(pass,
+							mesh->materialUsage * VK_PRIMITIVE_TOPOLOGY_RANGE_SIZE + mesh->primitiveTopology,
+							mesh->material ? mesh->material->getMaterialId() : 0,
+							mesh->drawInfo.meshId * VULKAN_MESH_MAX_LODS, meshletIndex);
+						packet.drawInfo.firstVertex = meshlet.firstVertex;
+						packet.drawInfo.vertexCount = meshlet.vertexCount;
+						packet.drawInfo.firstIndex = meshlet.firstIndex;
+						packet.drawInfo.indexCount = meshlet.indexCount;
+						packet.drawInfo.boundingSphere = meshlet.boundingSphere;
+						packet.drawInfo.boundingBoxMin = glm::vec3(meshlet.boundingSphere) - meshlet.boundingSphere.w;
+						packet.drawInfo.boundingBoxMax = glm::vec3(meshlet.boundingSphere) + meshlet.boundingSphere.w;
+						packet.drawInfo.cone = meshlet.cone;
+						renderQueue.push(packet);
+					}
+					clusteredCount++;
+					continue;
+				}
+				renderQueue.push(packet);
+			}
+		}
+	}
+	// sort by state (and merge packets of same mesh into instanced commands)
+	renderQueue.sort(drawInstancing);
+}
+
+// VulkanRenderer::getMeshPipeline
+VkPipeline VulkanRenderer::getMeshPipeline(VulkanMeshMatObj* mesh)
+{
+	// color subpass pipeline (equal depth test after depth pre-pass)
+	return depthPrepass && depthPrepass->isUsed() ?
+		depthPrepass->getColorPipeline(mesh) :
+		pipeline_mesh_obj[mesh->materialUsage][mesh->primitiveTopology].pipeline;
+}
+
+// VulkanRenderer::cullRenderQueue
+void VulkanRenderer::cullRenderQueue(VulkanScene* scene)
+{
+	// host culling is fallback of compute culling (which needs indirect draws)
+	VkBool32 drawIndirectSupported = drawIndirect && context.device.physicalDeviceFeaturesEnabled.drawIndirectFirstInstance;
+	frustumCulled = drawCull && !(drawIndirectSupported && drawCulling);
+	if (!frustumCulled) return;
+
+	// bounding volumes of meshes in render queue order, tested in SIMD batches
+	frustumCulling.begin(scene);
+	for (auto& model : scene->models) {
+		for (VulkanDrawPass pass : { VULKAN_DRAW_PASS_OPAQUE, VULKAN_DRAW_PASS_DEBUG }) {
+			if (pass == VULKAN_DRAW_PASS_OPAQUE && !model->visible) continue;
+			if (pass == VULKAN_DRAW_PASS_DEBUG && !model->visibleDebug) continue;
+			for (auto& mesh : pass == VULKAN_DRAW_PASS_OPAQUE ? model->meshes : model->meshes_debug)
+				frustumCulling.push(model->matrixModel, mesh->drawInfo.boundingBoxMin, mesh->drawInfo.boundingBoxMax, mesh->drawInfo.boundingSphere);
+		}
+	}
+	frustumCulling.cull();
+}
+
+// VulkanRenderer::writeDrawBuffers
+void VulkanRenderer::writeDrawBuffers(VulkanScene* scene, uint32_t frameIndex)
+{
+	// grow frame buffers (frame is complete on device)
+	drawFrameIndex = frameIndex;
+	VkDeviceSize drawPacketsCount = std::max((VkDeviceSize)renderQueue.size(), (VkDeviceSize)1);
+	if (drawDataBuffers[frameIndex].size < drawPacketsCount * sizeof(VulkanDrawData)) {
+		drawPacketsCount = std::max(drawPacketsCount, drawDataBuffers[frameIndex].size / sizeof(VulkanDrawData) * 2);
+		vulkanBufferDestroy(context.device, drawCountBuffers[frameIndex]);
+		vulkanBufferDestroy(context.device, drawIndirectBuffers[frameIndex]);
+		vulkanBufferDestroy(context.device, drawDataBuffers[frameIndex]);
+		vulkanBufferCreateMapped(context.device, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, drawPacketsCount * sizeof(VulkanDrawData), &drawDataBuffers[frameIndex]);
+		vulkanBufferCreateMapped(context.device, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, drawPacketsCount * VULKAN_DRAW_INDIRECT_STRIDE, &drawIndirectBuffers[frameIndex]);
+		vulkanBufferCreateMapped(context.device, VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, drawPacketsCount * sizeof(uint32_t), &drawCountBuffers[frameIndex]);
+		vulkanDescriptorSetUpdateBufferStorage(context.device, drawDescriptorSets[frameIndex], drawDataBuffers[frameIndex], 0);
+	}
+
+	// write draw data (one per instance), indirect commands and draw counts (commands and batches never exceed packets)
+	renderQueue.writeDrawData((VulkanDrawData*)drawDataBuffers[frameIndex].allocationInfo.pMappedData);
+	renderQueue.writeIndirectCommands(
+		(VkDrawIndexedIndirectCommand*)drawIndirectBuffers[frameIndex].allocationInfo.pMappedData,
+		(uint32_t*)drawCountBuffers[frameIndex].allocationInfo.pMappedData);
+	vmaFlushAllocation(context.device.allocator, drawDataBuffers[frameIndex].allocation, 0, VK_WHOLE_SIZE);
+	vmaFlushAllocation(context.device.allocator, drawIndirectBuffers[frameIndex].allocation, 0, VK_WHOLE_SIZE);
+	vmaFlushAllocation(context.device.allocator, drawCountBuffers[frameIndex].allocation, 0, VK_WHOLE_SIZE);
+
+	// indirect draws need first instance in commands (draw data index)
+	drawIndirectUsed = drawIndirect && context.device.physicalDeviceFeaturesEnabled.drawIndirectFirstInstance;
+	drawIndirectInfo.indirectBuffer = drawIndirectBuffers[frameIndex].buffer;
+	drawIndirectInfo.countBuffer = context.device.drawIndirectCountEnabled ? drawCountBuffers[frameIndex].buffer : VK_NULL_HANDLE;
+	drawIndirectInfo.fnCmdDrawIndirectCountKHR = context.device.fnCmdDrawIndirectCountKHR;
+	drawIndirectInfo.fnCmdDrawIndexedIndirectCountKHR = context.device.fnCmdDrawIndexedIndirectCountKHR;
+	drawIndirectInfo.multiDrawIndirect = context.device.physicalDeviceFeaturesEnabled.multiDrawIndirect;
+	drawDescriptorSet = drawDescriptorSets[frameIndex].descriptorSet;
+
+	// cull instances on compute queue (visible instances are compacted per command, visible commands when draw counts come from buffer)
+	VkBool32 occlusionUsed = occlusionCulling && occlusionCulling->isUsed();
+	if (drawIndirectUsed && drawCull && drawCulling) {
+		drawCulling->record(frameIndex, scene, renderQueue, drawDataBuffers[frameIndex], drawIndirectBuffers[frameIndex], context.device.drawIndirectCountEnabled, occlusionUsed);
+		drawIndirectInfo.indirectBuffer = drawCulling->getIndirectBuffer(frameIndex);
+		drawIndirectInfo.countBuffer = context.device.drawIndirectCountEnabled ? drawCulling->getCountBuffer(frameIndex) : VK_NULL_HANDLE;
+		drawDescriptorSet = drawCulling->getDrawDescriptorSet(frameIndex);
+	}
+
+	// second phase commands and instances of occlusion culling
+	if (occlusionUsed)
+		occlusionCulling->setDrawBuffers(*drawCulling, frameIndex, drawIndirectInfo);
+}
+
+// VulkanRenderer::bindDrawBuffers
+void VulkanRenderer::bindDrawBuffers(VulkanCommandBuffer& commandBuffer)
+{
+	// bind draw data descriptor set
+	vkCmdBindDescriptorSets(commandBuffer.commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, context.pipelineLayout.pipelineLayout, 3, 1, &drawDescriptorSet, 0, VK_NULL_HANDLE);
+}
+
+// VulkanRenderer::submitRenderQueue
+void VulkanRenderer::submitRenderQueue(VulkanCommandBuffer& commandBuffer, size_t first, size_t count, VkBool32 depthOnly, VulkanRenderQueueStats& stats)
+{
+	// record batches (indirect or direct draws)
+	renderQueue.submit(commandBuffer, context.pipelineLayout.pipelineLayout, first, count, drawIndirectUsed ? &drawIndirectInfo : nullptr, depthOnly, stats);
+}
+
+// VulkanRenderer::submitDrawCulling
+VkSemaphore VulkanRenderer::submitDrawCulling(uint32_t frameIndex)
+{
+	// culling is recorded with render queue
+	return drawCulling ? drawCulling->submit(frameIndex) : VK_NULL_HANDLE;
+}
+
+// VulkanRenderer::beginOcclusionCulling
+VkBool32 VulkanRenderer::beginOcclusionCulling(VulkanScene* scene)
+{
+	// second phase culls on graphics queue with compute culling pipelines (needs indirect draws, depth pre-pass replaces it)
+	if (!occlusionCulling)
+		return VK_FALSE;
+	VkBool32 drawIndirectSupported = drawIndirect && context.device.physicalDeviceFeaturesEnabled.drawIndirectFirstInstance;
+	VkBool32 depthPrepassUsed = depthPrepass && depthPrepass->isUsed();
+	return occlusionCulling->begin(scene, drawOcclusion && !depthPrepassUsed && drawIndirectSupported && drawCull && drawCulling);
+}
+
+// VulkanRenderer::beginPipelineStatistics
+void VulkanRenderer::beginPipelineStatistics(VulkanCommandBuffer& commandBuffer, uint32_t frameIndex)
+{
+	// pipeline statistics are not supported
+	if (!pipelineStatisticsQueryPool)
+		return;
+
+	// previous results of frame (frame is complete on device)
+	if (pipelineStatisticsQueried[frameIndex]) {
+		VkResult result = vkGetQueryPoolResults(context.device.device, pipelineStatisticsQueryPool, frameIndex, 1,
+			sizeof(VulkanPipelineStatistics), &pipelineStatistics, sizeof(VulkanPipelineStatistics), VK_QUERY_RESULT_64_BIT);
+		assert(result == VK_SUCCESS || result == VK_NOT_READY);
+	}
+
+	// begin query of frame (outside of render passes)
+	vkCmdResetQueryPool(commandBuffer.commandBuffer, pipelineStatisticsQueryPool, frameIndex, 1);
+	vkCmdBeginQuery(commandBuffer.commandBuffer, pipelineStatisticsQueryPool, frameIndex, 0);
+	pipelineStatisticsQueried[frameIndex] = VK_TRUE;
+}
+
+// VulkanRenderer::endPipelineStatistics
+void VulkanRenderer::endPipelineStatistics(VulkanCommandBuffer& commandBuffer, uint32_t frameIndex)
+{
+	// end query of frame
+	if (pipelineStatisticsQueryPool)
+		vkCmdEndQuery(commandBuffer.commandBuffer, pipelineStatisticsQueryPool, frameIndex);
+}
+
+// VulkanRenderer::getRenderQueueStats
+const VulkanRenderQueueStats& VulkanRenderer::getRenderQueueStats() const
+{
+	return renderQueueStats;
+}
+
+// VulkanRenderer::getPipelineStatistics
+const VulkanPipelineStatistics& VulkanRenderer::getPipelineStatistics() const
+{
+	return pipelineStatistics;
+}
+
+// VulkanRenderer_default::VulkanRenderer_default
+VulkanRenderer_default::VulkanRenderer_default(
+	VulkanContext& context,
+	VulkanSurface& surface,
+	const VulkanSwapchainConfig& swapchainConfig) :
+	VulkanRenderer_default(context, surface, swapchainConfig, VK_TRUE)
+{
+}
 
 // VulkanRenderer_default::VulkanRenderer_default
 VulkanRenderer_default::VulkanRenderer_default(
 	VulkanContext& context,
-	VulkanSurface& surface) :
-	VulkanRenderer(context, surface)
+	VulkanSurface& surface,
+	const VulkanSwapchainConfig& swapchainConfig,
+	VkBool32 forwardPasses) :
+	VulkanRenderer(context),
+	surface(surface)
 {
+	// create forward passes (render passes with depth only subpass, of occlusion phases and of particles, depth pyramid are created with them)
+	if (forwardPasses) {
+		depthPrepass = new VulkanDepthPrepass(context);
+		occlusionCulling = new VulkanOcclusionCulling(context);
+		particles = new VulkanParticles(context);
+	}
+	// create dynamic resolution (render scale of render targets follows measured frame time when enabled)
+	dynamicResolution = new VulkanDynamicResolution(context);
+	// create frame latency (application samples input after queued frames are within limit)
+	frameLatency = new VulkanFrameLatency(context);
+
 	// create swapchain
+	swapchain.config = swapchainConfig;
 	createSwapchain();
 	createImages();
-	createRenderPass();
-	createFramebuffers();
+	createRenderPasses();
+	createFramebuffers(renderPass, framebuffers);
+	if (depthPrepass)
+		createFramebuffers(renderPass_depthPrepass, framebuffers_depthPrepass);
 	createCommandBuffers();
+	createRecordCommandBuffers(framesCount);
+	createDrawBuffers(framesCount);
 	createSemaphores();
+	if (dynamicResolution)
+		dynamicResolution->createQueries(framesCount);
+	if (frameLatency)
+		frameLatency->setFramesCount(framesCount);
 	createShaders();
-	createPipelines();
+	createPipelines(renderPass);
+	if (depthPrepass)
+		depthPrepass->createPipelines(renderPass_depthPrepass, shader_mesh_obj);
+	if (particles)
+		particles->createDrawPipeline(renderPass_particles);
+	// create shadow pass (cascaded shadow maps of scenes with shadows)
+	shadowPass = new VulkanShadowPass(context, VULKAN_RENDERER_SHADOW_MAP_SIZE, VULKAN_SHADOW_MAX_CASCADES);
+	// create light clusters (clustered point lights of scenes)
+	lightClusters = new VulkanLightClusters(context);
+	// create skinning (animators evaluated on record threads, skinned meshes written into geometry pool before passes)
+	skinning = new VulkanSkinning(context);
+	// create debug geometry (debug lines of meshes generated when shown)
+	debugGeometry = new VulkanDebugGeometry(context);
 }
 
 // VulkanRenderer_default::~VulkanRenderer_default
 VulkanRenderer_default::~VulkanRenderer_default()
 {
+	// queued frames are complete on device
+	waitFrames();
+
 	// destroy handles
+	delete particles;
+	delete dynamicResolution;
+	delete frameLatency;
 	destroyPipelines();
 	destroyShaders();
 	destroySemaphores();
+	destroyDrawBuffers();
+	destroyRecordCommandBuffers();
 	destroyCommandBuffers();
-	destroyFramebuffers();
-	destroyRenderPass();
+	destroyFramebuffers(framebuffers_depthPrepass);
+	destroyFramebuffers(framebuffers);
+	destroyRenderPasses();
 	destroyImages();
 	destroySwapchain();
 }
 
-// VulkanRenderer_default::createSwapchain
-void VulkanRenderer_default::createSwapchain() {
-	// create swapchain
-	vulkanSwapchainCreate(context.device, surface, &swapchain);
-	// get frames count
-	framesCount = (uint32_t)swapchain.images.size();
-}
+// VulkanRenderer_default::createSwapchain
+void VulkanRenderer_default::createSwapchain() {
+	// create swapchain (present mode and images count of config)
+	vulkanSwapchainCreate(context.device, surface, swapchain.config, &swapchain);
+	// get frames count
+	framesCount = (uint32_t)swapchain.images.size();
+}
+
+// VulkanRenderer_default::createImages
+void VulkanRenderer_default::createImages() {
+	// swapchain images that can not be blitted to are rendered to at swapchain extent
+	if (dynamicResolution && !(swapchain.imageUsage & VK_IMAGE_USAGE_TRANSFER_DST_BIT))
+		dynamicResolution->reset();
+	// render extent of render scale (swapchain extent without dynamic resolution)
+	float renderScale = getRenderScale();
+	renderExtent.width = std::max(1U, (uint32_t)(swapchain.surfaceCapabilities.currentExtent.width * renderScale + 0.5f));
+	renderExtent.height = std::max(1U, (uint32_t)(swapchain.surfaceCapabilities.currentExtent.height * renderScale + 0.5f));
+	// render extent of swapchain extent renders into acquired swapchain images (no color attachments of frames)
+	renderToSwapchain =
+		renderExtent.width == swapchain.surfaceCapabilities.currentExtent.width &&
+		renderExtent.height == swapchain.surfaceCapabilities.currentExtent.height;
+	// create swapchain image views
+	swapchainImageViews.resize(renderToSwapchain ? swapchain.images.size() : 0);
+	for (uint32_t i = 0; i < (uint32_t)swapchainImageViews.size(); i++) {
+		// VkImageViewCreateInfo
+		VkImageViewCreateInfo imageViewCreateInfo{};
+		imageViewCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+		imageViewCreateInfo.pNext = VK_NULL_HANDLE;
+		imageViewCreateInfo.flags = 0;
+		imageViewCreateInfo.image = swapchain.images[i];
+		imageViewCreateInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+		imageViewCreateInfo.format = swapchain.surfaceFormat.format;
+		imageViewCreateInfo.components.r = VK_COMPONENT_SWIZZLE_IDENTITY;
+		imageViewCreateInfo.components.g = VK_COMPONENT_SWIZZLE_IDENTITY;
+		imageViewCreateInfo.components.b = VK_COMPONENT_SWIZZLE_IDENTITY;
+		imageViewCreateInfo.components.a = VK_COMPONENT_SWIZZLE_IDENTITY;
+		imageViewCreateInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		imageViewCreateInfo.subresourceRange.baseMipLevel = 0;
+		imageViewCreateInfo.subresourceRange.levelCount = 1;
+		imageViewCreateInfo.subresourceRange.baseArrayLayer = 0;
+		imageViewCreateInfo.subresourceRange.layerCount = 1;
+		VKT_CHECK(vkCreateImageView(context.device.device, &imageViewCreateInfo, VK_NULL_HANDLE, &swapchainImageViews[i]));
+		assert(swapchainImageViews[i]);
+	}
+	// create color attachment images (upscaled into swapchain images)
+	uint32_t colorAttachmentsCount = renderToSwapchain ? 0 : framesCount;
+	colorAttachmentImages.resize(colorAttachmentsCount);
+	colorAttachmentAllocations.resize(colorAttachmentsCount);
+	for (uint32_t i = 0; i < colorAttachmentsCount; i++) {
+		// VkImageCreateInfo - color
+		VkImageCreateInfo imageCreateInfo{};
+		imageCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+		imageCreateInfo.pNext = VK_NULL_HANDLE;
+		imageCreateInfo.flags = 0;
+		imageCreateInfo.imageType = VK_IMAGE_TYPE_2D;
+		imageCreateInfo.format = swapchain.surfaceFormat.format;
+		imageCreateInfo.extent.width = renderExtent.width;
+		imageCreateInfo.extent.height = renderExtent.height;
+		imageCreateInfo.extent.depth = 1;
+		imageCreateInfo.mipLevels = 1;
+		imageCreateInfo.arrayLayers = 1;
+		imageCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+		imageCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+		imageCreateInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+		imageCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+		imageCreateInfo.queueFamilyIndexCount = VK_QUEUE_FAMILY_IGNORED;
+		imageCreateInfo.pQueueFamilyIndices = VK_NULL_HANDLE;
+		imageCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+		// VmaAllocationCreateInfo
+		VmaAllocationCreateInfo allocCreateInfo{};
+		allocCreateInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+		allocCreateInfo.flags = 0;
 
-// VulkanRenderer_default::createImages
-void VulkanRenderer_default::createImages() {
+		// vmaCreateImage
+		VKT_CHECK(vmaCreateImage(context.device.allocator, &imageCreateInfo, &allocCreateInfo, &colorAttachmentImages[i], &colorAttachmentAllocations[i], VK_NULL_HANDLE));
+		assert(colorAttachmentImages[i]);
+		assert(colorAttachmentAllocations[i]);
+	}
 	// create color attachment image views
-	colorAttachmentImageViews.resize(framesCount);
-	for (uint32_t i = 0; i < framesCount; i++) {
+	colorAttachmentImageViews.resize(colorAttachmentsCount);
+	for (uint32_t i = 0; i < colorAttachmentsCount; i++) {
 		// VkImageViewCreateInfo
 		VkImageViewCreateInfo imageViewCreateInfo{};
 		imageViewCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
 		imageViewCreateInfo.pNext = VK_NULL_HANDLE;
 		imageViewCreateInfo.flags = 0;
-		imageViewCreateInfo.image = swapchain.images[i];
+		imageViewCreateInfo.image = colorAttachmentImages[i];
 		imageViewCreateInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
 		imageViewCreateInfo.format = swapchain.surfaceFormat.format;
 		imageViewCreateInfo.components.r = VK_COMPONENT_SWIZZLE_IDENTITY;
@@ -76,14 +897,14 @@ void VulkanRenderer_default::createImages() {
 		imageCreateInfo.flags = 0;
 		imageCreateInfo.imageType = VK_IMAGE_TYPE_2D;
 		imageCreateInfo.format = VK_FORMAT_D24_UNORM_S8_UINT; // must be the same as imageViewCreateInfo.format (see below)
-		imageCreateInfo.extent.width = swapchain.surfaceCapabilities.currentExtent.width;
-		imageCreateInfo.extent.height = swapchain.surfaceCapabilities.currentExtent.height;
+		imageCreateInfo.extent.width = renderExtent.width;
+		imageCreateInfo.extent.height = renderExtent.height;
 		imageCreateInfo.extent.depth = 1;
 		imageCreateInfo.mipLevels = 1;
 		imageCreateInfo.arrayLayers = 1;
 		imageCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT;
 		imageCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
-		imageCreateInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+		imageCreateInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
 		imageCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 		imageCreateInfo.queueFamilyIndexCount = VK_QUEUE_FAMILY_IGNORED;
 		imageCreateInfo.pQueueFamilyIndices = VK_NULL_HANDLE;
@@ -122,74 +943,221 @@ void VulkanRenderer_default::createImages() {
 		VKT_CHECK(vkCreateImageView(context.device.device, &imageViewCreateInfo, VK_NULL_HANDLE, &depthStencilAttachmentImageViews[i]));
 		assert(depthStencilAttachmentImageViews[i]);
 	}
+	// create depth attachment image views (sampled views have single aspect)
+	depthAttachmentImageViews.resize(framesCount);
+	for (uint32_t i = 0; i < framesCount; i++) {
+		// VkImageViewCreateInfo
+		VkImageViewCreateInfo imageViewCreateInfo{};
+		imageViewCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+		imageViewCreateInfo.pNext = VK_NULL_HANDLE;
+		imageViewCreateInfo.flags = 0;
+		imageViewCreateInfo.image = depthStencilAttachmentImages[i];
+		imageViewCreateInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+		imageViewCreateInfo.format = VK_FORMAT_D24_UNORM_S8_UINT;
+		imageViewCreateInfo.components.r = VK_COMPONENT_SWIZZLE_IDENTITY;
+		imageViewCreateInfo.components.g = VK_COMPONENT_SWIZZLE_IDENTITY;
+		imageViewCreateInfo.components.b = VK_COMPONENT_SWIZZLE_IDENTITY;
+		imageViewCreateInfo.components.a = VK_COMPONENT_SWIZZLE_IDENTITY;
+		imageViewCreateInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+		imageViewCreateInfo.subresourceRange.baseMipLevel = 0;
+		imageViewCreateInfo.subresourceRange.levelCount = 1;
+		imageViewCreateInfo.subresourceRange.baseArrayLayer = 0;
+		imageViewCreateInfo.subresourceRange.layerCount = 1;
+		VKT_CHECK(vkCreateImageView(context.device.device, &imageViewCreateInfo, VK_NULL_HANDLE, &depthAttachmentImageViews[i]));
+		assert(depthAttachmentImageViews[i]);
+	}
+	// create depth pyramid of occlusion culling (depth of render extent)
+	if (occlusionCulling)
+		occlusionCulling->createDepthPyramid(renderExtent.width, renderExtent.height);
 }
 
 // VulkanRenderer_default::createRenderPass
-void VulkanRenderer_default::createRenderPass() {
+void VulkanRenderer_default::createRenderPass(
+	VkRenderPass*              renderPass,
+	VkAttachmentLoadOp         loadOp,
+	VkImageLayout              colorInitialLayout,
+	VkImageLayout              colorFinalLayout,
+	VkImageLayout              depthInitialLayout,
+	VkImageLayout              depthFinalLayout,
+	VkBool32                   depthPrepass,
+	uint32_t                   dependencyCount,
+	const VkSubpassDependency* dependencies) {
 	// VkAttachmentDescription - color
 	std::array<VkAttachmentDescription, 2> attachmentDescriptions;
 	// color attachment
 	attachmentDescriptions[0].flags = 0;
 	attachmentDescriptions[0].format = swapchain.surfaceFormat.format;
 	attachmentDescriptions[0].samples = VK_SAMPLE_COUNT_1_BIT;
-	attachmentDescriptions[0].loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+	attachmentDescriptions[0].loadOp = loadOp;
 	attachmentDescriptions[0].storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-	attachmentDescriptions[0].stencilLoadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+	attachmentDescriptions[0].stencilLoadOp = loadOp;
 	attachmentDescriptions[0].stencilStoreOp = VK_ATTACHMENT_STORE_OP_STORE;
-	attachmentDescriptions[0].initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-	attachmentDescriptions[0].finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+	attachmentDescriptions[0].initialLayout = colorInitialLayout;
+	attachmentDescriptions[0].finalLayout = colorFinalLayout;
 	// depth-stencil attachment
 	attachmentDescriptions[1].flags = 0;
 	attachmentDescriptions[1].format = VK_FORMAT_D24_UNORM_S8_UINT;
 	attachmentDescriptions[1].samples = VK_SAMPLE_COUNT_1_BIT;
-	attachmentDescriptions[1].loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+	attachmentDescriptions[1].loadOp = loadOp;
 	attachmentDescriptions[1].storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-	attachmentDescriptions[1].stencilLoadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+	attachmentDescriptions[1].stencilLoadOp = loadOp;
 	attachmentDescriptions[1].stencilStoreOp = VK_ATTACHMENT_STORE_OP_STORE;
-	attachmentDescriptions[1].initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-	attachmentDescriptions[1].finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+	attachmentDescriptions[1].initialLayout = depthInitialLayout;
+	attachmentDescriptions[1].finalLayout = depthFinalLayout;
 
 	// VkAttachmentReference - color
 	std::array<VkAttachmentReference, 1> colorAttachmentReferences;
 	colorAttachmentReferences[0].attachment = 0;
 	colorAttachmentReferences[0].layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
 
-	// VkAttachmentReference - depth-stencil
-	VkAttachmentReference depthStencilAttachmentReference{};
-	depthStencilAttachmentReference.attachment = 1;
-	depthStencilAttachmentReference.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+	// VkAttachmentReference - depth-stencil (color subpass after depth pre-pass only reads depth)
+	std::array<VkAttachmentReference, 2> depthStencilAttachmentReferences;
+	depthStencilAttachmentReferences[0].attachment = 1;
+	depthStencilAttachmentReferences[0].layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+	depthStencilAttachmentReferences[1].attachment = 1;
+	depthStencilAttachmentReferences[1].layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
 
-	// VkSubpassDescription - subpassDescriptions
-	std::array<VkSubpassDescription, 1> subpassDescriptions;
+	// VkSubpassDescription - subpassDescriptions (depth only subpass is first with depth pre-pass)
+	std::array<VkSubpassDescription, 2> subpassDescriptions;
+	// depth only subpass
 	subpassDescriptions[0].flags = 0;
 	subpassDescriptions[0].pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
 	subpassDescriptions[0].inputAttachmentCount = 0;
 	subpassDescriptions[0].pInputAttachments = VK_NULL_HANDLE;
-	subpassDescriptions[0].colorAttachmentCount = (uint32_t)colorAttachmentReferences.size();
-	subpassDescriptions[0].pColorAttachments = colorAttachmentReferences.data();
+	subpassDescriptions[0].colorAttachmentCount = 0;
+	subpassDescriptions[0].pColorAttachments = VK_NULL_HANDLE;
 	subpassDescriptions[0].pResolveAttachments = VK_NULL_HANDLE;
-	subpassDescriptions[0].pDepthStencilAttachment = &depthStencilAttachmentReference;
+	subpassDescriptions[0].pDepthStencilAttachment = &depthStencilAttachmentReferences[0];
 	subpassDescriptions[0].preserveAttachmentCount = 0;
 	subpassDescriptions[0].pPreserveAttachments = VK_NULL_HANDLE;
+	// color subpass
+	subpassDescriptions[1].flags = 0;
+	subpassDescriptions[1].pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+	subpassDescriptions[1].inputAttachmentCount = 0;
+	subpassDescriptions[1].pInputAttachments = VK_NULL_HANDLE;
+	subpassDescriptions[1].colorAttachmentCount = (uint32_t)colorAttachmentReferences.size();
+	subpassDescriptions[1].pColorAttachments = colorAttachmentReferences.data();
+	subpassDescriptions[1].pResolveAttachments = VK_NULL_HANDLE;
+	subpassDescriptions[1].pDepthStencilAttachment = &depthStencilAttachmentReferences[depthPrepass ? 1 : 0];
+	subpassDescriptions[1].preserveAttachmentCount = 0;
+	subpassDescriptions[1].pPreserveAttachments = VK_NULL_HANDLE;
+
+	// VkSubpassDependency - subpassDependencies (color subpass tests depth written by depth only subpass)
+	std::vector<VkSubpassDependency> subpassDependencies(dependencies, dependencies + dependencyCount);
+	if (depthPrepass) {
+		VkSubpassDependency subpassDependency{};
+		subpassDependency.srcSubpass = 0;
+		subpassDependency.dstSubpass = 1;
+		subpassDependency.srcStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+		subpassDependency.dstStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+		subpassDependency.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+		subpassDependency.dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT;
+		subpassDependency.dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
+		subpassDependencies.push_back(subpassDependency);
+	}
+
+	// VkSubpassDependency - color attachment of undefined layout may be acquired swapchain image (transition after acquire wait of frame)
+	if (colorInitialLayout == VK_IMAGE_LAYOUT_UNDEFINED) {
+		VkSubpassDependency subpassDependency{};
+		subpassDependency.srcSubpass = VK_SUBPASS_EXTERNAL;
+		subpassDependency.dstSubpass = depthPrepass ? 1 : 0;
+		subpassDependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+		subpassDependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+		subpassDependency.srcAccessMask = 0;
+		subpassDependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+		subpassDependency.dependencyFlags = 0;
+		// depth-stencil attachment of same subpass has no implicit dependency anymore
+		if (!depthPrepass) {
+			subpassDependency.dstStageMask |= VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+			subpassDependency.dstAccessMask |= VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+		}
+		subpassDependencies.push_back(subpassDependency);
+	}
 
 	// VkRenderPassCreateInfo
 	VkRenderPassCreateInfo renderPassCreateInfo{};
 	renderPassCreateInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
 	renderPassCreateInfo.attachmentCount = (uint32_t)attachmentDescriptions.size();
 	renderPassCreateInfo.pAttachments = attachmentDescriptions.data();
-	renderPassCreateInfo.subpassCount = (uint32_t)subpassDescriptions.size();
-	renderPassCreateInfo.pSubpasses = subpassDescriptions.data();
-	VKT_CHECK(vkCreateRenderPass(context.device.device, &renderPassCreateInfo, VK_NULL_HANDLE, &renderPass));
-	assert(renderPass);
+	renderPassCreateInfo.subpassCount = depthPrepass ? 2 : 1;
+	renderPassCreateInfo.pSubpasses = depthPrepass ? &subpassDescriptions[0] : &subpassDescriptions[1];
+	renderPassCreateInfo.dependencyCount = (uint32_t)subpassDependencies.size();
+	renderPassCreateInfo.pDependencies = subpassDependencies.data();
+	VKT_CHECK(vkCreateRenderPass(context.device.device, &renderPassCreateInfo, VK_NULL_HANDLE, renderPass));
+	assert(*renderPass);
+}
+
+// VulkanRenderer_default::createRenderPasses
+void VulkanRenderer_default::createRenderPasses() {
+	// render pass of frame (color attachment is upscaled into swapchain image after render pass, or is swapchain image)
+	createRenderPass(&renderPass, VK_ATTACHMENT_LOAD_OP_CLEAR,
+		VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+		VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+		VK_FALSE, 0, VK_NULL_HANDLE);
+
+	// render pass of frame with depth pre-pass (renderers with depth pre-pass)
+	if (depthPrepass)
+		createRenderPass(&renderPass_depthPrepass, VK_ATTACHMENT_LOAD_OP_CLEAR,
+			VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+			VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+			VK_TRUE, 0, VK_NULL_HANDLE);
+
+	// render passes of occlusion phases (renderers with occlusion culling)
+	VkSubpassDependency subpassDependency{};
+	if (occlusionCulling) {
+		// VkSubpassDependency - first phase depth is reduced by compute (draw indirect stage chains culling semaphore wait)
+		subpassDependency.srcSubpass = 0;
+		subpassDependency.dstSubpass = VK_SUBPASS_EXTERNAL;
+		subpassDependency.srcStageMask = VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+		subpassDependency.dstStageMask = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+		subpassDependency.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+		subpassDependency.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+		subpassDependency.dependencyFlags = 0;
+		createRenderPass(&renderPass_occlusionFirst, VK_ATTACHMENT_LOAD_OP_CLEAR,
+			VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+			VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL,
+			VK_FALSE, 1, &subpassDependency);
+
+		// VkSubpassDependency - second phase loads attachments after depth pyramid is built
+		subpassDependency.srcSubpass = VK_SUBPASS_EXTERNAL;
+		subpassDependency.dstSubpass = 0;
+		subpassDependency.srcStageMask = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+		subpassDependency.dstStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+		subpassDependency.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+		subpassDependency.dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT | VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+		subpassDependency.dependencyFlags = 0;
+		createRenderPass(&renderPass_occlusionSecond, VK_ATTACHMENT_LOAD_OP_LOAD,
+			VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+			VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+			VK_FALSE, 1, &subpassDependency);
+	}
+
+	// render pass of particles (renderers with particles)
+	if (particles) {
+		// VkSubpassDependency - particles load attachments written by render passes of frame
+		subpassDependency.srcSubpass = VK_SUBPASS_EXTERNAL;
+		subpassDependency.dstSubpass = 0;
+		subpassDependency.srcStageMask = VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+		subpassDependency.dstStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+		subpassDependency.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+		subpassDependency.dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+		subpassDependency.dependencyFlags = 0;
+		createRenderPass(&renderPass_particles, VK_ATTACHMENT_LOAD_OP_LOAD,
+			VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+			VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+			VK_FALSE, 1, &subpassDependency);
+	}
 }
 
+
+
 // VulkanRenderer_default::createFramebuffers
-void VulkanRenderer_default::createFramebuffers() {
-	// create image views
-	framebuffers.resize(framesCount);
-	for (uint32_t i = 0; i < framesCount; i++) {
+void VulkanRenderer_default::createFramebuffers(VkRenderPass renderPass, std::vector<VkFramebuffer>& framebuffers) {
+	// create frame buffers (color attachment of frame or swapchain image, depth-stencil attachment of frame)
+	framebuffers.resize(getFramebuffersCount());
+	for (uint32_t i = 0; i < (uint32_t)framebuffers.size(); i++) {
 		// image views
-		VkImageView imageViews[] = { colorAttachmentImageViews[i], depthStencilAttachmentImageViews[i] };
+		VkImageView imageViews[] = { getFramebufferColorView(i), depthStencilAttachmentImageViews[getFramebufferFrame(i)] };
 	
 		// VkFramebufferCreateInfo
 		VkFramebufferCreateInfo framebufferCreateInfo{};
@@ -199,14 +1167,32 @@ void VulkanRenderer_default::createFramebuffers() {
 		framebufferCreateInfo.renderPass = renderPass;
 		framebufferCreateInfo.attachmentCount = VKT_ARRAY_ELEMENTS_COUNT(imageViews);
 		framebufferCreateInfo.pAttachments = imageViews;
-		framebufferCreateInfo.width = swapchain.surfaceCapabilities.currentExtent.width;
-		framebufferCreateInfo.height = swapchain.surfaceCapabilities.currentExtent.height;
+		framebufferCreateInfo.width = renderExtent.width;
+		framebufferCreateInfo.height = renderExtent.height;
 		framebufferCreateInfo.layers = 1;
 		VKT_CHECK(vkCreateFramebuffer(context.device.device, &framebufferCreateInfo, VK_NULL_HANDLE, &framebuffers[i]));
 		assert(framebuffers[i]);
 	}
 }
 
+// VulkanRenderer_default::getFramebuffersCount
+uint32_t VulkanRenderer_default::getFramebuffersCount() const {
+	// frame buffers of every frame and swapchain image pair when rendering to swapchain (acquired image is not frame index)
+	return renderToSwapchain ? framesCount * (uint32_t)swapchainImageViews.size() : framesCount;
+}
+
+// VulkanRenderer_default::getFramebufferColorView
+VkImageView VulkanRenderer_default::getFramebufferColorView(uint32_t framebuffer) const {
+	// swapchain image of frame buffer or color attachment of frame
+	return renderToSwapchain ? swapchainImageViews[framebuffer % swapchainImageViews.size()] : colorAttachmentImageViews[framebuffer];
+}
+
+// VulkanRenderer_default::getFramebufferFrame
+uint32_t VulkanRenderer_default::getFramebufferFrame(uint32_t framebuffer) const {
+	// frame of frame buffer
+	return renderToSwapchain ? framebuffer / (uint32_t)swapchainImageViews.size() : framebuffer;
+}
+
 // VulkanRenderer_default::createCommandBuffers
 void VulkanRenderer_default::createCommandBuffers() {
 	// create command buffers
@@ -225,91 +1211,16 @@ void VulkanRenderer_default::createSemaphores() {
 	presentSemaphores.resize(framesCount);
 	for (uint32_t frameIndex = 0; frameIndex < framesCount; frameIndex++)
 		vulkanSemaphoreCreate(context.device, &presentSemaphores[frameIndex]);
-}
-
-// VulkanRenderer_default::createShaders
-void VulkanRenderer_default::createShaders() {
-	// create all shaders
-	for (uint32_t materialUsage = VULKAN_MATERIAL_USAGE_BEGIN_RANGE; materialUsage <= VULKAN_MATERIAL_USAGE_END_RANGE; materialUsage++) {
-		// create mesh object shaders
-		vulkanShaderCreate(context.device,
-			shaders_mesh_obj_files_vert[materialUsage],
-			shaders_mesh_obj_files_frag[materialUsage],
-			&shader_mesh_obj[materialUsage]);
-		// create mesh object skin shaders
-		vulkanShaderCreate(context.device,
-			shaders_mesh_obj_skin_files_vert[materialUsage],
-			shaders_mesh_obj_skin_files_frag[materialUsage],
-			&shader_mesh_obj_skin[materialUsage]);
-	}
-}
-
-// VulkanRenderer_default::createPipelines
-void VulkanRenderer_default::createPipelines() {
-	// create all pipelines
-	for (uint32_t topology = VK_PRIMITIVE_TOPOLOGY_LINE_LIST; topology <= VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP_WITH_ADJACENCY; topology++) {
-		// create pipelines for materials
-		for (uint32_t materialUsage = VULKAN_MATERIAL_USAGE_COLOR; materialUsage <= VULKAN_MATERIAL_USAGE_COLOR_TEXTURE_LIGHT; materialUsage++) {
-			// create pipeline mesh object
-			vulkanPipelineCreate(context.device, shader_mesh_obj[materialUsage], context.pipelineLayout, renderPass, 0,
-				(VkPrimitiveTopology)topology, VK_POLYGON_MODE_FILL,
-				VKT_ARRAY_ELEMENTS_COUNT(vertexBindingDescriptions_mesh_obj), vertexBindingDescriptions_mesh_obj,
-				VKT_ARRAY_ELEMENTS_COUNT(vertexAttributeDescriptions_mesh_obj), vertexAttributeDescriptions_mesh_obj,
-				VKT_ARRAY_ELEMENTS_COUNT(pipelineColorBlendAttachmentStates_default), pipelineColorBlendAttachmentStates_default,
-				&pipeline_mesh_obj[materialUsage][topology]);
-			// create pipeline mesh object (wire-frame)
-			vulkanPipelineCreate(context.device, shader_mesh_obj[materialUsage], context.pipelineLayout, renderPass, 0,
-				(VkPrimitiveTopology)topology, VK_POLYGON_MODE_LINE,
-				VKT_ARRAY_ELEMENTS_COUNT(vertexBindingDescriptions_mesh_obj), vertexBindingDescriptions_mesh_obj,
-				VKT_ARRAY_ELEMENTS_COUNT(vertexAttributeDescriptions_mesh_obj), vertexAttributeDescriptions_mesh_obj,
-				VKT_ARRAY_ELEMENTS_COUNT(pipelineColorBlendAttachmentStates_default), pipelineColorBlendAttachmentStates_default,
-				&pipeline_mesh_obj_wf[materialUsage][topology]);
-			// create pipeline mesh object skin
-			vulkanPipelineCreate(context.device, shader_mesh_obj_skin[materialUsage], context.pipelineLayout, renderPass, 0,
-				(VkPrimitiveTopology)topology, VK_POLYGON_MODE_FILL,
-				VKT_ARRAY_ELEMENTS_COUNT(vertexBindingDescriptions_mesh_obj_skin), vertexBindingDescriptions_mesh_obj_skin,
-				VKT_ARRAY_ELEMENTS_COUNT(vertexAttributeDescriptions_mesh_obj_skin), vertexAttributeDescriptions_mesh_obj_skin,
-				VKT_ARRAY_ELEMENTS_COUNT(pipelineColorBlendAttachmentStates_default), pipelineColorBlendAttachmentStates_default,
-				&pipeline_mesh_obj_skin[materialUsage][topology]);
-			// create pipeline mesh object skin (wire-frame)
-			vulkanPipelineCreate(context.device, shader_mesh_obj_skin[materialUsage], context.pipelineLayout, renderPass, 0,
-				(VkPrimitiveTopology)topology, VK_POLYGON_MODE_LINE,
-				VKT_ARRAY_ELEMENTS_COUNT(vertexBindingDescriptions_mesh_obj_skin), vertexBindingDescriptions_mesh_obj_skin,
-				VKT_ARRAY_ELEMENTS_COUNT(vertexAttributeDescriptions_mesh_obj_skin), vertexAttributeDescriptions_mesh_obj_skin,
-				VKT_ARRAY_ELEMENTS_COUNT(pipelineColorBlendAttachmentStates_default), pipelineColorBlendAttachmentStates_default,
-				&pipeline_mesh_obj_skin_wf[materialUsage][topology]);
-		}
-		// create pipelines for bump materials
-		for (uint32_t materialUsage = VULKAN_MATERIAL_USAGE_COLOR_TEXTURE_LIGHT_BUMPMAP; materialUsage <= VULKAN_MATERIAL_USAGE_COLOR_TEXTURE_LIGHT_PBR; materialUsage++) {
-			// create pipeline mesh object
-			vulkanPipelineCreate(context.device, shader_mesh_obj[materialUsage], context.pipelineLayout, renderPass, 0,
-				(VkPrimitiveTopology)topology, VK_POLYGON_MODE_FILL,
-				VKT_ARRAY_ELEMENTS_COUNT(vertexBindingDescriptions_mesh_obj_bump), vertexBindingDescriptions_mesh_obj_bump,
-				VKT_ARRAY_ELEMENTS_COUNT(vertexAttributeDescriptions_mesh_obj_bump), vertexAttributeDescriptions_mesh_obj_bump,
-				VKT_ARRAY_ELEMENTS_COUNT(pipelineColorBlendAttachmentStates_default), pipelineColorBlendAttachmentStates_default,
-				&pipeline_mesh_obj[materialUsage][topology]);
-			// create pipeline mesh object (wire-frame)
-			vulkanPipelineCreate(context.device, shader_mesh_obj[materialUsage], context.pipelineLayout, renderPass, 0,
-				(VkPrimitiveTopology)topology, VK_POLYGON_MODE_LINE,
-				VKT_ARRAY_ELEMENTS_COUNT(vertexBindingDescriptions_mesh_obj_bump), vertexBindingDescriptions_mesh_obj_bump,
-				VKT_ARRAY_ELEMENTS_COUNT(vertexAttributeDescriptions_mesh_obj_bump), vertexAttributeDescriptions_mesh_obj_bump,
-				VKT_ARRAY_ELEMENTS_COUNT(pipelineColorBlendAttachmentStates_default), pipelineColorBlendAttachmentStates_default,
-				&pipeline_mesh_obj_wf[materialUsage][topology]);
-			// create pipeline mesh object skin
-			vulkanPipelineCreate(context.device, shader_mesh_obj_skin[materialUsage], context.pipelineLayout, renderPass, 0,
-				(VkPrimitiveTopology)topology, VK_POLYGON_MODE_FILL,
-				VKT_ARRAY_ELEMENTS_COUNT(vertexBindingDescriptions_mesh_obj_skin_bump), vertexBindingDescriptions_mesh_obj_skin_bump,
-				VKT_ARRAY_ELEMENTS_COUNT(vertexAttributeDescriptions_mesh_obj_skin_bump), vertexAttributeDescriptions_mesh_obj_skin_bump,
-				VKT_ARRAY_ELEMENTS_COUNT(pipelineColorBlendAttachmentStates_default), pipelineColorBlendAttachmentStates_default,
-				&pipeline_mesh_obj_skin[materialUsage][topology]);
-			// create pipeline mesh object skin (wire-frame)
-			vulkanPipelineCreate(context.device, shader_mesh_obj_skin[materialUsage], context.pipelineLayout, renderPass, 0,
-				(VkPrimitiveTopology)topology, VK_POLYGON_MODE_LINE,
-				VKT_ARRAY_ELEMENTS_COUNT(vertexBindingDescriptions_mesh_obj_skin_bump), vertexBindingDescriptions_mesh_obj_skin_bump,
-				VKT_ARRAY_ELEMENTS_COUNT(vertexAttributeDescriptions_mesh_obj_skin_bump), vertexAttributeDescriptions_mesh_obj_skin_bump,
-				VKT_ARRAY_ELEMENTS_COUNT(pipelineColorBlendAttachmentStates_default), pipelineColorBlendAttachmentStates_default,
-				&pipeline_mesh_obj_skin_wf[materialUsage][topology]);
-		}
+	// create frame fences (signaled - frames are not submitted yet)
+	frameFences.resize(framesCount);
+	for (uint32_t frameIndex = 0; frameIndex < framesCount; frameIndex++) {
+		// VkFenceCreateInfo
+		VkFenceCreateInfo fenceCreateInfo{};
+		fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+		fenceCreateInfo.pNext = VK_NULL_HANDLE;
+		fenceCreateInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+		VKT_CHECK(vkCreateFence(context.device.device, &fenceCreateInfo, VK_NULL_HANDLE, &frameFences[frameIndex]));
+		assert(frameFences[frameIndex]);
 	}
 }
 
@@ -324,12 +1235,26 @@ void VulkanRenderer_default::destroySwapchain() {
 
 // VulkanRenderer_default::destroyImages
 void VulkanRenderer_default::destroyImages() {
-	// destroy images
+	// destroy depth pyramid of occlusion culling
+	if (occlusionCulling)
+		occlusionCulling->destroyDepthPyramid();
+	// destroy swapchain image views (images are owned by swapchain)
+	for (auto& imageView : swapchainImageViews)
+		vkDestroyImageView(context.device.device, imageView, VK_NULL_HANDLE);
+	swapchainImageViews.clear();
+	// destroy color attachment image views and images
 	for (uint32_t i = 0; i < colorAttachmentImageViews.size(); i++) {
-		// destroy color attachment image views
 		vkDestroyImageView(context.device.device, colorAttachmentImageViews[i], VK_NULL_HANDLE);
 		colorAttachmentImageViews[i] = VK_NULL_HANDLE;
+		vmaDestroyImage(context.device.allocator, colorAttachmentImages[i], colorAttachmentAllocations[i]);
+		colorAttachmentImages[i] = VK_NULL_HANDLE;
+		colorAttachmentAllocations[i] = {};
+	}
+	// destroy images
+	for (uint32_t i = 0; i < depthStencilAttachmentImageViews.size(); i++) {
 		// destroy depth-stencil attachment image views
+		vkDestroyImageView(context.device.device, depthAttachmentImageViews[i], VK_NULL_HANDLE);
+		depthAttachmentImageViews[i] = VK_NULL_HANDLE;
 		vkDestroyImageView(context.device.device, depthStencilAttachmentImageViews[i], VK_NULL_HANDLE);
 		depthStencilAttachmentImageViews[i] = VK_NULL_HANDLE;
 		// destroy depth-stencil attachment images
@@ -339,15 +1264,23 @@ void VulkanRenderer_default::destroyImages() {
 	}
 }
 
-// VulkanRenderer_default::destroyRenderPass
-void VulkanRenderer_default::destroyRenderPass() {
-	// destroy render pass
+// VulkanRenderer_default::destroyRenderPasses
+void VulkanRenderer_default::destroyRenderPasses() {
+	// destroy render passes
+	vkDestroyRenderPass(context.device.device, renderPass_particles, VK_NULL_HANDLE);
+	renderPass_particles = VK_NULL_HANDLE;
+	vkDestroyRenderPass(context.device.device, renderPass_depthPrepass, VK_NULL_HANDLE);
+	renderPass_depthPrepass = VK_NULL_HANDLE;
+	vkDestroyRenderPass(context.device.device, renderPass_occlusionSecond, VK_NULL_HANDLE);
+	renderPass_occlusionSecond = VK_NULL_HANDLE;
+	vkDestroyRenderPass(context.device.device, renderPass_occlusionFirst, VK_NULL_HANDLE);
+	renderPass_occlusionFirst = VK_NULL_HANDLE;
 	vkDestroyRenderPass(context.device.device, renderPass, VK_NULL_HANDLE);
 	renderPass = VK_NULL_HANDLE;
 }
 
 // VulkanRenderer_default::destroyFramebuffers
-void VulkanRenderer_default::destroyFramebuffers() {
+void VulkanRenderer_default::destroyFramebuffers(std::vector<VkFramebuffer>& framebuffers) {
 	// destroy framebuffers
 	for (auto& framebuffer : framebuffers) {
 		vkDestroyFramebuffer(context.device.device, framebuffer, VK_NULL_HANDLE);
@@ -364,6 +1297,10 @@ void VulkanRenderer_default::destroyCommandBuffers() {
 
 // VulkanRenderer_default::destroySemaphores
 void VulkanRenderer_default::destroySemaphores() {
+	// destroy frame fences
+	for (auto& fence : frameFences)
+		vkDestroyFence(context.device.device, fence, VK_NULL_HANDLE);
+	frameFences.clear();
 	// destroy present semaphores
 	for (auto& semaphore : presentSemaphores)
 		vulkanSemaphoreDestroy(context.device, semaphore);
@@ -372,44 +1309,169 @@ void VulkanRenderer_default::destroySemaphores() {
 		vulkanSemaphoreDestroy(context.device, semaphore);
 }
 
-// VulkanRenderer_default::destroyShaders
-void VulkanRenderer_default::destroyShaders() {
-	// destroy all shaders
-	for (uint32_t materialUsage = VULKAN_MATERIAL_USAGE_BEGIN_RANGE; materialUsage <= VULKAN_MATERIAL_USAGE_END_RANGE; materialUsage++) {
-		vulkanShaderDestroy(context.device, shader_mesh_obj_skin[materialUsage]);
-		vulkanShaderDestroy(context.device, shader_mesh_obj[materialUsage]);
-	}
+// VulkanRenderer_default::waitFrames
+void VulkanRenderer_default::waitFrames() {
+	// wait for fences of all frames
+	for (uint32_t index = 0; index < framesCount; index++)
+		completeFrame(index);
 }
 
-// VulkanRenderer_default::destroyPipelines
-void VulkanRenderer_default::destroyPipelines() {
-	// destroy all pipelines
-	for (uint32_t materialUsage = VULKAN_MATERIAL_USAGE_BEGIN_RANGE; materialUsage <= VULKAN_MATERIAL_USAGE_END_RANGE; materialUsage++) {
-		for (uint32_t topology = VK_PRIMITIVE_TOPOLOGY_LINE_LIST; topology <= VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP_WITH_ADJACENCY; topology++) {
-			vulkanPipelineDestroy(context.device, pipeline_mesh_obj_skin_wf[materialUsage][topology]);
-			vulkanPipelineDestroy(context.device, pipeline_mesh_obj_skin[materialUsage][topology]);
-			vulkanPipelineDestroy(context.device, pipeline_mesh_obj_wf[materialUsage][topology]);
-			vulkanPipelineDestroy(context.device, pipeline_mesh_obj[materialUsage][topology]);
-		}
+// VulkanRenderer_default::completeFrame
+void VulkanRenderer_default::completeFrame(uint32_t index) {
+	// wait for fence of frame
+	VKT_CHECK(vkWaitForFences(context.device.device, 1, &frameFences[index], VK_TRUE, UINT64_MAX));
+	if (frameLatency)
+		frameLatency->completeFrame(index);
+}
+
+// VulkanRenderer_default::recreateFrameHandles
+void VulkanRenderer_default::recreateFrameHandles() {
+	// destroy per frame handles (frames are complete)
+	if (dynamicResolution)
+		dynamicResolution->destroyQueries();
+	destroyDrawBuffers();
+	destroyRecordCommandBuffers();
+	destroySemaphores();
+	destroyCommandBuffers();
+	// create per frame handles of new frames count
+	createCommandBuffers();
+	createSemaphores();
+	createRecordCommandBuffers(framesCount);
+	createDrawBuffers(framesCount);
+	if (dynamicResolution)
+		dynamicResolution->createQueries(framesCount);
+	if (frameLatency)
+		frameLatency->setFramesCount(framesCount);
+}
+
+// VulkanRenderer_default::resizeRenderTargets
+void VulkanRenderer_default::resizeRenderTargets() {
+	// frames are complete on device (render passes and pipelines do not depend on extent)
+	waitFrames();
+	destroyFramebuffers(framebuffers_depthPrepass);
+	destroyFramebuffers(framebuffers);
+	destroyImages();
+	createImages();
+	createFramebuffers(renderPass, framebuffers);
+	if (depthPrepass)
+		createFramebuffers(renderPass_depthPrepass, framebuffers_depthPrepass);
+}
+
+// VulkanRenderer_default::upscaleToSwapchain
+void VulkanRenderer_default::upscaleToSwapchain(VulkanCommandBuffer& commandBuffer, uint32_t imageIndex) {
+	// VkImageMemoryBarrier - acquired image was rendered to (swapchain image is presented)
+	if (renderToSwapchain) {
+		VkImageMemoryBarrier imageMemoryBarrier{};
+		imageMemoryBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		imageMemoryBarrier.pNext = VK_NULL_HANDLE;
+		imageMemoryBarrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+		imageMemoryBarrier.dstAccessMask = 0;
+		imageMemoryBarrier.oldLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+		imageMemoryBarrier.newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+		imageMemoryBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		imageMemoryBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		imageMemoryBarrier.image = swapchain.images[imageIndex];
+		imageMemoryBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		imageMemoryBarrier.subresourceRange.baseMipLevel = 0;
+		imageMemoryBarrier.subresourceRange.levelCount = 1;
+		imageMemoryBarrier.subresourceRange.baseArrayLayer = 0;
+		imageMemoryBarrier.subresourceRange.layerCount = 1;
+		vkCmdPipelineBarrier(commandBuffer.commandBuffer, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, VK_NULL_HANDLE, 0, VK_NULL_HANDLE, 1, &imageMemoryBarrier);
+		return;
 	}
+
+	// VkImageMemoryBarrier - color attachment is read by transfer, swapchain image is discarded after acquire semaphore wait (transfer stage)
+	VkImageMemoryBarrier imageMemoryBarriers[2]{};
+	imageMemoryBarriers[0].sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+	imageMemoryBarriers[0].pNext = VK_NULL_HANDLE;
+	imageMemoryBarriers[0].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+	imageMemoryBarriers[0].dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+	imageMemoryBarriers[0].oldLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+	imageMemoryBarriers[0].newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+	imageMemoryBarriers[0].srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	imageMemoryBarriers[0].dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	imageMemoryBarriers[0].image = colorAttachmentImages[frameIndex];
+	imageMemoryBarriers[0].subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	imageMemoryBarriers[0].subresourceRange.baseMipLevel = 0;
+	imageMemoryBarriers[0].subresourceRange.levelCount = 1;
+	imageMemoryBarriers[0].subresourceRange.baseArrayLayer = 0;
+	imageMemoryBarriers[0].subresourceRange.layerCount = 1;
+	imageMemoryBarriers[1] = imageMemoryBarriers[0];
+	imageMemoryBarriers[1].srcAccessMask = 0;
+	imageMemoryBarriers[1].dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	imageMemoryBarriers[1].oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	imageMemoryBarriers[1].newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	imageMemoryBarriers[1].image = swapchain.images[imageIndex];
+	vkCmdPipelineBarrier(commandBuffer.commandBuffer, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, VK_NULL_HANDLE, 0, VK_NULL_HANDLE, 2, imageMemoryBarriers);
+
+	// VkImageBlit - render extent into swapchain extent (linear filter)
+	VkImageBlit imageBlit{};
+	imageBlit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	imageBlit.srcSubresource.mipLevel = 0;
+	imageBlit.srcSubresource.baseArrayLayer = 0;
+	imageBlit.srcSubresource.layerCount = 1;
+	imageBlit.srcOffsets[1] = { (int32_t)renderExtent.width, (int32_t)renderExtent.height, 1 };
+	imageBlit.dstSubresource = imageBlit.srcSubresource;
+	imageBlit.dstOffsets[1] = { (int32_t)swapchain.surfaceCapabilities.currentExtent.width, (int32_t)swapchain.surfaceCapabilities.currentExtent.height, 1 };
+	vkCmdBlitImage(commandBuffer.commandBuffer,
+		colorAttachmentImages[frameIndex], VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+		swapchain.images[imageIndex], VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+		1, &imageBlit, VK_FILTER_LINEAR);
+
+	// VkImageMemoryBarrier - swapchain image is presented
+	imageMemoryBarriers[1].srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	imageMemoryBarriers[1].dstAccessMask = 0;
+	imageMemoryBarriers[1].oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	imageMemoryBarriers[1].newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+	vkCmdPipelineBarrier(commandBuffer.commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, VK_NULL_HANDLE, 0, VK_NULL_HANDLE, 1, &imageMemoryBarriers[1]);
 }
 
 // VulkanRenderer_default::reinitialize
 void VulkanRenderer_default::reinitialize() {
-	// wait device
-	VKT_CHECK(vkQueueWaitIdle(context.device.queueGraphics));
-	// destroy all related handles
-	destroyPipelines();
-	destroyFramebuffers();
-	destroyRenderPass();
+	// minimized surface keeps current swapchain (nothing is presented)
+	VkSurfaceCapabilitiesKHR surfaceCapabilities{};
+	VKT_CHECK(vkGetPhysicalDeviceSurfaceCapabilitiesKHR(context.device.physicalDevice, surface.surface, &surfaceCapabilities));
+	if (!surfaceCapabilities.currentExtent.width || !surfaceCapabilities.currentExtent.height)
+		return;
+
+	// wait for frames using size dependent handles (no device drain)
+	waitFrames();
+	destroyFramebuffers(framebuffers_depthPrepass);
+	destroyFramebuffers(framebuffers);
 	destroyImages();
-	destroySwapchain();
-	// create all related handles
-	createSwapchain();
+
+	// recreate swapchain from retired one (format and images count may change)
+	VkFormat surfaceFormat = swapchain.surfaceFormat.format;
+	uint32_t oldFramesCount = framesCount;
+	vulkanSwapchainRecreate(context.device, surface, swapchain.config, &swapchain);
+	framesCount = (uint32_t)swapchain.images.size();
+	frameIndex = 0;
+
+	// render passes depend on surface format only (pipelines are kept for compatible render passes)
+	if (swapchain.surfaceFormat.format != surfaceFormat) {
+		if (particles)
+			particles->destroyDrawPipeline();
+		if (depthPrepass)
+			depthPrepass->destroyPipelines();
+		destroyPipelines();
+		destroyRenderPasses();
+		createRenderPasses();
+		createPipelines(renderPass);
+		if (depthPrepass)
+			depthPrepass->createPipelines(renderPass_depthPrepass, shader_mesh_obj);
+		if (particles)
+			particles->createDrawPipeline(renderPass_particles);
+	}
+
+	// per frame handles follow images count
+	if (framesCount != oldFramesCount)
+		recreateFrameHandles();
+
+	// create size dependent handles
 	createImages();
-	createRenderPass();
-	createFramebuffers();
-	createPipelines();
+	createFramebuffers(renderPass, framebuffers);
+	if (depthPrepass)
+		createFramebuffers(renderPass_depthPrepass, framebuffers_depthPrepass);
 }
 
 // VulkanRenderer_default::getViewSize
@@ -428,85 +1490,165 @@ float VulkanRenderer_default::getViewAspect() {
 		float(swapchain.surfaceCapabilities.currentExtent.height);
 }
 
-// VulkanRenderer_default::drawScene
-void VulkanRenderer_default::drawScene(VulkanScene* scene) 
-{
-	// acquire next frame index
-	uint32_t imageIndex{};
-	VKT_CHECK(vkAcquireNextImageKHR(context.device.device, swapchain.swapchain, UINT64_MAX, presentSemaphores[frameIndex].semaphore, VK_NULL_HANDLE, &imageIndex));
+// VulkanRenderer_default::getRenderHeight
+uint32_t VulkanRenderer_default::getRenderHeight() {
+	return renderExtent.height;
+}
 
-	// VkCommandBufferBeginInfo
-	VkCommandBufferBeginInfo commandBufferBeginInfo{};
-	commandBufferBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-	commandBufferBeginInfo.pNext = VK_NULL_HANDLE;
-	commandBufferBeginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-	commandBufferBeginInfo.pInheritanceInfo = nullptr; // Optional
-	VKT_CHECK(vkBeginCommandBuffer(commandBuffers[frameIndex].commandBuffer, &commandBufferBeginInfo));
+// VulkanRenderer_default::getRenderWidth
+uint32_t VulkanRenderer_default::getRenderWidth() {
+	return renderExtent.width;
+}
+
+// VulkanRenderer_default::getMaxQueuedFrames
+uint32_t VulkanRenderer_default::getMaxQueuedFrames() const {
+	// at least one frame, at most one frame per swapchain image
+	return std::min(std::max(swapchain.config.maxQueuedFrames, 1u), framesCount);
+}
 
-	// scene before render
-	beforeRenderPass(commandBuffers[frameIndex], scene);
+// VulkanRenderer_default::setDynamicResolution
+void VulkanRenderer_default::setDynamicResolution(VkBool32 enabled, float targetTime, float scaleMin) {
+	// disabled dynamic resolution renders at swapchain extent again
+	if (dynamicResolution && dynamicResolution->set(enabled, targetTime, scaleMin))
+		resizeRenderTargets();
+}
 
+// VulkanRenderer_default::presentFrame
+void VulkanRenderer_default::presentFrame(VulkanCommandBuffer& commandBuffer, VulkanScene* scene)
+{
 	// VkClearValue
 	VkClearValue clearColors[2];
 	clearColors[0].color = { 0.0f, 0.125f, 0.3f, 1.0f };
 	clearColors[1].depthStencil.depth = 1.0f;
 	clearColors[1].depthStencil.stencil = 0;
 
+	// depth pre-pass adds depth only subpass, occlusion culling splits frame into two compatible render passes
+	VkBool32 depthPrepassUsed = depthPrepass && depthPrepass->begin(scene);
+	VkBool32 occlusionUsed = beginOcclusionCulling(scene);
+
 	// VkRenderPassBeginInfo
 	VkRenderPassBeginInfo renderPassBeginInfo{};
 	renderPassBeginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
 	renderPassBeginInfo.pNext = VK_NULL_HANDLE;
-	renderPassBeginInfo.renderPass = renderPass;
-	renderPassBeginInfo.framebuffer = framebuffers[frameIndex];
+	renderPassBeginInfo.renderPass = depthPrepassUsed ? renderPass_depthPrepass : occlusionUsed ? renderPass_occlusionFirst : renderPass;
+	renderPassBeginInfo.framebuffer = depthPrepassUsed ? framebuffers_depthPrepass[framebufferIndex] : framebuffers[framebufferIndex];
 	renderPassBeginInfo.renderArea.offset = { 0, 0 };
-	renderPassBeginInfo.renderArea.extent = swapchain.surfaceCapabilities.currentExtent;
+	renderPassBeginInfo.renderArea.extent = renderExtent;
 	renderPassBeginInfo.clearValueCount = VKT_ARRAY_ELEMENTS_COUNT(clearColors);
 	renderPassBeginInfo.pClearValues = clearColors;
-	vkCmdBeginRenderPass(commandBuffers[frameIndex].commandBuffer, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
 
-	// VkViewport
-	VkViewport viewport{};
-	viewport.x = 0.0f;
-	viewport.y = (float)swapchain.surfaceCapabilities.currentExtent.height;
-	viewport.width = (float)swapchain.surfaceCapabilities.currentExtent.width;
-	viewport.height = -(float)swapchain.surfaceCapabilities.currentExtent.height;
-	viewport.minDepth = 0.0f;
-	viewport.maxDepth = 1.0f;
-	vkCmdSetViewport(commandBuffers[frameIndex].commandBuffer, 0, 1, &viewport);
+	// present render pass
+	presentRenderPass(commandBuffer, scene, renderPassBeginInfo, frameIndex);
 
-	// VkRect2D (scissor)
-	VkRect2D scissor{};
-	scissor.offset = {0, 0};
-	scissor.extent = swapchain.surfaceCapabilities.currentExtent;
-	vkCmdSetScissor(commandBuffers[frameIndex].commandBuffer, 0, 1, &scissor);
-	
-	// set line width
-	vkCmdSetLineWidth(commandBuffers[frameIndex].commandBuffer, 1.0f);
+	// second phase of occlusion culling
+	if (occlusionUsed) {
+		renderPassBeginInfo.renderPass = renderPass_occlusionSecond;
+		presentOcclusionRenderPass(commandBuffer, scene, renderPassBeginInfo, depthAttachmentImageViews[frameIndex]);
+	}
 
-	// present render pass
-	presentSubPass(commandBuffers[frameIndex], scene);
+	// particles over frame
+	presentParticlesRenderPass(commandBuffer, scene);
+}
+
+// VulkanRenderer_default::presentParticlesRenderPass
+void VulkanRenderer_default::presentParticlesRenderPass(VulkanCommandBuffer& commandBuffer, VulkanScene* scene)
+{
+	// simulation of frame is submitted with frame (graphics queue waits for it, renderers without particles skip emitters)
+	if (!particles || scene->particleEmitters.empty())
+		return;
+	particles->update(scene->particleEmitters, scene->particleGravity, scene->particleTimeStep, frameIndex);
+
+	// VkRenderPassBeginInfo - attachments of frame are loaded
+	VkRenderPassBeginInfo renderPassBeginInfo{};
+	renderPassBeginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+	renderPassBeginInfo.pNext = VK_NULL_HANDLE;
+	renderPassBeginInfo.renderPass = renderPass_particles;
+	renderPassBeginInfo.framebuffer = framebuffers[framebufferIndex];
+	renderPassBeginInfo.renderArea.offset = { 0, 0 };
+	renderPassBeginInfo.renderArea.extent = renderExtent;
+	renderPassBeginInfo.clearValueCount = 0;
+	renderPassBeginInfo.pClearValues = VK_NULL_HANDLE;
+
+	// draw alive particles of frame (indirect draw written by simulation)
+	vkCmdBeginRenderPass(commandBuffer.commandBuffer, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
+	setDynamicState(commandBuffer, renderExtent);
+	scene->bind(commandBuffer);
+	particles->draw(commandBuffer, frameIndex);
+	vkCmdEndRenderPass(commandBuffer.commandBuffer);
+}
+
+// VulkanRenderer_default::drawScene
+void VulkanRenderer_default::drawScene(VulkanScene* scene) 
+{
+	// frame begins when application sampled its input
+	std::chrono::steady_clock::time_point frameBeginTime = std::chrono::steady_clock::now();
+
+	// render scale of measured frame time (swapchain images that can not be blitted to keep full scale)
+	if (dynamicResolution && (swapchain.imageUsage & VK_IMAGE_USAGE_TRANSFER_DST_BIT) && dynamicResolution->update())
+		resizeRenderTargets();
+
+	// wait for previous submit of frame (command buffer of frame is reused)
+	completeFrame(frameIndex);
+	VKT_CHECK(vkResetFences(context.device.device, 1, &frameFences[frameIndex]));
+	if (frameLatency)
+		frameLatency->beginFrame(frameIndex, frameBeginTime);
+
+	// acquire next frame index
+	uint32_t imageIndex{};
+	VKT_CHECK(vkAcquireNextImageKHR(context.device.device, swapchain.swapchain, UINT64_MAX, presentSemaphores[frameIndex].semaphore, VK_NULL_HANDLE, &imageIndex));
+	framebufferIndex = renderToSwapchain ? frameIndex * (uint32_t)swapchainImageViews.size() + imageIndex : frameIndex;
+
+	// VkCommandBufferBeginInfo
+	VkCommandBufferBeginInfo commandBufferBeginInfo{};
+	commandBufferBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	commandBufferBeginInfo.pNext = VK_NULL_HANDLE;
+	commandBufferBeginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+	commandBufferBeginInfo.pInheritanceInfo = nullptr; // Optional
+	VKT_CHECK(vkBeginCommandBuffer(commandBuffers[frameIndex].commandBuffer, &commandBufferBeginInfo));
+	if (dynamicResolution)
+		dynamicResolution->beginFrame(commandBuffers[frameIndex], frameIndex);
+
+	// scene before render and shadow maps
+	beforeRenderPass(commandBuffers[frameIndex], scene, frameIndex);
+	presentShadowPass(commandBuffers[frameIndex], scene, frameIndex);
+	beginPipelineStatistics(commandBuffers[frameIndex], frameIndex);
 
-	// end render pass
-	vkCmdEndRenderPass(commandBuffers[frameIndex].commandBuffer);
+	// render passes of frame
+	presentFrame(commandBuffers[frameIndex], scene);
 
 	// after render pass
+	endPipelineStatistics(commandBuffers[frameIndex], frameIndex);
 	afterRenderPass(commandBuffers[frameIndex], scene);
 
+	// upscale frame into acquired image (or present rendered acquired image)
+	upscaleToSwapchain(commandBuffers[frameIndex], imageIndex);
+	if (dynamicResolution)
+		dynamicResolution->endFrame(commandBuffers[frameIndex], frameIndex);
+
 	// end command buffer
 	VKT_CHECK(vkEndCommandBuffer(commandBuffers[frameIndex].commandBuffer));
 
+	// wait for image (written by upscale only, or by render passes when rendering to swapchain), culled draws and simulated particles
+	VkSemaphore waitSemaphores[] = { presentSemaphores[frameIndex].semaphore, VK_NULL_HANDLE, VK_NULL_HANDLE };
+	VkPipelineStageFlags waitDstStageMasks[] = {
+		renderToSwapchain ? VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT : VK_PIPELINE_STAGE_TRANSFER_BIT,
+		VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT };
+	uint32_t waitSemaphoreCount = 1;
+	for (VkSemaphore computeSemaphore : { submitDrawCulling(frameIndex), particles ? particles->submit(frameIndex) : VK_NULL_HANDLE })
+		if (computeSemaphore)
+			waitSemaphores[waitSemaphoreCount++] = computeSemaphore;
+
 	// VkSubmitInfo
-	VkPipelineStageFlags waitDstStageMask = VK_PIPELINE_STAGE_ALL_GRAPHICS_BIT;
 	VkSubmitInfo submitInfo{};
 	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-	submitInfo.pWaitDstStageMask = &waitDstStageMask;
+	submitInfo.pWaitDstStageMask = waitDstStageMasks;
 	submitInfo.commandBufferCount = 1;
 	submitInfo.pCommandBuffers = &commandBuffers[frameIndex].commandBuffer;
-	submitInfo.waitSemaphoreCount = 1;
-	submitInfo.pWaitSemaphores = &presentSemaphores[frameIndex].semaphore;
+	submitInfo.waitSemaphoreCount = waitSemaphoreCount;
+	submitInfo.pWaitSemaphores = waitSemaphores;
 	submitInfo.signalSemaphoreCount = 1;
 	submitInfo.pSignalSemaphores = &renderSemaphores[frameIndex].semaphore;
-	VKT_CHECK(vkQueueSubmit(context.device.queueGraphics, 1, &submitInfo, VK_NULL_HANDLE));
+	VKT_CHECK(vkQueueSubmit(context.device.queueGraphics, 1, &submitInfo, frameFences[frameIndex]));
 
 	// VkPresentInfoKHR
 	VkPresentInfoKHR presentInfo = {};
@@ -518,60 +1660,11 @@ void VulkanRenderer_default::drawScene(VulkanScene* scene)
 	presentInfo.pSwapchains = &swapchain.swapchain;
 	presentInfo.pImageIndices = &imageIndex;
 	VKT_CHECK(vkQueuePresentKHR(context.device.queueGraphics, &presentInfo));
-	VKT_CHECK(vkQueueWaitIdle(context.device.queueGraphics));
+
+	// frames ahead of device (instead of draining queue every frame)
+	if (frameLatency)
+		frameLatency->limit(frameFences, frameIndex, getMaxQueuedFrames());
 
 	// update frame index
 	frameIndex = (frameIndex + 1) % framesCount;
 }
-
-// VulkanRenderer_default::beforeRenderPass
-void VulkanRenderer_default::beforeRenderPass(VulkanCommandBuffer& commandBuffer, VulkanScene* scene) 
-{
-	// scene before render pass
-	scene->update(commandBuffer);
-}
-
-// VulkanRenderer_default::insideRenderPass
-void VulkanRenderer_default::presentSubPass(VulkanCommandBuffer& commandBuffer, VulkanScene* scene)
-{
-	// bind scene data to shader
-	scene->bind(commandBuffers[frameIndex]);
-	// draw models
-	for (auto& model : scene->models) {
-		// bind model data to shader
-		model->bind(commandBuffers[frameIndex]);
-		// draw meshes
-		if (model->visible) {
-			for (auto& mesh : model->meshes) {
-				// bind material if exists
-				if (mesh->material) mesh->material->bind(commandBuffer);
-				// bind pipeline
-				assert(mesh->primitiveTopology != VK_PRIMITIVE_TOPOLOGY_POINT_LIST);
-				assert(mesh->primitiveTopology != VK_PRIMITIVE_TOPOLOGY_PATCH_LIST);
- 				vkCmdBindPipeline(commandBuffers[frameIndex].commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
-					pipeline_mesh_obj[mesh->materialUsage][mesh->primitiveTopology].pipeline);
- 				// draw mesh
- 				mesh->draw(commandBuffers[frameIndex]);
-			}
-		}
-		// draw debug meshes
-		if (model->visibleDebug) {
-			for (auto& mesh : model->meshes_debug) {
-				// bind material if exists
-				if (mesh->material) mesh->material->bind(commandBuffer);
-				// bind pipeline
-				assert(mesh->primitiveTopology != VK_PRIMITIVE_TOPOLOGY_POINT_LIST);
-				assert(mesh->primitiveTopology != VK_PRIMITIVE_TOPOLOGY_PATCH_LIST);
-				vkCmdBindPipeline(commandBuffers[frameIndex].commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
-					pipeline_mesh_obj[mesh->materialUsage][mesh->primitiveTopology].pipeline);
- 				// draw mesh
- 				mesh->draw(commandBuffers[frameIndex]);
-			}
-		}
-	}
-}
-
-// VulkanRenderer_default::afterRenderPass
-void VulkanRenderer_default::afterRenderPass(VulkanCommandBuffer& commandBuffer, VulkanScene* scene)
-{
-}
@@ -2,10 +2,47 @@
 
 #include "vulkan_context.hpp"
 #include "vulkan_scene.hpp"
+#include "vulkan_render_queue.hpp"
+#include "vulkan_draw_culling.hpp"
+#include "vulkan_frustum_culling.hpp"
+#include "vulkan_occlusion_culling.hpp"
+#include "vulkan_debug_geometry.hpp"
+#include "vulkan_skinning.hpp"
+#include "vulkan_shadow_pass.hpp"
+#include "vulkan_depth_prepass.hpp"
+#include "vulkan_dynamic_resolution.hpp"
+#include "vulkan_frame_latency.hpp"
+#include "thread_pool.hpp"
+#include <chrono>
 
 // VulkanRenderer
 class VulkanRenderer;
 
+// VulkanPipelineStatistics (graphics pipeline statistics of frame, in query result order)
+struct VulkanPipelineStatistics {
+	uint64_t inputAssemblyVertices{};
+	uint64_t inputAssemblyPrimitives{};
+	uint64_t vertexShaderInvocations{};
+	uint64_t clippingInvocations{};
+	uint64_t clippingPrimitives{};
+	uint64_t fragmentShaderInvocations{};
+};
+
+// pipeline statistics flags (must match VulkanPipelineStatistics)
+#define VULKAN_PIPELINE_STATISTICS_FLAGS ( \
+	VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_VERTICES_BIT | \
+	VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_PRIMITIVES_BIT | \
+	VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT | \
+	VK_QUERY_PIPELINE_STATISTIC_CLIPPING_INVOCATIONS_BIT | \
+	VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT | \
+	VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT)
+
+// secondary command buffers per record thread of frame (depth pre-pass and color subpasses)
+#define VULKAN_RENDERER_MAX_SUBPASSES 2
+
+// shadow map size of each cascade
+#define VULKAN_RENDERER_SHADOW_MAP_SIZE 1024
+
 // renderer callback function type
 typedef void(* VulkanRendererCallbackFunc)(VulkanRenderer& renderer, VulkanCommandBuffer& commandBuffer);
 
@@ -14,54 +51,6 @@ class VulkanRenderer {
 protected:
 	// base handles
 	VulkanContext& context;
-	VulkanSurface& surface;
-public:
-	// constructor and destructor
-	VulkanRenderer(
-		VulkanContext& context,
-		VulkanSurface& surface) :
-		context(context),
-		surface(surface) {};
-	virtual ~VulkanRenderer() {}
-
-	// reinitialize
-	virtual void reinitialize() = 0;
-
-	// getters
-	virtual uint32_t getViewHeight() = 0;
-	virtual uint32_t getViewWidth() = 0;
-	virtual float getViewAspect() = 0;
-
-	// draw functions
-	virtual void drawScene(VulkanScene* scene) = 0;
-};
-
-// VulkanRenderer_default
-class VulkanRenderer_default : public VulkanRenderer {
-protected:
-	// swapchain
-	VulkanSwapchain swapchain{};
-protected:
-	// swapchain frames and image indexes
-	uint32_t frameIndex{};
-	uint32_t framesCount{};
-protected:
-	// present depth-stencil attachments
-	std::vector<VkImageView>   colorAttachmentImageViews{};
-	// present depth-stencil attachments
-	std::vector<VkImage>       depthStencilAttachmentImages{};
-	std::vector<VkImageView>   depthStencilAttachmentImageViews{};
-	std::vector<VmaAllocation> depthStencilAttachmentAllocations{};
-	// frame buffers and command buffers
-	std::vector<VkFramebuffer> framebuffers{};
-	// render pass
-	VkRenderPass renderPass{};
-protected:
-	// command buffers
-	std::vector<VulkanCommandBuffer> commandBuffers{};
-	// render and present semaphores
-	std::vector<VulkanSemaphore> renderSemaphores{};
-	std::vector<VulkanSemaphore> presentSemaphores{};
 protected:
 	// mesh object vertex shader files
 	const char* shaders_mesh_obj_files_vert[VULKAN_MATERIAL_USAGE_RANGE_SIZE]{
@@ -102,36 +91,236 @@ protected:
 	// shaders
 	VulkanShader shader_mesh_obj[VULKAN_MATERIAL_USAGE_RANGE_SIZE]{};
 	VulkanShader shader_mesh_obj_skin[VULKAN_MATERIAL_USAGE_RANGE_SIZE]{};
-	VulkanShader shader_shadow_mesh_obj{};
-	VulkanShader shader_shadow_mesh_obj_skin{};
 	// objects pipelines
 	VulkanPipeline pipeline_mesh_obj[VULKAN_MATERIAL_USAGE_RANGE_SIZE][VK_PRIMITIVE_TOPOLOGY_RANGE_SIZE]{};
 	VulkanPipeline pipeline_mesh_obj_wf[VULKAN_MATERIAL_USAGE_RANGE_SIZE][VK_PRIMITIVE_TOPOLOGY_RANGE_SIZE]{};
 	VulkanPipeline pipeline_mesh_obj_skin[VULKAN_MATERIAL_USAGE_RANGE_SIZE][VK_PRIMITIVE_TOPOLOGY_RANGE_SIZE]{};
 	VulkanPipeline pipeline_mesh_obj_skin_wf[VULKAN_MATERIAL_USAGE_RANGE_SIZE][VK_PRIMITIVE_TOPOLOGY_RANGE_SIZE]{};
+protected:
+	// render queue of current scene and its bind counters (packets sharing mesh and state are drawn as instances)
+	VulkanRenderQueue      renderQueue{};
+	VkBool32               drawInstancing = VK_TRUE;
+	VulkanRenderQueueStats renderQueueStats{};
+	// record threads (secondary command buffers are used when each thread gets enough draw calls to record)
+	ThreadPool* recordThreadPool{};
+	uint32_t    recordThreadsCount{};
+	uint32_t    recordThreadDrawCallsMin = 128;
+	// record command pools [frameIndex * recordThreadsCount + threadIndex] and their secondary command buffers of subpasses
+	std::vector<VkCommandPool>       recordCommandPools{};
+	std::vector<VulkanCommandBuffer> recordCommandBuffers{};
+protected:
+	// draw data, indirect commands and draw counts per frame (host visible, grown with render queue)
+	VkBool32 drawIndirect = VK_TRUE;
+	uint32_t drawPacketsMin = 1024;
+	std::vector<VulkanBuffer>        drawDataBuffers{};
+	std::vector<VulkanBuffer>        drawIndirectBuffers{};
+	std::vector<VulkanBuffer>        drawCountBuffers{};
+	std::vector<VulkanDescriptorSet> drawDescriptorSets{};
+	// frustum culling of indirect commands on compute queue (used with indirect draws)
+	VkBool32           drawCull = VK_TRUE;
+	VulkanDrawCulling* drawCulling{};
+	// level of detail selection from projected error of meshes in first view (pixels)
+	VkBool32 drawLod = VK_TRUE;
+	float    lodPixelError = 1.0f;
+	uint32_t lodSimplifiedCount{};
+	// meshes at full resolution are pushed as meshlets (culled by compute culling, one packet per meshlet)
+	VkBool32 drawClusters = VK_TRUE;
+	uint32_t clusteredCount{};
+	// frustum culling of meshes on host (used when draws are not culled on compute queue)
+	VulkanFrustumCulling frustumCulling{};
+	VkBool32             frustumCulled{};
+	// occlusion culling against depth pyramid of first phase draws (created by renderers opting in, second phase draws newly visible)
+	VkBool32                drawOcclusion = VK_TRUE;
+	VulkanOcclusionCulling* occlusionCulling{};
+	// depth pre-pass of scenes requesting it (created by renderers opting in, replaces occlusion culling)
+	VulkanDepthPrepass* depthPrepass{};
+	// shadow pass of scenes with shadows (created by renderers opting in, lit pipelines sample its shadow maps)
+	VulkanShadowPass* shadowPass{};
+	// clustered point lights of scenes (created by renderers opting in, light list binned into clusters by compute before render pass)
+	VulkanLightClusters* lightClusters{};
+	// debug lines of meshes (created by renderers opting in, normals and tangent space written into geometry pool by compute when shown)
+	VulkanDebugGeometry* debugGeometry{};
+	// skinned meshes (created by renderers opting in, vertices skinned into geometry pool by compute once per frame)
+	VulkanSkinning* skinning{};
+	// draw buffers of recorded frame (draw data set is culled instances with device culling)
+	uint32_t               drawFrameIndex{};
+	VulkanDrawIndirectInfo drawIndirectInfo{};
+	VkDescriptorSet        drawDescriptorSet{};
+	VkBool32               drawIndirectUsed{};
+protected:
+	// pipeline statistics query per frame (secondary command buffers need inherited queries)
+	VkQueryPool              pipelineStatisticsQueryPool{};
+	std::vector<VkBool32>    pipelineStatisticsQueried{};
+	VulkanPipelineStatistics pipelineStatistics{};
 protected:
 	// create functions
+	void createShaders();
+	void createPipelines(VkRenderPass renderPass);
+	void createRecordCommandBuffers(uint32_t framesCount);
+	void createDrawBuffers(uint32_t framesCount);
+
+	// destroy functions
+	void destroyShaders();
+	void destroyPipelines();
+	void destroyRecordCommandBuffers();
+	void destroyDrawBuffers();
+public:
+	// constructor and destructor
+	VulkanRenderer(VulkanContext& context);
+	virtual ~VulkanRenderer();
+
+	// reinitialize
+	virtual void reinitialize() = 0;
+
+	// getters
+	virtual uint32_t getViewHeight() = 0;
+	virtual uint32_t getViewWidth() = 0;
+	virtual float getViewAspect() = 0;
+	virtual uint32_t getRenderHeight() { return getViewHeight(); }
+	virtual uint32_t getRenderWidth() { return getViewWidth(); }
+	const VulkanRenderQueueStats& getRenderQueueStats() const;
+	const VulkanPipelineStatistics& getPipelineStatistics() const;
+
+	// draw functions
+	virtual void drawScene(VulkanScene* scene) = 0;
+protected:
+	// render pass functions
+	virtual void beforeRenderPass(VulkanCommandBuffer& commandBuffer, VulkanScene* scene, uint32_t frameIndex);
+	virtual void presentSubPass(VulkanCommandBuffer& commandBuffer, VulkanScene* scene);
+	void presentDepthSubPass(VulkanCommandBuffer& commandBuffer, VulkanScene* scene);
+	void presentShadowPass(VulkanCommandBuffer& commandBuffer, VulkanScene* scene, uint32_t frameIndex);
+	virtual void presentResolveSubPass(VulkanCommandBuffer& commandBuffer, VulkanScene* scene, const VkRenderPassBeginInfo& renderPassBeginInfo);
+	virtual void afterRenderPass(VulkanCommandBuffer& commandBuffer, VulkanScene* scene);
+
+	// render pass recording (inline or secondary command buffers from record threads)
+	void presentRenderPass(VulkanCommandBuffer& commandBuffer, VulkanScene* scene, const VkRenderPassBeginInfo& renderPassBeginInfo, uint32_t frameIndex);
+	void presentOcclusionRenderPass(VulkanCommandBuffer& commandBuffer, VulkanScene* scene, const VkRenderPassBeginInfo& renderPassBeginInfo, VkImageView depthImageView);
+	void recordSecondaryCommandBuffer(VulkanCommandBuffer& commandBuffer, VulkanScene* scene, const VkRenderPassBeginInfo& renderPassBeginInfo, uint32_t subpass, size_t first, size_t count, VulkanRenderQueueStats& stats);
+	void setDynamicState(VulkanCommandBuffer& commandBuffer, VkExtent2D extent);
+
+	// build render queue from visible meshes (culled on host without device culling)
+	void buildRenderQueue(VulkanScene* scene);
+	virtual VkPipeline getMeshPipeline(VulkanMeshMatObj* mesh);
+	void cullRenderQueue(VulkanScene* scene);
+
+	// write render queue into draw buffers of frame and bind them (set 3)
+	void writeDrawBuffers(VulkanScene* scene, uint32_t frameIndex);
+	void bindDrawBuffers(VulkanCommandBuffer& commandBuffer);
+	void submitRenderQueue(VulkanCommandBuffer& commandBuffer, size_t first, size_t count, VkBool32 depthOnly, VulkanRenderQueueStats& stats);
+
+	// submit culling of frame (returns semaphore to wait at draw indirect stage, or VK_NULL_HANDLE)
+	VkSemaphore submitDrawCulling(uint32_t frameIndex);
+
+	// occlusion culling is used with device culling and without depth pre-pass (renderers with occlusion culling)
+	VkBool32 beginOcclusionCulling(VulkanScene* scene);
+
+	// pipeline statistics of frame (previous results of frame are read when frame is complete on device)
+	void beginPipelineStatistics(VulkanCommandBuffer& commandBuffer, uint32_t frameIndex);
+	void endPipelineStatistics(VulkanCommandBuffer& commandBuffer, uint32_t frameIndex);
+};
+
+// VulkanRenderer_default
+class VulkanRenderer_default : public VulkanRenderer {
+protected:
+	// surface and swapchain
+	VulkanSurface& surface;
+	VulkanSwapchain swapchain{};
+protected:
+	// swapchain frames and image indexes
+	uint32_t frameIndex{};
+	uint32_t framesCount{};
+protected:
+	// color attachments of render extent (upscaled into acquired swapchain image, not created when rendering to swapchain)
+	std::vector<VkImage>       colorAttachmentImages{};
+	std::vector<VkImageView>   colorAttachmentImageViews{};
+	std::vector<VmaAllocation> colorAttachmentAllocations{};
+	// render extent is swapchain extent (acquired swapchain image is color attachment, no upscale)
+	VkBool32                   renderToSwapchain{};
+	std::vector<VkImageView>   swapchainImageViews{};
+	// present depth-stencil attachments (depth views are sampled by depth pyramid)
+	std::vector<VkImage>       depthStencilAttachmentImages{};
+	std::vector<VkImageView>   depthStencilAttachmentImageViews{};
+	std::vector<VkImageView>   depthAttachmentImageViews{};
+	std::vector<VmaAllocation> depthStencilAttachmentAllocations{};
+	// frame buffers and command buffers (depth pre-pass render pass is not compatible with others)
+	std::vector<VkFramebuffer> framebuffers{};
+	std::vector<VkFramebuffer> framebuffers_depthPrepass{};
+	// frame buffer of frame and acquired image (frame buffers per frame and swapchain image when rendering to swapchain)
+	uint32_t                   framebufferIndex{};
+	// render pass and compatible render passes of occlusion phases (first keeps depth for pyramid, second loads)
+	VkRenderPass renderPass{};
+	VkRenderPass renderPass_occlusionFirst{};
+	VkRenderPass renderPass_occlusionSecond{};
+	// render pass with depth only subpass before color subpass
+	VkRenderPass renderPass_depthPrepass{};
+	// render pass loading attachments of frame (particles over frame)
+	VkRenderPass renderPass_particles{};
+protected:
+	// particles of scenes (created by renderers opting in, emitted and simulated on compute queue, drawn after render passes of frame)
+	VulkanParticles* particles{};
+protected:
+	// command buffers
+	std::vector<VulkanCommandBuffer> commandBuffers{};
+	// render and present semaphores
+	std::vector<VulkanSemaphore> renderSemaphores{};
+	std::vector<VulkanSemaphore> presentSemaphores{};
+	// frame fences (signaled when command buffer of frame is complete on device)
+	std::vector<VkFence> frameFences{};
+	// frame latency of renderers opting in (queued frames limit of swapchain config, frames count of swapchain without it)
+	VulkanFrameLatency* frameLatency{};
+protected:
+	// dynamic resolution of renderers opting in (render extent of its scale, swapchain extent without it)
+	VulkanDynamicResolution* dynamicResolution{};
+	VkExtent2D               renderExtent{};
+protected:
+	// create functions (images and render passes of subclasses are created with them)
 	void createSwapchain();
-	void createImages();
-	void createRenderPass();
-	void createFramebuffers();
+	virtual void createImages();
+	void createRenderPass(VkRenderPass* renderPass, VkAttachmentLoadOp loadOp, VkImageLayout colorInitialLayout, VkImageLayout colorFinalLayout, VkImageLayout depthInitialLayout, VkImageLayout depthFinalLayout, VkBool32 depthPrepass, uint32_t dependencyCount, const VkSubpassDependency* dependencies);
+	virtual void createRenderPasses();
+	void createFramebuffers(VkRenderPass renderPass, std::vector<VkFramebuffer>& framebuffers);
 	void createCommandBuffers();
 	void createSemaphores();
-	void createShaders();
-	void createPipelines();
 
 	// destroy functions
 	void destroySwapchain();
-	void destroyImages();
-	void destroyRenderPass();
-	void destroyFramebuffers();
+	virtual void destroyImages();
+	virtual void destroyRenderPasses();
+	void destroyFramebuffers(std::vector<VkFramebuffer>& framebuffers);
 	void destroyCommandBuffers();
 	void destroySemaphores();
-	void destroyShaders();
-	void destroyPipelines();
+
+	// frame buffers count, and color attachment and frame of frame buffer (attachments of frame stay per frame)
+	uint32_t getFramebuffersCount() const;
+	VkImageView getFramebufferColorView(uint32_t framebuffer) const;
+	uint32_t getFramebufferFrame(uint32_t framebuffer) const;
+
+	// wait for submitted frames (size dependent handles are not used by device anymore, other queues are not drained)
+	void waitFrames();
+
+	// wait for completion of submitted frame (measures its latency)
+	void completeFrame(uint32_t index);
+
+	// recreate per frame handles (swapchain images count changed)
+	void recreateFrameHandles();
+
+	// recreate render targets of changed render scale (render passes and pipelines do not depend on extent)
+	void resizeRenderTargets();
+
+	// upscale color attachment of frame into acquired swapchain image (present layout, only layout of acquired image when rendering to swapchain)
+	void upscaleToSwapchain(VulkanCommandBuffer& commandBuffer, uint32_t imageIndex);
+
+	// render passes of frame into color attachment of frame
+	virtual void presentFrame(VulkanCommandBuffer& commandBuffer, VulkanScene* scene);
+
+	// record simulation of scene particles on compute queue and draw them over frame (scenes without emitters are skipped)
+	void presentParticlesRenderPass(VulkanCommandBuffer& commandBuffer, VulkanScene* scene);
+
+	// constructor of subclasses (forward passes are depth pre-pass, occlusion culling and particles over forward render pass)
+	VulkanRenderer_default(VulkanContext& context, VulkanSurface& surface, const VulkanSwapchainConfig& swapchainConfig, VkBool32 forwardPasses);
 public:
 	// constructor and destructor
-	VulkanRenderer_default(VulkanContext& context, VulkanSurface& surface);
+	VulkanRenderer_default(VulkanContext& context, VulkanSurface& surface, const VulkanSwapchainConfig& swapchainConfig);
 	virtual ~VulkanRenderer_default();
 
 	// reinitialize
@@ -141,12 +330,17 @@ public:
 	uint32_t getViewHeight() override;
 	uint32_t getViewWidth() override;
 	float getViewAspect() override;
+	uint32_t getRenderHeight() override;
+	uint32_t getRenderWidth() override;
+	float getRenderScale() const { return dynamicResolution ? dynamicResolution->getScale() : 1.0f; }
+	float getFrameTime() const { return dynamicResolution ? dynamicResolution->getFrameTime() : 0.0f; }
+	float getFrameLatency() const { return frameLatency ? frameLatency->getLatency() : 0.0f; }
+	VkPresentModeKHR getPresentMode() const { return swapchain.presentMode; }
+	uint32_t getMaxQueuedFrames() const;
+
+	// dynamic resolution (target frame time in milliseconds, render scale is not lowered below minimal scale)
+	void setDynamicResolution(VkBool32 enabled, float targetTime, float scaleMin);
 
 	// draw functions
 	void drawScene(VulkanScene* scene) override;
-protected:
-	// render pass functions
-	void beforeRenderPass(VulkanCommandBuffer& commandBuffer, VulkanScene* scene);
-	void presentSubPass(VulkanCommandBuffer& commandBuffer, VulkanScene* scene);
-	void afterRenderPass(VulkanCommandBuffer& commandBuffer, VulkanScene* scene);
 };
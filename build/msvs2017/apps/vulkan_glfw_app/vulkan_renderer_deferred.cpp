@@ -0,0 +1,456 @@
+#include "vulkan_renderer_deferred.hpp"
+#include <glm/matrix.hpp>
+#include <array>
+
+// G-buffer attachment formats (normals are packed into unsigned range, alpha is lit flag)
+static const VkFormat gbufferFormats[VULKAN_RENDERER_DEFERRED_GBUFFER_ATTACHMENTS] = {
+	VK_FORMAT_R8G8B8A8_UNORM,
+	VK_FORMAT_A2B10G10R10_UNORM_PACK32,
+	VK_FORMAT_D32_SFLOAT
+};
+
+// VulkanRenderer_deferred::VulkanRenderer_deferred
+VulkanRenderer_deferred::VulkanRenderer_deferred(
+	VulkanContext& context,
+	VulkanSurface& surface,
+	const VulkanSwapchainConfig& swapchainConfig) :
+	VulkanRenderer_default(context, surface, swapchainConfig, VK_FALSE)
+{
+	// create deferred handles (base constructor created forward handles without depth pre-pass and occlusion culling)
+	createDeferredShaders();
+	createDeferredRenderPass();
+	createDeferredPipelines();
+	createGBuffer();
+}
+
+// VulkanRenderer_deferred::~VulkanRenderer_deferred
+VulkanRenderer_deferred::~VulkanRenderer_deferred()
+{
+	// queued frames are complete on device
+	waitFrames();
+
+	// destroy deferred handles (base destructor destroys forward handles)
+	destroyGBuffer();
+	destroyDeferredPipelines();
+	destroyDeferredRenderPass();
+	destroyDeferredShaders();
+}
+
+// VulkanRenderer_deferred::createDeferredShaders
+void VulkanRenderer_deferred::createDeferredShaders() {
+	// create G-buffer shaders (same vertex shaders as forward shaders)
+	for (uint32_t materialUsage = VULKAN_MATERIAL_USAGE_BEGIN_RANGE; materialUsage <= VULKAN_MATERIAL_USAGE_END_RANGE; materialUsage++)
+		vulkanShaderCreate(context.device,
+			shaders_mesh_obj_files_vert[materialUsage],
+			shaders_mesh_obj_gbuffer_files_frag[materialUsage],
+			&shader_mesh_obj_gbuffer[materialUsage]);
+	// create lighting shader
+	vulkanShaderCreate(context.device,
+		shader_deferred_lighting_file_vert,
+		shader_deferred_lighting_file_frag,
+		&shader_deferred_lighting);
+}
+
+// VulkanRenderer_deferred::createDeferredRenderPass
+void VulkanRenderer_deferred::createDeferredRenderPass() {
+	// VkAttachmentDescription - color of frame and G-buffer (G-buffer is cleared and never stored)
+	std::array<VkAttachmentDescription, 1 + VULKAN_RENDERER_DEFERRED_GBUFFER_ATTACHMENTS> attachmentDescriptions;
+	// color attachment (every pixel is written by lighting subpass)
+	attachmentDescriptions[0].flags = 0;
+	attachmentDescriptions[0].format = swapchain.surfaceFormat.format;
+	attachmentDescriptions[0].samples = VK_SAMPLE_COUNT_1_BIT;
+	attachmentDescriptions[0].loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+	attachmentDescriptions[0].storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+	attachmentDescriptions[0].stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+	attachmentDescriptions[0].stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+	attachmentDescriptions[0].initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	attachmentDescriptions[0].finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+	// G-buffer attachments (contents stay in tile memory)
+	for (uint32_t attachment = 0; attachment < VULKAN_RENDERER_DEFERRED_GBUFFER_ATTACHMENTS; attachment++) {
+		VkBool32 depth = attachment == VULKAN_RENDERER_DEFERRED_GBUFFER_ATTACHMENTS - 1;
+		attachmentDescriptions[1 + attachment].flags = 0;
+		attachmentDescriptions[1 + attachment].format = gbufferFormats[attachment];
+		attachmentDescriptions[1 + attachment].samples = VK_SAMPLE_COUNT_1_BIT;
+		attachmentDescriptions[1 + attachment].loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+		attachmentDescriptions[1 + attachment].storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+		attachmentDescriptions[1 + attachment].stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+		attachmentDescriptions[1 + attachment].stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+		attachmentDescriptions[1 + attachment].initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		attachmentDescriptions[1 + attachment].finalLayout = depth ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	}
+
+	// VkAttachmentReference - G-buffer subpass writes albedo, normal and depth
+	std::array<VkAttachmentReference, 2> gbufferAttachmentReferences;
+	gbufferAttachmentReferences[0].attachment = 1;
+	gbufferAttachmentReferences[0].layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+	gbufferAttachmentReferences[1].attachment = 2;
+	gbufferAttachmentReferences[1].layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+	VkAttachmentReference depthAttachmentReference{};
+	depthAttachmentReference.attachment = 3;
+	depthAttachmentReference.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+	// VkAttachmentReference - lighting subpass reads G-buffer and writes color of frame
+	std::array<VkAttachmentReference, VULKAN_RENDERER_DEFERRED_GBUFFER_ATTACHMENTS> inputAttachmentReferences;
+	inputAttachmentReferences[0].attachment = 1;
+	inputAttachmentReferences[0].layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	inputAttachmentReferences[1].attachment = 2;
+	inputAttachmentReferences[1].layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	inputAttachmentReferences[2].attachment = 3;
+	inputAttachmentReferences[2].layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+	VkAttachmentReference colorAttachmentReference{};
+	colorAttachmentReference.attachment = 0;
+	colorAttachmentReference.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+	// VkSubpassDescription - subpassDescriptions
+	std::array<VkSubpassDescription, 2> subpassDescriptions;
+	// G-buffer subpass
+	subpassDescriptions[0].flags = 0;
+	subpassDescriptions[0].pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+	subpassDescriptions[0].inputAttachmentCount = 0;
+	subpassDescriptions[0].pInputAttachments = VK_NULL_HANDLE;
+	subpassDescriptions[0].colorAttachmentCount = (uint32_t)gbufferAttachmentReferences.size();
+	subpassDescriptions[0].pColorAttachments = gbufferAttachmentReferences.data();
+	subpassDescriptions[0].pResolveAttachments = VK_NULL_HANDLE;
+	subpassDescriptions[0].pDepthStencilAttachment = &depthAttachmentReference;
+	subpassDescriptions[0].preserveAttachmentCount = 0;
+	subpassDescriptions[0].pPreserveAttachments = VK_NULL_HANDLE;
+	// lighting subpass
+	subpassDescriptions[1].flags = 0;
+	subpassDescriptions[1].pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+	subpassDescriptions[1].inputAttachmentCount = (uint32_t)inputAttachmentReferences.size();
+	subpassDescriptions[1].pInputAttachments = inputAttachmentReferences.data();
+	subpassDescriptions[1].colorAttachmentCount = 1;
+	subpassDescriptions[1].pColorAttachments = &colorAttachmentReference;
+	subpassDescriptions[1].pResolveAttachments = VK_NULL_HANDLE;
+	subpassDescriptions[1].pDepthStencilAttachment = VK_NULL_HANDLE;
+	subpassDescriptions[1].preserveAttachmentCount = 0;
+	subpassDescriptions[1].pPreserveAttachments = VK_NULL_HANDLE;
+
+	// VkSubpassDependency - lighting subpass reads G-buffer of same pixel (by region keeps it on tile)
+	std::array<VkSubpassDependency, 2> subpassDependencies;
+	subpassDependencies[0].srcSubpass = 0;
+	subpassDependencies[0].dstSubpass = 1;
+	subpassDependencies[0].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+	subpassDependencies[0].dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+	subpassDependencies[0].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+	subpassDependencies[0].dstAccessMask = VK_ACCESS_INPUT_ATTACHMENT_READ_BIT;
+	subpassDependencies[0].dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
+	// VkSubpassDependency - color of frame may be acquired swapchain image (transition after acquire wait of frame)
+	subpassDependencies[1].srcSubpass = VK_SUBPASS_EXTERNAL;
+	subpassDependencies[1].dstSubpass = 1;
+	subpassDependencies[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+	subpassDependencies[1].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+	subpassDependencies[1].srcAccessMask = 0;
+	subpassDependencies[1].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+	subpassDependencies[1].dependencyFlags = 0;
+
+	// VkRenderPassCreateInfo
+	VkRenderPassCreateInfo renderPassCreateInfo{};
+	renderPassCreateInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+	renderPassCreateInfo.attachmentCount = (uint32_t)attachmentDescriptions.size();
+	renderPassCreateInfo.pAttachments = attachmentDescriptions.data();
+	renderPassCreateInfo.subpassCount = (uint32_t)subpassDescriptions.size();
+	renderPassCreateInfo.pSubpasses = subpassDescriptions.data();
+	renderPassCreateInfo.dependencyCount = (uint32_t)subpassDependencies.size();
+	renderPassCreateInfo.pDependencies = subpassDependencies.data();
+	VKT_CHECK(vkCreateRenderPass(context.device.device, &renderPassCreateInfo, VK_NULL_HANDLE, &renderPass_deferred));
+	assert(renderPass_deferred);
+}
+
+// VulkanRenderer_deferred::createDeferredPipelines
+void VulkanRenderer_deferred::createDeferredPipelines() {
+	// create G-buffer pipelines (first subpass)
+	for (uint32_t topology = VK_PRIMITIVE_TOPOLOGY_LINE_LIST; topology <= VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP_WITH_ADJACENCY; topology++) {
+		// create pipelines for materials
+		for (uint32_t materialUsage = VULKAN_MATERIAL_USAGE_COLOR; materialUsage <= VULKAN_MATERIAL_USAGE_COLOR_TEXTURE_LIGHT; materialUsage++) {
+			vulkanPipelineCreate(context.device, shader_mesh_obj_gbuffer[materialUsage], context.pipelineLayout, renderPass_deferred, 0,
+				(VkPrimitiveTopology)topology, VK_POLYGON_MODE_FILL,
+				VKT_ARRAY_ELEMENTS_COUNT(vertexBindingDescriptions_mesh_obj), vertexBindingDescriptions_mesh_obj,
+				VKT_ARRAY_ELEMENTS_COUNT(vertexAttributeDescriptions_mesh_obj), vertexAttributeDescriptions_mesh_obj,
+				VKT_ARRAY_ELEMENTS_COUNT(pipelineColorBlendAttachmentStates_gbuffer), pipelineColorBlendAttachmentStates_gbuffer,
+				nullptr, &pipeline_mesh_obj_gbuffer[materialUsage][topology]);
+		}
+		// create pipelines for bump materials
+		for (uint32_t materialUsage = VULKAN_MATERIAL_USAGE_COLOR_TEXTURE_LIGHT_BUMPMAP; materialUsage <= VULKAN_MATERIAL_USAGE_COLOR_TEXTURE_LIGHT_PBR; materialUsage++) {
+			vulkanPipelineCreate(context.device, shader_mesh_obj_gbuffer[materialUsage], context.pipelineLayout, renderPass_deferred, 0,
+				(VkPrimitiveTopology)topology, VK_POLYGON_MODE_FILL,
+				VKT_ARRAY_ELEMENTS_COUNT(vertexBindingDescriptions_mesh_obj_bump), vertexBindingDescriptions_mesh_obj_bump,
+				VKT_ARRAY_ELEMENTS_COUNT(vertexAttributeDescriptions_mesh_obj_bump), vertexAttributeDescriptions_mesh_obj_bump,
+				VKT_ARRAY_ELEMENTS_COUNT(pipelineColorBlendAttachmentStates_gbuffer), pipelineColorBlendAttachmentStates_gbuffer,
+				nullptr, &pipeline_mesh_obj_gbuffer[materialUsage][topology]);
+		}
+	}
+
+	// VulkanPipelineDepthState - lighting subpass has no depth attachment
+	VulkanPipelineDepthState pipelineDepthState{};
+	pipelineDepthState.depthTestEnable = VK_FALSE;
+	pipelineDepthState.depthWriteEnable = VK_FALSE;
+	pipelineDepthState.depthCompareOp = VK_COMPARE_OP_ALWAYS;
+
+	// create lighting pipeline (second subpass, full screen triangle without vertex input)
+	vulkanPipelineCreate(context.device, shader_deferred_lighting, context.pipelineLayout_deferred, renderPass_deferred, 1,
+		VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, VK_POLYGON_MODE_FILL,
+		0, nullptr,
+		0, nullptr,
+		VKT_ARRAY_ELEMENTS_COUNT(pipelineColorBlendAttachmentStates_default), pipelineColorBlendAttachmentStates_default,
+		&pipelineDepthState, &pipeline_deferred_lighting);
+}
+
+// VulkanRenderer_deferred::createGBuffer
+void VulkanRenderer_deferred::createGBuffer() {
+	// create G-buffer images (render extent of frame)
+	gbufferImages.resize(framesCount * VULKAN_RENDERER_DEFERRED_GBUFFER_ATTACHMENTS);
+	gbufferImageViews.resize(framesCount * VULKAN_RENDERER_DEFERRED_GBUFFER_ATTACHMENTS);
+	gbufferAllocations.resize(framesCount * VULKAN_RENDERER_DEFERRED_GBUFFER_ATTACHMENTS);
+	for (uint32_t i = 0; i < (uint32_t)gbufferImages.size(); i++) {
+		VkFormat format = gbufferFormats[i % VULKAN_RENDERER_DEFERRED_GBUFFER_ATTACHMENTS];
+		VkBool32 depth = i % VULKAN_RENDERER_DEFERRED_GBUFFER_ATTACHMENTS == VULKAN_RENDERER_DEFERRED_GBUFFER_ATTACHMENTS - 1;
+
+		// VkImageCreateInfo - transient attachment (never leaves render pass)
+		VkImageCreateInfo imageCreateInfo{};
+		imageCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+		imageCreateInfo.pNext = VK_NULL_HANDLE;
+		imageCreateInfo.flags = 0;
+		imageCreateInfo.imageType = VK_IMAGE_TYPE_2D;
+		imageCreateInfo.format = format;
+		imageCreateInfo.extent.width = renderExtent.width;
+		imageCreateInfo.extent.height = renderExtent.height;
+		imageCreateInfo.extent.depth = 1;
+		imageCreateInfo.mipLevels = 1;
+		imageCreateInfo.arrayLayers = 1;
+		imageCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+		imageCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+		imageCreateInfo.usage = VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT |
+			(depth ? VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT : VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT);
+		imageCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+		imageCreateInfo.queueFamilyIndexCount = VK_QUEUE_FAMILY_IGNORED;
+		imageCreateInfo.pQueueFamilyIndices = VK_NULL_HANDLE;
+		imageCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+		// VmaAllocationCreateInfo - lazily allocated memory where available (tile based devices back it by tile memory only)
+		VmaAllocationCreateInfo allocCreateInfo{};
+		allocCreateInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+		allocCreateInfo.flags = 0;
+		allocCreateInfo.preferredFlags = VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
+
+		// vmaCreateImage
+		VKT_CHECK(vmaCreateImage(context.device.allocator, &imageCreateInfo, &allocCreateInfo, &gbufferImages[i], &gbufferAllocations[i], VK_NULL_HANDLE));
+		assert(gbufferImages[i]);
+		assert(gbufferAllocations[i]);
+
+		// VkImageViewCreateInfo
+		VkImageViewCreateInfo imageViewCreateInfo{};
+		imageViewCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+		imageViewCreateInfo.pNext = VK_NULL_HANDLE;
+		imageViewCreateInfo.flags = 0;
+		imageViewCreateInfo.image = gbufferImages[i];
+		imageViewCreateInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+		imageViewCreateInfo.format = format;
+		imageViewCreateInfo.components.r = VK_COMPONENT_SWIZZLE_IDENTITY;
+		imageViewCreateInfo.components.g = VK_COMPONENT_SWIZZLE_IDENTITY;
+		imageViewCreateInfo.components.b = VK_COMPONENT_SWIZZLE_IDENTITY;
+		imageViewCreateInfo.components.a = VK_COMPONENT_SWIZZLE_IDENTITY;
+		imageViewCreateInfo.subresourceRange.aspectMask = depth ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_COLOR_BIT;
+		imageViewCreateInfo.subresourceRange.baseMipLevel = 0;
+		imageViewCreateInfo.subresourceRange.levelCount = 1;
+		imageViewCreateInfo.subresourceRange.baseArrayLayer = 0;
+		imageViewCreateInfo.subresourceRange.layerCount = 1;
+		VKT_CHECK(vkCreateImageView(context.device.device, &imageViewCreateInfo, VK_NULL_HANDLE, &gbufferImageViews[i]));
+		assert(gbufferImageViews[i]);
+	}
+
+	// create frame buffers (color attachment of frame or swapchain image, then G-buffer of frame)
+	framebuffers_deferred.resize(getFramebuffersCount());
+	for (uint32_t i = 0; i < (uint32_t)framebuffers_deferred.size(); i++) {
+		// image views
+		VkImageView imageViews[1 + VULKAN_RENDERER_DEFERRED_GBUFFER_ATTACHMENTS] = { getFramebufferColorView(i) };
+		for (uint32_t attachment = 0; attachment < VULKAN_RENDERER_DEFERRED_GBUFFER_ATTACHMENTS; attachment++)
+			imageViews[1 + attachment] = gbufferImageViews[getFramebufferFrame(i) * VULKAN_RENDERER_DEFERRED_GBUFFER_ATTACHMENTS + attachment];
+
+		// VkFramebufferCreateInfo
+		VkFramebufferCreateInfo framebufferCreateInfo{};
+		framebufferCreateInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+		framebufferCreateInfo.pNext = VK_NULL_HANDLE;
+		framebufferCreateInfo.flags = 0;
+		framebufferCreateInfo.renderPass = renderPass_deferred;
+		framebufferCreateInfo.attachmentCount = VKT_ARRAY_ELEMENTS_COUNT(imageViews);
+		framebufferCreateInfo.pAttachments = imageViews;
+		framebufferCreateInfo.width = renderExtent.width;
+		framebufferCreateInfo.height = renderExtent.height;
+		framebufferCreateInfo.layers = 1;
+		VKT_CHECK(vkCreateFramebuffer(context.device.device, &framebufferCreateInfo, VK_NULL_HANDLE, &framebuffers_deferred[i]));
+		assert(framebuffers_deferred[i]);
+	}
+
+	// create deferred data buffers and G-buffer descriptor sets
+	deferredDataBuffers.resize(framesCount);
+	deferredDescriptorSets.resize(framesCount);
+	for (uint32_t i = 0; i < framesCount; i++) {
+		vulkanBufferCreate(context.device, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, sizeof(VulkanDeferredData), &deferredDataBuffers[i]);
+		vulkanDescriptorSetCreate(context.device, context.descriptorSetLayout_gbuffer, &deferredDescriptorSets[i]);
+
+		// VkDescriptorImageInfo - G-buffer in layouts of lighting subpass
+		std::array<VkDescriptorImageInfo, VULKAN_RENDERER_DEFERRED_GBUFFER_ATTACHMENTS> descriptorImageInfos;
+		std::array<VkWriteDescriptorSet, VULKAN_RENDERER_DEFERRED_GBUFFER_ATTACHMENTS> writeDescriptorSets;
+		for (uint32_t attachment = 0; attachment < VULKAN_RENDERER_DEFERRED_GBUFFER_ATTACHMENTS; attachment++) {
+			VkBool32 depth = attachment == VULKAN_RENDERER_DEFERRED_GBUFFER_ATTACHMENTS - 1;
+			descriptorImageInfos[attachment].sampler = VK_NULL_HANDLE;
+			descriptorImageInfos[attachment].imageView = gbufferImageViews[i * VULKAN_RENDERER_DEFERRED_GBUFFER_ATTACHMENTS + attachment];
+			descriptorImageInfos[attachment].imageLayout = depth ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+			// VkWriteDescriptorSet
+			writeDescriptorSets[attachment].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			writeDescriptorSets[attachment].pNext = VK_NULL_HANDLE;
+			writeDescriptorSets[attachment].dstSet = deferredDescriptorSets[i].descriptorSet;
+			writeDescriptorSets[attachment].dstBinding = attachment;
+			writeDescriptorSets[attachment].dstArrayElement = 0;
+			writeDescriptorSets[attachment].descriptorCount = 1;
+			writeDescriptorSets[attachment].descriptorType = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+			writeDescriptorSets[attachment].pImageInfo = &descriptorImageInfos[attachment];
+			writeDescriptorSets[attachment].pBufferInfo = VK_NULL_HANDLE;
+			writeDescriptorSets[attachment].pTexelBufferView = VK_NULL_HANDLE;
+		}
+		vkUpdateDescriptorSets(context.device.device, (uint32_t)writeDescriptorSets.size(), writeDescriptorSets.data(), 0, VK_NULL_HANDLE);
+		vulkanDescriptorSetUpdateBufferUniform(context.device, deferredDescriptorSets[i], deferredDataBuffers[i], VULKAN_RENDERER_DEFERRED_GBUFFER_ATTACHMENTS);
+	}
+}
+
+// VulkanRenderer_deferred::destroyDeferredShaders
+void VulkanRenderer_deferred::destroyDeferredShaders() {
+	// destroy all deferred shaders
+	vulkanShaderDestroy(context.device, shader_deferred_lighting);
+	for (uint32_t materialUsage = VULKAN_MATERIAL_USAGE_BEGIN_RANGE; materialUsage <= VULKAN_MATERIAL_USAGE_END_RANGE; materialUsage++)
+		vulkanShaderDestroy(context.device, shader_mesh_obj_gbuffer[materialUsage]);
+}
+
+// VulkanRenderer_deferred::destroyDeferredRenderPass
+void VulkanRenderer_deferred::destroyDeferredRenderPass() {
+	// destroy render pass
+	vkDestroyRenderPass(context.device.device, renderPass_deferred, VK_NULL_HANDLE);
+	renderPass_deferred = VK_NULL_HANDLE;
+}
+
+// VulkanRenderer_deferred::destroyDeferredPipelines
+void VulkanRenderer_deferred::destroyDeferredPipelines() {
+	// destroy all deferred pipelines
+	vulkanPipelineDestroy(context.device, pipeline_deferred_lighting);
+	for (uint32_t materialUsage = VULKAN_MATERIAL_USAGE_BEGIN_RANGE; materialUsage <= VULKAN_MATERIAL_USAGE_END_RANGE; materialUsage++)
+		for (uint32_t topology = VK_PRIMITIVE_TOPOLOGY_LINE_LIST; topology <= VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP_WITH_ADJACENCY; topology++)
+			vulkanPipelineDestroy(context.device, pipeline_mesh_obj_gbuffer[materialUsage][topology]);
+}
+
+// VulkanRenderer_deferred::destroyGBuffer
+void VulkanRenderer_deferred::destroyGBuffer() {
+	// destroy descriptor sets and deferred data buffers
+	for (auto& descriptorSet : deferredDescriptorSets)
+		vulkanDescriptorSetDestroy(context.device, descriptorSet);
+	for (auto& buffer : deferredDataBuffers)
+		vulkanBufferDestroy(context.device, buffer);
+	deferredDescriptorSets.clear();
+	deferredDataBuffers.clear();
+	// destroy frame buffers
+	for (auto& framebuffer : framebuffers_deferred)
+		vkDestroyFramebuffer(context.device.device, framebuffer, VK_NULL_HANDLE);
+	framebuffers_deferred.clear();
+	// destroy G-buffer image views and images
+	for (uint32_t i = 0; i < (uint32_t)gbufferImages.size(); i++) {
+		vkDestroyImageView(context.device.device, gbufferImageViews[i], VK_NULL_HANDLE);
+		vmaDestroyImage(context.device.allocator, gbufferImages[i], gbufferAllocations[i]);
+	}
+	gbufferImageViews.clear();
+	gbufferImages.clear();
+	gbufferAllocations.clear();
+}
+
+// VulkanRenderer_deferred::createImages
+void VulkanRenderer_deferred::createImages() {
+	// G-buffer follows color attachments of render extent and frames count
+	VulkanRenderer_default::createImages();
+	createGBuffer();
+}
+
+// VulkanRenderer_deferred::destroyImages
+void VulkanRenderer_deferred::destroyImages() {
+	// G-buffer frame buffers reference color attachments
+	destroyGBuffer();
+	VulkanRenderer_default::destroyImages();
+}
+
+// VulkanRenderer_deferred::createRenderPasses
+void VulkanRenderer_deferred::createRenderPasses() {
+	// deferred render pass and its pipelines follow surface format
+	VulkanRenderer_default::createRenderPasses();
+	createDeferredRenderPass();
+	createDeferredPipelines();
+}
+
+// VulkanRenderer_deferred::destroyRenderPasses
+void VulkanRenderer_deferred::destroyRenderPasses() {
+	// destroy deferred pipelines with their render pass
+	destroyDeferredPipelines();
+	destroyDeferredRenderPass();
+	VulkanRenderer_default::destroyRenderPasses();
+}
+
+// VulkanRenderer_deferred::beforeRenderPass
+void VulkanRenderer_deferred::beforeRenderPass(VulkanCommandBuffer& commandBuffer, VulkanScene* scene, uint32_t frameIndex)
+{
+	// deferred data of first view (buffer of frame is not used by queued frames)
+	VulkanDeferredData deferredData{};
+	deferredData.matrixViewProjectionInverse = glm::inverse(scene->matrixProjection * scene->matrixView);
+	deferredData.matrixView = scene->matrixView;
+	deferredData.viewport = glm::vec4(1.0f / (float)renderExtent.width, 1.0f / (float)renderExtent.height, 0.0f, 0.0f);
+	vkCmdUpdateBuffer(commandBuffer.commandBuffer, deferredDataBuffers[frameIndex].buffer, 0, sizeof(VulkanDeferredData), &deferredData);
+
+	// scene uniforms (updated uniforms barrier includes deferred data)
+	VulkanRenderer::beforeRenderPass(commandBuffer, scene, frameIndex);
+}
+
+// VulkanRenderer_deferred::getMeshPipeline
+VkPipeline VulkanRenderer_deferred::getMeshPipeline(VulkanMeshMatObj* mesh)
+{
+	// G-buffer subpass pipeline
+	return pipeline_mesh_obj_gbuffer[mesh->materialUsage][mesh->primitiveTopology].pipeline;
+}
+
+// VulkanRenderer_deferred::presentFrame
+void VulkanRenderer_deferred::presentFrame(VulkanCommandBuffer& commandBuffer, VulkanScene* scene)
+{
+	// VkClearValue - background albedo is unlit (zero normal alpha)
+	VkClearValue clearColors[1 + VULKAN_RENDERER_DEFERRED_GBUFFER_ATTACHMENTS];
+	clearColors[0].color = { 0.0f, 0.0f, 0.0f, 0.0f };
+	clearColors[1].color = { 0.0f, 0.125f, 0.3f, 1.0f };
+	clearColors[2].color = { 0.0f, 0.0f, 0.0f, 0.0f };
+	clearColors[3].depthStencil.depth = 1.0f;
+	clearColors[3].depthStencil.stencil = 0;
+
+	// VkRenderPassBeginInfo - G-buffer subpass is only geometry subpass (renderer has no depth pre-pass and occlusion culling)
+	VkRenderPassBeginInfo renderPassBeginInfo{};
+	renderPassBeginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+	renderPassBeginInfo.pNext = VK_NULL_HANDLE;
+	renderPassBeginInfo.renderPass = renderPass_deferred;
+	renderPassBeginInfo.framebuffer = framebuffers_deferred[framebufferIndex];
+	renderPassBeginInfo.renderArea.offset = { 0, 0 };
+	renderPassBeginInfo.renderArea.extent = renderExtent;
+	renderPassBeginInfo.clearValueCount = VKT_ARRAY_ELEMENTS_COUNT(clearColors);
+	renderPassBeginInfo.pClearValues = clearColors;
+
+	// present render pass (lighting subpass is recorded by resolve subpass)
+	presentRenderPass(commandBuffer, scene, renderPassBeginInfo, frameIndex);
+}
+
+// VulkanRenderer_deferred::presentResolveSubPass
+void VulkanRenderer_deferred::presentResolveSubPass(VulkanCommandBuffer& commandBuffer, VulkanScene* scene, const VkRenderPassBeginInfo& renderPassBeginInfo)
+{
+	// lighting subpass (recorded inline after G-buffer subpass of any contents)
+	vkCmdNextSubpass(commandBuffer.commandBuffer, VK_SUBPASS_CONTENTS_INLINE);
+	setDynamicState(commandBuffer, renderPassBeginInfo.renderArea.extent);
+	vkCmdBindPipeline(commandBuffer.commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_deferred_lighting.pipeline);
+
+	// bind scene (shadows and light clusters) and G-buffer of frame
+	scene->bind(commandBuffer);
+	vkCmdBindDescriptorSets(commandBuffer.commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, context.pipelineLayout_deferred.pipelineLayout, 3, 1, &deferredDescriptorSets[frameIndex].descriptorSet, 0, VK_NULL_HANDLE);
+
+	// shade every pixel once (lighting cost does not depend on geometry)
+	vkCmdDraw(commandBuffer.commandBuffer, 3, 1, 0, 0);
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "vulkan_renderer.hpp"
+
+// G-buffer attachments per frame (albedo, normal and lit flag, depth)
+#define VULKAN_RENDERER_DEFERRED_GBUFFER_ATTACHMENTS 3
+
+// VulkanDeferredData (std140 uniforms of lighting subpass, G-buffer set binding 3)
+struct VulkanDeferredData {
+	glm::mat4 matrixViewProjectionInverse; // world position from depth of first view
+	glm::mat4 matrixView;                  // view depth of world position (shadow cascades and light clusters)
+	glm::vec4 viewport;                    // inverse width and height of render area
+};
+
+// VulkanRenderer_deferred (geometry subpass writes G-buffer, lighting subpass shades it from input attachments)
+class VulkanRenderer_deferred : public VulkanRenderer_default {
+protected:
+	// G-buffer fragment shader files (vertex shaders of forward pipelines)
+	const char* shaders_mesh_obj_gbuffer_files_frag[VULKAN_MATERIAL_USAGE_RANGE_SIZE]{
+		"shaders/mesh_obj_color_gbuffer.frag.spv",
+		"shaders/mesh_obj_color_light_gbuffer.frag.spv",
+		"shaders/mesh_obj_color_texture_gbuffer.frag.spv",
+		"shaders/mesh_obj_color_texture_light_gbuffer.frag.spv",
+		"shaders/mesh_obj_color_texture_bump_gbuffer.frag.spv",
+		"shaders/mesh_obj_color_texture_pbr_gbuffer.frag.spv"
+	};
+	// lighting shader files (full screen triangle)
+	const char* shader_deferred_lighting_file_vert = "shaders/deferred_lighting.vert.spv";
+	const char* shader_deferred_lighting_file_frag = "shaders/deferred_lighting.frag.spv";
+	// shaders
+	VulkanShader shader_mesh_obj_gbuffer[VULKAN_MATERIAL_USAGE_RANGE_SIZE]{};
+	VulkanShader shader_deferred_lighting{};
+	// G-buffer pipelines (first subpass) and lighting pipeline (second subpass)
+	VulkanPipeline pipeline_mesh_obj_gbuffer[VULKAN_MATERIAL_USAGE_RANGE_SIZE][VK_PRIMITIVE_TOPOLOGY_RANGE_SIZE]{};
+	VulkanPipeline pipeline_deferred_lighting{};
+protected:
+	// G-buffer attachments [frameIndex * VULKAN_RENDERER_DEFERRED_GBUFFER_ATTACHMENTS + attachment] (transient, lazily allocated)
+	std::vector<VkImage>       gbufferImages{};
+	std::vector<VkImageView>   gbufferImageViews{};
+	std::vector<VmaAllocation> gbufferAllocations{};
+	// deferred data buffers and G-buffer descriptor sets per frame
+	std::vector<VulkanBuffer>        deferredDataBuffers{};
+	std::vector<VulkanDescriptorSet> deferredDescriptorSets{};
+	// frame buffers and render pass (G-buffer subpass, lighting subpass into color attachment of frame)
+	std::vector<VkFramebuffer> framebuffers_deferred{};
+	VkRenderPass               renderPass_deferred{};
+protected:
+	// create functions
+	void createDeferredShaders();
+	void createDeferredRenderPass();
+	void createDeferredPipelines();
+	void createGBuffer();
+
+	// destroy functions
+	void destroyDeferredShaders();
+	void destroyDeferredRenderPass();
+	void destroyDeferredPipelines();
+	void destroyGBuffer();
+
+	// images and render passes with G-buffer and deferred render pass
+	void createImages() override;
+	void destroyImages() override;
+	void createRenderPasses() override;
+	void destroyRenderPasses() override;
+
+	// deferred data of frame before render pass
+	void beforeRenderPass(VulkanCommandBuffer& commandBuffer, VulkanScene* scene, uint32_t frameIndex) override;
+
+	// G-buffer pipeline of mesh
+	VkPipeline getMeshPipeline(VulkanMeshMatObj* mesh) override;
+
+	// deferred render pass of frame (no depth pre-pass and occlusion culling)
+	void presentFrame(VulkanCommandBuffer& commandBuffer, VulkanScene* scene) override;
+
+	// lighting subpass (full screen triangle reads G-buffer)
+	void presentResolveSubPass(VulkanCommandBuffer& commandBuffer, VulkanScene* scene, const VkRenderPassBeginInfo& renderPassBeginInfo) override;
+public:
+	// constructor and destructor
+	VulkanRenderer_deferred(VulkanContext& context, VulkanSurface& surface, const VulkanSwapchainConfig& swapchainConfig);
+	virtual ~VulkanRenderer_deferred();
+};
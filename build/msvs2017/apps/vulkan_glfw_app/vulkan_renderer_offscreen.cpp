@@ -0,0 +1,593 @@
+#include "vulkan_renderer_offscreen.hpp"
+
+// VulkanRenderer_offscreen::VulkanRenderer_offscreen
+VulkanRenderer_offscreen::VulkanRenderer_offscreen(
+	VulkanContext& context,
+	uint32_t       width,
+	uint32_t       height,
+	uint32_t       framesCount,
+	uint32_t       viewsCount) :
+	VulkanRenderer(context),
+	width(width),
+	height(height),
+	framesCount(framesCount),
+	viewsCount(viewsCount)
+{
+	// check size, frames and views count
+	assert(width && height);
+	assert(framesCount);
+	assert(viewsCount && viewsCount <= VULKAN_SCENE_MAX_VIEWS);
+	assert(viewsCount == 1 || context.device.multiviewEnabled);
+	assert(viewsCount <= context.device.maxMultiviewViewCount);
+
+	// color attachment format
+	colorFormat = VK_FORMAT_R8G8B8A8_UNORM;
+
+	// depth-stencil attachment format (D24S8 is not available everywhere)
+	VkFormatProperties formatProperties{};
+	vkGetPhysicalDeviceFormatProperties(context.device.physicalDevice, VK_FORMAT_D24_UNORM_S8_UINT, &formatProperties);
+	depthStencilFormat = (formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT) ?
+		VK_FORMAT_D24_UNORM_S8_UINT : VK_FORMAT_D32_SFLOAT_S8_UINT;
+
+	// create offscreen targets
+	createImages();
+	createRenderPass();
+	createFramebuffers();
+	createCommandBuffers();
+	createRecordCommandBuffers(framesCount);
+	createDrawBuffers(framesCount);
+	createFences();
+	createReadbackBuffers();
+	createShaders();
+	createPipelines(renderPass);
+	// create shadow pass (cascaded shadow maps of scenes with shadows)
+	shadowPass = new VulkanShadowPass(context, VULKAN_RENDERER_SHADOW_MAP_SIZE, VULKAN_SHADOW_MAX_CASCADES);
+	// create light clusters (clustered point lights of scenes)
+	lightClusters = new VulkanLightClusters(context);
+	// create skinning (animators evaluated on record threads, skinned meshes written into geometry pool before passes)
+	skinning = new VulkanSkinning(context);
+	// create debug geometry (debug lines of meshes generated when shown)
+	debugGeometry = new VulkanDebugGeometry(context);
+}
+
+// VulkanRenderer_offscreen::~VulkanRenderer_offscreen
+VulkanRenderer_offscreen::~VulkanRenderer_offscreen()
+{
+	// wait frames in flight
+	finish();
+	// destroy handles
+	destroyPipelines();
+	destroyShaders();
+	destroyReadbackBuffers();
+	destroyFences();
+	destroyDrawBuffers();
+	destroyRecordCommandBuffers();
+	destroyCommandBuffers();
+	destroyFramebuffers();
+	destroyRenderPass();
+	destroyImages();
+}
+
+// VulkanRenderer_offscreen::createImages
+void VulkanRenderer_offscreen::createImages() {
+	// create color attachment images
+	colorAttachmentImages.resize(framesCount);
+	colorAttachmentAllocations.resize(framesCount);
+	for (uint32_t i = 0; i < framesCount; i++) {
+		// VkImageCreateInfo - color
+		VkImageCreateInfo imageCreateInfo{};
+		imageCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+		imageCreateInfo.pNext = VK_NULL_HANDLE;
+		imageCreateInfo.flags = 0;
+		imageCreateInfo.imageType = VK_IMAGE_TYPE_2D;
+		imageCreateInfo.format = colorFormat;
+		imageCreateInfo.extent.width = width;
+		imageCreateInfo.extent.height = height;
+		imageCreateInfo.extent.depth = 1;
+		imageCreateInfo.mipLevels = 1;
+		imageCreateInfo.arrayLayers = viewsCount;
+		imageCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+		imageCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+		imageCreateInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+		imageCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+		imageCreateInfo.queueFamilyIndexCount = 0;
+		imageCreateInfo.pQueueFamilyIndices = VK_NULL_HANDLE;
+		imageCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+		// VmaAllocationCreateInfo
+		VmaAllocationCreateInfo allocCreateInfo{};
+		allocCreateInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+		allocCreateInfo.flags = 0;
+
+		// vmaCreateImage
+		VKT_CHECK(vmaCreateImage(context.device.allocator, &imageCreateInfo, &allocCreateInfo, &colorAttachmentImages[i], &colorAttachmentAllocations[i], VK_NULL_HANDLE));
+		assert(colorAttachmentImages[i]);
+		assert(colorAttachmentAllocations[i]);
+	}
+	// create color attachment image views
+	colorAttachmentImageViews.resize(framesCount);
+	for (uint32_t i = 0; i < framesCount; i++) {
+		// VkImageViewCreateInfo
+		VkImageViewCreateInfo imageViewCreateInfo{};
+		imageViewCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+		imageViewCreateInfo.pNext = VK_NULL_HANDLE;
+		imageViewCreateInfo.flags = 0;
+		imageViewCreateInfo.image = colorAttachmentImages[i];
+		imageViewCreateInfo.viewType = viewsCount > 1 ? VK_IMAGE_VIEW_TYPE_2D_ARRAY : VK_IMAGE_VIEW_TYPE_2D;
+		imageViewCreateInfo.format = colorFormat;
+		imageViewCreateInfo.components.r = VK_COMPONENT_SWIZZLE_IDENTITY;
+		imageViewCreateInfo.components.g = VK_COMPONENT_SWIZZLE_IDENTITY;
+		imageViewCreateInfo.components.b = VK_COMPONENT_SWIZZLE_IDENTITY;
+		imageViewCreateInfo.components.a = VK_COMPONENT_SWIZZLE_IDENTITY;
+		imageViewCreateInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		imageViewCreateInfo.subresourceRange.baseMipLevel = 0;
+		imageViewCreateInfo.subresourceRange.levelCount = 1;
+		imageViewCreateInfo.subresourceRange.baseArrayLayer = 0;
+		imageViewCreateInfo.subresourceRange.layerCount = viewsCount;
+		VKT_CHECK(vkCreateImageView(context.device.device, &imageViewCreateInfo, VK_NULL_HANDLE, &colorAttachmentImageViews[i]));
+		assert(colorAttachmentImageViews[i]);
+	}
+	// create depth-stencil attachment images
+	depthStencilAttachmentImages.resize(framesCount);
+	depthStencilAttachmentAllocations.resize(framesCount);
+	for (uint32_t i = 0; i < framesCount; i++) {
+		// VkImageCreateInfo - depth and stencil
+		VkImageCreateInfo imageCreateInfo{};
+		imageCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+		imageCreateInfo.pNext = VK_NULL_HANDLE;
+		imageCreateInfo.flags = 0;
+		imageCreateInfo.imageType = VK_IMAGE_TYPE_2D;
+		imageCreateInfo.format = depthStencilFormat;
+		imageCreateInfo.extent.width = width;
+		imageCreateInfo.extent.height = height;
+		imageCreateInfo.extent.depth = 1;
+		imageCreateInfo.mipLevels = 1;
+		imageCreateInfo.arrayLayers = viewsCount;
+		imageCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+		imageCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+		imageCreateInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+		imageCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+		imageCreateInfo.queueFamilyIndexCount = 0;
+		imageCreateInfo.pQueueFamilyIndices = VK_NULL_HANDLE;
+		imageCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+		// VmaAllocationCreateInfo
+		VmaAllocationCreateInfo allocCreateInfo{};
+		allocCreateInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+		allocCreateInfo.flags = 0;
+
+		// vmaCreateImage
+		VKT_CHECK(vmaCreateImage(context.device.allocator, &imageCreateInfo, &allocCreateInfo, &depthStencilAttachmentImages[i], &depthStencilAttachmentAllocations[i], VK_NULL_HANDLE));
+		assert(depthStencilAttachmentImages[i]);
+		assert(depthStencilAttachmentAllocations[i]);
+	}
+	// create depth-stencil attachment image views
+	depthStencilAttachmentImageViews.resize(framesCount);
+	for (uint32_t i = 0; i < framesCount; i++) {
+		// VkImageViewCreateInfo
+		VkImageViewCreateInfo imageViewCreateInfo{};
+		imageViewCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+		imageViewCreateInfo.pNext = VK_NULL_HANDLE;
+		imageViewCreateInfo.flags = 0;
+		imageViewCreateInfo.image = depthStencilAttachmentImages[i];
+		imageViewCreateInfo.viewType = viewsCount > 1 ? VK_IMAGE_VIEW_TYPE_2D_ARRAY : VK_IMAGE_VIEW_TYPE_2D;
+		imageViewCreateInfo.format = depthStencilFormat;
+		imageViewCreateInfo.components.r = VK_COMPONENT_SWIZZLE_IDENTITY;
+		imageViewCreateInfo.components.g = VK_COMPONENT_SWIZZLE_IDENTITY;
+		imageViewCreateInfo.components.b = VK_COMPONENT_SWIZZLE_IDENTITY;
+		imageViewCreateInfo.components.a = VK_COMPONENT_SWIZZLE_IDENTITY;
+		imageViewCreateInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+		imageViewCreateInfo.subresourceRange.baseMipLevel = 0;
+		imageViewCreateInfo.subresourceRange.levelCount = 1;
+		imageViewCreateInfo.subresourceRange.baseArrayLayer = 0;
+		imageViewCreateInfo.subresourceRange.layerCount = viewsCount;
+		VKT_CHECK(vkCreateImageView(context.device.device, &imageViewCreateInfo, VK_NULL_HANDLE, &depthStencilAttachmentImageViews[i]));
+		assert(depthStencilAttachmentImageViews[i]);
+	}
+}
+
+// VulkanRenderer_offscreen::createRenderPass
+void VulkanRenderer_offscreen::createRenderPass() {
+	// VkAttachmentDescription - color
+	std::array<VkAttachmentDescription, 2> attachmentDescriptions;
+	// color attachment (left in transfer layout for readback)
+	attachmentDescriptions[0].flags = 0;
+	attachmentDescriptions[0].format = colorFormat;
+	attachmentDescriptions[0].samples = VK_SAMPLE_COUNT_1_BIT;
+	attachmentDescriptions[0].loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+	attachmentDescriptions[0].storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+	attachmentDescriptions[0].stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+	attachmentDescriptions[0].stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+	attachmentDescriptions[0].initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	attachmentDescriptions[0].finalLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+	// depth-stencil attachment (not needed after render pass)
+	attachmentDescriptions[1].flags = 0;
+	attachmentDescriptions[1].format = depthStencilFormat;
+	attachmentDescriptions[1].samples = VK_SAMPLE_COUNT_1_BIT;
+	attachmentDescriptions[1].loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+	attachmentDescriptions[1].storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+	attachmentDescriptions[1].stencilLoadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+	attachmentDescriptions[1].stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+	attachmentDescriptions[1].initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	attachmentDescriptions[1].finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+	// VkAttachmentReference - color
+	std::array<VkAttachmentReference, 1> colorAttachmentReferences;
+	colorAttachmentReferences[0].attachment = 0;
+	colorAttachmentReferences[0].layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+	// VkAttachmentReference - depth-stencil
+	VkAttachmentReference depthStencilAttachmentReference{};
+	depthStencilAttachmentReference.attachment = 1;
+	depthStencilAttachmentReference.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+	// VkSubpassDescription - subpassDescriptions
+	std::array<VkSubpassDescription, 1> subpassDescriptions;
+	subpassDescriptions[0].flags = 0;
+	subpassDescriptions[0].pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+	subpassDescriptions[0].inputAttachmentCount = 0;
+	subpassDescriptions[0].pInputAttachments = VK_NULL_HANDLE;
+	subpassDescriptions[0].colorAttachmentCount = (uint32_t)colorAttachmentReferences.size();
+	subpassDescriptions[0].pColorAttachments = colorAttachmentReferences.data();
+	subpassDescriptions[0].pResolveAttachments = VK_NULL_HANDLE;
+	subpassDescriptions[0].pDepthStencilAttachment = &depthStencilAttachmentReference;
+	subpassDescriptions[0].preserveAttachmentCount = 0;
+	subpassDescriptions[0].pPreserveAttachments = VK_NULL_HANDLE;
+
+	// VkSubpassDependency - color writes visible to readback copy
+	std::array<VkSubpassDependency, 1> subpassDependencies;
+	subpassDependencies[0].srcSubpass = 0;
+	subpassDependencies[0].dstSubpass = VK_SUBPASS_EXTERNAL;
+	subpassDependencies[0].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+	subpassDependencies[0].dstStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+	subpassDependencies[0].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+	subpassDependencies[0].dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+	subpassDependencies[0].dependencyFlags = 0;
+
+	// VkRenderPassMultiviewCreateInfo - all views rendered by one draw stream
+	uint32_t viewMask = (1u << viewsCount) - 1;
+	VkRenderPassMultiviewCreateInfo renderPassMultiviewCreateInfo{};
+	renderPassMultiviewCreateInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_MULTIVIEW_CREATE_INFO;
+	renderPassMultiviewCreateInfo.pNext = VK_NULL_HANDLE;
+	renderPassMultiviewCreateInfo.subpassCount = 1;
+	renderPassMultiviewCreateInfo.pViewMasks = &viewMask;
+	renderPassMultiviewCreateInfo.dependencyCount = 0;
+	renderPassMultiviewCreateInfo.pViewOffsets = VK_NULL_HANDLE;
+	renderPassMultiviewCreateInfo.correlationMaskCount = 1;
+	renderPassMultiviewCreateInfo.pCorrelationMasks = &viewMask;
+
+	// VkRenderPassCreateInfo
+	VkRenderPassCreateInfo renderPassCreateInfo{};
+	renderPassCreateInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+	renderPassCreateInfo.pNext = viewsCount > 1 ? &renderPassMultiviewCreateInfo : VK_NULL_HANDLE;
+	renderPassCreateInfo.attachmentCount = (uint32_t)attachmentDescriptions.size();
+	renderPassCreateInfo.pAttachments = attachmentDescriptions.data();
+	renderPassCreateInfo.subpassCount = (uint32_t)subpassDescriptions.size();
+	renderPassCreateInfo.pSubpasses = subpassDescriptions.data();
+	renderPassCreateInfo.dependencyCount = (uint32_t)subpassDependencies.size();
+	renderPassCreateInfo.pDependencies = subpassDependencies.data();
+	VKT_CHECK(vkCreateRenderPass(context.device.device, &renderPassCreateInfo, VK_NULL_HANDLE, &renderPass));
+	assert(renderPass);
+}
+
+// VulkanRenderer_offscreen::createFramebuffers
+void VulkanRenderer_offscreen::createFramebuffers() {
+	// create framebuffers
+	framebuffers.resize(framesCount);
+	for (uint32_t i = 0; i < framesCount; i++) {
+		// image views
+		VkImageView imageViews[] = { colorAttachmentImageViews[i], depthStencilAttachmentImageViews[i] };
+
+		// VkFramebufferCreateInfo
+		VkFramebufferCreateInfo framebufferCreateInfo{};
+		framebufferCreateInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+		framebufferCreateInfo.pNext = VK_NULL_HANDLE;
+		framebufferCreateInfo.flags = 0;
+		framebufferCreateInfo.renderPass = renderPass;
+		framebufferCreateInfo.attachmentCount = VKT_ARRAY_ELEMENTS_COUNT(imageViews);
+		framebufferCreateInfo.pAttachments = imageViews;
+		framebufferCreateInfo.width = width;
+		framebufferCreateInfo.height = height;
+		framebufferCreateInfo.layers = 1;
+		VKT_CHECK(vkCreateFramebuffer(context.device.device, &framebufferCreateInfo, VK_NULL_HANDLE, &framebuffers[i]));
+		assert(framebuffers[i]);
+	}
+}
+
+// VulkanRenderer_offscreen::createCommandBuffers
+void VulkanRenderer_offscreen::createCommandBuffers() {
+	// create command buffers
+	commandBuffers.resize(framesCount);
+	for (uint32_t frameIndex = 0; frameIndex < framesCount; frameIndex++)
+		vulkanCommandBufferAllocate(context.device, VK_COMMAND_BUFFER_LEVEL_PRIMARY, &commandBuffers[frameIndex]);
+}
+
+// VulkanRenderer_offscreen::createFences
+void VulkanRenderer_offscreen::createFences() {
+	// create frame fences
+	fences.resize(framesCount);
+	for (uint32_t frameIndex = 0; frameIndex < framesCount; frameIndex++) {
+		// VkFenceCreateInfo
+		VkFenceCreateInfo fenceCreateInfo{};
+		fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+		fenceCreateInfo.pNext = VK_NULL_HANDLE;
+		fenceCreateInfo.flags = 0;
+		VKT_CHECK(vkCreateFence(context.device.device, &fenceCreateInfo, VK_NULL_HANDLE, &fences[frameIndex]));
+		assert(fences[frameIndex]);
+	}
+}
+
+// VulkanRenderer_offscreen::createReadbackBuffers
+void VulkanRenderer_offscreen::createReadbackBuffers() {
+	// create readback buffers
+	readbackBuffers.resize(framesCount);
+	readbackAllocations.resize(framesCount);
+	readbackAllocationInfos.resize(framesCount);
+	for (uint32_t i = 0; i < framesCount; i++) {
+		// VkBufferCreateInfo
+		VkBufferCreateInfo bufferCreateInfo{};
+		bufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+		bufferCreateInfo.pNext = VK_NULL_HANDLE;
+		bufferCreateInfo.size = (VkDeviceSize)width * height * viewsCount * vulkanGetFormatTexelSize(colorFormat);
+		bufferCreateInfo.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+		bufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+		bufferCreateInfo.queueFamilyIndexCount = 0;
+		bufferCreateInfo.pQueueFamilyIndices = VK_NULL_HANDLE;
+
+		// VmaAllocationCreateInfo
+		VmaAllocationCreateInfo allocationCreateInfo{};
+		allocationCreateInfo.usage = VMA_MEMORY_USAGE_GPU_TO_CPU;
+		allocationCreateInfo.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+		// vmaCreateBuffer
+		VKT_CHECK(vmaCreateBuffer(context.device.allocator, &bufferCreateInfo, &allocationCreateInfo, &readbackBuffers[i], &readbackAllocations[i], &readbackAllocationInfos[i]));
+		assert(readbackAllocationInfos[i].pMappedData);
+		assert(readbackAllocations[i]);
+		assert(readbackBuffers[i]);
+	}
+	// clear readback state
+	readbackPending.assign(framesCount, VK_FALSE);
+	readbackUserData.assign(framesCount, nullptr);
+}
+
+// VulkanRenderer_offscreen::destroyImages
+void VulkanRenderer_offscreen::destroyImages() {
+	// destroy images
+	for (uint32_t i = 0; i < colorAttachmentImages.size(); i++) {
+		// destroy color attachment image views
+		vkDestroyImageView(context.device.device, colorAttachmentImageViews[i], VK_NULL_HANDLE);
+		colorAttachmentImageViews[i] = VK_NULL_HANDLE;
+		// destroy color attachment images
+		vmaDestroyImage(context.device.allocator, colorAttachmentImages[i], colorAttachmentAllocations[i]);
+		colorAttachmentImages[i] = VK_NULL_HANDLE;
+		colorAttachmentAllocations[i] = {};
+		// destroy depth-stencil attachment image views
+		vkDestroyImageView(context.device.device, depthStencilAttachmentImageViews[i], VK_NULL_HANDLE);
+		depthStencilAttachmentImageViews[i] = VK_NULL_HANDLE;
+		// destroy depth-stencil attachment images
+		vmaDestroyImage(context.device.allocator, depthStencilAttachmentImages[i], depthStencilAttachmentAllocations[i]);
+		depthStencilAttachmentImages[i] = VK_NULL_HANDLE;
+		depthStencilAttachmentAllocations[i] = {};
+	}
+}
+
+// VulkanRenderer_offscreen::destroyRenderPass
+void VulkanRenderer_offscreen::destroyRenderPass() {
+	// destroy render pass
+	vkDestroyRenderPass(context.device.device, renderPass, VK_NULL_HANDLE);
+	renderPass = VK_NULL_HANDLE;
+}
+
+// VulkanRenderer_offscreen::destroyFramebuffers
+void VulkanRenderer_offscreen::destroyFramebuffers() {
+	// destroy framebuffers
+	for (auto& framebuffer : framebuffers) {
+		vkDestroyFramebuffer(context.device.device, framebuffer, VK_NULL_HANDLE);
+		framebuffer = VK_NULL_HANDLE;
+	}
+}
+
+// VulkanRenderer_offscreen::destroyCommandBuffers
+void VulkanRenderer_offscreen::destroyCommandBuffers() {
+	// destroy command buffers
+	for (auto& commandBuffer : commandBuffers)
+		vulkanCommandBufferFree(context.device, commandBuffer);
+}
+
+// VulkanRenderer_offscreen::destroyFences
+void VulkanRenderer_offscreen::destroyFences() {
+	// destroy frame fences
+	for (auto& fence : fences) {
+		vkDestroyFence(context.device.device, fence, VK_NULL_HANDLE);
+		fence = VK_NULL_HANDLE;
+	}
+}
+
+// VulkanRenderer_offscreen::destroyReadbackBuffers
+void VulkanRenderer_offscreen::destroyReadbackBuffers() {
+	// destroy readback buffers
+	for (uint32_t i = 0; i < readbackBuffers.size(); i++) {
+		vmaDestroyBuffer(context.device.allocator, readbackBuffers[i], readbackAllocations[i]);
+		readbackBuffers[i] = VK_NULL_HANDLE;
+		readbackAllocations[i] = {};
+		readbackAllocationInfos[i] = {};
+	}
+}
+
+// VulkanRenderer_offscreen::readbackFrame
+void VulkanRenderer_offscreen::readbackFrame(uint32_t frameIndex) {
+	// skip frames without pending results
+	if (!readbackPending[frameIndex])
+		return;
+
+	// wait frame and make it reusable
+	VKT_CHECK(vkWaitForFences(context.device.device, 1, &fences[frameIndex], VK_TRUE, UINT64_MAX));
+	VKT_CHECK(vkResetFences(context.device.device, 1, &fences[frameIndex]));
+	readbackPending[frameIndex] = VK_FALSE;
+
+	// deliver pixels (memory may be non-coherent)
+	vmaInvalidateAllocation(context.device.allocator, readbackAllocations[frameIndex], 0, VK_WHOLE_SIZE);
+	if (readbackFunc)
+		readbackFunc(*this, readbackAllocationInfos[frameIndex].pMappedData, width, height * viewsCount, readbackUserData[frameIndex]);
+	readbackUserData[frameIndex] = nullptr;
+}
+
+// VulkanRenderer_offscreen::reinitialize
+void VulkanRenderer_offscreen::reinitialize() {
+	// wait frames in flight
+	finish();
+	// destroy size related handles (render pass and pipelines are kept)
+	destroyReadbackBuffers();
+	destroyFramebuffers();
+	destroyImages();
+	// create size related handles
+	createImages();
+	createFramebuffers();
+	createReadbackBuffers();
+	frameIndex = 0;
+}
+
+// VulkanRenderer_offscreen::resize
+void VulkanRenderer_offscreen::resize(uint32_t width, uint32_t height) {
+	// check size
+	assert(width && height);
+	if ((this->width == width) && (this->height == height))
+		return;
+	// set size and recreate targets
+	this->width = width;
+	this->height = height;
+	reinitialize();
+}
+
+// VulkanRenderer_offscreen::getViewHeight
+uint32_t VulkanRenderer_offscreen::getViewHeight() {
+	return height;
+}
+
+// VulkanRenderer_offscreen::getViewWidth
+uint32_t VulkanRenderer_offscreen::getViewWidth() {
+	return width;
+}
+
+// VulkanRenderer_offscreen::getViewAspect
+float VulkanRenderer_offscreen::getViewAspect() {
+	return float(width) / float(height);
+}
+
+// VulkanRenderer_offscreen::getViewsCount
+uint32_t VulkanRenderer_offscreen::getViewsCount() {
+	return viewsCount;
+}
+
+// VulkanRenderer_offscreen::setReadbackFunc
+void VulkanRenderer_offscreen::setReadbackFunc(VulkanRendererReadbackFunc readbackFunc) {
+	this->readbackFunc = readbackFunc;
+}
+
+// VulkanRenderer_offscreen::drawScene
+void VulkanRenderer_offscreen::drawScene(VulkanScene* scene)
+{
+	drawScene(scene, nullptr);
+}
+
+// VulkanRenderer_offscreen::drawScene
+void VulkanRenderer_offscreen::drawScene(VulkanScene* scene, void* userData)
+{
+	// frame slot is reused - deliver its previous result first
+	readbackFrame(frameIndex);
+
+	// VkCommandBufferBeginInfo
+	VkCommandBufferBeginInfo commandBufferBeginInfo{};
+	commandBufferBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	commandBufferBeginInfo.pNext = VK_NULL_HANDLE;
+	commandBufferBeginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+	commandBufferBeginInfo.pInheritanceInfo = nullptr; // Optional
+	VKT_CHECK(vkBeginCommandBuffer(commandBuffers[frameIndex].commandBuffer, &commandBufferBeginInfo));
+
+	// scene before render and shadow maps
+	beforeRenderPass(commandBuffers[frameIndex], scene, frameIndex);
+	presentShadowPass(commandBuffers[frameIndex], scene, frameIndex);
+	beginPipelineStatistics(commandBuffers[frameIndex], frameIndex);
+
+	// VkClearValue
+	VkClearValue clearColors[2];
+	clearColors[0].color = { 0.0f, 0.125f, 0.3f, 1.0f };
+	clearColors[1].depthStencil.depth = 1.0f;
+	clearColors[1].depthStencil.stencil = 0;
+
+	// VkRenderPassBeginInfo
+	VkRenderPassBeginInfo renderPassBeginInfo{};
+	renderPassBeginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+	renderPassBeginInfo.pNext = VK_NULL_HANDLE;
+	renderPassBeginInfo.renderPass = renderPass;
+	renderPassBeginInfo.framebuffer = framebuffers[frameIndex];
+	renderPassBeginInfo.renderArea.offset = { 0, 0 };
+	renderPassBeginInfo.renderArea.extent = { width, height };
+	renderPassBeginInfo.clearValueCount = VKT_ARRAY_ELEMENTS_COUNT(clearColors);
+	renderPassBeginInfo.pClearValues = clearColors;
+
+	// present render pass
+	presentRenderPass(commandBuffers[frameIndex], scene, renderPassBeginInfo, frameIndex);
+
+	// after render pass
+	endPipelineStatistics(commandBuffers[frameIndex], frameIndex);
+	afterRenderPass(commandBuffers[frameIndex], scene);
+
+	// VkBufferImageCopy - color attachment to readback buffer
+	VkBufferImageCopy bufferImageCopy{};
+	bufferImageCopy.bufferOffset = 0;
+	bufferImageCopy.bufferRowLength = 0;
+	bufferImageCopy.bufferImageHeight = 0;
+	bufferImageCopy.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	bufferImageCopy.imageSubresource.mipLevel = 0;
+	bufferImageCopy.imageSubresource.baseArrayLayer = 0;
+	bufferImageCopy.imageSubresource.layerCount = viewsCount;
+	bufferImageCopy.imageOffset = { 0, 0, 0 };
+	bufferImageCopy.imageExtent = { width, height, 1 };
+	vkCmdCopyImageToBuffer(commandBuffers[frameIndex].commandBuffer, colorAttachmentImages[frameIndex], VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, readbackBuffers[frameIndex], 1, &bufferImageCopy);
+
+	// VkBufferMemoryBarrier - readback visible to host
+	VkBufferMemoryBarrier bufferMemoryBarrier{};
+	bufferMemoryBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+	bufferMemoryBarrier.pNext = VK_NULL_HANDLE;
+	bufferMemoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	bufferMemoryBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+	bufferMemoryBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	bufferMemoryBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	bufferMemoryBarrier.buffer = readbackBuffers[frameIndex];
+	bufferMemoryBarrier.offset = 0;
+	bufferMemoryBarrier.size = VK_WHOLE_SIZE;
+	vkCmdPipelineBarrier(commandBuffers[frameIndex].commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 0, VK_NULL_HANDLE, 1, &bufferMemoryBarrier, 0, VK_NULL_HANDLE);
+
+	// end command buffer
+	VKT_CHECK(vkEndCommandBuffer(commandBuffers[frameIndex].commandBuffer));
+
+	// wait for culled draws
+	VkSemaphore waitSemaphore = submitDrawCulling(frameIndex);
+	VkPipelineStageFlags waitDstStageMask = VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT;
+
+	// VkSubmitInfo
+	VkSubmitInfo submitInfo{};
+	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	submitInfo.waitSemaphoreCount = waitSemaphore ? 1 : 0;
+	submitInfo.pWaitSemaphores = &waitSemaphore;
+	submitInfo.pWaitDstStageMask = &waitDstStageMask;
+	submitInfo.commandBufferCount = 1;
+	submitInfo.pCommandBuffers = &commandBuffers[frameIndex].commandBuffer;
+	VKT_CHECK(vkQueueSubmit(context.device.queueGraphics, 1, &submitInfo, fences[frameIndex]));
+
+	// result is read back when this frame slot is reused (or on finish)
+	readbackPending[frameIndex] = VK_TRUE;
+	readbackUserData[frameIndex] = userData;
+
+	// update frame index
+	frameIndex = (frameIndex + 1) % framesCount;
+}
+
+// VulkanRenderer_offscreen::finish
+void VulkanRenderer_offscreen::finish()
+{
+	// deliver results from oldest to newest frame
+	for (uint32_t i = 0; i < framesCount; i++)
+		readbackFrame((frameIndex + i) % framesCount);
+}
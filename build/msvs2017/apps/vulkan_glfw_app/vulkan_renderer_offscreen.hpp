@@ -0,0 +1,91 @@
+#pragma once
+
+#include "vulkan_renderer.hpp"
+
+// renderer readback function type (pixels are tightly packed RGBA8 rows, views are stacked vertically)
+typedef void(* VulkanRendererReadbackFunc)(VulkanRenderer& renderer, const void* pixels, uint32_t width, uint32_t height, void* userData);
+
+// VulkanRenderer_offscreen
+class VulkanRenderer_offscreen : public VulkanRenderer {
+protected:
+	// view size and attachment formats
+	uint32_t width{};
+	uint32_t height{};
+	VkFormat colorFormat{};
+	VkFormat depthStencilFormat{};
+protected:
+	// frames in flight and frame indexes
+	uint32_t frameIndex{};
+	uint32_t framesCount{};
+	// views rendered by one draw stream (multiview render pass if more than one)
+	uint32_t viewsCount{};
+protected:
+	// color attachments
+	std::vector<VkImage>       colorAttachmentImages{};
+	std::vector<VkImageView>   colorAttachmentImageViews{};
+	std::vector<VmaAllocation> colorAttachmentAllocations{};
+	// depth-stencil attachments
+	std::vector<VkImage>       depthStencilAttachmentImages{};
+	std::vector<VkImageView>   depthStencilAttachmentImageViews{};
+	std::vector<VmaAllocation> depthStencilAttachmentAllocations{};
+	// frame buffers
+	std::vector<VkFramebuffer> framebuffers{};
+	// render pass
+	VkRenderPass renderPass{};
+protected:
+	// command buffers and frame fences
+	std::vector<VulkanCommandBuffer> commandBuffers{};
+	std::vector<VkFence>             fences{};
+protected:
+	// readback buffers (host visible, persistently mapped)
+	std::vector<VkBuffer>          readbackBuffers{};
+	std::vector<VmaAllocation>     readbackAllocations{};
+	std::vector<VmaAllocationInfo> readbackAllocationInfos{};
+	// readback state
+	std::vector<VkBool32>      readbackPending{};
+	std::vector<void*>         readbackUserData{};
+	VulkanRendererReadbackFunc readbackFunc{};
+protected:
+	// create functions
+	void createImages();
+	void createRenderPass();
+	void createFramebuffers();
+	void createCommandBuffers();
+	void createFences();
+	void createReadbackBuffers();
+
+	// destroy functions
+	void destroyImages();
+	void destroyRenderPass();
+	void destroyFramebuffers();
+	void destroyCommandBuffers();
+	void destroyFences();
+	void destroyReadbackBuffers();
+
+	// readback functions
+	void readbackFrame(uint32_t frameIndex);
+public:
+	// constructor and destructor
+	VulkanRenderer_offscreen(VulkanContext& context, uint32_t width, uint32_t height, uint32_t framesCount = 2, uint32_t viewsCount = 1);
+	virtual ~VulkanRenderer_offscreen();
+
+	// reinitialize
+	void reinitialize() override;
+	void resize(uint32_t width, uint32_t height);
+
+	// getters
+	uint32_t getViewHeight() override;
+	uint32_t getViewWidth() override;
+	float getViewAspect() override;
+	uint32_t getViewsCount();
+
+	// readback function (called when frame results become available)
+	void setReadbackFunc(VulkanRendererReadbackFunc readbackFunc);
+
+	// draw functions
+	void drawScene(VulkanScene* scene) override;
+	void drawScene(VulkanScene* scene, void* userData);
+
+	// wait all frames in flight and deliver their readbacks
+	void finish();
+};
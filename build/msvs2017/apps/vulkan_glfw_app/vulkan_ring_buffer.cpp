@@ -0,0 +1,56 @@
+#include "vulkan_ring_buffer.hpp"
+#include <algorithm>
+#include <cassert>
+
+// VulkanRingBuffer::VulkanRingBuffer
+VulkanRingBuffer::VulkanRingBuffer(VulkanDevice& device, VkBufferUsageFlags usage, VkDeviceSize size) :
+	device(device)
+{
+	// create mapped buffer
+	assert(size);
+	vulkanBufferCreateMapped(device, usage, size, &buffer);
+}
+
+// VulkanRingBuffer::~VulkanRingBuffer
+VulkanRingBuffer::~VulkanRingBuffer()
+{
+	// destroy buffer
+	vulkanBufferDestroy(device, buffer);
+}
+
+// VulkanRingBuffer::beginFrame
+void VulkanRingBuffer::beginFrame(uint32_t frameIndex)
+{
+	// frames complete in submit order (regions up to end of previous use of frame are free)
+	if (frameHeads.size() <= frameIndex)
+		frameHeads.resize(frameIndex + 1, 0);
+	tail = std::max(tail, frameHeads[frameIndex]);
+	this->frameIndex = frameIndex;
+}
+
+// VulkanRingBuffer::allocate
+bool VulkanRingBuffer::allocate(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize& offset)
+{
+	// aligned region (end of buffer is skipped when region does not fit before it)
+	assert(size <= buffer.size && buffer.size % alignment == 0);
+	VkDeviceSize first = (head + alignment - 1) / alignment * alignment;
+	VkDeviceSize wrapped = first % buffer.size;
+	if (wrapped + size > buffer.size) {
+		first += buffer.size - wrapped;
+		wrapped = 0;
+	}
+	// regions of frames in flight are not overwritten
+	if (first + size - tail > buffer.size)
+		return false;
+	head = first + size;
+	offset = wrapped;
+	return true;
+}
+
+// VulkanRingBuffer::endFrame
+void VulkanRingBuffer::endFrame()
+{
+	// regions of frame are released at next begin of frame
+	frameHeads[frameIndex] = head;
+	vmaFlushAllocation(device.allocator, buffer.allocation, 0, VK_WHOLE_SIZE);
+}
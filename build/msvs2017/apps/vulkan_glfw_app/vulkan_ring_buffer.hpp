@@ -0,0 +1,35 @@
+#pragma once
+#include <vktoolkit.hpp>
+#include <vector>
+
+// VulkanRingBuffer (mapped buffer written by host, regions of frame are reused when frame is complete on device)
+class VulkanRingBuffer {
+protected:
+	// device and mapped buffer
+	VulkanDevice& device;
+	VulkanBuffer  buffer{};
+protected:
+	// allocated bytes (monotonic, wrapped into buffer) and bytes released by complete frames
+	VkDeviceSize head{};
+	VkDeviceSize tail{};
+	// head at end of last use of frames
+	std::vector<VkDeviceSize> frameHeads{};
+	uint32_t                  frameIndex{};
+public:
+	// constructor and destructor
+	VulkanRingBuffer(VulkanDevice& device, VkBufferUsageFlags usage, VkDeviceSize size);
+	~VulkanRingBuffer();
+
+	// begin frame (previous use of frame is complete on device, its regions and older are released)
+	void beginFrame(uint32_t frameIndex);
+
+	// allocate contiguous region of frame (false when ring is full)
+	bool allocate(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize& offset);
+
+	// end frame (flush host writes)
+	void endFrame();
+
+	// getters
+	VulkanBuffer& getBuffer() { return buffer; }
+	void* getMappedData(VkDeviceSize offset) const { return (uint8_t*)buffer.allocationInfo.pMappedData + offset; }
+};
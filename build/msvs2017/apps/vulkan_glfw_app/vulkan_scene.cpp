@@ -1,11 +1,13 @@
 #include "vulkan_scene.hpp"
 #include "vulkan_context.hpp"
+#include <glm/geometric.hpp>
+#include <glm/gtc/matrix_access.hpp>
 
 // VulkanScene::VulkanScene
 VulkanScene::VulkanScene(VulkanContext& context) : VulkanContextObject(context)
 {
 	// create view-projection matrices buffer
-	vulkanBufferCreate(context.device, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, 2*sizeof(glm::mat4), &bufferViewProjectionMatrices);
+	vulkanBufferCreate(context.device, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, 2*sizeof(glm::mat4)*VULKAN_SCENE_MAX_VIEWS, &bufferViewProjectionMatrices);
 	// create descriptor set
 	vulkanDescriptorSetCreate(context.device, context.descriptorSetLayout_scene, &descriptorSet);
 	// update descriptor set
@@ -24,9 +26,21 @@ VulkanScene::~VulkanScene()
 // VulkanScene::update
 void VulkanScene::update(VulkanCommandBuffer& commandBuffer)
 {
-	// update scene buffers
-	vkCmdUpdateBuffer(commandBuffer.commandBuffer, bufferViewProjectionMatrices.buffer, sizeof(glm::mat4) * 0, sizeof(matrixView), &matrixView);
-	vkCmdUpdateBuffer(commandBuffer.commandBuffer, bufferViewProjectionMatrices.buffer, sizeof(glm::mat4) * 1, sizeof(matrixProjection), &matrixProjection);
+	// update scene buffers (view matrices array, then projection matrices array)
+	assert(viewsCount > 0 && viewsCount <= VULKAN_SCENE_MAX_VIEWS);
+	vkCmdUpdateBuffer(commandBuffer.commandBuffer, bufferViewProjectionMatrices.buffer, sizeof(glm::mat4) * 0, sizeof(glm::mat4) * viewsCount, matrixViews);
+	vkCmdUpdateBuffer(commandBuffer.commandBuffer, bufferViewProjectionMatrices.buffer, sizeof(glm::mat4) * VULKAN_SCENE_MAX_VIEWS, sizeof(glm::mat4) * viewsCount, matrixProjections);
+
+	// fit shadow cascades to first view (disabled shadows leave all fragments lit, renderers without shadow pass bind no shadow maps)
+	if (shadowMaps) {
+		if (shadows)
+			shadowMaps->updateCascades(matrixView, matrixProjection, lightDirection, shadowDistance);
+		shadowMaps->update(commandBuffer, shadows);
+	}
+
+	// bin point lights into clusters of first view (renderers without light clusters bind no light clusters)
+	if (lightClusters)
+		lightClusters->update(commandBuffer, matrixView, matrixProjection, lights);
 
 	// update models
 	for (auto& model : models)
@@ -39,3 +53,39 @@ void VulkanScene::bind(VulkanCommandBuffer& commandBuffer)
 	// bind descriptor set
 	vkCmdBindDescriptorSets(commandBuffer.commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, context.pipelineLayout.pipelineLayout, 2, 1, &descriptorSet.descriptorSet, 0, VK_NULL_HANDLE);
 }
+
+// VulkanScene::setShadowMaps
+void VulkanScene::setShadowMaps(VulkanShadowMaps* shadowMaps)
+{
+	// shadow data and shadow maps bindings of scene descriptor set
+	if (shadowMaps == this->shadowMaps)
+		return;
+	this->shadowMaps = shadowMaps;
+	shadowMaps->updateDescriptorSet(descriptorSet, 2, 3);
+}
+
+// VulkanScene::setLightClusters
+void VulkanScene::setLightClusters(VulkanLightClusters* lightClusters)
+{
+	// light sources, light clusters and light clusters data bindings of scene descriptor set
+	if (lightClusters == this->lightClusters)
+		return;
+	this->lightClusters = lightClusters;
+	lightClusters->updateDescriptorSet(descriptorSet, 1, 4, 5);
+}
+
+// VulkanScene::getFrustumPlanes
+void VulkanScene::getFrustumPlanes(glm::vec4 planes[VULKAN_SCENE_MAX_VIEWS * 6]) const
+{
+	for (uint32_t viewIndex = 0; viewIndex < viewsCount; viewIndex++) {
+		// planes from rows of view-projection matrix (normalized for sphere distances)
+		glm::mat4 matrixViewProjection = matrixProjections[viewIndex] * matrixViews[viewIndex];
+		glm::vec4 row0 = glm::row(matrixViewProjection, 0);
+		glm::vec4 row1 = glm::row(matrixViewProjection, 1);
+		glm::vec4 row2 = glm::row(matrixViewProjection, 2);
+		glm::vec4 row3 = glm::row(matrixViewProjection, 3);
+		glm::vec4 viewPlanes[6] = { row3 + row0, row3 - row0, row3 + row1, row3 - row1, row3 + row2, row3 - row2 };
+		for (uint32_t planeIndex = 0; planeIndex < 6; planeIndex++)
+			planes[viewIndex * 6 + planeIndex] = viewPlanes[planeIndex] / glm::length(glm::vec3(viewPlanes[planeIndex]));
+	}
+}
@@ -1,6 +1,12 @@
 #pragma once
 
 #include "vulkan_model.hpp"
+#include "vulkan_shadow_maps.hpp"
+#include "vulkan_light_clusters.hpp"
+#include "vulkan_particles.hpp"
+
+// max views rendered by one multiview render pass (must match shaders)
+#define VULKAN_SCENE_MAX_VIEWS 8
 
 // VulkanScene
 class VulkanScene : public VulkanContextObject {
@@ -10,13 +16,34 @@ protected:
 protected:
 	// view-projection matrices buffer
 	VulkanBuffer bufferViewProjectionMatrices;
+	// shadow maps of renderer drawing scene (written into descriptor set when renderer changes)
+	VulkanShadowMaps* shadowMaps{};
+	// light clusters of renderer drawing scene (written into descriptor set when renderer changes)
+	VulkanLightClusters* lightClusters{};
 public:
 	// models
 	std::vector<VulkanModel*> models{};
+	// point lights (binned into clusters of first view every frame, VULKAN_LIGHT_CLUSTERS_MAX_LIGHTS at most)
+	std::vector<VulkanLight> lights{};
+	// particle emitters (emitted and simulated on compute queue every frame, VULKAN_PARTICLES_MAX_EMITTERS at most)
+	std::vector<VulkanParticleEmitter> particleEmitters{};
+	glm::vec3                          particleGravity = glm::vec3(0.0f, -9.81f, 0.0f);
+	float                              particleTimeStep = 0.0f; // seconds of frame, set by application
+public:
+	// per view matrices (view index is gl_ViewIndex in multiview render pass)
+	uint32_t  viewsCount = 1;
+	glm::mat4 matrixViews[VULKAN_SCENE_MAX_VIEWS]{};
+	glm::mat4 matrixProjections[VULKAN_SCENE_MAX_VIEWS]{};
+	// view and projection matrices (first view)
+	glm::mat4& matrixView = matrixViews[0];
+	glm::mat4& matrixProjection = matrixProjections[0];
 public:
-	// view and projection matrices
-	glm::mat4 matrixView;
-	glm::mat4 matrixProjection;
+	// depth only pre-pass before color pass (color pass tests equal depth without writes, no overdraw of shading)
+	VkBool32 depthPrepass = VK_FALSE;
+	// cascaded shadow maps of directional light (static models are cached, moved static models need shadow maps invalidated)
+	VkBool32  shadows = VK_FALSE;
+	glm::vec3 lightDirection = glm::vec3(-0.5f, -1.0f, -0.25f);
+	float     shadowDistance = 20.0f;
 public:
 	// constructor and destructor
 	VulkanScene(VulkanContext& context);
@@ -27,4 +54,17 @@ public:
 
 	// bind
 	virtual void bind(VulkanCommandBuffer& commandBuffer);
+
+	// normalized frustum planes of views (6 per view: left, right, bottom, top, near, far)
+	void getFrustumPlanes(glm::vec4 planes[VULKAN_SCENE_MAX_VIEWS * 6]) const;
+
+	// bind shadow maps of renderer (scene is not in flight with other shadow maps)
+	void setShadowMaps(VulkanShadowMaps* shadowMaps);
+
+	// bind light clusters of renderer (scene is not in flight with other light clusters)
+	void setLightClusters(VulkanLightClusters* lightClusters);
+
+	// getters
+	VulkanShadowMaps* getShadowMaps() const { return shadowMaps; }
+	VulkanLightClusters* getLightClusters() const { return lightClusters; }
 };
@@ -0,0 +1,522 @@
+#include "vulkan_shadow_maps.hpp"
+#include "vulkan_scene.hpp"
+#include <glm/geometric.hpp>
+#include <glm/common.hpp>
+#include <glm/exponential.hpp>
+#include <glm/gtc/matrix_access.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <cassert>
+
+// vulkanShadowMapsCreateImage (depth image with layer per cascade)
+static void vulkanShadowMapsCreateImage(
+	VulkanDevice&     device,
+	uint32_t          size,
+	uint32_t          layersCount,
+	VkImageUsageFlags usage,
+	VkImage*          image,
+	VmaAllocation*    allocation)
+{
+	// VkImageCreateInfo
+	VkImageCreateInfo imageCreateInfo{};
+	imageCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+	imageCreateInfo.pNext = VK_NULL_HANDLE;
+	imageCreateInfo.flags = 0;
+	imageCreateInfo.imageType = VK_IMAGE_TYPE_2D;
+	imageCreateInfo.format = VULKAN_SHADOW_FORMAT;
+	imageCreateInfo.extent.width = size;
+	imageCreateInfo.extent.height = size;
+	imageCreateInfo.extent.depth = 1;
+	imageCreateInfo.mipLevels = 1;
+	imageCreateInfo.arrayLayers = layersCount;
+	imageCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+	imageCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+	imageCreateInfo.usage = usage;
+	imageCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+	imageCreateInfo.queueFamilyIndexCount = VK_QUEUE_FAMILY_IGNORED;
+	imageCreateInfo.pQueueFamilyIndices = VK_NULL_HANDLE;
+	imageCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+	// VmaAllocationCreateInfo
+	VmaAllocationCreateInfo allocCreateInfo{};
+	allocCreateInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+	allocCreateInfo.flags = 0;
+
+	// vmaCreateImage
+	VKT_CHECK(vmaCreateImage(device.allocator, &imageCreateInfo, &allocCreateInfo, image, allocation, VK_NULL_HANDLE));
+	assert(*image);
+	assert(*allocation);
+}
+
+// vulkanShadowMapsCreateImageView (depth view of layers range)
+static void vulkanShadowMapsCreateImageView(
+	VulkanDevice&   device,
+	VkImage         image,
+	VkImageViewType viewType,
+	uint32_t        baseLayer,
+	uint32_t        layersCount,
+	VkImageView*    imageView)
+{
+	// VkImageViewCreateInfo
+	VkImageViewCreateInfo imageViewCreateInfo{};
+	imageViewCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+	imageViewCreateInfo.pNext = VK_NULL_HANDLE;
+	imageViewCreateInfo.flags = 0;
+	imageViewCreateInfo.image = image;
+	imageViewCreateInfo.viewType = viewType;
+	imageViewCreateInfo.format = VULKAN_SHADOW_FORMAT;
+	imageViewCreateInfo.components.r = VK_COMPONENT_SWIZZLE_IDENTITY;
+	imageViewCreateInfo.components.g = VK_COMPONENT_SWIZZLE_IDENTITY;
+	imageViewCreateInfo.components.b = VK_COMPONENT_SWIZZLE_IDENTITY;
+	imageViewCreateInfo.components.a = VK_COMPONENT_SWIZZLE_IDENTITY;
+	imageViewCreateInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+	imageViewCreateInfo.subresourceRange.baseMipLevel = 0;
+	imageViewCreateInfo.subresourceRange.levelCount = 1;
+	imageViewCreateInfo.subresourceRange.baseArrayLayer = baseLayer;
+	imageViewCreateInfo.subresourceRange.layerCount = layersCount;
+	VKT_CHECK(vkCreateImageView(device.device, &imageViewCreateInfo, VK_NULL_HANDLE, imageView));
+	assert(*imageView);
+}
+
+// vulkanShadowMapsCreateFramebuffer (depth only framebuffer of single layer view)
+static void vulkanShadowMapsCreateFramebuffer(
+	VulkanDevice&  device,
+	VkRenderPass   renderPass,
+	VkImageView    imageView,
+	uint32_t       size,
+	VkFramebuffer* framebuffer)
+{
+	// VkFramebufferCreateInfo
+	VkFramebufferCreateInfo framebufferCreateInfo{};
+	framebufferCreateInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+	framebufferCreateInfo.pNext = VK_NULL_HANDLE;
+	framebufferCreateInfo.flags = 0;
+	framebufferCreateInfo.renderPass = renderPass;
+	framebufferCreateInfo.attachmentCount = 1;
+	framebufferCreateInfo.pAttachments = &imageView;
+	framebufferCreateInfo.width = size;
+	framebufferCreateInfo.height = size;
+	framebufferCreateInfo.layers = 1;
+	VKT_CHECK(vkCreateFramebuffer(device.device, &framebufferCreateInfo, VK_NULL_HANDLE, framebuffer));
+	assert(*framebuffer);
+}
+
+// VulkanShadowMaps::VulkanShadowMaps
+VulkanShadowMaps::VulkanShadowMaps(VulkanContext& context, uint32_t size, uint32_t cascadesCount) :
+	context(context),
+	size(size),
+	cascadesCount(cascadesCount)
+{
+	assert(cascadesCount > 0 && cascadesCount <= VULKAN_SHADOW_MAX_CASCADES);
+
+	// create shadow maps (sampled, written by copy and dynamic casters) and static casters cache (copied from)
+	vulkanShadowMapsCreateImage(context.device, size, cascadesCount,
+		VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT, &image, &allocation);
+	vulkanShadowMapsCreateImage(context.device, size, cascadesCount,
+		VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT, &imageStatic, &allocationStatic);
+	vulkanShadowMapsCreateImageView(context.device, image, VK_IMAGE_VIEW_TYPE_2D_ARRAY, 0, cascadesCount, &imageView);
+	layerImageViews.resize(cascadesCount);
+	layerImageViewsStatic.resize(cascadesCount);
+	for (uint32_t cascade = 0; cascade < cascadesCount; cascade++) {
+		vulkanShadowMapsCreateImageView(context.device, image, VK_IMAGE_VIEW_TYPE_2D, cascade, 1, &layerImageViews[cascade]);
+		vulkanShadowMapsCreateImageView(context.device, imageStatic, VK_IMAGE_VIEW_TYPE_2D, cascade, 1, &layerImageViewsStatic[cascade]);
+	}
+
+	// create render passes and framebuffers of cascades
+	createRenderPass(context.device, VK_ATTACHMENT_LOAD_OP_CLEAR, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, &renderPass_static);
+	createRenderPass(context.device, VK_ATTACHMENT_LOAD_OP_LOAD, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, &renderPass_dynamic);
+	framebuffers_static.resize(cascadesCount);
+	framebuffers_dynamic.resize(cascadesCount);
+	for (uint32_t cascade = 0; cascade < cascadesCount; cascade++) {
+		vulkanShadowMapsCreateFramebuffer(context.device, renderPass_static, layerImageViewsStatic[cascade], size, &framebuffers_static[cascade]);
+		vulkanShadowMapsCreateFramebuffer(context.device, renderPass_dynamic, layerImageViews[cascade], size, &framebuffers_dynamic[cascade]);
+	}
+
+	// VkSamplerCreateInfo - filtered comparison, fragments outside of cascade are clamped to its edge
+	VkSamplerCreateInfo samplerCreateInfo{};
+	samplerCreateInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+	samplerCreateInfo.pNext = VK_NULL_HANDLE;
+	samplerCreateInfo.flags = 0;
+	samplerCreateInfo.magFilter = VK_FILTER_LINEAR;
+	samplerCreateInfo.minFilter = VK_FILTER_LINEAR;
+	samplerCreateInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+	samplerCreateInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+	samplerCreateInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+	samplerCreateInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+	samplerCreateInfo.mipLodBias = 0.0f;
+	samplerCreateInfo.anisotropyEnable = VK_FALSE;
+	samplerCreateInfo.maxAnisotropy = 1.0f;
+	samplerCreateInfo.compareEnable = VK_TRUE;
+	samplerCreateInfo.compareOp = VK_COMPARE_OP_LESS_OR_EQUAL;
+	samplerCreateInfo.minLod = 0.0f;
+	samplerCreateInfo.maxLod = 0.0f;
+	samplerCreateInfo.borderColor = VK_BORDER_COLOR_FLOAT_OPAQUE_WHITE;
+	samplerCreateInfo.unnormalizedCoordinates = VK_FALSE;
+	VKT_CHECK(vkCreateSampler(context.device.device, &samplerCreateInfo, VK_NULL_HANDLE, &sampler.sampler));
+	assert(sampler.sampler);
+
+	// create shadow data buffer and cascade matrices buffers with their descriptor sets (scene layout)
+	vulkanBufferCreate(context.device, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, sizeof(VulkanShadowData), &bufferShadowData);
+	cascadeBuffers.resize(cascadesCount);
+	cascadeDescriptorSets.resize(cascadesCount);
+	for (uint32_t cascade = 0; cascade < cascadesCount; cascade++) {
+		vulkanBufferCreate(context.device, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, 2 * sizeof(glm::mat4) * VULKAN_SCENE_MAX_VIEWS, &cascadeBuffers[cascade]);
+		vulkanDescriptorSetCreate(context.device, context.descriptorSetLayout_scene, &cascadeDescriptorSets[cascade]);
+		vulkanDescriptorSetUpdateBufferUniform(context.device, cascadeDescriptorSets[cascade], cascadeBuffers[cascade], 0);
+	}
+
+	// cascades are rendered before first use
+	cascadeCenters.resize(cascadesCount);
+	cascadeExtents.resize(cascadesCount);
+	cascadeProjections.resize(cascadesCount, glm::mat4(1.0f));
+	cascadeValid.resize(cascadesCount, VK_FALSE);
+	cascadeRefreshed.resize(cascadesCount, VK_FALSE);
+
+	// create command buffer
+	VulkanCommandBuffer commandBuffer{};
+	vulkanCommandBufferAllocate(context.device, VK_COMMAND_BUFFER_LEVEL_PRIMARY, &commandBuffer);
+	vulkanCommandBufferBegin(context.device, commandBuffer, VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+
+	// VkImageMemoryBarrier - shadow maps are cleared to far depth (lit until first shadow pass)
+	VkImageMemoryBarrier imageMemoryBarrier{};
+	imageMemoryBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+	imageMemoryBarrier.pNext = VK_NULL_HANDLE;
+	imageMemoryBarrier.srcAccessMask = 0;
+	imageMemoryBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	imageMemoryBarrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	imageMemoryBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	imageMemoryBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	imageMemoryBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	imageMemoryBarrier.image = image;
+	imageMemoryBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+	imageMemoryBarrier.subresourceRange.baseMipLevel = 0;
+	imageMemoryBarrier.subresourceRange.levelCount = 1;
+	imageMemoryBarrier.subresourceRange.baseArrayLayer = 0;
+	imageMemoryBarrier.subresourceRange.layerCount = cascadesCount;
+	vkCmdPipelineBarrier(commandBuffer.commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, VK_NULL_HANDLE, 0, VK_NULL_HANDLE, 1, &imageMemoryBarrier);
+	VkClearDepthStencilValue clearDepthStencilValue{ 1.0f, 0 };
+	vkCmdClearDepthStencilImage(commandBuffer.commandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &clearDepthStencilValue, 1, &imageMemoryBarrier.subresourceRange);
+	imageMemoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	imageMemoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+	imageMemoryBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	imageMemoryBarrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	vkCmdPipelineBarrier(commandBuffer.commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, VK_NULL_HANDLE, 0, VK_NULL_HANDLE, 1, &imageMemoryBarrier);
+
+	// vkEndCommandBuffer
+	vulkanCommandBufferEnd(commandBuffer);
+
+	// submit and wait
+	vulkanQueueSubmit(context.device, commandBuffer, nullptr, nullptr);
+	VKT_CHECK(vkQueueWaitIdle(context.device.queueGraphics));
+
+	// free command buffer
+	vulkanCommandBufferFree(context.device, commandBuffer);
+}
+
+// VulkanShadowMaps::~VulkanShadowMaps
+VulkanShadowMaps::~VulkanShadowMaps()
+{
+	// destroy descriptor sets and buffers
+	for (auto& descriptorSet : cascadeDescriptorSets)
+		vulkanDescriptorSetDestroy(context.device, descriptorSet);
+	for (auto& buffer : cascadeBuffers)
+		vulkanBufferDestroy(context.device, buffer);
+	vulkanBufferDestroy(context.device, bufferShadowData);
+	// destroy sampler
+	vulkanSamplerDestroy(context.device, sampler);
+	// destroy framebuffers and render passes
+	for (auto& framebuffer : framebuffers_dynamic)
+		vkDestroyFramebuffer(context.device.device, framebuffer, VK_NULL_HANDLE);
+	for (auto& framebuffer : framebuffers_static)
+		vkDestroyFramebuffer(context.device.device, framebuffer, VK_NULL_HANDLE);
+	vkDestroyRenderPass(context.device.device, renderPass_dynamic, VK_NULL_HANDLE);
+	vkDestroyRenderPass(context.device.device, renderPass_static, VK_NULL_HANDLE);
+	// destroy image views and images
+	for (auto& layerImageView : layerImageViewsStatic)
+		vkDestroyImageView(context.device.device, layerImageView, VK_NULL_HANDLE);
+	for (auto& layerImageView : layerImageViews)
+		vkDestroyImageView(context.device.device, layerImageView, VK_NULL_HANDLE);
+	vkDestroyImageView(context.device.device, imageView, VK_NULL_HANDLE);
+	vmaDestroyImage(context.device.allocator, imageStatic, allocationStatic);
+	vmaDestroyImage(context.device.allocator, image, allocation);
+}
+
+// VulkanShadowMaps::createRenderPass
+void VulkanShadowMaps::createRenderPass(
+	VulkanDevice&      device,
+	VkAttachmentLoadOp loadOp,
+	VkImageLayout      initialLayout,
+	VkImageLayout      finalLayout,
+	VkRenderPass*      renderPass)
+{
+	// VkAttachmentDescription - depth
+	VkAttachmentDescription attachmentDescription{};
+	attachmentDescription.flags = 0;
+	attachmentDescription.format = VULKAN_SHADOW_FORMAT;
+	attachmentDescription.samples = VK_SAMPLE_COUNT_1_BIT;
+	attachmentDescription.loadOp = loadOp;
+	attachmentDescription.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+	attachmentDescription.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+	attachmentDescription.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+	attachmentDescription.initialLayout = initialLayout;
+	attachmentDescription.finalLayout = finalLayout;
+
+	// VkAttachmentReference - depth
+	VkAttachmentReference depthAttachmentReference{};
+	depthAttachmentReference.attachment = 0;
+	depthAttachmentReference.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+	// VkSubpassDescription - depth only subpass
+	VkSubpassDescription subpassDescription{};
+	subpassDescription.flags = 0;
+	subpassDescription.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+	subpassDescription.inputAttachmentCount = 0;
+	subpassDescription.pInputAttachments = VK_NULL_HANDLE;
+	subpassDescription.colorAttachmentCount = 0;
+	subpassDescription.pColorAttachments = VK_NULL_HANDLE;
+	subpassDescription.pResolveAttachments = VK_NULL_HANDLE;
+	subpassDescription.pDepthStencilAttachment = &depthAttachmentReference;
+	subpassDescription.preserveAttachmentCount = 0;
+	subpassDescription.pPreserveAttachments = VK_NULL_HANDLE;
+
+	// VkSubpassDependency - depth is written after cache copy, then copied into shadow maps or sampled by lit shaders
+	VkSubpassDependency subpassDependencies[2]{};
+	subpassDependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+	subpassDependencies[0].dstSubpass = 0;
+	subpassDependencies[0].srcStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+	subpassDependencies[0].dstStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+	subpassDependencies[0].srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	subpassDependencies[0].dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+	subpassDependencies[0].dependencyFlags = 0;
+	subpassDependencies[1].srcSubpass = 0;
+	subpassDependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+	subpassDependencies[1].srcStageMask = VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+	subpassDependencies[1].dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT;
+	subpassDependencies[1].srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+	subpassDependencies[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_TRANSFER_READ_BIT;
+	subpassDependencies[1].dependencyFlags = 0;
+
+	// VkRenderPassCreateInfo
+	VkRenderPassCreateInfo renderPassCreateInfo{};
+	renderPassCreateInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+	renderPassCreateInfo.attachmentCount = 1;
+	renderPassCreateInfo.pAttachments = &attachmentDescription;
+	renderPassCreateInfo.subpassCount = 1;
+	renderPassCreateInfo.pSubpasses = &subpassDescription;
+	renderPassCreateInfo.dependencyCount = VKT_ARRAY_ELEMENTS_COUNT(subpassDependencies);
+	renderPassCreateInfo.pDependencies = subpassDependencies;
+	VKT_CHECK(vkCreateRenderPass(device.device, &renderPassCreateInfo, VK_NULL_HANDLE, renderPass));
+	assert(*renderPass);
+}
+
+// VulkanShadowMaps::updateCascades
+void VulkanShadowMaps::updateCascades(const glm::mat4& matrixView, const glm::mat4& matrixProjection, const glm::vec3& lightDirection, float shadowDistance)
+{
+	// light view looks along light direction (changed direction invalidates all cached cascades)
+	glm::vec3 direction = glm::normalize(lightDirection);
+	if (direction != this->lightDirection) {
+		this->lightDirection = direction;
+		glm::vec3 up = glm::abs(direction.y) > 0.99f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+		matrixLightView = glm::lookAt(glm::vec3(0.0f), direction, up);
+		invalidate();
+	}
+
+	// view near and far planes (perspective projection, depth -1..1) and near plane corners in view space
+	float viewNear = matrixProjection[3][2] / (matrixProjection[2][2] - 1.0f);
+	float viewFar = glm::min(matrixProjection[3][2] / (matrixProjection[2][2] + 1.0f), shadowDistance);
+	glm::mat4 matrixProjectionInverse = glm::inverse(matrixProjection);
+	glm::vec3 nearCorners[4];
+	for (uint32_t corner = 0; corner < 4; corner++) {
+		glm::vec4 position = matrixProjectionInverse * glm::vec4(corner & 1 ? 1.0f : -1.0f, corner & 2 ? 1.0f : -1.0f, -1.0f, 1.0f);
+		nearCorners[corner] = glm::vec3(position) / position.w;
+	}
+	glm::mat4 matrixViewInverse = glm::inverse(matrixView);
+
+	// fit cascades to view slices
+	cascadeRefreshedCount = 0;
+	uint32_t movedRefreshedCount = 0;
+	float sliceNear = viewNear;
+	for (uint32_t cascade = 0; cascade < cascadesCount; cascade++) {
+		// practical split (logarithmic and uniform splits blended)
+		float ratio = float(cascade + 1) / float(cascadesCount);
+		float splitLog = viewNear * glm::pow(viewFar / viewNear, ratio);
+		float splitUniform = viewNear + (viewFar - viewNear) * ratio;
+		float sliceFar = splitLambda * splitLog + (1.0f - splitLambda) * splitUniform;
+		shadowData.cascadeSplits[cascade] = sliceFar;
+
+		// bounding sphere of slice corners (rigid with view, radius rounded up to keep extent stable)
+		glm::vec3 corners[8];
+		glm::vec3 center(0.0f);
+		for (uint32_t corner = 0; corner < 4; corner++) {
+			corners[corner * 2 + 0] = nearCorners[corner] * (sliceNear / viewNear);
+			corners[corner * 2 + 1] = nearCorners[corner] * (sliceFar / viewNear);
+			center += corners[corner * 2 + 0] + corners[corner * 2 + 1];
+		}
+		center /= 8.0f;
+		float radius = 0.0f;
+		for (uint32_t corner = 0; corner < 8; corner++)
+			radius = glm::max(radius, glm::length(corners[corner] - center));
+		radius = glm::ceil(radius * 16.0f) / 16.0f;
+		sliceNear = sliceFar;
+
+		// light space center and extent with margin (texel size is fixed by extent)
+		glm::vec3 lightCenter = glm::vec3(matrixLightView * matrixViewInverse * glm::vec4(center, 1.0f));
+		float extent = radius * float(size) / float(size - 2 * VULKAN_SHADOW_MARGIN_TEXELS);
+		float margin = extent - radius;
+		float texelSize = 2.0f * extent / float(size);
+
+		// cached cascade still contains slice (moved less than margin) or cascade is refreshed
+		glm::vec3 offset = glm::abs(lightCenter - cascadeCenters[cascade]);
+		VkBool32 contained = extent == cascadeExtents[cascade] && offset.x <= margin && offset.y <= margin && offset.z <= margin;
+		cascadeRefreshed[cascade] = !cascadeValid[cascade] || (!contained && movedRefreshedCount < staticRefreshMax);
+		if (cascadeRefreshed[cascade]) {
+			if (cascadeValid[cascade])
+				movedRefreshedCount++;
+			cascadeRefreshedCount++;
+			cascadeValid[cascade] = VK_TRUE;
+			// center snapped to texels (static casters do not shimmer when cascade moves)
+			cascadeCenters[cascade] = glm::floor(lightCenter / texelSize + 0.5f) * texelSize;
+			cascadeExtents[cascade] = extent;
+			// casters up to shadow distance towards light are included
+			const glm::vec3& c = cascadeCenters[cascade];
+			cascadeProjections[cascade] = glm::orthoRH_ZO(c.x - extent, c.x + extent, c.y - extent, c.y + extent, -c.z - extent - shadowDistance, -c.z + extent);
+		}
+
+		// shadow matrix (world to shadow map texture coordinates and depth, shadow pass viewport is flipped like scene viewport)
+		glm::mat4 matrixBias = glm::scale(glm::translate(glm::mat4(1.0f), glm::vec3(0.5f, 0.5f, 0.0f)), glm::vec3(0.5f, -0.5f, 1.0f));
+		shadowData.shadowMatrices[cascade] = matrixBias * cascadeProjections[cascade] * matrixLightView;
+	}
+	shadowData.lightDirection = glm::vec4(direction, 0.0f);
+}
+
+// VulkanShadowMaps::update
+void VulkanShadowMaps::update(VulkanCommandBuffer& commandBuffer, VkBool32 enabled)
+{
+	// shadow data (no cascades when disabled)
+	shadowData.cascadesCount = enabled ? cascadesCount : 0;
+	vkCmdUpdateBuffer(commandBuffer.commandBuffer, bufferShadowData.buffer, 0, sizeof(VulkanShadowData), &shadowData);
+	if (!enabled)
+		return;
+
+	// cascade matrices (first view of scene layout)
+	for (uint32_t cascade = 0; cascade < cascadesCount; cascade++) {
+		vkCmdUpdateBuffer(commandBuffer.commandBuffer, cascadeBuffers[cascade].buffer, sizeof(glm::mat4) * 0, sizeof(glm::mat4), &matrixLightView);
+		vkCmdUpdateBuffer(commandBuffer.commandBuffer, cascadeBuffers[cascade].buffer, sizeof(glm::mat4) * VULKAN_SCENE_MAX_VIEWS, sizeof(glm::mat4), &cascadeProjections[cascade]);
+	}
+}
+
+// VulkanShadowMaps::invalidate
+void VulkanShadowMaps::invalidate()
+{
+	// all cascades are refreshed by next update
+	for (auto& valid : cascadeValid)
+		valid = VK_FALSE;
+}
+
+// VulkanShadowMaps::beginStatic
+void VulkanShadowMaps::beginStatic(VulkanCommandBuffer& commandBuffer, uint32_t cascade)
+{
+	// VkClearValue
+	VkClearValue clearValue{};
+	clearValue.depthStencil.depth = 1.0f;
+	clearValue.depthStencil.stencil = 0;
+
+	// VkRenderPassBeginInfo
+	VkRenderPassBeginInfo renderPassBeginInfo{};
+	renderPassBeginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+	renderPassBeginInfo.pNext = VK_NULL_HANDLE;
+	renderPassBeginInfo.renderPass = renderPass_static;
+	renderPassBeginInfo.framebuffer = framebuffers_static[cascade];
+	renderPassBeginInfo.renderArea.offset = { 0, 0 };
+	renderPassBeginInfo.renderArea.extent = { size, size };
+	renderPassBeginInfo.clearValueCount = 1;
+	renderPassBeginInfo.pClearValues = &clearValue;
+	vkCmdBeginRenderPass(commandBuffer.commandBuffer, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
+}
+
+// VulkanShadowMaps::beginDynamic
+void VulkanShadowMaps::beginDynamic(VulkanCommandBuffer& commandBuffer, uint32_t cascade)
+{
+	// VkImageMemoryBarrier - shadow map layer was sampled by previous frames
+	VkImageMemoryBarrier imageMemoryBarrier{};
+	imageMemoryBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+	imageMemoryBarrier.pNext = VK_NULL_HANDLE;
+	imageMemoryBarrier.srcAccessMask = VK_ACCESS_SHADER_READ_BIT;
+	imageMemoryBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	imageMemoryBarrier.oldLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	imageMemoryBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	imageMemoryBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	imageMemoryBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	imageMemoryBarrier.image = image;
+	imageMemoryBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+	imageMemoryBarrier.subresourceRange.baseMipLevel = 0;
+	imageMemoryBarrier.subresourceRange.levelCount = 1;
+	imageMemoryBarrier.subresourceRange.baseArrayLayer = cascade;
+	imageMemoryBarrier.subresourceRange.layerCount = 1;
+	vkCmdPipelineBarrier(commandBuffer.commandBuffer, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, VK_NULL_HANDLE, 0, VK_NULL_HANDLE, 1, &imageMemoryBarrier);
+
+	// VkImageCopy - cached static casters into shadow map layer
+	VkImageCopy imageCopy{};
+	imageCopy.srcSubresource.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+	imageCopy.srcSubresource.mipLevel = 0;
+	imageCopy.srcSubresource.baseArrayLayer = cascade;
+	imageCopy.srcSubresource.layerCount = 1;
+	imageCopy.dstSubresource = imageCopy.srcSubresource;
+	imageCopy.extent.width = size;
+	imageCopy.extent.height = size;
+	imageCopy.extent.depth = 1;
+	vkCmdCopyImage(commandBuffer.commandBuffer, imageStatic, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &imageCopy);
+
+	// VkRenderPassBeginInfo - dynamic casters are drawn over copied depth
+	VkRenderPassBeginInfo renderPassBeginInfo{};
+	renderPassBeginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+	renderPassBeginInfo.pNext = VK_NULL_HANDLE;
+	renderPassBeginInfo.renderPass = renderPass_dynamic;
+	renderPassBeginInfo.framebuffer = framebuffers_dynamic[cascade];
+	renderPassBeginInfo.renderArea.offset = { 0, 0 };
+	renderPassBeginInfo.renderArea.extent = { size, size };
+	renderPassBeginInfo.clearValueCount = 0;
+	renderPassBeginInfo.pClearValues = VK_NULL_HANDLE;
+	vkCmdBeginRenderPass(commandBuffer.commandBuffer, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
+}
+
+// VulkanShadowMaps::updateDescriptorSet
+void VulkanShadowMaps::updateDescriptorSet(VulkanDescriptorSet& descriptorSet, uint32_t bindingShadowData, uint32_t bindingShadowMaps)
+{
+	// shadow data
+	vulkanDescriptorSetUpdateBufferUniform(context.device, descriptorSet, bufferShadowData, bindingShadowData);
+
+	// VkDescriptorImageInfo - shadow maps are sampled between shadow passes
+	VkDescriptorImageInfo descriptorImageInfo{};
+	descriptorImageInfo.sampler = sampler.sampler;
+	descriptorImageInfo.imageView = imageView;
+	descriptorImageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+	// VkWriteDescriptorSet
+	VkWriteDescriptorSet writeDescriptorSet{};
+	writeDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	writeDescriptorSet.pNext = VK_NULL_HANDLE;
+	writeDescriptorSet.dstSet = descriptorSet.descriptorSet;
+	writeDescriptorSet.dstBinding = bindingShadowMaps;
+	writeDescriptorSet.dstArrayElement = 0;
+	writeDescriptorSet.descriptorCount = 1;
+	writeDescriptorSet.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+	writeDescriptorSet.pImageInfo = &descriptorImageInfo;
+	writeDescriptorSet.pBufferInfo = VK_NULL_HANDLE;
+	writeDescriptorSet.pTexelBufferView = VK_NULL_HANDLE;
+	vkUpdateDescriptorSets(context.device.device, 1, &writeDescriptorSet, 0, VK_NULL_HANDLE);
+}
+
+// VulkanShadowMaps::getCascadePlanes
+void VulkanShadowMaps::getCascadePlanes(uint32_t cascade, glm::vec4 planes[6]) const
+{
+	// planes from rows of cascade matrix (depth 0..1, near plane is row 2 alone)
+	glm::mat4 matrixLightViewProjection = cascadeProjections[cascade] * matrixLightView;
+	glm::vec4 row0 = glm::row(matrixLightViewProjection, 0);
+	glm::vec4 row1 = glm::row(matrixLightViewProjection, 1);
+	glm::vec4 row2 = glm::row(matrixLightViewProjection, 2);
+	glm::vec4 row3 = glm::row(matrixLightViewProjection, 3);
+	glm::vec4 cascadePlanes[6] = { row3 + row0, row3 - row0, row3 + row1, row3 - row1, row2, row3 - row2 };
+	for (uint32_t planeIndex = 0; planeIndex < 6; planeIndex++)
+		planes[planeIndex] = cascadePlanes[planeIndex] / glm::length(glm::vec3(cascadePlanes[planeIndex]));
+}
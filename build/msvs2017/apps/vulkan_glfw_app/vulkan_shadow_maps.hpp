@@ -0,0 +1,107 @@
+#pragma once
+
+#include "vulkan_context.hpp"
+#include <glm/vec3.hpp>
+#include <glm/mat4x4.hpp>
+#include <vector>
+
+// max cascades of directional light (must match shaders)
+#define VULKAN_SHADOW_MAX_CASCADES 4
+
+// shadow map format (depth only, sampled with comparison)
+#define VULKAN_SHADOW_FORMAT VK_FORMAT_D16_UNORM
+
+// cascade margin in texels (cached cascade is reused while its slice moves less than margin)
+#define VULKAN_SHADOW_MARGIN_TEXELS 64
+
+// VulkanShadowData (std140 shadow uniforms of lit fragment shaders, scene set binding 2)
+struct VulkanShadowData {
+	glm::mat4 shadowMatrices[VULKAN_SHADOW_MAX_CASCADES];
+	glm::vec4 cascadeSplits;
+	glm::vec4 lightDirection;
+	uint32_t  cascadesCount;
+	uint32_t  padding[3];
+};
+
+// VulkanShadowMaps (cascaded shadow maps of directional light, static casters are cached per cascade)
+class VulkanShadowMaps {
+protected:
+	// base handles
+	VulkanContext& context;
+protected:
+	// shadow map size and cascades count (one array layer per cascade)
+	uint32_t size{};
+	uint32_t cascadesCount{};
+	// sampled shadow maps (static cache copy and dynamic casters), view of all layers and views of single layers
+	VkImage                  image{};
+	VmaAllocation            allocation{};
+	VkImageView              imageView{};
+	std::vector<VkImageView> layerImageViews{};
+	// static casters cache (transfer source of sampled shadow maps)
+	VkImage                  imageStatic{};
+	VmaAllocation            allocationStatic{};
+	std::vector<VkImageView> layerImageViewsStatic{};
+	// render passes (static clears cache layer, dynamic loads copied cache) and their framebuffers per cascade
+	VkRenderPass               renderPass_static{};
+	VkRenderPass               renderPass_dynamic{};
+	std::vector<VkFramebuffer> framebuffers_static{};
+	std::vector<VkFramebuffer> framebuffers_dynamic{};
+	// comparison sampler (filtered depth comparison)
+	VulkanSampler sampler{};
+	// shadow data buffer (sampled by lit shaders)
+	VulkanBuffer     bufferShadowData{};
+	VulkanShadowData shadowData{};
+	// cascade matrices buffers and descriptor sets (scene layout, first view is light view and cascade projection)
+	std::vector<VulkanBuffer>        cascadeBuffers{};
+	std::vector<VulkanDescriptorSet> cascadeDescriptorSets{};
+protected:
+	// light view and cached cascades (light space center and extent of rendered static casters)
+	glm::vec3              lightDirection{};
+	glm::mat4              matrixLightView{};
+	std::vector<glm::vec3> cascadeCenters{};
+	std::vector<float>     cascadeExtents{};
+	std::vector<glm::mat4> cascadeProjections{};
+	std::vector<VkBool32>  cascadeValid{};
+	std::vector<VkBool32>  cascadeRefreshed{};
+	uint32_t               cascadeRefreshedCount{};
+public:
+	// moved cascades refreshed per frame (other moved cascades keep their cached placement one more frame)
+	uint32_t staticRefreshMax = 1;
+	// weight of logarithmic splits (uniform splits for the rest)
+	float splitLambda = 0.75f;
+public:
+	// constructor and destructor
+	VulkanShadowMaps(VulkanContext& context, uint32_t size, uint32_t cascadesCount);
+	~VulkanShadowMaps();
+
+	// create render pass of shadow maps (pipelines of shadow casters are created with it)
+	static void createRenderPass(VulkanDevice& device, VkAttachmentLoadOp loadOp, VkImageLayout initialLayout, VkImageLayout finalLayout, VkRenderPass* renderPass);
+
+	// fit cascades to view slices up to shadow distance (host, selects cascades with static casters to refresh)
+	void updateCascades(const glm::mat4& matrixView, const glm::mat4& matrixProjection, const glm::vec3& lightDirection, float shadowDistance);
+
+	// update shadow buffers (disabled shadows keep all fragments lit)
+	void update(VulkanCommandBuffer& commandBuffer, VkBool32 enabled);
+
+	// invalidate cached static casters (static casters changed)
+	void invalidate();
+
+	// record static casters render pass of cascade (cleared cache layer)
+	void beginStatic(VulkanCommandBuffer& commandBuffer, uint32_t cascade);
+
+	// record dynamic casters render pass of cascade (cache layer is copied to shadow map first)
+	void beginDynamic(VulkanCommandBuffer& commandBuffer, uint32_t cascade);
+
+	// write shadow data and shadow maps into descriptor set
+	void updateDescriptorSet(VulkanDescriptorSet& descriptorSet, uint32_t bindingShadowData, uint32_t bindingShadowMaps);
+
+	// normalized planes of cascade volume (left, right, bottom, top, near, far)
+	void getCascadePlanes(uint32_t cascade, glm::vec4 planes[6]) const;
+
+	// getters
+	uint32_t getSize() const { return size; }
+	uint32_t getCascadesCount() const { return cascadesCount; }
+	uint32_t getRefreshedCount() const { return cascadeRefreshedCount; }
+	VkBool32 isStaticRefreshed(uint32_t cascade) const { return cascadeRefreshed[cascade]; }
+	VkDescriptorSet getCascadeDescriptorSet(uint32_t cascade) const { return cascadeDescriptorSets[cascade].descriptorSet; }
+};
@@ -0,0 +1,181 @@
+#include "vulkan_shadow_pass.hpp"
+#include "vulkan_descriptors.hpp"
+#include <algorithm>
+
+// VulkanShadowPass::VulkanShadowPass
+VulkanShadowPass::VulkanShadowPass(VulkanContext& context, uint32_t size, uint32_t cascadesCount) :
+	context(context)
+{
+	// create shadow maps (bound to scenes drawn by renderer)
+	shadowMaps = new VulkanShadowMaps(context, size, cascadesCount);
+
+	// create depth only shader and render pass compatible with shadow maps render passes
+	vulkanShaderCreate(context.device, shader_shadow_file_vert, nullptr, &shader_shadow);
+	VulkanShadowMaps::createRenderPass(context.device, VK_ATTACHMENT_LOAD_OP_CLEAR, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, &renderPass_shadow);
+
+	// VulkanPipelineDepthState - casters are pushed away from light by slope scaled bias (no shadow acne)
+	VulkanPipelineDepthState pipelineDepthState{};
+	pipelineDepthState.depthTestEnable = VK_TRUE;
+	pipelineDepthState.depthWriteEnable = VK_TRUE;
+	pipelineDepthState.depthCompareOp = VK_COMPARE_OP_LESS;
+	pipelineDepthState.depthBiasEnable = VK_TRUE;
+	pipelineDepthState.depthBiasConstantFactor = depthBiasConstant;
+	pipelineDepthState.depthBiasSlopeFactor = depthBiasSlope;
+
+	// create pipelines of triangle topologies (cascade matrices are first view of scene set)
+	for (uint32_t topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST; topology <= VK_PRIMITIVE_TOPOLOGY_TRIANGLE_FAN; topology++) {
+		vulkanPipelineCreate(context.device, shader_shadow, context.pipelineLayout, renderPass_shadow, 0,
+			(VkPrimitiveTopology)topology, VK_POLYGON_MODE_FILL,
+			VKT_ARRAY_ELEMENTS_COUNT(vertexBindingDescriptions_mesh_obj_depth), vertexBindingDescriptions_mesh_obj_depth,
+			VKT_ARRAY_ELEMENTS_COUNT(vertexAttributeDescriptions_mesh_obj_depth), vertexAttributeDescriptions_mesh_obj_depth,
+			0, nullptr,
+			&pipelineDepthState, &pipeline_shadow_mesh_obj[topology]);
+	}
+}
+
+// VulkanShadowPass::~VulkanShadowPass
+VulkanShadowPass::~VulkanShadowPass()
+{
+	// destroy frames
+	for (auto& frame : frames) {
+		destroyFrameBuffers(frame);
+		vulkanDescriptorSetDestroy(context.device, frame.descriptorSet);
+	}
+	frames.clear();
+	// destroy pipelines, render pass and shader
+	for (uint32_t topology = VK_PRIMITIVE_TOPOLOGY_LINE_LIST; topology <= VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP_WITH_ADJACENCY; topology++)
+		vulkanPipelineDestroy(context.device, pipeline_shadow_mesh_obj[topology]);
+	vkDestroyRenderPass(context.device.device, renderPass_shadow, VK_NULL_HANDLE);
+	renderPass_shadow = VK_NULL_HANDLE;
+	vulkanShaderDestroy(context.device, shader_shadow);
+	// destroy shadow maps
+	delete shadowMaps;
+}
+
+// VulkanShadowPass::createFrameBuffers
+void VulkanShadowPass::createFrameBuffers(VulkanShadowPassFrame& frame, VkDeviceSize drawPacketsCapacity)
+{
+	// casters draw data is written by host
+	vulkanBufferCreateMapped(context.device, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, drawPacketsCapacity * sizeof(VulkanDrawData), &frame.bufferDrawData);
+	vulkanDescriptorSetUpdateBufferStorage(context.device, frame.descriptorSet, frame.bufferDrawData, 0);
+}
+
+// VulkanShadowPass::destroyFrameBuffers
+void VulkanShadowPass::destroyFrameBuffers(VulkanShadowPassFrame& frame)
+{
+	vulkanBufferDestroy(context.device, frame.bufferDrawData);
+}
+
+// VulkanShadowPass::bind
+void VulkanShadowPass::bind(VulkanScene* scene)
+{
+	// scene is drawn with shadow maps of renderer (cached static casters belong to last scene)
+	if (scene != shadowScene) {
+		shadowMaps->invalidate();
+		shadowScene = scene;
+	}
+	scene->setShadowMaps(shadowMaps);
+}
+
+// VulkanShadowPass::buildQueue
+void VulkanShadowPass::buildQueue(VulkanScene* scene, VkBool32 instancing)
+{
+	// casters are triangle meshes of visible models (static casters only for cascades with refreshed cache)
+	auto isCaster = [](const VulkanMeshMatObj* mesh) {
+		return mesh->primitiveTopology >= VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST && mesh->primitiveTopology <= VK_PRIMITIVE_TOPOLOGY_TRIANGLE_FAN;
+	};
+	shadowQueue.clear();
+	for (uint32_t cascade = 0; cascade < shadowMaps->getCascadesCount(); cascade++) {
+		VkBool32 staticRefreshed = shadowMaps->isStaticRefreshed(cascade);
+
+		// cull casters against cascade volume (extended towards light)
+		glm::vec4 planes[6];
+		shadowMaps->getCascadePlanes(cascade, planes);
+		shadowCulling.begin(planes, 1);
+		for (auto& model : scene->models) {
+			if (!model->visible || (!model->dynamic && !staticRefreshed)) continue;
+			for (auto& mesh : model->meshes)
+				if (isCaster(mesh))
+					shadowCulling.push(model->matrixModel, mesh->drawInfo.boundingBoxMin, mesh->drawInfo.boundingBoxMax, mesh->drawInfo.boundingSphere);
+		}
+		shadowCulling.cull();
+
+		// one packet per visible caster (full level of detail, static and dynamic passes of cascade)
+		uint32_t boundsIndex = 0;
+		for (auto& model : scene->models) {
+			if (!model->visible || (!model->dynamic && !staticRefreshed)) continue;
+			for (auto& mesh : model->meshes) {
+				if (!isCaster(mesh) || !shadowCulling.isVisible(boundsIndex++)) continue;
+				// VulkanDrawPacket
+				VulkanDrawPacket packet{};
+				packet.pipeline = pipeline_shadow_mesh_obj[mesh->primitiveTopology].pipeline;
+				packet.pipelineDepth = packet.pipeline;
+				packet.descriptorSetMaterial = VK_NULL_HANDLE;
+				packet.drawInfo = mesh->drawInfo;
+				packet.drawData.model = model->matrixModel;
+				packet.drawData.materialId = 0;
+				packet.key = VulkanRenderQueue::makeKey((VulkanDrawPass)(VULKAN_DRAW_PASS_SHADOW + cascade * 2 + (model->dynamic ? 1 : 0)),
+					mesh->primitiveTopology, 0, mesh->drawInfo.meshId * VULKAN_MESH_MAX_LODS, 0.0f);
+				shadowQueue.push(packet);
+			}
+		}
+	}
+	// sort by cascade pass and geometry (and merge casters of same mesh into instanced commands)
+	shadowQueue.sort(instancing);
+}
+
+// VulkanShadowPass::present
+void VulkanShadowPass::present(VulkanCommandBuffer& commandBuffer, VulkanScene* scene, uint32_t frameIndex, VkBool32 instancing)
+{
+	drawsCount = 0;
+	cachedCount = 0;
+	if (!scene->shadows)
+		return;
+
+	// build casters queue and grow draw data buffer of frame (frame is complete on device)
+	buildQueue(scene, instancing);
+	VkDeviceSize drawPacketsCount = std::max((VkDeviceSize)shadowQueue.size(), (VkDeviceSize)1);
+	if (frames.size() <= frameIndex)
+		frames.resize(frameIndex + 1);
+	VulkanShadowPassFrame& frame = frames[frameIndex];
+	if (!frame.descriptorSet.descriptorSet)
+		vulkanDescriptorSetCreate(context.device, context.descriptorSetLayout_draw, &frame.descriptorSet);
+	if (frame.bufferDrawData.size < drawPacketsCount * sizeof(VulkanDrawData)) {
+		drawPacketsCount = std::max(drawPacketsCount, std::max(frame.bufferDrawData.size / sizeof(VulkanDrawData) * 2, (VkDeviceSize)1024));
+		destroyFrameBuffers(frame);
+		createFrameBuffers(frame, drawPacketsCount);
+	}
+	shadowQueue.writeDrawData((VulkanDrawData*)frame.bufferDrawData.allocationInfo.pMappedData);
+	vmaFlushAllocation(context.device.allocator, frame.bufferDrawData.allocation, 0, VK_WHOLE_SIZE);
+
+	// VkViewport and VkRect2D - whole cascade (flipped like views of render passes)
+	uint32_t size = shadowMaps->getSize();
+	VkViewport viewport{ 0.0f, (float)size, (float)size, -(float)size, 0.0f, 1.0f };
+	VkRect2D scissor{ { 0, 0 }, { size, size } };
+
+	// record static casters of refreshed cascades into cache, then dynamic casters over cache copy (direct draws)
+	VulkanRenderQueueStats stats{};
+	for (uint32_t cascade = 0; cascade < shadowMaps->getCascadesCount(); cascade++) {
+		// bind cascade matrices and casters draw data
+		VkDescriptorSet descriptorSets[] = { shadowMaps->getCascadeDescriptorSet(cascade), frame.descriptorSet.descriptorSet };
+		vkCmdBindDescriptorSets(commandBuffer.commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, context.pipelineLayout.pipelineLayout, 2, 2, descriptorSets, 0, VK_NULL_HANDLE);
+		for (uint32_t dynamic = 0; dynamic < 2; dynamic++) {
+			if (!dynamic && !shadowMaps->isStaticRefreshed(cascade)) {
+				cachedCount++;
+				continue;
+			}
+			size_t first{}, count{};
+			shadowQueue.getPassBatches(VULKAN_DRAW_PASS_SHADOW + cascade * 2 + dynamic, &first, &count);
+			if (dynamic)
+				shadowMaps->beginDynamic(commandBuffer, cascade);
+			else
+				shadowMaps->beginStatic(commandBuffer, cascade);
+			vkCmdSetViewport(commandBuffer.commandBuffer, 0, 1, &viewport);
+			vkCmdSetScissor(commandBuffer.commandBuffer, 0, 1, &scissor);
+			vkCmdSetLineWidth(commandBuffer.commandBuffer, 1.0f);
+			shadowQueue.submit(commandBuffer, context.pipelineLayout.pipelineLayout, first, count, nullptr, VK_TRUE, stats);
+			vkCmdEndRenderPass(commandBuffer.commandBuffer);
+		}
+	}
+	drawsCount = stats.drawsCount;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "vulkan_shadow_maps.hpp"
+#include "vulkan_render_queue.hpp"
+#include "vulkan_frustum_culling.hpp"
+#include <vector>
+
+// VulkanShadowPassFrame (casters draw data written by host, draw descriptor set of frame)
+struct VulkanShadowPassFrame {
+	VulkanBuffer        bufferDrawData{};
+	VulkanDescriptorSet descriptorSet{};
+};
+
+// VulkanShadowPass (shadow casters of scene drawn into cascaded shadow maps before render passes, static casters only into refreshed cascades)
+class VulkanShadowPass {
+protected:
+	// base handles
+	VulkanContext& context;
+protected:
+	// depth only vertex shader file (position stream only)
+	const char* shader_shadow_file_vert = "shaders/mesh_obj_depth.vert.spv";
+	// shader, render pass compatible with shadow maps and casters pipelines (depth only with slope scaled bias)
+	VulkanShader   shader_shadow{};
+	VkRenderPass   renderPass_shadow{};
+	VulkanPipeline pipeline_shadow_mesh_obj[VK_PRIMITIVE_TOPOLOGY_RANGE_SIZE]{};
+protected:
+	// cascaded shadow maps bound to scenes drawn by renderer (cached static casters belong to last scene)
+	VulkanShadowMaps* shadowMaps{};
+	VulkanScene*      shadowScene{};
+	// casters queue and its culling against cascade volumes
+	VulkanRenderQueue    shadowQueue{};
+	VulkanFrustumCulling shadowCulling{};
+	// frames in flight (created on first use of frame)
+	std::vector<VulkanShadowPassFrame> frames{};
+	// depth bias of casters (pipelines are created with it)
+	float depthBiasConstant = 4.0f;
+	float depthBiasSlope = 1.5f;
+	// casters drawn and cascades reused from cache of last frame
+	uint32_t drawsCount{};
+	uint32_t cachedCount{};
+protected:
+	// create and destroy frame buffers (frame is complete on device)
+	void createFrameBuffers(VulkanShadowPassFrame& frame, VkDeviceSize drawPacketsCapacity);
+	void destroyFrameBuffers(VulkanShadowPassFrame& frame);
+
+	// build casters queue of each cascade (static and dynamic passes of cascades, culled on host)
+	void buildQueue(VulkanScene* scene, VkBool32 instancing);
+public:
+	// constructor and destructor
+	VulkanShadowPass(VulkanContext& context, uint32_t size, uint32_t cascadesCount);
+	~VulkanShadowPass();
+
+	// bind shadow maps to scene (cached static casters are invalidated when scene changes)
+	void bind(VulkanScene* scene);
+
+	// record casters of scene with shadows into cascades of shadow maps (outside of render passes)
+	void present(VulkanCommandBuffer& commandBuffer, VulkanScene* scene, uint32_t frameIndex, VkBool32 instancing);
+
+	// getters
+	VulkanShadowMaps* getShadowMaps() const { return shadowMaps; }
+	uint32_t getDrawsCount() const { return drawsCount; }
+	uint32_t getCachedCount() const { return cachedCount; }
+};
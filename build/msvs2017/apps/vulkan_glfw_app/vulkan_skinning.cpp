@@ -0,0 +1,146 @@
+#include "vulkan_skinning.hpp"
+#include <algorithm>
+#include <cstring>
+#include <cassert>
+
+// VulkanSkinning::VulkanSkinning
+VulkanSkinning::VulkanSkinning(VulkanContext& context) :
+	context(context)
+{
+	// create compute pipeline
+	vulkanPipelineCreateCompute(context.device, shader_skinning_file_comp, context.pipelineLayout_skinning, &pipeline_skinning);
+	// create palette ring
+	paletteRing = new VulkanRingBuffer(context.device, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, (VkDeviceSize)VULKAN_SKINNING_PALETTE_RING_CAPACITY * sizeof(glm::mat4));
+}
+
+// VulkanSkinning::~VulkanSkinning
+VulkanSkinning::~VulkanSkinning()
+{
+	// destroy frames
+	for (auto& frame : frames) {
+		destroyFrameBuffers(frame);
+		vulkanDescriptorSetDestroy(context.device, frame.descriptorSet);
+	}
+	frames.clear();
+	// destroy palette ring
+	delete paletteRing;
+	// destroy pipeline
+	vulkanPipelineDestroy(context.device, pipeline_skinning);
+}
+
+// VulkanSkinning::createFrameBuffers
+void VulkanSkinning::createFrameBuffers(VulkanSkinningFrame& frame, VkDeviceSize jobsCapacity)
+{
+	// jobs are written by host
+	vulkanBufferCreateMapped(context.device, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, jobsCapacity * sizeof(glm::uvec4), &frame.bufferJobs);
+	vulkanDescriptorSetUpdateBufferStorage(context.device, frame.descriptorSet, frame.bufferJobs, 0);
+}
+
+// VulkanSkinning::destroyFrameBuffers
+void VulkanSkinning::destroyFrameBuffers(VulkanSkinningFrame& frame)
+{
+	vulkanBufferDestroy(context.device, frame.bufferJobs);
+}
+
+// VulkanSkinning::update
+void VulkanSkinning::update(VulkanCommandBuffer& commandBuffer, VulkanScene* scene, uint32_t frameIndex, ThreadPool* threadPool)
+{
+	verticesCount = 0;
+	jobsCount = 0;
+	animatedCount = 0;
+	VulkanGeometryPool* geometryPool = context.geometryPool;
+	if (!geometryPool) return;
+
+	// count jobs of skinned meshes (skinned models are dynamic shadow casters)
+	uint32_t jobsCapacity = 0;
+	for (auto& model : scene->models) {
+		if (!model->visible || model->meshes_skinned.empty()) continue;
+		model->dynamic = VK_TRUE;
+		for (auto& mesh : model->meshes_skinned)
+			jobsCapacity += (mesh->getSkinVertexRange().count + VULKAN_SKINNING_GROUP_SIZE - 1) / VULKAN_SKINNING_GROUP_SIZE;
+	}
+	if (!jobsCapacity)
+		return;
+	assert(jobsCapacity <= context.device.physicalDeviceProperties.limits.maxComputeWorkGroupCount[0]);
+
+	// create frame descriptor set (geometry pool and palette ring never change)
+	if (frames.size() <= frameIndex)
+		frames.resize(frameIndex + 1);
+	VulkanSkinningFrame& frame = frames[frameIndex];
+	if (!frame.descriptorSet.descriptorSet) {
+		vulkanDescriptorSetCreate(context.device, context.descriptorSetLayout_skinning, &frame.descriptorSet);
+		vulkanDescriptorSetUpdateBufferStorage(context.device, frame.descriptorSet, paletteRing->getBuffer(), 1);
+		vulkanDescriptorSetUpdateBufferStorage(context.device, frame.descriptorSet, geometryPool->bufferSkin, 2);
+		vulkanDescriptorSetUpdateBufferStorage(context.device, frame.descriptorSet, geometryPool->bufferPos, 3);
+		vulkanDescriptorSetUpdateBufferStorage(context.device, frame.descriptorSet, geometryPool->bufferNrm, 4);
+	}
+
+	// grow frame jobs buffer (frame is complete on device)
+	VkDeviceSize jobsBufferCapacity = frame.bufferJobs.size / sizeof(glm::uvec4);
+	if (jobsBufferCapacity < jobsCapacity) {
+		destroyFrameBuffers(frame);
+		createFrameBuffers(frame, std::max((VkDeviceSize)jobsCapacity, jobsBufferCapacity * 2));
+	}
+
+	// palettes in ring (meshes without room keep last skinned vertices) and jobs of group size vertices
+	paletteRing->beginFrame(frameIndex);
+	animationTasks.clear();
+	animatorPaletteOffsets.clear();
+	glm::uvec4* jobs = (glm::uvec4*)frame.bufferJobs.allocationInfo.pMappedData;
+	for (auto& model : scene->models) {
+		if (!model->visible) continue;
+		for (auto& mesh : model->meshes_skinned) {
+			const VulkanGeometryRange& skinVertexRange = mesh->getSkinVertexRange();
+			uint32_t paletteCount = mesh->animator ? mesh->animator->getJointsCount() : (uint32_t)mesh->palette.size();
+			VkDeviceSize paletteOffset{};
+			if (!skinVertexRange.count || !paletteCount) continue;
+			// animator is evaluated once (jobs of its other meshes read palette of its first mesh)
+			auto animatorPaletteOffset = mesh->animator ? animatorPaletteOffsets.find(mesh->animator) : animatorPaletteOffsets.end();
+			if (animatorPaletteOffset != animatorPaletteOffsets.end())
+				paletteOffset = animatorPaletteOffset->second;
+			else {
+				if (!paletteRing->allocate(paletteCount * sizeof(glm::mat4), sizeof(glm::mat4), paletteOffset)) continue;
+				glm::mat4* palette = (glm::mat4*)paletteRing->getMappedData(paletteOffset);
+				if (mesh->animator) {
+					animationTasks.push_back({ mesh->animator, palette });
+					animatorPaletteOffsets.emplace(mesh->animator, paletteOffset);
+				}
+				else
+					memcpy(palette, mesh->palette.data(), paletteCount * sizeof(glm::mat4));
+			}
+			for (uint32_t first = 0; first < skinVertexRange.count; first += VULKAN_SKINNING_GROUP_SIZE)
+				jobs[jobsCount++] = glm::uvec4(
+					skinVertexRange.first + first,
+					mesh->drawInfo.firstVertex + first,
+					std::min(skinVertexRange.count - first, (uint32_t)VULKAN_SKINNING_GROUP_SIZE),
+					(uint32_t)(paletteOffset / sizeof(glm::mat4)));
+			verticesCount += skinVertexRange.count;
+		}
+	}
+
+	// evaluate distinct animators into ring on worker threads
+	animation.evaluate(animationTasks, threadPool);
+	animatedCount = (uint32_t)animationTasks.size();
+	paletteRing->endFrame();
+	vmaFlushAllocation(context.device.allocator, frame.bufferJobs.allocation, 0, VK_WHOLE_SIZE);
+	if (!jobsCount)
+		return;
+
+	// VkMemoryBarrier - previous frames in flight finished reading skinned vertices
+	VkMemoryBarrier memoryBarrier{};
+	memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+	memoryBarrier.pNext = VK_NULL_HANDLE;
+	memoryBarrier.srcAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;
+	memoryBarrier.dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+	vkCmdPipelineBarrier(commandBuffer.commandBuffer, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &memoryBarrier, 0, VK_NULL_HANDLE, 0, VK_NULL_HANDLE);
+
+	// skin vertices (one work group per job)
+	vkCmdBindPipeline(commandBuffer.commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline_skinning.pipeline);
+	vkCmdBindDescriptorSets(commandBuffer.commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, context.pipelineLayout_skinning.pipelineLayout, 0, 1, &frame.descriptorSet.descriptorSet, 0, VK_NULL_HANDLE);
+	vkCmdDispatch(commandBuffer.commandBuffer, jobsCount, 1, 1);
+
+	// VkMemoryBarrier - skinned vertices visible to vertex input of all passes
+	memoryBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+	memoryBarrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;
+	vkCmdPipelineBarrier(commandBuffer.commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, 0, 1, &memoryBarrier, 0, VK_NULL_HANDLE, 0, VK_NULL_HANDLE);
+}
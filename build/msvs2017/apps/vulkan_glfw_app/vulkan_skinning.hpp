@@ -0,0 +1,62 @@
+#pragma once
+
+#include "vulkan_scene.hpp"
+#include "vulkan_ring_buffer.hpp"
+#include "vulkan_animation.hpp"
+#include <glm/vec4.hpp>
+#include <glm/mat4x4.hpp>
+#include <unordered_map>
+#include <vector>
+
+// skinning shader work group size, vertices per job (must match shader)
+#define VULKAN_SKINNING_GROUP_SIZE 64
+
+// joint matrices of palette ring (frames in flight share ring)
+#define VULKAN_SKINNING_PALETTE_RING_CAPACITY (1 << 16)
+
+// VulkanSkinningFrame (jobs written by host, descriptor set of frame)
+struct VulkanSkinningFrame {
+	VulkanBuffer        bufferJobs{};
+	VulkanDescriptorSet descriptorSet{};
+};
+
+// VulkanSkinning (skinned meshes of visible models written into geometry pool by compute shader once per frame)
+class VulkanSkinning {
+protected:
+	// base handles
+	VulkanContext& context;
+protected:
+	// skinning shader file
+	const char* shader_skinning_file_comp = "shaders/skinning.comp.spv";
+	// compute pipeline
+	VulkanPipeline pipeline_skinning{};
+protected:
+	// frames in flight (created on first use of frame)
+	std::vector<VulkanSkinningFrame> frames{};
+	// palettes of frames (written by host and animation threads)
+	VulkanRingBuffer* paletteRing{};
+	// animators evaluated into palette ring (once per frame, meshes of same animator share its palette)
+	VulkanAnimation                                         animation{};
+	std::vector<VulkanAnimationTask>                        animationTasks{};
+	std::unordered_map<const VulkanAnimator*, VkDeviceSize> animatorPaletteOffsets{};
+	// skinned vertices, jobs and animated meshes of last frame
+	uint32_t verticesCount{};
+	uint32_t jobsCount{};
+	uint32_t animatedCount{};
+protected:
+	// create and destroy frame buffers (frame is complete on device)
+	void createFrameBuffers(VulkanSkinningFrame& frame, VkDeviceSize jobsCapacity);
+	void destroyFrameBuffers(VulkanSkinningFrame& frame);
+public:
+	// constructor and destructor
+	VulkanSkinning(VulkanContext& context);
+	~VulkanSkinning();
+
+	// write palettes (animators in parallel on idle thread pool of caller) and record skinning of skinned meshes of visible models (skinned models become dynamic)
+	void update(VulkanCommandBuffer& commandBuffer, VulkanScene* scene, uint32_t frameIndex, ThreadPool* threadPool);
+
+	// getters
+	uint32_t getVerticesCount() const { return verticesCount; }
+	uint32_t getJobsCount() const { return jobsCount; }
+	uint32_t getAnimatedCount() const { return animatedCount; }
+};
@@ -4,6 +4,12 @@
 #include <fstream>
 #include <array>
 #include <map>
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+#include <mutex>
+#include <cmath>
+#include <cfloat>
 
 #if _DEBUG
 // MyDebugReportCallback
@@ -41,15 +47,49 @@ void vulkanInstanceCreate(
 	applicationInfo.engineVersion = VK_MAKE_VERSION(0, 0, 1);
 	applicationInfo.apiVersion = VK_API_VERSION_1_1;
 
+	// get instance layer properties count
+	uint32_t layerPropertiesCount = 0;
+	VKT_CHECK(vkEnumerateInstanceLayerProperties(&layerPropertiesCount, nullptr));
+	// get instance layer properties list
+	std::vector<VkLayerProperties> layerProperties(layerPropertiesCount);
+	VKT_CHECK(vkEnumerateInstanceLayerProperties(&layerPropertiesCount, layerProperties.data()));
+
+	// skip layers not supported by loader (validation layers are optional, enabled layers are kept in instance)
+	std::vector<const char *> supportedLayerNames;
+	instance->enabledLayerNames.clear();
+	for (const auto& enabledLayerName : enabledLayerNames)
+		for (const auto& layerProperty : layerProperties)
+			if (strcmp(enabledLayerName, layerProperty.layerName) == 0) {
+				supportedLayerNames.push_back(enabledLayerName);
+				instance->enabledLayerNames.push_back(enabledLayerName);
+			}
+
+	// get instance extension properties count
+	uint32_t extensionPropertiesCount = 0;
+	VKT_CHECK(vkEnumerateInstanceExtensionProperties(VK_NULL_HANDLE, &extensionPropertiesCount, nullptr));
+	// get instance extension properties list
+	std::vector<VkExtensionProperties> extensionProperties(extensionPropertiesCount);
+	VKT_CHECK(vkEnumerateInstanceExtensionProperties(VK_NULL_HANDLE, &extensionPropertiesCount, extensionProperties.data()));
+
+	// skip extensions not supported by loader (enabled extensions are kept in instance)
+	std::vector<const char *> supportedExtensionNames;
+	instance->enabledExtensionNames.clear();
+	for (const auto& enabledExtensionName : enabledExtensionNames)
+		for (const auto& extensionProperty : extensionProperties)
+			if (strcmp(enabledExtensionName, extensionProperty.extensionName) == 0) {
+				supportedExtensionNames.push_back(enabledExtensionName);
+				instance->enabledExtensionNames.push_back(enabledExtensionName);
+			}
+
 	// VkInstanceCreateInfo
 	VkInstanceCreateInfo instanceCreateInfo{};
 	instanceCreateInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
 	instanceCreateInfo.pNext = VK_NULL_HANDLE;
 	instanceCreateInfo.pApplicationInfo = &applicationInfo;
-	instanceCreateInfo.enabledLayerCount = (uint32_t)enabledLayerNames.size();
-	instanceCreateInfo.ppEnabledLayerNames = enabledLayerNames.data();
-	instanceCreateInfo.enabledExtensionCount = (uint32_t)enabledExtensionNames.size();
-	instanceCreateInfo.ppEnabledExtensionNames = enabledExtensionNames.data();
+	instanceCreateInfo.enabledLayerCount = (uint32_t)supportedLayerNames.size();
+	instanceCreateInfo.ppEnabledLayerNames = supportedLayerNames.data();
+	instanceCreateInfo.enabledExtensionCount = (uint32_t)supportedExtensionNames.size();
+	instanceCreateInfo.ppEnabledExtensionNames = supportedExtensionNames.data();
 
 	// vkCreateInstance
 	VKT_CHECK(vkCreateInstance(&instanceCreateInfo, VK_NULL_HANDLE, &instance->instance));
@@ -72,8 +112,9 @@ void vulkanInstanceCreate(
 	callbackCreateInfo.pfnCallback = &MyDebugReportCallback;
 	callbackCreateInfo.pUserData = nullptr;
 
-	// fnCreateDebugReportCallbackEXT
-	if (fnCreateDebugReportCallbackEXT)
+	// fnCreateDebugReportCallbackEXT (only with debug report extension)
+	instance->debugReportCallback = VK_NULL_HANDLE;
+	if (fnCreateDebugReportCallbackEXT && vulkanInstanceExtensionEnabled(*instance, VK_EXT_DEBUG_REPORT_EXTENSION_NAME))
 		VKT_CHECK(fnCreateDebugReportCallbackEXT(instance->instance, &callbackCreateInfo, nullptr, &instance->debugReportCallback));
 #endif
 
@@ -92,17 +133,37 @@ void vulkanInstanceDestroy(
 {
 #ifdef _DEBUG
 	PFN_vkDestroyDebugReportCallbackEXT fnDestroyDebugReportCallbackEXT = (PFN_vkDestroyDebugReportCallbackEXT)vkGetInstanceProcAddr(instance.instance, "vkDestroyDebugReportCallbackEXT");
-	if (fnDestroyDebugReportCallbackEXT)
+	if (fnDestroyDebugReportCallbackEXT && instance.debugReportCallback)
 		fnDestroyDebugReportCallbackEXT(instance.instance, instance.debugReportCallback, nullptr);
 	instance.debugReportCallback = VK_NULL_HANDLE;
 #endif
 	// destroy handles
 	vkDestroyInstance(instance.instance, VK_NULL_HANDLE);
 	// clear handles
+	instance.enabledExtensionNames.clear();
+	instance.enabledLayerNames.clear();
 	instance.physicalDevices.clear();
 	instance.instance = VK_NULL_HANDLE;
 }
 
+// vulkanInstanceLayerEnabled
+bool vulkanInstanceLayerEnabled(
+	const VulkanInstance& instance,
+	const char*           layerName)
+{
+	// layer was requested and is supported
+	return std::find(instance.enabledLayerNames.begin(), instance.enabledLayerNames.end(), layerName) != instance.enabledLayerNames.end();
+}
+
+// vulkanInstanceExtensionEnabled
+bool vulkanInstanceExtensionEnabled(
+	const VulkanInstance& instance,
+	const char*           extensionName)
+{
+	// extension was requested and is supported
+	return std::find(instance.enabledExtensionNames.begin(), instance.enabledExtensionNames.end(), extensionName) != instance.enabledExtensionNames.end();
+}
+
 // vulkanDeviceCreate
 void vulkanDeviceCreate(
 	VulkanInstance&            instance,
@@ -114,27 +175,34 @@ void vulkanDeviceCreate(
 	// check handles
 	assert(device);
 
-	// find physical device by type
+	// find physical device by type (fall back to first device, e.g. software rasterizer)
 	device->physicalDevice = VK_NULL_HANDLE;
 	for (const auto& physicalDevice : instance.physicalDevices)
 	{
-		VkPhysicalDeviceFeatures physicalDeviceFeatures;
 		VkPhysicalDeviceProperties physicalDeviceProperties;
-		VkPhysicalDeviceMemoryProperties physicalDeviceMemoryProperties;
-		vkGetPhysicalDeviceFeatures(physicalDevice, &physicalDeviceFeatures);
 		vkGetPhysicalDeviceProperties(physicalDevice, &physicalDeviceProperties);
-		vkGetPhysicalDeviceMemoryProperties(physicalDevice, &physicalDeviceMemoryProperties);
-		if (physicalDeviceProperties.deviceType & physicalDeviceType)
+		if (physicalDeviceProperties.deviceType == physicalDeviceType)
 		{
 			device->physicalDevice = physicalDevice;
-			device->physicalDeviceFeatures = physicalDeviceFeatures;
-			device->physicalDeviceProperties = physicalDeviceProperties;
-			device->physicalDeviceMemoryProperties = physicalDeviceMemoryProperties;
 			break;
 		}
 	}
+	if (!device->physicalDevice && !instance.physicalDevices.empty())
+		device->physicalDevice = instance.physicalDevices[0];
 	assert(device->physicalDevice);
 
+	// get physical device features and properties
+	vkGetPhysicalDeviceFeatures(device->physicalDevice, &device->physicalDeviceFeatures);
+	vkGetPhysicalDeviceProperties(device->physicalDevice, &device->physicalDeviceProperties);
+	vkGetPhysicalDeviceMemoryProperties(device->physicalDevice, &device->physicalDeviceMemoryProperties);
+
+	// skip features not supported by physical device
+	const VkBool32* requestedFeatures = (const VkBool32*)&physicalDeviceFeatures;
+	const VkBool32* supportedFeatures = (const VkBool32*)&device->physicalDeviceFeatures;
+	VkBool32* enabledFeatures = (VkBool32*)&device->physicalDeviceFeaturesEnabled;
+	for (uint32_t i = 0; i < sizeof(VkPhysicalDeviceFeatures) / sizeof(VkBool32); i++)
+		enabledFeatures[i] = requestedFeatures[i] && supportedFeatures[i] ? VK_TRUE : VK_FALSE;
+
 	// get queue family properties count
 	uint32_t queueFamilyPropertiesCount = 0;
 	vkGetPhysicalDeviceQueueFamilyProperties(device->physicalDevice, &queueFamilyPropertiesCount, nullptr);
@@ -156,6 +224,77 @@ void vulkanDeviceCreate(
 	device->queueFamilyPropertiesCompute = queueFamilyProperties[device->queueFamilyIndexCompute];
 	device->queueFamilyPropertiesTransfer = queueFamilyProperties[device->queueFamilyIndexTransfer];
 
+	// get device extension properties count
+	uint32_t extensionPropertiesCount = 0;
+	VKT_CHECK(vkEnumerateDeviceExtensionProperties(device->physicalDevice, VK_NULL_HANDLE, &extensionPropertiesCount, nullptr));
+	// get device extension properties list
+	std::vector<VkExtensionProperties> extensionProperties(extensionPropertiesCount);
+	VKT_CHECK(vkEnumerateDeviceExtensionProperties(device->physicalDevice, VK_NULL_HANDLE, &extensionPropertiesCount, extensionProperties.data()));
+
+	// skip extensions not supported by physical device (enabled extensions are kept in device)
+	std::vector<const char *> supportedExtensionNames;
+	device->enabledExtensionNames.clear();
+	for (const auto& enabledExtensionName : enabledExtensionNames)
+		for (const auto& extensionProperty : extensionProperties)
+			if (strcmp(enabledExtensionName, extensionProperty.extensionName) == 0) {
+				supportedExtensionNames.push_back(enabledExtensionName);
+				device->enabledExtensionNames.push_back(enabledExtensionName);
+			}
+
+	// check external memory host and draw indirect count extensions
+	device->externalMemoryHostEnabled = vulkanDeviceExtensionEnabled(*device, VK_EXT_EXTERNAL_MEMORY_HOST_EXTENSION_NAME);
+	device->drawIndirectCountEnabled = vulkanDeviceExtensionEnabled(*device, VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
+
+	// get external memory host properties
+	device->minImportedHostPointerAlignment = 0;
+	if (device->externalMemoryHostEnabled) {
+		// VkPhysicalDeviceExternalMemoryHostPropertiesEXT
+		VkPhysicalDeviceExternalMemoryHostPropertiesEXT physicalDeviceExternalMemoryHostProperties{};
+		physicalDeviceExternalMemoryHostProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTERNAL_MEMORY_HOST_PROPERTIES_EXT;
+		physicalDeviceExternalMemoryHostProperties.pNext = VK_NULL_HANDLE;
+		// VkPhysicalDeviceProperties2
+		VkPhysicalDeviceProperties2 physicalDeviceProperties2{};
+		physicalDeviceProperties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+		physicalDeviceProperties2.pNext = &physicalDeviceExternalMemoryHostProperties;
+		vkGetPhysicalDeviceProperties2(device->physicalDevice, &physicalDeviceProperties2);
+		device->minImportedHostPointerAlignment = physicalDeviceExternalMemoryHostProperties.minImportedHostPointerAlignment;
+	}
+
+	// VkPhysicalDeviceShaderDrawParameterFeatures (core in Vulkan 1.1)
+	VkPhysicalDeviceShaderDrawParameterFeatures physicalDeviceShaderDrawParameterFeatures{};
+	physicalDeviceShaderDrawParameterFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_DRAW_PARAMETER_FEATURES;
+	physicalDeviceShaderDrawParameterFeatures.pNext = VK_NULL_HANDLE;
+	// VkPhysicalDeviceMultiviewFeatures (core in Vulkan 1.1)
+	VkPhysicalDeviceMultiviewFeatures physicalDeviceMultiviewFeatures{};
+	physicalDeviceMultiviewFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MULTIVIEW_FEATURES;
+	physicalDeviceMultiviewFeatures.pNext = &physicalDeviceShaderDrawParameterFeatures;
+	// VkPhysicalDeviceFeatures2
+	VkPhysicalDeviceFeatures2 physicalDeviceFeatures2{};
+	physicalDeviceFeatures2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+	physicalDeviceFeatures2.pNext = &physicalDeviceMultiviewFeatures;
+	vkGetPhysicalDeviceFeatures2(device->physicalDevice, &physicalDeviceFeatures2);
+	// enable multiview only (no geometry and tessellation shaders)
+	physicalDeviceMultiviewFeatures.multiviewGeometryShader = VK_FALSE;
+	physicalDeviceMultiviewFeatures.multiviewTessellationShader = VK_FALSE;
+	device->multiviewEnabled = physicalDeviceMultiviewFeatures.multiview;
+	// draw parameters (gl_DrawID, gl_BaseInstance) in shaders
+	device->shaderDrawParametersEnabled = physicalDeviceShaderDrawParameterFeatures.shaderDrawParameters;
+
+	// get multiview properties
+	device->maxMultiviewViewCount = 1;
+	if (device->multiviewEnabled) {
+		// VkPhysicalDeviceMultiviewProperties
+		VkPhysicalDeviceMultiviewProperties physicalDeviceMultiviewProperties{};
+		physicalDeviceMultiviewProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MULTIVIEW_PROPERTIES;
+		physicalDeviceMultiviewProperties.pNext = VK_NULL_HANDLE;
+		// VkPhysicalDeviceProperties2
+		VkPhysicalDeviceProperties2 physicalDeviceProperties2{};
+		physicalDeviceProperties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+		physicalDeviceProperties2.pNext = &physicalDeviceMultiviewProperties;
+		vkGetPhysicalDeviceProperties2(device->physicalDevice, &physicalDeviceProperties2);
+		device->maxMultiviewViewCount = physicalDeviceMultiviewProperties.maxMultiviewViewCount;
+	}
+
 	// deviceQueueCreateInfos
 	std::vector<VkDeviceQueueCreateInfo> deviceQueueCreateInfos;
 	float queuePriorities[] = { 1.0f };
@@ -177,15 +316,15 @@ void vulkanDeviceCreate(
 	// VkDeviceCreateInfo
 	VkDeviceCreateInfo deviceCreateInfo{};
 	deviceCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
-	deviceCreateInfo.pNext = VK_NULL_HANDLE;
+	deviceCreateInfo.pNext = &physicalDeviceMultiviewFeatures;
 	deviceCreateInfo.flags = 0;
 	deviceCreateInfo.queueCreateInfoCount = (uint32_t)deviceQueueCreateInfos.size();
 	deviceCreateInfo.pQueueCreateInfos = deviceQueueCreateInfos.data();
-	deviceCreateInfo.enabledExtensionCount = (uint32_t)enabledExtensionNames.size();
-	deviceCreateInfo.ppEnabledExtensionNames = enabledExtensionNames.data();
+	deviceCreateInfo.enabledExtensionCount = (uint32_t)supportedExtensionNames.size();
+	deviceCreateInfo.ppEnabledExtensionNames = supportedExtensionNames.data();
 	deviceCreateInfo.enabledLayerCount = 0;
 	deviceCreateInfo.ppEnabledLayerNames = VK_NULL_HANDLE;
-	deviceCreateInfo.pEnabledFeatures = &physicalDeviceFeatures;
+	deviceCreateInfo.pEnabledFeatures = &device->physicalDeviceFeaturesEnabled;
 	VKT_CHECK(vkCreateDevice(device->physicalDevice, &deviceCreateInfo, VK_NULL_HANDLE, &device->device));
 	assert(device->device);
 
@@ -197,6 +336,23 @@ void vulkanDeviceCreate(
 	assert(device->queueCompute);
 	assert(device->queueTransfer);
 
+	// vkGetMemoryHostPointerPropertiesEXT
+	device->fnGetMemoryHostPointerPropertiesEXT = VK_NULL_HANDLE;
+	if (device->externalMemoryHostEnabled) {
+		device->fnGetMemoryHostPointerPropertiesEXT = (PFN_vkGetMemoryHostPointerPropertiesEXT)vkGetDeviceProcAddr(device->device, "vkGetMemoryHostPointerPropertiesEXT");
+		assert(device->fnGetMemoryHostPointerPropertiesEXT);
+	}
+
+	// vkCmdDrawIndirectCountKHR and vkCmdDrawIndexedIndirectCountKHR
+	device->fnCmdDrawIndirectCountKHR = VK_NULL_HANDLE;
+	device->fnCmdDrawIndexedIndirectCountKHR = VK_NULL_HANDLE;
+	if (device->drawIndirectCountEnabled) {
+		device->fnCmdDrawIndirectCountKHR = (PFN_vkCmdDrawIndirectCountKHR)vkGetDeviceProcAddr(device->device, "vkCmdDrawIndirectCountKHR");
+		device->fnCmdDrawIndexedIndirectCountKHR = (PFN_vkCmdDrawIndexedIndirectCountKHR)vkGetDeviceProcAddr(device->device, "vkCmdDrawIndexedIndirectCountKHR");
+		assert(device->fnCmdDrawIndirectCountKHR);
+		assert(device->fnCmdDrawIndexedIndirectCountKHR);
+	}
+
 	// VmaAllocatorCreateInfo
 	VmaAllocatorCreateInfo allocatorCreateInfo{};
 	allocatorCreateInfo.flags = 0;
@@ -256,6 +412,14 @@ void vulkanDeviceDestroy(
 	vmaDestroyAllocator(device.allocator);
 	vkDestroyDevice(device.device, VK_NULL_HANDLE);
 	// clear handles
+	device.fnCmdDrawIndexedIndirectCountKHR = VK_NULL_HANDLE;
+	device.fnCmdDrawIndirectCountKHR = VK_NULL_HANDLE;
+	device.drawIndirectCountEnabled = VK_FALSE;
+	device.shaderDrawParametersEnabled = VK_FALSE;
+	device.fnGetMemoryHostPointerPropertiesEXT = VK_NULL_HANDLE;
+	device.minImportedHostPointerAlignment = 0;
+	device.externalMemoryHostEnabled = VK_FALSE;
+	device.enabledExtensionNames.clear();
 	device.bufferStagingAllocationInfo = {};
 	device.bufferStagingAllocation = VK_NULL_HANDLE;
 	device.bufferStaging = VK_NULL_HANDLE;
@@ -274,24 +438,44 @@ void vulkanDeviceDestroy(
 	device.queueFamilyPropertiesTransfer = {};
 	device.physicalDeviceMemoryProperties = {};
 	device.physicalDeviceProperties = {};
+	device.physicalDeviceFeaturesEnabled = {};
 	device.physicalDeviceFeatures = {};
 	device.physicalDevice = VK_NULL_HANDLE;
 }
 
+// vulkanDeviceExtensionEnabled
+bool vulkanDeviceExtensionEnabled(
+	const VulkanDevice& device,
+	const char*         extensionName)
+{
+	// extension was requested and is supported
+	return std::find(device.enabledExtensionNames.begin(), device.enabledExtensionNames.end(), extensionName) != device.enabledExtensionNames.end();
+}
+
 // vulkanSwapchainCreate
 void vulkanSwapchainCreate(
-	VulkanDevice&    device,
-	VulkanSurface&   surface,
-	VulkanSwapchain* swapchain)
+	VulkanDevice&                device,
+	VulkanSurface&               surface,
+	const VulkanSwapchainConfig& config,
+	VulkanSwapchain*             swapchain)
 {
 	// check handles
 	assert(swapchain);
 
 	// find surface format, present mode and capabilities 
+	swapchain->config = config;
 	swapchain->surfaceFormat = vulkanGetDefaultSurfaceFormat(device, surface);
-	swapchain->presentMode = vulkanGetDefaultSurfacePresentMode(device, surface);
+	swapchain->presentMode = vulkanFindSurfacePresentMode(device, surface, config.presentMode);
 	VKT_CHECK(vkGetPhysicalDeviceSurfaceCapabilitiesKHR(device.physicalDevice, surface.surface, &swapchain->surfaceCapabilities));
 
+	// images count within surface limits (zero max count is unlimited)
+	uint32_t minImageCount = std::max(config.imageCount, swapchain->surfaceCapabilities.minImageCount);
+	if (swapchain->surfaceCapabilities.maxImageCount)
+		minImageCount = std::min(minImageCount, swapchain->surfaceCapabilities.maxImageCount);
+
+	// images are rendered to, blitted to only when surface supports it
+	swapchain->imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | (swapchain->surfaceCapabilities.supportedUsageFlags & VK_IMAGE_USAGE_TRANSFER_DST_BIT);
+
 	// get present supported
 	VkBool32 supported = VK_FALSE;
 	vkGetPhysicalDeviceSurfaceSupportKHR(device.physicalDevice, device.queueFamilyIndexGraphics, surface.surface, &supported);
@@ -303,13 +487,13 @@ void vulkanSwapchainCreate(
 	swapchainCreateInfoKHR.pNext = VK_NULL_HANDLE;
 	swapchainCreateInfoKHR.flags = 0;
 	swapchainCreateInfoKHR.surface = surface.surface;
-	swapchainCreateInfoKHR.minImageCount = 3;
+	swapchainCreateInfoKHR.minImageCount = minImageCount;
 	swapchainCreateInfoKHR.imageFormat = swapchain->surfaceFormat.format;
 	swapchainCreateInfoKHR.imageColorSpace = swapchain->surfaceFormat.colorSpace;
 	swapchainCreateInfoKHR.imageExtent.width = swapchain->surfaceCapabilities.currentExtent.width;
 	swapchainCreateInfoKHR.imageExtent.height = swapchain->surfaceCapabilities.currentExtent.height;
 	swapchainCreateInfoKHR.imageArrayLayers = 1;
-	swapchainCreateInfoKHR.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+	swapchainCreateInfoKHR.imageUsage = swapchain->imageUsage;
 	swapchainCreateInfoKHR.imageSharingMode = VK_SHARING_MODE_EXCLUSIVE;
 	swapchainCreateInfoKHR.queueFamilyIndexCount = VK_QUEUE_FAMILY_IGNORED;
 	swapchainCreateInfoKHR.pQueueFamilyIndices = VK_NULL_HANDLE;
@@ -317,7 +501,7 @@ void vulkanSwapchainCreate(
 	swapchainCreateInfoKHR.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
 	swapchainCreateInfoKHR.presentMode = swapchain->presentMode;
 	swapchainCreateInfoKHR.clipped = VK_TRUE;
-	swapchainCreateInfoKHR.oldSwapchain = VK_NULL_HANDLE;
+	swapchainCreateInfoKHR.oldSwapchain = swapchain->swapchain; // retired swapchain when recreated, otherwise null
 	VKT_CHECK(vkCreateSwapchainKHR(device.device, &swapchainCreateInfoKHR, VK_NULL_HANDLE, &swapchain->swapchain));
 	assert(swapchain->swapchain);
 
@@ -328,6 +512,25 @@ void vulkanSwapchainCreate(
 	vkGetSwapchainImagesKHR(device.device, swapchain->swapchain, &imageCount, swapchain->images.data());
 }
 
+// vulkanSwapchainRecreate
+void vulkanSwapchainRecreate(
+	VulkanDevice&                device,
+	VulkanSurface&               surface,
+	const VulkanSwapchainConfig& config,
+	VulkanSwapchain*             swapchain)
+{
+	// check handles
+	assert(swapchain);
+	assert(swapchain->swapchain);
+
+	// create new swapchain from retired one (presentation engine can reuse its resources)
+	VkSwapchainKHR oldSwapchain = swapchain->swapchain;
+	vulkanSwapchainCreate(device, surface, config, swapchain);
+
+	// destroy retired swapchain (its images must not be used by device anymore)
+	vkDestroySwapchainKHR(device.device, oldSwapchain, VK_NULL_HANDLE);
+}
+
 // vulkanSwapchainDestroy
 void vulkanSwapchainDestroy(
 	VulkanDevice& device,
@@ -340,6 +543,7 @@ void vulkanSwapchainDestroy(
 	swapchain.surfaceCapabilities = {};
 	swapchain.presentMode = {};
 	swapchain.surfaceFormat = {};
+	swapchain.config = {};
 }
 
 // vulkanSwapchainBeginFrame
@@ -398,7 +602,7 @@ void vulkanSamplerCreate(
 	samplerCreateInfo.addressModeV = samplerAddressMode;
 	samplerCreateInfo.addressModeW = samplerAddressMode;
 	samplerCreateInfo.mipLodBias = 0.0f;
-	samplerCreateInfo.anisotropyEnable = anisotropyEnable;
+	samplerCreateInfo.anisotropyEnable = anisotropyEnable && device.physicalDeviceFeaturesEnabled.samplerAnisotropy;
 	samplerCreateInfo.maxAnisotropy = device.physicalDeviceProperties.limits.maxSamplerAnisotropy;
 	samplerCreateInfo.compareEnable = VK_FALSE;
 	samplerCreateInfo.compareOp = VK_COMPARE_OP_ALWAYS;
@@ -428,18 +632,22 @@ void vulkanImageCreate(
 	uint32_t      width,
 	uint32_t      height,
 	uint32_t      depth,
+	uint32_t      arrayLayers,
 	VulkanImage*  image)
 {
 	// check parameters
 	assert(width);
 	assert(height);
 	assert(depth);
+	assert(arrayLayers);
+	assert(depth == 1 || arrayLayers == 1);
 	assert(image);
 
 	// get mipmap levels count and image type
 	uint32_t mipLevels = (uint32_t)std::floor(std::log2(std::max(width, std::max(height, depth)))) + 1;
 	VkImageType imageType = depth > 1 ? VK_IMAGE_TYPE_3D : height > 1 ? VK_IMAGE_TYPE_2D : VK_IMAGE_TYPE_1D;
 	VkImageViewType imageViewType = depth > 1 ? VK_IMAGE_VIEW_TYPE_3D : height > 1 ? VK_IMAGE_VIEW_TYPE_2D : VK_IMAGE_VIEW_TYPE_1D;
+	if (arrayLayers > 1) imageViewType = height > 1 ? VK_IMAGE_VIEW_TYPE_2D_ARRAY : VK_IMAGE_VIEW_TYPE_1D_ARRAY;
 
 	// store properties
 	image->imageType = imageType;
@@ -447,6 +655,7 @@ void vulkanImageCreate(
 	image->width = width;
 	image->height = height;
 	image->depth = depth;
+	image->arrayLayers = arrayLayers;
 	image->mipLevels = mipLevels;
 	image->accessFlags.clear();
 	image->accessFlags.resize(mipLevels, 0);
@@ -464,7 +673,7 @@ void vulkanImageCreate(
 	imageCreateInfo.extent.height = height;
 	imageCreateInfo.extent.depth = depth;
 	imageCreateInfo.mipLevels = mipLevels;
-	imageCreateInfo.arrayLayers = 1;
+	imageCreateInfo.arrayLayers = arrayLayers;
 	imageCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT;
 	imageCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
 	imageCreateInfo.usage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
@@ -499,7 +708,7 @@ void vulkanImageCreate(
 	imageViewCreateInfo.subresourceRange.baseMipLevel = 0;
 	imageViewCreateInfo.subresourceRange.levelCount = image->mipLevels;
 	imageViewCreateInfo.subresourceRange.baseArrayLayer = 0;
-	imageViewCreateInfo.subresourceRange.layerCount = 1;
+	imageViewCreateInfo.subresourceRange.layerCount = image->arrayLayers;
 	VKT_CHECK(vkCreateImageView(device.device, &imageViewCreateInfo, VK_NULL_HANDLE, &image->imageView));
 	assert(image->imageView);
 }
@@ -515,6 +724,7 @@ void vulkanImageRead(
 	assert(image.width);
 	assert(image.height);
 	assert(image.depth);
+	assert(image.arrayLayers == 1);
 	assert(mipLevel < image.mipLevels);
 	assert(data);
 
@@ -534,6 +744,7 @@ void vulkanImageRead(
 	imageStaging.width = width;
 	imageStaging.height = height;
 	imageStaging.depth = depth;
+	imageStaging.arrayLayers = 1;
 	imageStaging.mipLevels = 1;
 	imageStaging.accessFlags.resize(1, 0);
 	imageStaging.imageLayouts.resize(1, VK_IMAGE_LAYOUT_UNDEFINED);
@@ -626,6 +837,7 @@ void vulkanImageWrite(
 	assert(image.width);
 	assert(image.height);
 	assert(image.depth);
+	assert(image.arrayLayers == 1);
 	assert(mipLevel < image.mipLevels);
 	assert(data);
 
@@ -645,6 +857,7 @@ void vulkanImageWrite(
 	imageStaging.width = width;
 	imageStaging.height = height;
 	imageStaging.depth = depth;
+	imageStaging.arrayLayers = 1;
 	imageStaging.mipLevels = 1;
 	imageStaging.accessFlags.resize(1, 0);
 	imageStaging.imageLayouts.resize(1, VK_IMAGE_LAYOUT_PREINITIALIZED);
@@ -726,6 +939,72 @@ void vulkanImageWrite(
 	vmaDestroyImage(device.allocator, imageStaging.image, imageStaging.allocation);
 }
 
+// vulkanImageWriteHostMemory
+void vulkanImageWriteHostMemory(
+	VulkanDevice& device,
+	VulkanImage&  image,
+	uint32_t      mipLevel,
+	const void*   data)
+{
+	// check parameters
+	assert(image.width);
+	assert(image.height);
+	assert(image.depth);
+	assert(mipLevel < image.mipLevels);
+	assert(data);
+
+	// calculate mipmap sizes 
+	uint32_t width = std::max(1U, image.width >> mipLevel);
+	uint32_t height = std::max(1U, image.height >> mipLevel);
+	uint32_t depth = std::max(1U, image.depth >> mipLevel);
+	VkDeviceSize size = (VkDeviceSize)width * height * depth * image.arrayLayers * vulkanGetFormatTexelSize(image.format);
+
+	// import host memory as transfer source (staging image if host memory can not be imported)
+	VulkanBuffer bufferHost{};
+	if (!vulkanHostMemoryIsImportable(device, data, size) ||
+		!vulkanBufferCreateFromHostMemory(device, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, size, data, &bufferHost)) {
+		vulkanImageWrite(device, image, mipLevel, data);
+		return;
+	}
+
+	// create command buffer
+	VulkanCommandBuffer commandBuffer{};
+	vulkanCommandBufferAllocate(device, VK_COMMAND_BUFFER_LEVEL_PRIMARY, &commandBuffer);
+	vulkanCommandBufferBegin(device, commandBuffer, VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+
+	// change image layouts
+	vulkanImageSetLayout(commandBuffer, image, mipLevel, VK_ACCESS_TRANSFER_WRITE_BIT, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+
+	// VkBufferImageCopy
+	VkBufferImageCopy bufferImageCopy{};
+	bufferImageCopy.bufferOffset = 0;
+	bufferImageCopy.bufferRowLength = 0;
+	bufferImageCopy.bufferImageHeight = 0;
+	bufferImageCopy.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	bufferImageCopy.imageSubresource.mipLevel = mipLevel;
+	bufferImageCopy.imageSubresource.baseArrayLayer = 0;
+	bufferImageCopy.imageSubresource.layerCount = image.arrayLayers;
+	bufferImageCopy.imageOffset = { 0, 0, 0 };
+	bufferImageCopy.imageExtent = { width, height, depth };
+	vkCmdCopyBufferToImage(commandBuffer.commandBuffer, bufferHost.buffer, image.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &bufferImageCopy);
+
+	// change image layouts
+	vulkanImageSetLayout(commandBuffer, image, mipLevel, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+	// vkEndCommandBuffer
+	vulkanCommandBufferEnd(commandBuffer);
+
+	// submit and wait
+	vulkanQueueSubmit(device, commandBuffer, nullptr, nullptr);
+	VKT_CHECK(vkQueueWaitIdle(device.queueGraphics));
+
+	// command buffer free
+	vulkanCommandBufferFree(device, commandBuffer);
+
+	// destroy handles
+	vulkanBufferDestroy(device, bufferHost);
+}
+
 // vulkanImageCopy
 void vulkanImageCopy(
 	VulkanDevice& device,
@@ -751,6 +1030,7 @@ void vulkanImageCopy(
 	assert(widthSrc == widthDst);
 	assert(heightSrc == heightDst);
 	assert(depthSrc == depthDst);
+	assert(imageSrc.arrayLayers == imageDst.arrayLayers);
 
 	// create command buffer
 	VulkanCommandBuffer commandBuffer{};
@@ -765,10 +1045,10 @@ void vulkanImageCopy(
 	VkImageCopy imageCopy{};
 	imageCopy.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
 	imageCopy.srcSubresource.mipLevel = mipLevelSrc;
-	imageCopy.srcSubresource.layerCount = 1;
+	imageCopy.srcSubresource.layerCount = imageSrc.arrayLayers;
 	imageCopy.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
 	imageCopy.dstSubresource.mipLevel = mipLevelDst;
-	imageCopy.dstSubresource.layerCount = 1;
+	imageCopy.dstSubresource.layerCount = imageDst.arrayLayers;
 	imageCopy.extent.width = widthSrc;
 	imageCopy.extent.height = heightSrc;
 	imageCopy.extent.depth = depthSrc;
@@ -790,18 +1070,11 @@ void vulkanImageCopy(
 }
 
 // vulkanImageBuildMipmaps
-void vulkanImageBuildMipmaps(
-	VulkanDevice& device,
-	VulkanImage&  image)
+// vulkanImageRecordMipmaps (blits level 0 into other levels, all levels end shader read optimal)
+static void vulkanImageRecordMipmaps(
+	VulkanCommandBuffer& commandBuffer,
+	VulkanImage&         image)
 {
-	// check parameters
-	assert(image.imageLayouts[0] != VK_IMAGE_LAYOUT_UNDEFINED);
-
-	// create command buffer
-	VulkanCommandBuffer commandBuffer{};
-	vulkanCommandBufferAllocate(device, VK_COMMAND_BUFFER_LEVEL_PRIMARY, &commandBuffer);
-	vulkanCommandBufferBegin(device, commandBuffer, VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
-
 	// set mipmap level 0 to transfer source optimal
 	vulkanImageSetLayout(commandBuffer, image, 0, VK_ACCESS_TRANSFER_READ_BIT, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
 
@@ -822,13 +1095,13 @@ void vulkanImageBuildMipmaps(
 		imageBlit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
 		imageBlit.srcSubresource.mipLevel = 0;
 		imageBlit.srcSubresource.baseArrayLayer = 0;
-		imageBlit.srcSubresource.layerCount = 1;
+		imageBlit.srcSubresource.layerCount = image.arrayLayers;
 		imageBlit.dstOffsets[0] = { 0, 0, 0 };
 		imageBlit.dstOffsets[1] = { width, height, depth };
 		imageBlit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
 		imageBlit.dstSubresource.mipLevel = mipLevel;
 		imageBlit.dstSubresource.baseArrayLayer = 0;
-		imageBlit.dstSubresource.layerCount = 1;
+		imageBlit.dstSubresource.layerCount = image.arrayLayers;
 		vkCmdBlitImage(commandBuffer.commandBuffer, image.image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, image.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &imageBlit, VK_FILTER_NEAREST);
 
 		// change image layouts
@@ -837,6 +1110,23 @@ void vulkanImageBuildMipmaps(
 
 	// set mipmap level 0 to shader read optimal
 	vulkanImageSetLayout(commandBuffer, image, 0, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+}
+
+// vulkanImageBuildMipmaps
+void vulkanImageBuildMipmaps(
+	VulkanDevice& device,
+	VulkanImage&  image)
+{
+	// check parameters
+	assert(image.imageLayouts[0] != VK_IMAGE_LAYOUT_UNDEFINED);
+
+	// create command buffer
+	VulkanCommandBuffer commandBuffer{};
+	vulkanCommandBufferAllocate(device, VK_COMMAND_BUFFER_LEVEL_PRIMARY, &commandBuffer);
+	vulkanCommandBufferBegin(device, commandBuffer, VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+
+	// record mipmaps
+	vulkanImageRecordMipmaps(commandBuffer, image);
 
 	// vkEndCommandBuffer
 	vulkanCommandBufferEnd(commandBuffer);
@@ -874,7 +1164,7 @@ void vulkanImageSetLayout(
 	imageMemoryBarrier.subresourceRange.baseMipLevel = mipLevel;
 	imageMemoryBarrier.subresourceRange.levelCount = 1;
 	imageMemoryBarrier.subresourceRange.baseArrayLayer = 0;
-	imageMemoryBarrier.subresourceRange.layerCount = 1;
+	imageMemoryBarrier.subresourceRange.layerCount = image.arrayLayers;
 	vkCmdPipelineBarrier(commandBuffer.commandBuffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 0, nullptr, 0, nullptr, 1, &imageMemoryBarrier);
 	image.accessFlags[mipLevel] = accessFlags;
 	image.imageLayouts[mipLevel] = imageLayout;
@@ -914,7 +1204,8 @@ void vulkanBufferCreate(
 	assert(size);
 	assert(buffer);
 
-	// store properties
+	// store properties (memory is owned by allocation)
+	buffer->memory = VK_NULL_HANDLE;
 	buffer->size = size;
 
 	// VkBufferCreateInfo
@@ -938,6 +1229,87 @@ void vulkanBufferCreate(
 	assert(buffer->buffer);
 }
 
+// vulkanBufferCreateMapped
+void vulkanBufferCreateMapped(
+	VulkanDevice&      device,
+	VkBufferUsageFlags usage,
+	VkDeviceSize       size,
+	VulkanBuffer*      buffer)
+{
+	// check size
+	assert(size);
+	assert(buffer);
+
+	// store properties (memory is owned by allocation)
+	buffer->memory = VK_NULL_HANDLE;
+	buffer->size = size;
+
+	// queue families (host written buffers may be read by graphics and compute queues)
+	uint32_t queueFamilyIndices[] = { device.queueFamilyIndexGraphics, device.queueFamilyIndexCompute };
+	VkBool32 concurrent = device.queueFamilyIndexGraphics != device.queueFamilyIndexCompute;
+
+	// VkBufferCreateInfo
+	VkBufferCreateInfo bufferCreateInfo{};
+	bufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+	bufferCreateInfo.pNext = VK_NULL_HANDLE;
+	bufferCreateInfo.size = size;
+	bufferCreateInfo.usage = usage;
+	bufferCreateInfo.sharingMode = concurrent ? VK_SHARING_MODE_CONCURRENT : VK_SHARING_MODE_EXCLUSIVE;
+	bufferCreateInfo.queueFamilyIndexCount = concurrent ? VKT_ARRAY_ELEMENTS_COUNT(queueFamilyIndices) : 0;
+	bufferCreateInfo.pQueueFamilyIndices = concurrent ? queueFamilyIndices : VK_NULL_HANDLE;
+
+	// VmaAllocationCreateInfo - host visible and persistently mapped (written by host every frame)
+	VmaAllocationCreateInfo allocCreateInfo{};
+	allocCreateInfo.usage = VMA_MEMORY_USAGE_CPU_TO_GPU;
+	allocCreateInfo.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+	// vmaCreateBuffer
+	VKT_CHECK(vmaCreateBuffer(device.allocator, &bufferCreateInfo, &allocCreateInfo, &buffer->buffer, &buffer->allocation, &buffer->allocationInfo));
+	assert(buffer->allocationInfo.pMappedData);
+	assert(buffer->allocation);
+	assert(buffer->buffer);
+}
+
+// vulkanBufferCreateShared
+void vulkanBufferCreateShared(
+	VulkanDevice&      device,
+	VkBufferUsageFlags usage,
+	VkDeviceSize       size,
+	VulkanBuffer*      buffer)
+{
+	// check size
+	assert(size);
+	assert(buffer);
+
+	// store properties (memory is owned by allocation)
+	buffer->memory = VK_NULL_HANDLE;
+	buffer->size = size;
+
+	// queue families (written by compute queue, read by graphics queue without ownership transfers)
+	uint32_t queueFamilyIndices[] = { device.queueFamilyIndexGraphics, device.queueFamilyIndexCompute };
+	VkBool32 concurrent = device.queueFamilyIndexGraphics != device.queueFamilyIndexCompute;
+
+	// VkBufferCreateInfo
+	VkBufferCreateInfo bufferCreateInfo{};
+	bufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+	bufferCreateInfo.pNext = VK_NULL_HANDLE;
+	bufferCreateInfo.size = size;
+	bufferCreateInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | usage;
+	bufferCreateInfo.sharingMode = concurrent ? VK_SHARING_MODE_CONCURRENT : VK_SHARING_MODE_EXCLUSIVE;
+	bufferCreateInfo.queueFamilyIndexCount = concurrent ? VKT_ARRAY_ELEMENTS_COUNT(queueFamilyIndices) : 0;
+	bufferCreateInfo.pQueueFamilyIndices = concurrent ? queueFamilyIndices : VK_NULL_HANDLE;
+
+	// VmaAllocationCreateInfo
+	VmaAllocationCreateInfo allocCreateInfo{};
+	allocCreateInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+	allocCreateInfo.flags = 0;
+
+	// vmaCreateBuffer
+	VKT_CHECK(vmaCreateBuffer(device.allocator, &bufferCreateInfo, &allocCreateInfo, &buffer->buffer, &buffer->allocation, &buffer->allocationInfo));
+	assert(buffer->allocation);
+	assert(buffer->buffer);
+}
+
 // vulkanBufferRead
 void vulkanBufferRead(
 	VulkanDevice& device,
@@ -1057,6 +1429,120 @@ void vulkanBufferWrite(
 	}
 }
 
+// vulkanBufferWriteHostMemory
+void vulkanBufferWriteHostMemory(
+	VulkanDevice& device,
+	VulkanBuffer& buffer,
+	VkDeviceSize  offset,
+	VkDeviceSize  size,
+	const void*   data)
+{
+	// check data
+	assert(offset + size <= buffer.size);
+	assert(data);
+
+	// import host memory as transfer source (staging buffer if host memory can not be imported)
+	VulkanBuffer bufferHost{};
+	if (!vulkanHostMemoryIsImportable(device, data, size) ||
+		!vulkanBufferCreateFromHostMemory(device, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, size, data, &bufferHost)) {
+		vulkanBufferWrite(device, buffer, offset, size, data);
+		return;
+	}
+
+	// copy from imported memory
+	vulkanBufferCopy(device, bufferHost, 0, buffer, offset, size);
+	vulkanBufferDestroy(device, bufferHost);
+}
+
+// vulkanBufferCreateFromHostMemory
+bool vulkanBufferCreateFromHostMemory(
+	VulkanDevice&      device,
+	VkBufferUsageFlags usage,
+	VkDeviceSize       size,
+	const void*        data,
+	VulkanBuffer*      buffer)
+{
+	// check parameters
+	assert(vulkanHostMemoryIsImportable(device, data, size));
+	assert(size);
+	assert(buffer);
+
+	// imported size must be multiple of import alignment
+	VkDeviceSize alignment = device.minImportedHostPointerAlignment;
+	VkDeviceSize sizeAligned = (size + alignment - 1) / alignment * alignment;
+
+	// store properties
+	buffer->allocation = VK_NULL_HANDLE;
+	buffer->allocationInfo = {};
+	buffer->size = size;
+
+	// VkExternalMemoryBufferCreateInfo
+	VkExternalMemoryBufferCreateInfo externalMemoryBufferCreateInfo{};
+	externalMemoryBufferCreateInfo.sType = VK_STRUCTURE_TYPE_EXTERNAL_MEMORY_BUFFER_CREATE_INFO;
+	externalMemoryBufferCreateInfo.pNext = VK_NULL_HANDLE;
+	externalMemoryBufferCreateInfo.handleTypes = VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT;
+
+	// VkBufferCreateInfo
+	VkBufferCreateInfo bufferCreateInfo{};
+	bufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+	bufferCreateInfo.pNext = &externalMemoryBufferCreateInfo;
+	bufferCreateInfo.size = sizeAligned;
+	bufferCreateInfo.usage = usage;
+	bufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+	bufferCreateInfo.queueFamilyIndexCount = 0;
+	bufferCreateInfo.pQueueFamilyIndices = VK_NULL_HANDLE;
+	VKT_CHECK(vkCreateBuffer(device.device, &bufferCreateInfo, VK_NULL_HANDLE, &buffer->buffer));
+	assert(buffer->buffer);
+
+	// get buffer memory requirements
+	VkMemoryRequirements memoryRequirements{};
+	vkGetBufferMemoryRequirements(device.device, buffer->buffer, &memoryRequirements);
+
+	// VkMemoryHostPointerPropertiesEXT
+	VkMemoryHostPointerPropertiesEXT memoryHostPointerProperties{};
+	memoryHostPointerProperties.sType = VK_STRUCTURE_TYPE_MEMORY_HOST_POINTER_PROPERTIES_EXT;
+	memoryHostPointerProperties.pNext = VK_NULL_HANDLE;
+	VKT_CHECK(device.fnGetMemoryHostPointerPropertiesEXT(device.device, VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT, data, &memoryHostPointerProperties));
+
+	// find memory type (prefer host cached)
+	uint32_t memoryTypeBits = memoryRequirements.memoryTypeBits & memoryHostPointerProperties.memoryTypeBits;
+	uint32_t memoryTypeIndex = UINT32_MAX;
+	for (uint32_t i = 0; i < device.physicalDeviceMemoryProperties.memoryTypeCount; i++) {
+		if ((memoryTypeBits & (1 << i)) == 0) continue;
+		if (memoryTypeIndex == UINT32_MAX) memoryTypeIndex = i;
+		if (device.physicalDeviceMemoryProperties.memoryTypes[i].propertyFlags & VK_MEMORY_PROPERTY_HOST_CACHED_BIT) {
+			memoryTypeIndex = i;
+			break;
+		}
+	}
+	// no memory type of buffer can import pointer
+	if (memoryTypeIndex == UINT32_MAX) {
+		vkDestroyBuffer(device.device, buffer->buffer, VK_NULL_HANDLE);
+		buffer->buffer = VK_NULL_HANDLE;
+		return false;
+	}
+
+	// VkImportMemoryHostPointerInfoEXT
+	VkImportMemoryHostPointerInfoEXT importMemoryHostPointerInfo{};
+	importMemoryHostPointerInfo.sType = VK_STRUCTURE_TYPE_IMPORT_MEMORY_HOST_POINTER_INFO_EXT;
+	importMemoryHostPointerInfo.pNext = VK_NULL_HANDLE;
+	importMemoryHostPointerInfo.handleType = VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT;
+	importMemoryHostPointerInfo.pHostPointer = (void*)data;
+
+	// VkMemoryAllocateInfo
+	VkMemoryAllocateInfo memoryAllocateInfo{};
+	memoryAllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+	memoryAllocateInfo.pNext = &importMemoryHostPointerInfo;
+	memoryAllocateInfo.allocationSize = std::max(sizeAligned, memoryRequirements.size);
+	memoryAllocateInfo.memoryTypeIndex = memoryTypeIndex;
+	VKT_CHECK(vkAllocateMemory(device.device, &memoryAllocateInfo, VK_NULL_HANDLE, &buffer->memory));
+	assert(buffer->memory);
+
+	// bind imported memory
+	VKT_CHECK(vkBindBufferMemory(device.device, buffer->buffer, buffer->memory, 0));
+	return true;
+}
+
 // vulkanBufferCopy
 void vulkanBufferCopy(
 	VulkanDevice& device,
@@ -1096,9 +1582,14 @@ void vulkanBufferDestroy(
 	VulkanBuffer& buffer)
 {
 	// destroy handles
-	vmaDestroyBuffer(device.allocator, buffer.buffer, buffer.allocation);
+	if (buffer.memory) {
+		vkDestroyBuffer(device.device, buffer.buffer, VK_NULL_HANDLE);
+		vkFreeMemory(device.device, buffer.memory, VK_NULL_HANDLE);
+	}
+	else vmaDestroyBuffer(device.allocator, buffer.buffer, buffer.allocation);
 	// clear handles
 	buffer.allocation = VK_NULL_HANDLE;
+	buffer.memory = VK_NULL_HANDLE;
 	buffer.buffer = VK_NULL_HANDLE;
 }
 
@@ -1181,6 +1672,247 @@ void vulkanSemaphoreDestroy(
 	semaphore.semaphore = VK_NULL_HANDLE;
 }
 
+// vulkanTransferCreate
+void vulkanTransferCreate(
+	VulkanDevice&   device,
+	VulkanTransfer* transfer)
+{
+	// check handles
+	assert(transfer);
+
+	// VkCommandPoolCreateInfo (own pool, so transfers can be recorded while other pools are in use)
+	VkCommandPoolCreateInfo commandPoolCreateInfo{};
+	commandPoolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+	commandPoolCreateInfo.pNext = VK_NULL_HANDLE;
+	commandPoolCreateInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT | VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+	commandPoolCreateInfo.queueFamilyIndex = device.queueFamilyIndexGraphics;
+	VKT_CHECK(vkCreateCommandPool(device.device, &commandPoolCreateInfo, VK_NULL_HANDLE, &transfer->commandPool));
+	assert(transfer->commandPool);
+
+	// VkCommandBufferAllocateInfo
+	VkCommandBufferAllocateInfo commandBufferAllocateInfo{};
+	commandBufferAllocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+	commandBufferAllocateInfo.pNext = VK_NULL_HANDLE;
+	commandBufferAllocateInfo.commandPool = transfer->commandPool;
+	commandBufferAllocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+	commandBufferAllocateInfo.commandBufferCount = 1;
+	VKT_CHECK(vkAllocateCommandBuffers(device.device, &commandBufferAllocateInfo, &transfer->commandBuffer.commandBuffer));
+	assert(transfer->commandBuffer.commandBuffer);
+
+	// VkFenceCreateInfo
+	VkFenceCreateInfo fenceCreateInfo{};
+	fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+	fenceCreateInfo.pNext = VK_NULL_HANDLE;
+	fenceCreateInfo.flags = 0;
+	VKT_CHECK(vkCreateFence(device.device, &fenceCreateInfo, VK_NULL_HANDLE, &transfer->fence));
+	assert(transfer->fence);
+
+	// store properties (staging buffer is created by first upload)
+	transfer->stagingBuffer = {};
+	transfer->stagingOffset = 0;
+	transfer->stagingBuffers.clear();
+	transfer->recording = VK_FALSE;
+	transfer->submitted = VK_FALSE;
+}
+
+// vulkanTransferDestroy
+void vulkanTransferDestroy(
+	VulkanDevice&   device,
+	VulkanTransfer& transfer)
+{
+	// wait submitted transfers and release staging buffers
+	assert(!transfer.recording);
+	vulkanTransferWait(device, transfer);
+	// destroy handles
+	if (transfer.stagingBuffer.buffer)
+		vulkanBufferDestroy(device, transfer.stagingBuffer);
+	vkDestroyFence(device.device, transfer.fence, VK_NULL_HANDLE);
+	vkDestroyCommandPool(device.device, transfer.commandPool, VK_NULL_HANDLE);
+	// clear handles
+	transfer.fence = VK_NULL_HANDLE;
+	transfer.commandBuffer.commandBuffer = VK_NULL_HANDLE;
+	transfer.commandPool = VK_NULL_HANDLE;
+}
+
+// vulkanTransferBegin
+void vulkanTransferBegin(
+	VulkanDevice&   device,
+	VulkanTransfer& transfer)
+{
+	// previous submission must be complete before command buffer and staging buffers are reused
+	assert(!transfer.recording);
+	vulkanTransferWait(device, transfer);
+
+	// begin command buffer
+	VKT_CHECK(vkResetCommandBuffer(transfer.commandBuffer.commandBuffer, 0));
+	vulkanCommandBufferBegin(device, transfer.commandBuffer, VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+	transfer.stagingOffset = 0;
+	transfer.recording = VK_TRUE;
+}
+
+// vulkanTransferStage (copies data into staging buffer of transfer, returns offset of data)
+static VkDeviceSize vulkanTransferStage(
+	VulkanDevice&   device,
+	VulkanTransfer& transfer,
+	VkDeviceSize    size,
+	const void*     data)
+{
+	// sub-allocate staging buffer (offsets aligned for buffer to image copies)
+	VkDeviceSize offset = (transfer.stagingOffset + 15) & ~(VkDeviceSize)15;
+	if (!transfer.stagingBuffer.buffer || offset + size > transfer.stagingBuffer.size) {
+		// outgrown buffer is read by recorded copies (released when transfer is complete)
+		if (transfer.stagingBuffer.buffer) {
+			vmaFlushAllocation(device.allocator, transfer.stagingBuffer.allocation, 0, transfer.stagingOffset);
+			transfer.stagingBuffers.push_back(transfer.stagingBuffer);
+		}
+		VkDeviceSize stagingSize = std::max(std::max(size, transfer.stagingBuffer.size * 2), (VkDeviceSize)VKT_TRANSFER_STAGING_SIZE);
+		vulkanBufferCreateMapped(device, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, stagingSize, &transfer.stagingBuffer);
+		offset = 0;
+	}
+
+	// copy data
+	memcpy((uint8_t*)transfer.stagingBuffer.allocationInfo.pMappedData + offset, data, (size_t)size);
+	transfer.stagingOffset = offset + size;
+	return offset;
+}
+
+// vulkanTransferBufferWrite
+void vulkanTransferBufferWrite(
+	VulkanDevice&   device,
+	VulkanTransfer& transfer,
+	VulkanBuffer&   buffer,
+	VkDeviceSize    offset,
+	VkDeviceSize    size,
+	const void*     data)
+{
+	// check parameters
+	assert(transfer.recording);
+	assert(offset + size <= buffer.size);
+	if (!size) return;
+	assert(data);
+
+	// stage data and record copy
+	VkBufferCopy bufferCopy{};
+	bufferCopy.srcOffset = vulkanTransferStage(device, transfer, size, data);
+	bufferCopy.dstOffset = offset;
+	bufferCopy.size = size;
+	vkCmdCopyBuffer(transfer.commandBuffer.commandBuffer, transfer.stagingBuffer.buffer, buffer.buffer, 1, &bufferCopy);
+}
+
+// vulkanTransferImageWrite
+void vulkanTransferImageWrite(
+	VulkanDevice&   device,
+	VulkanTransfer& transfer,
+	VulkanImage&    image,
+	uint32_t        mipLevel,
+	const void*     data)
+{
+	// check parameters
+	assert(transfer.recording);
+	assert(image.width);
+	assert(image.height);
+	assert(image.depth);
+	assert(mipLevel < image.mipLevels);
+	assert(data);
+
+	// calculate mipmap sizes
+	uint32_t width = std::max(1U, image.width >> mipLevel);
+	uint32_t height = std::max(1U, image.height >> mipLevel);
+	uint32_t depth = std::max(1U, image.depth >> mipLevel);
+	VkDeviceSize size = (VkDeviceSize)width * height * depth * image.arrayLayers * vulkanGetFormatTexelSize(image.format);
+
+	// stage data and change image layout
+	VkDeviceSize offsetStaging = vulkanTransferStage(device, transfer, size, data);
+	vulkanImageSetLayout(transfer.commandBuffer, image, mipLevel, VK_ACCESS_TRANSFER_WRITE_BIT, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+
+	// VkBufferImageCopy
+	VkBufferImageCopy bufferImageCopy{};
+	bufferImageCopy.bufferOffset = offsetStaging;
+	bufferImageCopy.bufferRowLength = 0;
+	bufferImageCopy.bufferImageHeight = 0;
+	bufferImageCopy.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	bufferImageCopy.imageSubresource.mipLevel = mipLevel;
+	bufferImageCopy.imageSubresource.baseArrayLayer = 0;
+	bufferImageCopy.imageSubresource.layerCount = image.arrayLayers;
+	bufferImageCopy.imageOffset = { 0, 0, 0 };
+	bufferImageCopy.imageExtent = { width, height, depth };
+	vkCmdCopyBufferToImage(transfer.commandBuffer.commandBuffer, transfer.stagingBuffer.buffer, image.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &bufferImageCopy);
+
+	// change image layout
+	vulkanImageSetLayout(transfer.commandBuffer, image, mipLevel, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+}
+
+// vulkanTransferImageBuildMipmaps
+void vulkanTransferImageBuildMipmaps(
+	VulkanDevice&   device,
+	VulkanTransfer& transfer,
+	VulkanImage&    image)
+{
+	// check parameters
+	assert(transfer.recording);
+	assert(image.imageLayouts[0] != VK_IMAGE_LAYOUT_UNDEFINED);
+
+	// record mipmaps
+	vulkanImageRecordMipmaps(transfer.commandBuffer, image);
+}
+
+// vulkanTransferSubmit
+void vulkanTransferSubmit(
+	VulkanDevice&   device,
+	VulkanTransfer& transfer)
+{
+	// check parameters
+	assert(transfer.recording);
+
+	// staged data visible to device
+	if (transfer.stagingBuffer.buffer)
+		vmaFlushAllocation(device.allocator, transfer.stagingBuffer.allocation, 0, transfer.stagingOffset);
+
+	// VkMemoryBarrier (later submissions on queue read written buffers)
+	VkMemoryBarrier memoryBarrier{};
+	memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+	memoryBarrier.pNext = VK_NULL_HANDLE;
+	memoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	memoryBarrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+	vkCmdPipelineBarrier(transfer.commandBuffer.commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 1, &memoryBarrier, 0, nullptr, 0, nullptr);
+	vulkanCommandBufferEnd(transfer.commandBuffer);
+	transfer.recording = VK_FALSE;
+
+	// VkSubmitInfo (signals fence, no queue wait)
+	VkSubmitInfo submitInfo{};
+	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	submitInfo.commandBufferCount = 1;
+	submitInfo.pCommandBuffers = &transfer.commandBuffer.commandBuffer;
+	VKT_CHECK(vkResetFences(device.device, 1, &transfer.fence));
+	VKT_CHECK(vkQueueSubmit(device.queueGraphics, 1, &submitInfo, transfer.fence));
+	transfer.submitted = VK_TRUE;
+}
+
+// vulkanTransferIsComplete
+bool vulkanTransferIsComplete(
+	VulkanDevice&   device,
+	VulkanTransfer& transfer)
+{
+	// nothing submitted or fence signaled
+	return !transfer.submitted || vkGetFenceStatus(device.device, transfer.fence) == VK_SUCCESS;
+}
+
+// vulkanTransferWait
+void vulkanTransferWait(
+	VulkanDevice&   device,
+	VulkanTransfer& transfer)
+{
+	// wait fence of submission
+	if (transfer.submitted) {
+		VKT_CHECK(vkWaitForFences(device.device, 1, &transfer.fence, VK_TRUE, UINT64_MAX));
+		transfer.submitted = VK_FALSE;
+	}
+	// release outgrown staging buffers (current one is reused)
+	for (auto& bufferStaging : transfer.stagingBuffers)
+		vulkanBufferDestroy(device, bufferStaging);
+	transfer.stagingBuffers.clear();
+}
+
 // loadFileData
 void loadFileData(
 	const char*        fileName,
@@ -1208,9 +1940,8 @@ void vulkanShaderCreate(
 	const char*   fileNameFS,
 	VulkanShader* shader)
 {
-	// check handles
+	// check handles (fragment shader is optional for depth only pipelines)
 	assert(fileNameVS);
-	assert(fileNameFS);
 	assert(shader);
 
 	// VkShaderModuleCreateInfo - vertex shader
@@ -1226,6 +1957,10 @@ void vulkanShaderCreate(
 	assert(shader->shaderModuleVS);
 
 	// VkShaderModuleCreateInfo - fragment shader
+	if (!fileNameFS) {
+		shader->shaderModuleFS = VK_NULL_HANDLE;
+		return;
+	}
 	std::vector<char> dataFS;
 	loadFileData(fileNameFS, dataFS);
 	VkShaderModuleCreateInfo shaderModuleCreateInfoFS{};
@@ -1348,12 +2083,13 @@ void vulkanPipelineCreate(
 	const VkVertexInputAttributeDescription   vertexInputAttributeDescriptions[],
 	uint32_t                                  pipelineColorBlendAttachmentStateCount,
 	const VkPipelineColorBlendAttachmentState pipelineColorBlendAttachmentStates[],
+	const VulkanPipelineDepthState*           pipelineDepthState,
 	VulkanPipeline*                           pipeline)
 {
-	// check handles
-	assert(vertexInputBindingDescriptions);
-	assert(vertexInputAttributeDescriptions);
-	assert(pipelineColorBlendAttachmentStates);
+	// check handles (depth only pipelines have no fragment shader and no color attachments, full screen pipelines have no vertex input)
+	assert(vertexInputBindingDescriptions || !vertexInputBindingDescriptionCount);
+	assert(vertexInputAttributeDescriptions || !vertexInputAttributeDescriptionCount);
+	assert(pipelineColorBlendAttachmentStates || !pipelineColorBlendAttachmentStateCount);
 	assert(pipeline);
 
 	// VkPipelineShaderStageCreateInfo
@@ -1433,13 +2169,13 @@ void vulkanPipelineCreate(
 	pipelineRasterizationStateCreateInfo.flags = 0;
 	pipelineRasterizationStateCreateInfo.depthClampEnable = VK_FALSE;
 	pipelineRasterizationStateCreateInfo.rasterizerDiscardEnable = VK_FALSE;
-	pipelineRasterizationStateCreateInfo.polygonMode = polygonMode;
+	pipelineRasterizationStateCreateInfo.polygonMode = device.physicalDeviceFeaturesEnabled.fillModeNonSolid ? polygonMode : VK_POLYGON_MODE_FILL;
 	pipelineRasterizationStateCreateInfo.cullMode = VK_CULL_MODE_NONE;
 	pipelineRasterizationStateCreateInfo.frontFace = VK_FRONT_FACE_CLOCKWISE;
-	pipelineRasterizationStateCreateInfo.depthBiasEnable = VK_FALSE;
-	pipelineRasterizationStateCreateInfo.depthBiasConstantFactor = 0.0f;
+	pipelineRasterizationStateCreateInfo.depthBiasEnable = pipelineDepthState ? pipelineDepthState->depthBiasEnable : VK_FALSE;
+	pipelineRasterizationStateCreateInfo.depthBiasConstantFactor = pipelineDepthState ? pipelineDepthState->depthBiasConstantFactor : 0.0f;
 	pipelineRasterizationStateCreateInfo.depthBiasClamp = 0.0f;
-	pipelineRasterizationStateCreateInfo.depthBiasSlopeFactor = 0.0f;
+	pipelineRasterizationStateCreateInfo.depthBiasSlopeFactor = pipelineDepthState ? pipelineDepthState->depthBiasSlopeFactor : 0.0f;
 	pipelineRasterizationStateCreateInfo.lineWidth = 1.0f;
 
 	// VkPipelineMultisampleStateCreateInfo
@@ -1459,10 +2195,10 @@ void vulkanPipelineCreate(
 	pipelineDepthStencilStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
 	pipelineDepthStencilStateCreateInfo.pNext = VK_NULL_HANDLE;
 	pipelineDepthStencilStateCreateInfo.flags = 0;
-	pipelineDepthStencilStateCreateInfo.depthTestEnable = VK_TRUE;
-	pipelineDepthStencilStateCreateInfo.depthWriteEnable = VK_TRUE;
-	pipelineDepthStencilStateCreateInfo.depthCompareOp = VK_COMPARE_OP_LESS;
-	pipelineDepthStencilStateCreateInfo.depthBoundsTestEnable = VK_TRUE;
+	pipelineDepthStencilStateCreateInfo.depthTestEnable = pipelineDepthState ? pipelineDepthState->depthTestEnable : VK_TRUE;
+	pipelineDepthStencilStateCreateInfo.depthWriteEnable = pipelineDepthState ? pipelineDepthState->depthWriteEnable : VK_TRUE;
+	pipelineDepthStencilStateCreateInfo.depthCompareOp = pipelineDepthState ? pipelineDepthState->depthCompareOp : VK_COMPARE_OP_LESS;
+	pipelineDepthStencilStateCreateInfo.depthBoundsTestEnable = device.physicalDeviceFeaturesEnabled.depthBounds;
 	pipelineDepthStencilStateCreateInfo.stencilTestEnable = VK_FALSE;
 	pipelineDepthStencilStateCreateInfo.front.failOp = VK_STENCIL_OP_KEEP;
 	pipelineDepthStencilStateCreateInfo.front.passOp = VK_STENCIL_OP_KEEP;
@@ -1511,7 +2247,7 @@ void vulkanPipelineCreate(
 	graphicsPipelineCreateInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
 	graphicsPipelineCreateInfo.pNext = VK_NULL_HANDLE;
 	graphicsPipelineCreateInfo.flags = 0;
-	graphicsPipelineCreateInfo.stageCount = (uint32_t)pipelineShaderStageCreateInfos.size();
+	graphicsPipelineCreateInfo.stageCount = shader.shaderModuleFS ? (uint32_t)pipelineShaderStageCreateInfos.size() : 1;
 	graphicsPipelineCreateInfo.pStages = pipelineShaderStageCreateInfos.data();
 	graphicsPipelineCreateInfo.pVertexInputState = &pipelineVertexInputStateCreateInfo;
 	graphicsPipelineCreateInfo.pInputAssemblyState = &pipelineInputAssemblyStateCreateInfo;
@@ -1530,10 +2266,60 @@ void vulkanPipelineCreate(
 	VKT_CHECK(vkCreateGraphicsPipelines(device.device, VK_NULL_HANDLE, 1, &graphicsPipelineCreateInfo, VK_NULL_HANDLE, &pipeline->pipeline));
 	assert(pipeline->pipeline);
 	// store parameters
-	pipeline->polygonMode = polygonMode;
+	pipeline->polygonMode = pipelineRasterizationStateCreateInfo.polygonMode;
 	pipeline->primitiveTopology = primitiveTopology;
 }
 
+// vulkanPipelineCreateCompute
+void vulkanPipelineCreateCompute(
+	VulkanDevice&         device,
+	const char*           fileNameCS,
+	VulkanPipelineLayout& pipelineLayout,
+	VulkanPipeline*       pipeline)
+{
+	// check handles
+	assert(fileNameCS);
+	assert(pipeline);
+
+	// VkShaderModuleCreateInfo - compute shader
+	std::vector<char> dataCS;
+	loadFileData(fileNameCS, dataCS);
+	VkShaderModuleCreateInfo shaderModuleCreateInfoCS{};
+	shaderModuleCreateInfoCS.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+	shaderModuleCreateInfoCS.pNext = VK_NULL_HANDLE;
+	shaderModuleCreateInfoCS.flags = VK_NULL_HANDLE;
+	shaderModuleCreateInfoCS.codeSize = (uint32_t)dataCS.size();
+	shaderModuleCreateInfoCS.pCode = (uint32_t *)dataCS.data();
+	VkShaderModule shaderModuleCS{};
+	VKT_CHECK(vkCreateShaderModule(device.device, &shaderModuleCreateInfoCS, VK_NULL_HANDLE, &shaderModuleCS));
+	assert(shaderModuleCS);
+
+	// VkComputePipelineCreateInfo
+	VkComputePipelineCreateInfo computePipelineCreateInfo{};
+	computePipelineCreateInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+	computePipelineCreateInfo.pNext = VK_NULL_HANDLE;
+	computePipelineCreateInfo.flags = 0;
+	computePipelineCreateInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+	computePipelineCreateInfo.stage.pNext = VK_NULL_HANDLE;
+	computePipelineCreateInfo.stage.flags = 0;
+	computePipelineCreateInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+	computePipelineCreateInfo.stage.module = shaderModuleCS;
+	computePipelineCreateInfo.stage.pName = "main";
+	computePipelineCreateInfo.stage.pSpecializationInfo = VK_NULL_HANDLE;
+	computePipelineCreateInfo.layout = pipelineLayout.pipelineLayout;
+	computePipelineCreateInfo.basePipelineHandle = VK_NULL_HANDLE;
+	computePipelineCreateInfo.basePipelineIndex = -1;
+	VKT_CHECK(vkCreateComputePipelines(device.device, VK_NULL_HANDLE, 1, &computePipelineCreateInfo, VK_NULL_HANDLE, &pipeline->pipeline));
+	assert(pipeline->pipeline);
+
+	// shader module is not needed after pipeline creation
+	vkDestroyShaderModule(device.device, shaderModuleCS, VK_NULL_HANDLE);
+
+	// store parameters (not used by compute pipelines)
+	pipeline->polygonMode = VK_POLYGON_MODE_FILL;
+	pipeline->primitiveTopology = VK_PRIMITIVE_TOPOLOGY_POINT_LIST;
+}
+
 // vulkanPipelineDestroy
 void vulkanPipelineDestroy(
 	VulkanDevice&   device,
@@ -1636,6 +2422,34 @@ void vulkanDescriptorSetUpdateBufferUniform(
 	vkUpdateDescriptorSets(device.device, 1, &writeDescriptorSet, 0, VK_NULL_HANDLE);
 }
 
+// vulkanDescriptorSetUpdateBufferStorage
+void vulkanDescriptorSetUpdateBufferStorage(
+	VulkanDevice&        device,
+	VulkanDescriptorSet& descriptorSet,
+	VulkanBuffer&        buffer,
+	uint32_t             binding)
+{
+	// VkDescriptorBufferInfo
+	VkDescriptorBufferInfo descriptorBufferInfo{};
+	descriptorBufferInfo.buffer = buffer.buffer;
+	descriptorBufferInfo.offset = 0;
+	descriptorBufferInfo.range = VK_WHOLE_SIZE;
+
+	// VkWriteDescriptorSet - storage buffer
+	VkWriteDescriptorSet writeDescriptorSet{};
+	writeDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	writeDescriptorSet.pNext = VK_NULL_HANDLE;
+	writeDescriptorSet.dstSet = descriptorSet.descriptorSet;
+	writeDescriptorSet.dstBinding = binding;
+	writeDescriptorSet.dstArrayElement = 0;
+	writeDescriptorSet.descriptorCount = 1;
+	writeDescriptorSet.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+	writeDescriptorSet.pImageInfo = VK_NULL_HANDLE;
+	writeDescriptorSet.pBufferInfo = &descriptorBufferInfo;
+	writeDescriptorSet.pTexelBufferView = VK_NULL_HANDLE;
+	vkUpdateDescriptorSets(device.device, 1, &writeDescriptorSet, 0, VK_NULL_HANDLE);
+}
+
 // vulkanDescriptorSetDestroy
 void vulkanDescriptorSetDestroy(
 	VulkanDevice&        device,
@@ -1649,6 +2463,99 @@ void vulkanDescriptorSetDestroy(
 	descriptorSet.descriptorPool = VK_NULL_HANDLE;
 }
 
+// VulkanHostMemoryHeader (stored right before aligned host memory)
+typedef struct VulkanHostMemoryHeader {
+	void*  allocation;
+	size_t size;
+} VulkanHostMemoryHeader;
+
+// aligned host memory blocks by address (only these pages are owned and may be imported)
+static std::mutex                  hostMemoryBlocksMutex;
+static std::map<uintptr_t, size_t> hostMemoryBlocks;
+
+// vulkanHostMemoryAlloc
+void* vulkanHostMemoryAlloc(
+	size_t size)
+{
+	// round size up, so whole aligned range can be imported
+	size_t sizeAligned = (size + VKT_HOST_MEMORY_ALIGNMENT - 1) / VKT_HOST_MEMORY_ALIGNMENT * VKT_HOST_MEMORY_ALIGNMENT;
+	void* allocation = malloc(sizeAligned + VKT_HOST_MEMORY_ALIGNMENT + sizeof(VulkanHostMemoryHeader));
+	if (!allocation) return nullptr;
+
+	// get aligned pointer and fill header
+	uintptr_t address = (uintptr_t)allocation + sizeof(VulkanHostMemoryHeader);
+	address = (address + VKT_HOST_MEMORY_ALIGNMENT - 1) / VKT_HOST_MEMORY_ALIGNMENT * VKT_HOST_MEMORY_ALIGNMENT;
+	VulkanHostMemoryHeader* header = (VulkanHostMemoryHeader*)address - 1;
+	header->allocation = allocation;
+	header->size = size;
+
+	// track aligned block
+	std::lock_guard<std::mutex> lock(hostMemoryBlocksMutex);
+	hostMemoryBlocks[address] = sizeAligned;
+	return (void*)address;
+}
+
+// vulkanHostMemoryRealloc
+void* vulkanHostMemoryRealloc(
+	void*  data,
+	size_t size)
+{
+	// allocate new memory
+	if (!data) return vulkanHostMemoryAlloc(size);
+	void* dataNew = vulkanHostMemoryAlloc(size);
+	if (!dataNew) return nullptr;
+
+	// copy old data and free
+	VulkanHostMemoryHeader* header = (VulkanHostMemoryHeader*)data - 1;
+	memcpy(dataNew, data, std::min(header->size, size));
+	vulkanHostMemoryFree(data);
+	return dataNew;
+}
+
+// vulkanHostMemoryFree
+void vulkanHostMemoryFree(
+	void* data)
+{
+	if (!data) return;
+	{
+		std::lock_guard<std::mutex> lock(hostMemoryBlocksMutex);
+		hostMemoryBlocks.erase((uintptr_t)data);
+	}
+	VulkanHostMemoryHeader* header = (VulkanHostMemoryHeader*)data - 1;
+	free(header->allocation);
+}
+
+// vulkanHostMemoryIsImportable
+bool vulkanHostMemoryIsImportable(
+	VulkanDevice& device,
+	const void*   data,
+	VkDeviceSize  size)
+{
+	// host memory must be aligned by device
+	VkDeviceSize alignment = device.minImportedHostPointerAlignment;
+	if (!device.externalMemoryHostEnabled || !data || !size) return false;
+	if (!alignment || alignment > VKT_HOST_MEMORY_ALIGNMENT || ((uintptr_t)data % alignment) != 0) return false;
+
+	// range rounded up by import alignment must lie in block allocated by vulkanHostMemoryAlloc
+	{
+		uintptr_t address = (uintptr_t)data;
+		VkDeviceSize sizeAligned = (size + alignment - 1) / alignment * alignment;
+		std::lock_guard<std::mutex> lock(hostMemoryBlocksMutex);
+		auto block = hostMemoryBlocks.upper_bound(address);
+		if (block == hostMemoryBlocks.begin()) return false;
+		block--;
+		if (address + sizeAligned > block->first + block->second) return false;
+	}
+
+	// some memory type must import pointer
+	VkMemoryHostPointerPropertiesEXT memoryHostPointerProperties{};
+	memoryHostPointerProperties.sType = VK_STRUCTURE_TYPE_MEMORY_HOST_POINTER_PROPERTIES_EXT;
+	memoryHostPointerProperties.pNext = VK_NULL_HANDLE;
+	if (device.fnGetMemoryHostPointerPropertiesEXT(device.device, VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT, data, &memoryHostPointerProperties) != VK_SUCCESS)
+		return false;
+	return memoryHostPointerProperties.memoryTypeBits != 0;
+}
+
 // vulkanInitDeviceQueueCreateInfo
 VkDeviceQueueCreateInfo vulkanInitDeviceQueueCreateInfo(
 	uint32_t queueFamilyIndex,
@@ -1730,6 +2637,76 @@ VkPresentModeKHR vulkanGetDefaultSurfacePresentMode(
 	return presentModes[0];
 }
 
+// vulkanFindSurfacePresentMode
+VkPresentModeKHR vulkanFindSurfacePresentMode(
+	VulkanDevice&    device,
+	VulkanSurface&   surface,
+	VkPresentModeKHR preferredPresentMode)
+{
+	// get present modes count
+	uint32_t presentModesCount = 0;
+	vkGetPhysicalDeviceSurfacePresentModesKHR(device.physicalDevice, surface.surface, &presentModesCount, nullptr);
+	assert(presentModesCount);
+	// get present modes list
+	std::vector<VkPresentModeKHR> presentModes(presentModesCount);
+	vkGetPhysicalDeviceSurfacePresentModesKHR(device.physicalDevice, surface.surface, &presentModesCount, presentModes.data());
+
+	// fallback keeps blocking behaviour (mailbox and immediate never block, relaxed FIFO blocks like FIFO)
+	VkPresentModeKHR fallbackPresentMode = VK_PRESENT_MODE_FIFO_KHR;
+	if (preferredPresentMode == VK_PRESENT_MODE_MAILBOX_KHR)
+		fallbackPresentMode = VK_PRESENT_MODE_IMMEDIATE_KHR;
+	if (preferredPresentMode == VK_PRESENT_MODE_IMMEDIATE_KHR)
+		fallbackPresentMode = VK_PRESENT_MODE_MAILBOX_KHR;
+
+	// try to find preferred mode, then fallback mode
+	for (const auto& presentMode : presentModes)
+		if (presentMode == preferredPresentMode)
+			return presentMode;
+	for (const auto& presentMode : presentModes)
+		if (presentMode == fallbackPresentMode)
+			return presentMode;
+
+	// FIFO mode is always supported
+	return VK_PRESENT_MODE_FIFO_KHR;
+}
+
+// vulkanGetFormatTexelSize
+uint32_t vulkanGetFormatTexelSize(
+	VkFormat format)
+{
+	switch (format) {
+	case VK_FORMAT_R8_UNORM:
+	case VK_FORMAT_R8_UINT:
+		return 1;
+	case VK_FORMAT_R8G8_UNORM:
+	case VK_FORMAT_R16_SFLOAT:
+	case VK_FORMAT_D16_UNORM:
+		return 2;
+	case VK_FORMAT_R8G8B8_UNORM:
+		return 3;
+	case VK_FORMAT_R8G8B8A8_UNORM:
+	case VK_FORMAT_R8G8B8A8_SNORM:
+	case VK_FORMAT_R8G8B8A8_SRGB:
+	case VK_FORMAT_B8G8R8A8_UNORM:
+	case VK_FORMAT_B8G8R8A8_SRGB:
+	case VK_FORMAT_A2B10G10R10_UNORM_PACK32:
+	case VK_FORMAT_A2R10G10B10_UNORM_PACK32:
+	case VK_FORMAT_R32_SFLOAT:
+	case VK_FORMAT_R32_UINT:
+	case VK_FORMAT_D32_SFLOAT:
+	case VK_FORMAT_D24_UNORM_S8_UINT:
+		return 4;
+	case VK_FORMAT_R16G16B16A16_SFLOAT:
+	case VK_FORMAT_R32G32_SFLOAT:
+		return 8;
+	case VK_FORMAT_R32G32B32A32_SFLOAT:
+		return 16;
+	default:
+		assert(0);
+		return 0;
+	}
+}
+
 // vulkanFindQueueFamilyPropertiesByFlags
 uint32_t vulkanFindQueueFamilyPropertiesByFlags(
 	std::vector<VkQueueFamilyProperties>& queueFamilyProperties,
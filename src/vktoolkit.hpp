@@ -2,11 +2,12 @@
 
 #include <VmaUsage.h>
 #include <vector>
+#include <string>
 
 #ifdef _DEBUG
 #define VKT_CHECK(func) { VkResult result = func; assert(result == VK_SUCCESS); };
 #else
-#define VKT_CHECK(func)
+#define VKT_CHECK(func) { func; };
 #endif
 
 #ifndef VKT_ARRAY_ELEMENTS_COUNT
@@ -17,15 +18,27 @@
 #define VKT_VECTOR_DATA_SIZE(vec) (VkDeviceSize)(vec.size()*sizeof(vec[0]))
 #endif
 
+#ifndef VKT_HOST_MEMORY_ALIGNMENT
+#define VKT_HOST_MEMORY_ALIGNMENT 4096
+#endif
+
+#ifndef VKT_TRANSFER_STAGING_SIZE
+#define VKT_TRANSFER_STAGING_SIZE (4 * 1024 * 1024)
+#endif
+
 typedef struct VulkanInstance {
 	VkInstance                    instance;
 	VkDebugReportCallbackEXT      debugReportCallback;
 	std::vector<VkPhysicalDevice> physicalDevices;
+	std::vector<std::string>      enabledLayerNames;     // requested layers supported by loader
+	std::vector<std::string>      enabledExtensionNames; // requested extensions supported by loader
 } VulkanInstance;
 
 typedef struct VulkanDevice {
 	VkPhysicalDevice                 physicalDevice;
 	VkPhysicalDeviceFeatures         physicalDeviceFeatures;
+	VkPhysicalDeviceFeatures         physicalDeviceFeaturesEnabled; // requested features supported by physical device
+	std::vector<std::string>         enabledExtensionNames;         // requested extensions supported by physical device
 	VkPhysicalDeviceProperties       physicalDeviceProperties;
 	VkPhysicalDeviceMemoryProperties physicalDeviceMemoryProperties;
 	uint32_t                         queueFamilyIndexGraphics;
@@ -44,16 +57,33 @@ typedef struct VulkanDevice {
 	VkBuffer                         bufferStaging;
 	VmaAllocation                    bufferStagingAllocation;
 	VmaAllocationInfo                bufferStagingAllocationInfo;
+	VkBool32                         externalMemoryHostEnabled;
+	VkDeviceSize                     minImportedHostPointerAlignment;
+	PFN_vkGetMemoryHostPointerPropertiesEXT fnGetMemoryHostPointerPropertiesEXT;
+	VkBool32                         multiviewEnabled;
+	uint32_t                         maxMultiviewViewCount;
+	VkBool32                         shaderDrawParametersEnabled;
+	VkBool32                         drawIndirectCountEnabled;
+	PFN_vkCmdDrawIndirectCountKHR    fnCmdDrawIndirectCountKHR;
+	PFN_vkCmdDrawIndexedIndirectCountKHR fnCmdDrawIndexedIndirectCountKHR;
 } VulkanDevice;
 
 typedef struct VulkanSurface {
 	VkSurfaceKHR surface;
 } VulkanSurface;
 
+typedef struct VulkanSwapchainConfig {
+	VkPresentModeKHR presentMode;     // preferred (unsupported mode falls back to closest supported)
+	uint32_t         imageCount;      // requested (clamped to surface limits)
+	uint32_t         maxQueuedFrames; // frames ahead of device (1 - lowest latency, images count - highest throughput)
+} VulkanSwapchainConfig;
+
 typedef struct VulkanSwapchain {
+	VulkanSwapchainConfig      config;
 	VkSurfaceFormatKHR         surfaceFormat;
 	VkPresentModeKHR           presentMode;
 	VkSurfaceCapabilitiesKHR   surfaceCapabilities;
+	VkImageUsageFlags          imageUsage; // color attachment, transfer destination when supported by surface
 	VkSwapchainKHR             swapchain;
 	std::vector<VkImage>       images;
 } VulkanSwapchain;
@@ -73,6 +103,7 @@ typedef struct VulkanImage {
 	uint32_t                   width;
 	uint32_t                   height;
 	uint32_t                   depth;
+	uint32_t                   arrayLayers;
 	uint32_t                   mipLevels;
 	std::vector<VkAccessFlags> accessFlags{};
 	std::vector<VkImageLayout> imageLayouts{};
@@ -81,6 +112,7 @@ typedef struct VulkanImage {
 typedef struct VulkanBuffer {
 	VmaAllocation     allocation;
 	VmaAllocationInfo allocationInfo;
+	VkDeviceMemory    memory{}; // imported memory (null when allocation owns memory)
 	VkBuffer          buffer;
 	VkDeviceSize      size;
 } VulkanBuffer;
@@ -93,6 +125,17 @@ typedef struct VulkanCommandBuffer {
 	VkCommandBuffer commandBuffer;
 } VulkanCommandBuffer;
 
+typedef struct VulkanTransfer {
+	VkCommandPool             commandPool;
+	VulkanCommandBuffer       commandBuffer;
+	VkFence                   fence;          // signaled when submitted transfers are complete
+	VulkanBuffer              stagingBuffer;  // persistent mapped staging memory (sub-allocated while recording)
+	VkDeviceSize              stagingOffset;
+	std::vector<VulkanBuffer> stagingBuffers; // outgrown staging buffers, released when transfer is reused or destroyed
+	VkBool32                  recording;
+	VkBool32                  submitted;
+} VulkanTransfer;
+
 typedef struct VulkanShader {
 	VkShaderModule shaderModuleVS;
 	VkShaderModule shaderModuleFS;
@@ -114,6 +157,15 @@ typedef struct VulkanPipeline {
 	VkPrimitiveTopology primitiveTopology;
 } VulkanPipeline;
 
+typedef struct VulkanPipelineDepthState {
+	VkBool32    depthTestEnable;
+	VkBool32    depthWriteEnable;
+	VkCompareOp depthCompareOp;
+	VkBool32    depthBiasEnable;
+	float       depthBiasConstantFactor;
+	float       depthBiasSlopeFactor;
+} VulkanPipelineDepthState;
+
 typedef struct VulkanDescriptorSet {
 	VkDescriptorPool descriptorPool;
 	VkDescriptorSet  descriptorSet;
@@ -131,6 +183,16 @@ void vulkanInstanceDestroy(
 	VulkanInstance& instance
 );
 
+bool vulkanInstanceLayerEnabled(
+	const VulkanInstance& instance,
+	const char*           layerName
+);
+
+bool vulkanInstanceExtensionEnabled(
+	const VulkanInstance& instance,
+	const char*           extensionName
+);
+
 void vulkanDeviceCreate(
 	VulkanInstance&            instance,
 	VkPhysicalDeviceType       physicalDeviceType,
@@ -143,10 +205,23 @@ void vulkanDeviceDestroy(
 	VulkanDevice& device
 );
 
+bool vulkanDeviceExtensionEnabled(
+	const VulkanDevice& device,
+	const char*         extensionName
+);
+
 void vulkanSwapchainCreate(
-	VulkanDevice&    device,
-	VulkanSurface&   surface,
-	VulkanSwapchain* swapchain
+	VulkanDevice&                device,
+	VulkanSurface&               surface,
+	const VulkanSwapchainConfig& config,
+	VulkanSwapchain*             swapchain
+);
+
+void vulkanSwapchainRecreate(
+	VulkanDevice&                device,
+	VulkanSurface&               surface,
+	const VulkanSwapchainConfig& config,
+	VulkanSwapchain*             swapchain
 );
 
 void vulkanSwapchainDestroy(
@@ -187,6 +262,7 @@ void vulkanImageCreate(
 	uint32_t      width,
 	uint32_t      height,
 	uint32_t      depth,
+	uint32_t      arrayLayers,
 	VulkanImage*  image
 );
 
@@ -204,6 +280,13 @@ void vulkanImageWrite(
 	const void*   data
 );
 
+void vulkanImageWriteHostMemory(
+	VulkanDevice& device,
+	VulkanImage&  image,
+	uint32_t      mipLevel,
+	const void*   data
+);
+
 void vulkanImageCopy(
 	VulkanDevice& device,
 	VulkanImage&  imageSrc,
@@ -237,6 +320,20 @@ void vulkanBufferCreate(
 	VulkanBuffer*      buffer
 );
 
+void vulkanBufferCreateMapped(
+	VulkanDevice&      device,
+	VkBufferUsageFlags usage,
+	VkDeviceSize       size,
+	VulkanBuffer*      buffer
+);
+
+void vulkanBufferCreateShared(
+	VulkanDevice&      device,
+	VkBufferUsageFlags usage,
+	VkDeviceSize       size,
+	VulkanBuffer*      buffer
+);
+
 void vulkanBufferRead(
 	VulkanDevice& device,
 	VulkanBuffer& buffer,
@@ -253,6 +350,22 @@ void vulkanBufferWrite(
 	const void*   data
 );
 
+void vulkanBufferWriteHostMemory(
+	VulkanDevice& device,
+	VulkanBuffer& buffer,
+	VkDeviceSize  offset,
+	VkDeviceSize  size,
+	const void*   data
+);
+
+bool vulkanBufferCreateFromHostMemory(
+	VulkanDevice&      device,
+	VkBufferUsageFlags usage,
+	VkDeviceSize       size,
+	const void*        data,
+	VulkanBuffer*      buffer
+);
+
 void vulkanBufferCopy(
 	VulkanDevice& device,
 	VulkanBuffer& bufferSrc,
@@ -298,6 +411,61 @@ void vulkanSemaphoreDestroy(
 	VulkanSemaphore& semaphore
 );
 
+// transfer utilities (uploads recorded into command buffer, no queue wait)
+
+void vulkanTransferCreate(
+	VulkanDevice&   device,
+	VulkanTransfer* transfer
+);
+
+void vulkanTransferDestroy(
+	VulkanDevice&   device,
+	VulkanTransfer& transfer
+);
+
+void vulkanTransferBegin(
+	VulkanDevice&   device,
+	VulkanTransfer& transfer
+);
+
+void vulkanTransferBufferWrite(
+	VulkanDevice&   device,
+	VulkanTransfer& transfer,
+	VulkanBuffer&   buffer,
+	VkDeviceSize    offset,
+	VkDeviceSize    size,
+	const void*     data
+);
+
+void vulkanTransferImageWrite(
+	VulkanDevice&   device,
+	VulkanTransfer& transfer,
+	VulkanImage&    image,
+	uint32_t        mipLevel,
+	const void*     data
+);
+
+void vulkanTransferImageBuildMipmaps(
+	VulkanDevice&   device,
+	VulkanTransfer& transfer,
+	VulkanImage&    image
+);
+
+void vulkanTransferSubmit(
+	VulkanDevice&   device,
+	VulkanTransfer& transfer
+);
+
+bool vulkanTransferIsComplete(
+	VulkanDevice&   device,
+	VulkanTransfer& transfer
+);
+
+void vulkanTransferWait(
+	VulkanDevice&   device,
+	VulkanTransfer& transfer
+);
+
 void vulkanShaderCreate(
 	VulkanDevice& device,
 	const char*   fileNameVS,
@@ -346,9 +514,17 @@ void vulkanPipelineCreate(
 	const VkVertexInputAttributeDescription   vertexInputAttributeDescriptions[],
 	uint32_t                                  pipelineColorBlendAttachmentStateCount,
 	const VkPipelineColorBlendAttachmentState pipelineColorBlendAttachmentStates[],
+	const VulkanPipelineDepthState*           pipelineDepthState,
 	VulkanPipeline*                           pipeline
 );
 
+void vulkanPipelineCreateCompute(
+	VulkanDevice&         device,
+	const char*           fileNameCS,
+	VulkanPipelineLayout& pipelineLayout,
+	VulkanPipeline*       pipeline
+);
+
 void vulkanPipelineDestroy(
 	VulkanDevice&   device,
 	VulkanPipeline& pipeline
@@ -375,11 +551,55 @@ void vulkanDescriptorSetUpdateBufferUniform(
 	uint32_t             binding
 );
 
+void vulkanDescriptorSetUpdateBufferStorage(
+	VulkanDevice&        device,
+	VulkanDescriptorSet& descriptorSet,
+	VulkanBuffer&        buffer,
+	uint32_t             binding
+);
+
 void vulkanDescriptorSetDestroy(
 	VulkanDevice&        device,
 	VulkanDescriptorSet& descriptorSet
 );
 
+// host memory utilities
+
+void* vulkanHostMemoryAlloc(
+	size_t size
+);
+
+void* vulkanHostMemoryRealloc(
+	void*  data,
+	size_t size
+);
+
+void vulkanHostMemoryFree(
+	void* data
+);
+
+bool vulkanHostMemoryIsImportable(
+	VulkanDevice& device,
+	const void*   data,
+	VkDeviceSize  size
+);
+
+// VulkanHostAllocator (STL allocator over vulkanHostMemoryAlloc)
+template <typename T>
+struct VulkanHostAllocator {
+	typedef T value_type;
+	VulkanHostAllocator() = default;
+	template <typename U> VulkanHostAllocator(const VulkanHostAllocator<U>&) {}
+	T* allocate(size_t count) { return (T*)vulkanHostMemoryAlloc(count * sizeof(T)); }
+	void deallocate(T* data, size_t) { vulkanHostMemoryFree(data); }
+	template <typename U> bool operator==(const VulkanHostAllocator<U>&) const { return true; }
+	template <typename U> bool operator!=(const VulkanHostAllocator<U>&) const { return false; }
+};
+
+// VulkanHostVector
+template <typename T>
+using VulkanHostVector = std::vector<T, VulkanHostAllocator<T>>;
+
 // init utilities
 
 VkDeviceQueueCreateInfo vulkanInitDeviceQueueCreateInfo(
@@ -400,6 +620,16 @@ VkPresentModeKHR vulkanGetDefaultSurfacePresentMode(
 	VulkanSurface& surface
 );
 
+VkPresentModeKHR vulkanFindSurfacePresentMode(
+	VulkanDevice&    device,
+	VulkanSurface&   surface,
+	VkPresentModeKHR preferredPresentMode
+);
+
+uint32_t vulkanGetFormatTexelSize(
+	VkFormat format
+);
+
 uint32_t vulkanFindQueueFamilyPropertiesByFlags(
 	std::vector<VkQueueFamilyProperties>& queueFamilyProperties,
 	VkQueueFlags                          queueFlags